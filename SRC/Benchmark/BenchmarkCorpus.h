@@ -0,0 +1,42 @@
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ProForma {
+namespace Benchmark {
+	/** \brief  Intact protein sized proteoform (1500 residues) with a modification every 25 residues */
+	inline std::string LongProteoform()
+	{
+		static const char residues[] = "ACDEFGHIKLMNPQRSTVWY";
+		std::string text = "[Acetyl]-";
+
+		for (int i = 0; i < 1500; i++)
+		{
+			text += residues[(i * 7) % 20];
+			if (i % 25 == 24)
+				text += (i % 50 == 49) ? "[Phospho]" : "[+15.9949]";
+		}
+
+		return text;
+	}
+
+	/**
+	 * \brief  Reference ProForma strings used by the benchmarks, one per grammar construct.
+	 *         The first element is the name used in benchmark labels.
+	 */
+	inline const std::vector<std::pair<std::string, std::string>>& Corpus()
+	{
+		static const std::vector<std::pair<std::string, std::string>> corpus = {
+			{ "plain",       "PROTEOFORMPEPTIDESEQVENCEK" },
+			{ "modified",    "[Acetyl]-EM[Oxidation]EVEES[Phospho]PEK[U:Methyl]-[Amidated]" },
+			{ "grouped",     "EM[Oxidation]EVT[#g1(0.01)]S[#g1(0.09)]ES[Phospho#g1(0.90)]PEK" },
+			{ "global",      "<[Carbamidomethyl]@C>ATPEILTCNSIGCLK" },
+			{ "unlocalized", "[Phospho]?EM[Oxidation]EVTSECSPEK" },
+			{ "long",        LongProteoform() },
+		};
+		return corpus;
+	}
+}
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace ProForma {
+namespace Benchmark {
+	/**
+	 * \struct BenchmarkCase
+	 *
+	 * \brief A named micro benchmark. The body runs the measured operation the requested number
+	 *        of times and returns the number of input bytes processed.
+	 *
+	 */
+	struct BenchmarkCase {
+		std::string Name;
+		std::function<size_t(size_t)> Body;
+	};
+
+	/** \brief  All benchmarks registered through PROFORMA_BENCHMARK */
+	inline std::vector<BenchmarkCase>& Registry()
+	{
+		static std::vector<BenchmarkCase> cases;
+		return cases;
+	}
+
+	/** \brief  Registers a benchmark from a static initializer */
+	struct BenchmarkRegistration {
+		BenchmarkRegistration(const std::string& name, std::function<size_t(size_t)> body)
+		{
+			Registry().push_back(BenchmarkCase{ name, body });
+		}
+	};
+
+	/** \brief  Heap allocations made by the process so far, counted by the benchmark program's operator new.
+	  *         Allocations done inside the shared library are only seen where the platform lets the
+	  *         executable replace operator new for every module (ELF, Mach-O).
+	  */
+	size_t AllocationCount();
+
+	/** \brief  Keeps a result alive so the optimizer cannot drop the measured work */
+	inline void KeepAlive(size_t value)
+	{
+		static volatile size_t sink = 0;
+		sink = sink + value;
+	}
+
+	/** \brief  Elapsed nanoseconds of a steady clock interval */
+	inline double ElapsedNs(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end)
+	{
+		return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+	}
+}
+}
+
+#define PROFORMA_BENCHMARK_CONCAT_IMPL(a, b) a##b
+#define PROFORMA_BENCHMARK_CONCAT(a, b) PROFORMA_BENCHMARK_CONCAT_IMPL(a, b)
+
+/** \brief  Registers a benchmark body: size_t (size_t iterations) */
+#define PROFORMA_BENCHMARK(name, body) \
+	static ProForma::Benchmark::BenchmarkRegistration PROFORMA_BENCHMARK_CONCAT(_benchmark_, __LINE__)(name, body)
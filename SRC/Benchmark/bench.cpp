@@ -0,0 +1,165 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "ProFormaBenchmark.h"
+#include "ProFormaParseException.h"
+
+using namespace ProForma::Benchmark;
+
+static std::atomic<size_t> _allocations(0);
+
+size_t ProForma::Benchmark::AllocationCount() { return _allocations.load(std::memory_order_relaxed); }
+
+// Count every heap allocation of the process
+void* operator new(size_t size)
+{
+    _allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+// Result of one benchmark
+struct BenchmarkResult {
+    std::string Name;
+    size_t Iterations;
+    double NsPerOp;
+    double MinNsPerOp;
+    double BytesPerSecond;
+    double AllocationsPerOp;
+};
+
+static void usage(const char* program)
+{
+    fprintf(stderr, "Usage: %s [--min-time MS] [--samples N] [--iterations N] [--json PATH] [FILTER]\n", program);
+    fprintf(stderr, "  --min-time MS     minimum duration of a sample, 50 by default\n");
+    fprintf(stderr, "  --samples N       measured samples per benchmark, the median is reported, 5 by default\n");
+    fprintf(stderr, "  --iterations N    fixed iterations per sample instead of the calibration\n");
+    fprintf(stderr, "  --json PATH       also write the results as JSON\n");
+    fprintf(stderr, "  FILTER            only run the benchmarks whose name contains FILTER\n");
+}
+
+static bool WriteJson(const std::string& path, const std::vector<BenchmarkResult>& results, double minSampleNs, int samples)
+{
+    FILE* file = fopen(path.c_str(), "w");
+    if (file == nullptr)
+        return false;
+
+    time_t now = time(nullptr);
+    char date[32];
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+
+    fprintf(file, "{\n  \"context\": {\"date\": \"%s\", \"min_time_ms\": %.0f, \"samples\": %d},\n  \"benchmarks\": [", date, minSampleNs / 1e6, samples);
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const BenchmarkResult& result = results[i];
+        fprintf(file, "%s\n    {\"name\": \"%s\", \"iterations\": %zu, \"ns_per_op\": %.3f, \"min_ns_per_op\": %.3f, \"bytes_per_second\": %.1f, \"allocs_per_op\": %.3f}",
+            i > 0 ? "," : "", result.Name.c_str(), result.Iterations, result.NsPerOp, result.MinNsPerOp, result.BytesPerSecond, result.AllocationsPerOp);
+    }
+    fprintf(file, "\n  ]\n}\n");
+
+    return fclose(file) == 0;
+}
+
+int main(int argc, char** argv) {
+    // Minimum duration of one measured sample, and number of samples
+    double minSampleNs = 50e6;
+    int samples = 5;
+    size_t fixedIterations = 0;
+    const char* filter = nullptr;
+    std::string jsonPath;
+
+    for (int i = 1; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+
+        if (strcmp(argv[i], "--min-time") == 0 && hasValue)
+            minSampleNs = std::atof(argv[++i]) * 1e6;
+        else if (strcmp(argv[i], "--samples") == 0 && hasValue)
+            samples = std::max(1, std::atoi(argv[++i]));
+        else if (strcmp(argv[i], "--iterations") == 0 && hasValue)
+            fixedIterations = static_cast<size_t>(std::strtoull(argv[++i], nullptr, 10));
+        else if (strcmp(argv[i], "--json") == 0 && hasValue)
+            jsonPath = argv[++i];
+        else if (strncmp(argv[i], "--", 2) == 0)
+        {
+            usage(argv[0]);
+            return strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+        else
+            filter = argv[i];
+    }
+
+    std::vector<BenchmarkResult> results;
+    printf("%-48s %14s %12s %12s\n", "Benchmark", "ns/op", "MB/s", "allocs/op");
+
+    for (auto& benchmark : Registry())
+    {
+        if (filter && benchmark.Name.find(filter) == std::string::npos)
+            continue;
+
+        try {
+            // Grow the iteration count until a sample is long enough to be measured reliably,
+            // the calibration runs double as the warm-up of caches and allocator
+            size_t iterations = fixedIterations > 0 ? fixedIterations : 1;
+            while (fixedIterations == 0)
+            {
+                auto start = std::chrono::steady_clock::now();
+                KeepAlive(benchmark.Body(iterations));
+                double elapsed = ElapsedNs(start, std::chrono::steady_clock::now());
+
+                if (elapsed >= minSampleNs)
+                    break;
+
+                iterations *= elapsed > 0 ? std::min<size_t>(10, std::max<size_t>(2, static_cast<size_t>(minSampleNs / elapsed))) : 10;
+            }
+
+            // One untimed sample at the final size
+            KeepAlive(benchmark.Body(iterations));
+
+            // Report the median of several samples
+            std::vector<double> nsPerOp;
+            size_t bytes = 0;
+            for (int sample = 0; sample < samples; sample++)
+            {
+                auto start = std::chrono::steady_clock::now();
+                bytes = benchmark.Body(iterations);
+                nsPerOp.push_back(ElapsedNs(start, std::chrono::steady_clock::now()) / iterations);
+            }
+
+            std::sort(nsPerOp.begin(), nsPerOp.end());
+            double median = nsPerOp[nsPerOp.size() / 2];
+            double mbPerSecond = (bytes / static_cast<double>(iterations)) / median * 1e3;
+
+            // One more sample for the allocation count
+            size_t allocations = AllocationCount();
+            benchmark.Body(iterations);
+            double allocationsPerOp = (AllocationCount() - allocations) / static_cast<double>(iterations);
+
+            printf("%-48s %14.1f %12.1f %12.1f\n", benchmark.Name.c_str(), median, mbPerSecond, allocationsPerOp);
+            fflush(stdout);
+            results.push_back(BenchmarkResult{ benchmark.Name, iterations, median, nsPerOp.front(), mbPerSecond * 1e6, allocationsPerOp });
+        } catch (ProForma::ProFormaParseException* e) {
+            printf("%-48s ERROR: %s\n", benchmark.Name.c_str(), e->what());
+        }
+    }
+
+    if (!jsonPath.empty() && !WriteJson(jsonPath, results, minSampleNs, samples))
+    {
+        fprintf(stderr, "ERROR: Cannot write %s\n", jsonPath.c_str());
+        return 1;
+    }
+
+    return 0;
+}
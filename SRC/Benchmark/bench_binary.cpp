@@ -0,0 +1,91 @@
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#include "BenchmarkCorpus.h"
+#include "ProFormaBenchmark.h"
+#include "ProFormaBinaryReader.h"
+#include "ProFormaBinaryWriter.h"
+#include "ProFormaParser.h"
+
+using namespace ProForma;
+using namespace ProForma::Benchmark;
+
+// Encodes the whole corpus as one stream, so the string table is shared between the terms
+static size_t EncodeBinary(const std::vector<ProFormaTerm>& terms, size_t iterations)
+{
+    size_t bytes = 0;
+
+    for (size_t i = 0; i < iterations; i++)
+    {
+        std::ostringstream stream;
+        ProFormaBinaryWriter writer(stream);
+        for (auto& term : terms)
+            writer.Write(term);
+        bytes += stream.str().length();
+    }
+
+    return bytes;
+}
+
+// Decodes the stream written by EncodeBinary, ns/op compares directly with binary/parse/corpus
+static size_t DecodeBinary(const std::string& bytes, size_t iterations)
+{
+    size_t residues = 0;
+    ProFormaTerm term("");
+
+    for (size_t i = 0; i < iterations; i++)
+    {
+        std::istringstream stream(bytes);
+        ProFormaBinaryReader reader(stream);
+        while (reader.Read(term))
+            residues += term.Sequence().length();
+    }
+
+    KeepAlive(residues);
+    return bytes.length() * iterations;
+}
+
+// Parses the ProForma strings the stream was written from
+static size_t ParseProForma(const std::vector<std::string>& inputs, size_t iterations)
+{
+    ProFormaQuietParser parser;
+    size_t residues = 0, bytes = 0;
+
+    for (size_t i = 0; i < iterations; i++)
+    {
+        for (auto& input : inputs)
+        {
+            residues += parser.ParseString(input).Sequence().length();
+            bytes += input.length();
+        }
+    }
+
+    KeepAlive(residues);
+    return bytes;
+}
+
+static int RegisterBinary()
+{
+    auto terms = std::make_shared<std::vector<ProFormaTerm>>();
+    auto inputs = std::make_shared<std::vector<std::string>>();
+
+    for (auto& item : Corpus())
+    {
+        inputs->push_back(item.second);
+        terms->push_back(ProFormaQuietParser().ParseString(item.second));
+    }
+
+    std::ostringstream stream;
+    ProFormaBinaryWriter writer(stream);
+    for (auto& term : *terms)
+        writer.Write(term);
+    auto bytes = std::make_shared<std::string>(stream.str());
+
+    BenchmarkRegistration("binary/encode/corpus", [terms](size_t iterations) { return EncodeBinary(*terms, iterations); });
+    BenchmarkRegistration("binary/decode/corpus", [bytes](size_t iterations) { return DecodeBinary(*bytes, iterations); });
+    BenchmarkRegistration("binary/parse/corpus", [inputs](size_t iterations) { return ParseProForma(*inputs, iterations); });
+    return 0;
+}
+
+static int _binary = RegisterBinary();
@@ -0,0 +1,72 @@
+#include "ProFormaBenchmark.h"
+#include "ProFormaTermBuilder.h"
+
+using namespace ProForma;
+using namespace ProForma::Benchmark;
+
+static const size_t Residues = 64;
+
+// Builds a term with one two-descriptor tag every fourth residue through the builder
+static size_t BuildWithBuilder(size_t iterations)
+{
+    size_t tags = 0;
+
+    for (size_t i = 0; i < iterations; i++)
+    {
+        ProFormaTermBuilder builder;
+        for (size_t r = 0; r < Residues; r++)
+        {
+            builder.AddResidue('A' + r % 20);
+            if (r % 4 == 0)
+            {
+                builder.AddTag(r);
+                builder.AddDescriptor(ProFormaDescriptor(ProFormaKey::Name, ProFormaEvidenceType::Unimod, "Phospho"));
+                builder.AddDescriptor(ProFormaDescriptor(ProFormaKey::Mass, "+79.966331"));
+            }
+        }
+
+        tags += std::move(builder).Build().Tags().size();
+    }
+
+    KeepAlive(tags);
+    return Residues * iterations;
+}
+
+// Builds the same term from named containers handed over as lvalues, every level is copied
+static size_t BuildWithCopies(size_t iterations)
+{
+    size_t tags = 0;
+
+    for (size_t i = 0; i < iterations; i++)
+    {
+        std::string sequence;
+        std::list<ProFormaTag> tagList;
+        for (size_t r = 0; r < Residues; r++)
+        {
+            sequence.push_back('A' + r % 20);
+            if (r % 4 == 0)
+            {
+                std::list<ProFormaDescriptor> descriptors;
+                ProFormaDescriptor name(ProFormaKey::Name, ProFormaEvidenceType::Unimod, "Phospho");
+                ProFormaDescriptor mass(ProFormaKey::Mass, "+79.966331");
+                descriptors.push_back(name);
+                descriptors.push_back(mass);
+                ProFormaTag tag(r, descriptors);
+                tagList.push_back(tag);
+            }
+        }
+
+        std::list<ProFormaDescriptor> none;
+        std::list<ProFormaUnlocalizedTag> unlocalized;
+        std::map<std::string, ProFormaTagGroup*> groups;
+        std::list<ProFormaGlobalModification> global;
+        ProFormaTerm term(sequence, tagList, none, none, none, unlocalized, groups, global);
+        tags += term.Tags().size();
+    }
+
+    KeepAlive(tags);
+    return Residues * iterations;
+}
+
+PROFORMA_BENCHMARK("build/builder", BuildWithBuilder);
+PROFORMA_BENCHMARK("build/copies", BuildWithCopies);
@@ -0,0 +1,68 @@
+#include <memory>
+
+#include "BenchmarkCorpus.h"
+#include "ProFormaBenchmark.h"
+#include "ProFormaCanonicalizer.h"
+#include "ProFormaParser.h"
+#include "ProFormaWriter.h"
+
+using namespace ProForma;
+using namespace ProForma::Benchmark;
+
+// Streaming hash of the canonical form
+static size_t HashTerm(const ProFormaTerm& term, size_t iterations)
+{
+    const ProFormaCanonicalizer& canonicalizer = ProFormaCanonicalizer::Default();
+    uint64_t hash = 0;
+
+    for (size_t i = 0; i < iterations; i++)
+        hash ^= canonicalizer.Hash(term);
+
+    KeepAlive(hash);
+    return term.Sequence().length() * iterations;
+}
+
+// Equality of two separately parsed copies, the worst case of a hash table lookup
+static size_t CompareTerms(const ProFormaTerm& left, const ProFormaTerm& right, size_t iterations)
+{
+    size_t equal = 0;
+
+    for (size_t i = 0; i < iterations; i++)
+        equal += left == right;
+
+    KeepAlive(equal);
+    return left.Sequence().length() * iterations;
+}
+
+// The key built the obvious way, canonical term written as a string
+static size_t StringKey(const ProFormaTerm& term, size_t iterations)
+{
+    const ProFormaCanonicalizer& canonicalizer = ProFormaCanonicalizer::Default();
+    size_t length = 0;
+
+    for (size_t i = 0; i < iterations; i++)
+        length += ProFormaWriter::TermToString(canonicalizer.Canonicalize(term)).length();
+
+    KeepAlive(length);
+    return term.Sequence().length() * iterations;
+}
+
+static int RegisterCanonical()
+{
+    for (auto& item : Corpus())
+    {
+        auto term = std::make_shared<ProFormaTerm>(ProFormaQuietParser().ParseString(item.second));
+        auto copy = std::make_shared<ProFormaTerm>(ProFormaQuietParser().ParseString(item.second));
+
+        BenchmarkRegistration("canonical/hash/" + item.first,
+            [term](size_t iterations) { return HashTerm(*term, iterations); });
+        BenchmarkRegistration("canonical/equal/" + item.first,
+            [term, copy](size_t iterations) { return CompareTerms(*term, *copy, iterations); });
+        BenchmarkRegistration("canonical/string-key/" + item.first,
+            [term](size_t iterations) { return StringKey(*term, iterations); });
+    }
+
+    return 0;
+}
+
+static int _canonical = RegisterCanonical();
@@ -0,0 +1,100 @@
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#include "BenchmarkCorpus.h"
+#include "ProFormaBenchmark.h"
+#include "ProFormaColumnarReader.h"
+#include "ProFormaColumnarWriter.h"
+#include "ProFormaParser.h"
+
+using namespace ProForma;
+using namespace ProForma::Benchmark;
+
+// The corpus repeated, as a result set with many terms sharing sequences and modifications
+static std::vector<ProFormaTerm> ResultSet()
+{
+    ProFormaQuietParser parser;
+    std::vector<ProFormaTerm> terms;
+
+    for (int i = 0; i < 200; i++)
+        for (auto& item : Corpus())
+            terms.push_back(parser.ParseString(item.second));
+
+    return terms;
+}
+
+static size_t WriteColumnar(const std::vector<ProFormaTerm>& terms, size_t iterations)
+{
+    size_t bytes = 0;
+
+    for (size_t i = 0; i < iterations; i++)
+    {
+        std::ostringstream stream;
+        ProFormaColumnarWriter writer(stream, 1024);
+        writer.Write(terms);
+        writer.Close();
+        bytes += stream.str().length();
+    }
+
+    return bytes;
+}
+
+// Decodes every row group into terms
+static size_t ReadColumnar(const std::string& archive, size_t iterations)
+{
+    size_t terms = 0;
+
+    for (size_t i = 0; i < iterations; i++)
+    {
+        std::istringstream stream(archive);
+        ProFormaColumnarReader reader(stream);
+        std::vector<ProFormaTerm> decoded;
+        for (size_t j = 0; j < reader.RowGroups().size(); j++)
+            reader.ReadRowGroup(j, decoded);
+        terms += decoded.size();
+    }
+
+    KeepAlive(terms);
+    return archive.length() * iterations;
+}
+
+// Finds the Phospho sites, only the symbol and tag columns are read
+static size_t ScanColumnar(const std::string& archive, size_t iterations)
+{
+    size_t sites = 0, bytes = 0;
+
+    for (size_t i = 0; i < iterations; i++)
+    {
+        std::istringstream stream(archive);
+        ProFormaColumnarReader reader(stream);
+        for (size_t j = 0; j < reader.RowGroups().size(); j++)
+            reader.ReadTags(j, [&sites](uint64_t, const ProFormaTag& tag)
+            {
+                for (auto& descriptor : tag.Descriptors())
+                    sites += descriptor.Value() == "Phospho";
+            });
+        bytes += reader.BytesRead();
+    }
+
+    KeepAlive(sites);
+    return bytes;
+}
+
+static int RegisterColumnar()
+{
+    auto terms = std::make_shared<std::vector<ProFormaTerm>>(ResultSet());
+
+    std::ostringstream stream;
+    ProFormaColumnarWriter writer(stream, 1024);
+    writer.Write(*terms);
+    writer.Close();
+    auto archive = std::make_shared<std::string>(stream.str());
+
+    BenchmarkRegistration("columnar/write/corpus", [terms](size_t iterations) { return WriteColumnar(*terms, iterations); });
+    BenchmarkRegistration("columnar/read/corpus", [archive](size_t iterations) { return ReadColumnar(*archive, iterations); });
+    BenchmarkRegistration("columnar/scan-tags/corpus", [archive](size_t iterations) { return ScanColumnar(*archive, iterations); });
+    return 0;
+}
+
+static int _columnar = RegisterColumnar();
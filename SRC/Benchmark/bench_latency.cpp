@@ -0,0 +1,72 @@
+#include <memory>
+
+#include "BenchmarkCorpus.h"
+#include "ProFormaBenchmark.h"
+#include "ProFormaLatencyHistogram.h"
+#include "ProFormaParser.h"
+#include "ProFormaWriter.h"
+
+using namespace ProForma;
+using namespace ProForma::Benchmark;
+
+// Cost of adding a duration to a shared histogram
+static size_t RecordLatency(size_t iterations)
+{
+    for (size_t i = 0; i < iterations; i++)
+        ProFormaLatency::Record(ProFormaOperation::WriteJson, 32, 200 + (i & 1023));
+
+    ProFormaLatency::Reset();
+    return iterations * sizeof(uint64_t);
+}
+
+// Writer entry point with the recording on, compare with write/json/<name>
+static size_t AppendJsonTimed(const ProFormaTerm& term, size_t iterations)
+{
+    std::string buffer;
+    size_t length = 0;
+
+    ProFormaLatency::SetEnabled(true);
+    for (size_t i = 0; i < iterations; i++)
+    {
+        buffer.clear();
+        ProFormaWriter::AppendJsonTo(buffer, term);
+        length += buffer.length();
+    }
+    ProFormaLatency::SetEnabled(false);
+    ProFormaLatency::Reset();
+
+    KeepAlive(length);
+    return length;
+}
+
+// Quantile lookup on a histogram holding a million values
+static size_t Quantile(size_t iterations)
+{
+    ProFormaLatencyHistogram histogram;
+    for (uint64_t value = 1; value <= 1000000; value++)
+        histogram.Record(value * 37 % 1000003);
+
+    uint64_t sum = 0;
+    for (size_t i = 0; i < iterations; i++)
+        sum += histogram.ValueAtQuantile(0.99);
+
+    KeepAlive(static_cast<size_t>(sum));
+    return iterations * sizeof(ProFormaLatencyHistogram);
+}
+
+static int RegisterLatency()
+{
+    BenchmarkRegistration("latency/record", RecordLatency);
+    BenchmarkRegistration("latency/quantile", Quantile);
+
+    for (auto& item : Corpus())
+    {
+        auto term = std::make_shared<ProFormaTerm>(ProFormaQuietParser().ParseString(item.second));
+        BenchmarkRegistration("latency/write-json/" + item.first,
+            [term](size_t iterations) { return AppendJsonTimed(*term, iterations); });
+    }
+
+    return 0;
+}
+
+static int _latency = RegisterLatency();
@@ -0,0 +1,87 @@
+#include <cstdio>
+#include <ctime>
+#include <ostream>
+#include <streambuf>
+#include <string>
+
+#include "ProFormaBenchmark.h"
+#include "ProFormaLogger.h"
+
+using namespace ProForma;
+using namespace ProForma::Benchmark;
+
+#ifdef WIN32
+static const char* NullDevice = "NUL";
+#else
+static const char* NullDevice = "/dev/null";
+#endif
+
+// Cost of a Log call on the logging thread, the records the background thread cannot drain in time are dropped
+static size_t LogBurst(size_t iterations)
+{
+    ProFormaLogger* logger = ProFormaLogger::GetLogger();
+    logger->Open(NullDevice);
+    std::string tag = "Phospho";
+
+    for (size_t i = 0; i < iterations; i++)
+        logger->Log("Processing tag: %s at %d", tag.c_str(), static_cast<int>(i));
+
+    logger->Flush();
+    return tag.length() * iterations;
+}
+
+// Waits for the background thread every 256 messages, so every message is formatted and written
+static size_t LogFlushed(size_t iterations)
+{
+    ProFormaLogger* logger = ProFormaLogger::GetLogger();
+    logger->Open(NullDevice);
+    std::string tag = "Phospho";
+
+    for (size_t i = 0; i < iterations; i++)
+    {
+        logger->Log("Processing tag: %s at %d", tag.c_str(), static_cast<int>(i));
+        if (i % 256 == 255)
+            logger->Flush();
+    }
+
+    logger->Flush();
+    return tag.length() * iterations;
+}
+
+// Discards the output
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+};
+
+// What the synchronous logger did on the calling thread: format, date and time, stream write
+static size_t LogSynchronous(size_t iterations)
+{
+    NullBuffer buffer;
+    std::ostream sink(&buffer);
+    std::string tag = "Phospho";
+
+    for (size_t i = 0; i < iterations; i++)
+    {
+        char message[256];
+        snprintf(message, sizeof(message), "Processing tag: %s at %d", tag.c_str(), static_cast<int>(i));
+
+        time_t now = time(NULL);
+        struct tm tstruct;
+        char stamp[80];
+#ifdef WIN32
+        localtime_s(&tstruct, &now);
+#else
+        localtime_r(&now, &tstruct);
+#endif
+        strftime(stamp, sizeof(stamp), "%Y-%m-%d.%X", &tstruct);
+        sink << stamp << ":\t" << message << "\n";
+    }
+
+    return tag.length() * iterations;
+}
+
+PROFORMA_BENCHMARK("log/async/burst", LogBurst);
+PROFORMA_BENCHMARK("log/async/flushed", LogFlushed);
+PROFORMA_BENCHMARK("log/sync-reference", LogSynchronous);
@@ -0,0 +1,98 @@
+#include "BenchmarkCorpus.h"
+#include "ProFormaBenchmark.h"
+#include "ProFormaParser.h"
+
+using namespace ProForma;
+using namespace ProForma::Benchmark;
+
+// Parses the same input with a policy specialized parser
+template <typename Parser>
+static size_t ParseRepeatedly(const std::string& input, size_t iterations)
+{
+    Parser parser;
+    size_t residues = 0;
+
+    for (size_t i = 0; i < iterations; i++)
+        residues += parser.ParseString(input).Sequence().length();
+
+    KeepAlive(residues);
+    return input.length() * iterations;
+}
+
+// Registers one benchmark per corpus entry for the given parser
+template <typename Parser>
+static int RegisterParser(const std::string& parserName, bool peptideOnly)
+{
+    for (auto& item : Corpus())
+    {
+        // The reduced grammar only understands localized and terminal modifications
+        if (peptideOnly && item.first != "plain" && item.first != "modified" && item.first != "long")
+            continue;
+
+        std::string input = item.second;
+        BenchmarkRegistration("parse/" + parserName + "/" + item.first,
+            [input](size_t iterations) { return ParseRepeatedly<Parser>(input, iterations); });
+    }
+
+    return 0;
+}
+
+// The default parser logs every step to the console, it is left out so it does not flood the results
+static int _quiet = RegisterParser<ProFormaQuietParser>("quiet", false);
+static int _lenient = RegisterParser<ProFormaLenientParser>("lenient", false);
+static int _peptide = RegisterParser<ProFormaPeptideParser>("peptide", true);
+
+// Descriptor parsing by kind, one tag in a short peptide so the descriptor dominates
+static size_t ParseDescriptors(const std::string& input, size_t iterations)
+{
+    ProFormaQuietParser parser;
+    size_t tags = 0;
+
+    for (size_t i = 0; i < iterations; i++)
+        tags += parser.ParseString(input).Tags().size();
+
+    KeepAlive(tags);
+    return input.length() * iterations;
+}
+
+// Chains joined by a crosslink or as a chimeric spectrum
+static size_t ParseMulti(const std::string& input, size_t iterations)
+{
+    ProFormaQuietParser parser;
+    size_t chains = 0;
+
+    for (size_t i = 0; i < iterations; i++)
+        chains += parser.ParseMultiString(input).ChainCount();
+
+    KeepAlive(chains);
+    return input.length() * iterations;
+}
+
+static int RegisterDescriptors()
+{
+    static const std::pair<const char*, const char*> descriptors[] = {
+        { "name",      "PEPT[Phospho]IDE" },
+        { "mass",      "PEPT[+79.966331]IDE" },
+        { "accession", "PEPT[UNIMOD:21]IDE" },
+        { "prefixed",  "PEPT[U:Phospho]IDE" },
+        { "formula",   "PEPT[Formula:HPO3]IDE" },
+        { "weighted",  "PEPT[Phospho#g1(0.75)]IDE" },
+        { "several",   "PEPT[Phospho|U:21|+79.966331|Formula:HPO3|Info:site]IDE" },
+    };
+
+    for (auto& item : descriptors)
+    {
+        std::string input = item.second;
+        BenchmarkRegistration(std::string("parse/descriptor/") + item.first,
+            [input](size_t iterations) { return ParseDescriptors(input, iterations); });
+    }
+
+    BenchmarkRegistration("parse/multi/crosslinked",
+        [](size_t iterations) { return ParseMulti("SEK[XLMOD:02001#XL1]UENCE//EMEVTK[#XL1]SESPEK", iterations); });
+    BenchmarkRegistration("parse/multi/chimeric",
+        [](size_t iterations) { return ParseMulti("EMEVTK[Phospho]SESPEK+ELVISLIVER", iterations); });
+
+    return 0;
+}
+
+static int _descriptors = RegisterDescriptors();
@@ -0,0 +1,70 @@
+#include <memory>
+
+#include "BenchmarkCorpus.h"
+#include "ProFormaBenchmark.h"
+#include "ProFormaJsonReader.h"
+#include "ProFormaParser.h"
+#include "ProFormaWriter.h"
+
+using namespace ProForma;
+using namespace ProForma::Benchmark;
+
+// Reads the same JSON term, ns/op compares directly with read/proforma on the same corpus entry
+static size_t ReadJson(const std::string& json, size_t iterations)
+{
+    size_t residues = 0;
+
+    for (size_t i = 0; i < iterations; i++)
+        residues += ProFormaJsonReader::ReadTerm(json).Sequence().length();
+
+    KeepAlive(residues);
+    return json.length() * iterations;
+}
+
+// Parses the ProForma string the JSON was written from
+static size_t ReadProForma(const std::string& input, size_t iterations)
+{
+    ProFormaQuietParser parser;
+    size_t residues = 0;
+
+    for (size_t i = 0; i < iterations; i++)
+        residues += parser.ParseString(input).Sequence().length();
+
+    KeepAlive(residues);
+    return input.length() * iterations;
+}
+
+// Reads the whole corpus as JSON Lines
+static size_t ReadJsonLines(const std::string& lines, size_t iterations)
+{
+    size_t terms = 0;
+
+    for (size_t i = 0; i < iterations; i++)
+        terms += ProFormaJsonReader::ReadJsonLines(lines, [](ProFormaTerm&& term) { KeepAlive(term.Sequence().length()); });
+
+    KeepAlive(terms);
+    return lines.length() * iterations;
+}
+
+static int RegisterReader()
+{
+    auto lines = std::make_shared<std::string>();
+
+    for (auto& item : Corpus())
+    {
+        std::string input = item.second;
+        std::string json = ProFormaWriter::TermToJson(ProFormaQuietParser().ParseString(input));
+
+        BenchmarkRegistration("read/json/" + item.first,
+            [json](size_t iterations) { return ReadJson(json, iterations); });
+        BenchmarkRegistration("read/proforma/" + item.first,
+            [input](size_t iterations) { return ReadProForma(input, iterations); });
+
+        *lines += json + "\n";
+    }
+
+    BenchmarkRegistration("read/jsonl/corpus", [lines](size_t iterations) { return ReadJsonLines(*lines, iterations); });
+    return 0;
+}
+
+static int _reader = RegisterReader();
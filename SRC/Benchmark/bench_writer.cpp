@@ -0,0 +1,144 @@
+#include <memory>
+#include <ostream>
+#include <streambuf>
+#include <vector>
+
+#include "nlohmann/json.hpp"
+
+#include "BenchmarkCorpus.h"
+#include "ProFormaBenchmark.h"
+#include "ProFormaParser.h"
+#include "ProFormaWriter.h"
+
+using namespace ProForma;
+using namespace ProForma::Benchmark;
+
+// Writes the same term into a new string every time
+static size_t WriteToString(const ProFormaTerm& term, size_t iterations)
+{
+    size_t length = 0;
+
+    for (size_t i = 0; i < iterations; i++)
+        length += ProFormaWriter::TermToString(term).length();
+
+    KeepAlive(length);
+    return length;
+}
+
+// Writes the same term into a buffer reused across iterations
+static size_t AppendToBuffer(const ProFormaTerm& term, size_t iterations)
+{
+    std::string buffer;
+    size_t length = 0;
+
+    for (size_t i = 0; i < iterations; i++)
+    {
+        buffer.clear();
+        ProFormaWriter::AppendTo(buffer, term);
+        length += buffer.length();
+    }
+
+    KeepAlive(length);
+    return length;
+}
+
+// Writes the same term as JSON into a buffer reused across iterations
+static size_t AppendJsonToBuffer(const ProFormaTerm& term, ProFormaJsonFormat format, size_t iterations)
+{
+    std::string buffer;
+    size_t length = 0;
+
+    for (size_t i = 0; i < iterations; i++)
+    {
+        buffer.clear();
+        ProFormaWriter::AppendJsonTo(buffer, term, format);
+        length += buffer.length();
+    }
+
+    KeepAlive(length);
+    return length;
+}
+
+// Encodes the same term as CBOR or MessagePack into a buffer reused across iterations
+template <void (*Append)(std::vector<uint8_t>&, const ProFormaTerm&, ProFormaJsonFormat)>
+static size_t AppendBinaryToBuffer(const ProFormaTerm& term, size_t iterations)
+{
+    std::vector<uint8_t> buffer;
+    size_t length = 0;
+
+    for (size_t i = 0; i < iterations; i++)
+    {
+        buffer.clear();
+        Append(buffer, term, ProFormaJsonFormat::Standard);
+        length += buffer.size();
+    }
+
+    KeepAlive(length);
+    return length;
+}
+
+// The route the direct encoders replace: JSON text, nlohmann DOM, then to_cbor
+static size_t CborThroughDom(const ProFormaTerm& term, size_t iterations)
+{
+    size_t length = 0;
+
+    for (size_t i = 0; i < iterations; i++)
+        length += nlohmann::ordered_json::to_cbor(nlohmann::ordered_json::parse(ProFormaWriter::TermToJson(term))).size();
+
+    KeepAlive(length);
+    return length;
+}
+
+// Discards the output, so the batch benchmarks measure serialization and hand-over only
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+};
+
+// Batch export of the corpus repeated, ns/op is per batch
+static size_t WriteJsonLinesBatch(const std::vector<ProFormaTerm>& terms, unsigned threads, size_t iterations)
+{
+    NullBuffer buffer;
+    std::ostream sink(&buffer);
+    size_t bytes = 0;
+
+    for (size_t i = 0; i < iterations; i++)
+        bytes += ProFormaWriter::WriteJsonLines(terms, sink, threads);
+
+    return bytes;
+}
+
+static int RegisterWriter()
+{
+    auto batch = std::make_shared<std::vector<ProFormaTerm>>();
+    for (auto& item : Corpus())
+    {
+        auto term = std::make_shared<ProFormaTerm>(ProFormaQuietParser().ParseString(item.second));
+        for (int i = 0; i < 500; i++)
+            batch->push_back(*term);
+
+        BenchmarkRegistration("write/string/" + item.first,
+            [term](size_t iterations) { return WriteToString(*term, iterations); });
+        BenchmarkRegistration("write/append/" + item.first,
+            [term](size_t iterations) { return AppendToBuffer(*term, iterations); });
+        BenchmarkRegistration("write/json/" + item.first,
+            [term](size_t iterations) { return AppendJsonToBuffer(*term, ProFormaJsonFormat::Standard, iterations); });
+        BenchmarkRegistration("write/json-compact/" + item.first,
+            [term](size_t iterations) { return AppendJsonToBuffer(*term, ProFormaJsonFormat::Compact, iterations); });
+        BenchmarkRegistration("write/cbor/" + item.first,
+            [term](size_t iterations) { return AppendBinaryToBuffer<ProFormaWriter::AppendCborTo>(*term, iterations); });
+        BenchmarkRegistration("write/msgpack/" + item.first,
+            [term](size_t iterations) { return AppendBinaryToBuffer<ProFormaWriter::AppendMsgPackTo>(*term, iterations); });
+        BenchmarkRegistration("write/cbor-dom/" + item.first,
+            [term](size_t iterations) { return CborThroughDom(*term, iterations); });
+    }
+
+    for (unsigned threads : { 1u, 2u, 4u, 8u })
+        BenchmarkRegistration("write/jsonl/threads-" + std::to_string(threads),
+            [batch, threads](size_t iterations) { return WriteJsonLinesBatch(*batch, threads, iterations); });
+
+    return 0;
+}
+
+static int _writer = RegisterWriter();
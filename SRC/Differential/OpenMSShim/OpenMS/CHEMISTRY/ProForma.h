@@ -0,0 +1,4 @@
+#pragma once
+
+// ProForma2.cpp at the repository root includes its own header under the OpenMS path
+#include "ProForma2.h"
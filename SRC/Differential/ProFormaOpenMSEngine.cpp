@@ -0,0 +1,88 @@
+#include "ProFormaOpenMSEngine.h"
+
+#include <iostream>
+#include <streambuf>
+
+#include <OpenMS/CHEMISTRY/ProForma.h>
+
+using namespace ProForma;
+
+namespace {
+    class NullBuffer : public std::streambuf {
+    protected:
+        int overflow(int c) override { return traits_type::not_eof(c); }
+        std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+    };
+
+    class QuietScope {
+    public:
+        QuietScope() : _previous(std::cout.rdbuf(&Buffer())) {}
+        ~QuietScope() { std::cout.rdbuf(_previous); }
+
+    private:
+        static NullBuffer& Buffer()
+        {
+            static thread_local NullBuffer buffer;
+            return buffer;
+        }
+
+        std::streambuf* _previous;
+    };
+}
+
+/*****************************************************************************/
+// PUBLIC
+/*****************************************************************************/
+
+bool ProFormaOpenMSEngine::StandIn()
+{
+#if defined(PROFORMA_OPENMS_STAND_IN)
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool ProFormaOpenMSEngine::Parse(const std::string& input, std::string& error)
+{
+    QuietScope quiet;
+
+    try
+    {
+        OpenMS::ProForma proForma{ OpenMS::AASequence() };
+        proForma.fromProFormaString(input);
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        error = e.what();
+        return false;
+    }
+}
+
+bool ProFormaOpenMSEngine::View(const std::string& input, ProFormaSiteView& view, std::string& error)
+{
+    QuietScope quiet;
+    std::string text;
+
+    try
+    {
+        OpenMS::ProForma first{ OpenMS::AASequence() };
+        OpenMS::ProForma second{ first.fromProFormaString(input) };
+        second.fromProFormaString(input);
+        text = second.toProFormaString();
+    }
+    catch (const std::exception& e)
+    {
+        error = e.what();
+        return false;
+    }
+
+    if (!ProFormaSiteView::FromOpenMSString(text, view))
+    {
+        error = "unreadable toProFormaString output " + text;
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+
+#include "ProFormaSiteView.h"
+
+namespace ProForma {
+	/**
+	 * \class ProFormaOpenMSEngine
+	 *
+	 * \brief Runs OpenMS::ProForma from ProForma2.cpp at the repository root, against OpenMS when it was
+	 *        found by CMake or against the AASequence stand-in of this directory otherwise. The class logs
+	 *        every step to std::cout, which is sent to a null buffer for the duration of each call so the
+	 *        formatting is still paid but not the terminal.
+	 *
+	 */
+	class ProFormaOpenMSEngine {
+	public:
+		/** \brief  True when built against the stand-in instead of OpenMS */
+		static bool StandIn();
+
+		/** \brief  Parses a string the way a caller of the class would, with a new ProForma object
+		  * \param  input ProForma string.
+		  * \param  error Receives the exception message of a failed parse.
+		  * \return false if the class threw
+		  */
+		static bool Parse(const std::string& input, std::string& error);
+
+		/** \brief  Reads what the class understood of a string. fromProFormaString only returns the sequence,
+		  *         the modifications are read back from toProFormaString of an object built on that sequence.
+		  * \param  input ProForma string.
+		  * \param  view Receives the view.
+		  * \param  error Receives the exception message of a failed parse.
+		  * \return false if the class threw or wrote a string the view cannot read
+		  */
+		static bool View(const std::string& input, ProFormaSiteView& view, std::string& error);
+	};
+}
@@ -0,0 +1,301 @@
+#include "ProFormaSiteView.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <tuple>
+
+#include "ProFormaGlobalModification.h"
+#include "ProFormaTagGroup.h"
+
+using namespace ProForma;
+
+namespace {
+    // Same text as ProFormaWriter, so names compare with what the OpenMS class keeps from the input
+    std::string DescriptorText(const IProFormaDescriptor& descriptor)
+    {
+        std::string text;
+
+        switch (descriptor.Key())
+        {
+        case ProFormaKey::Formula:  text = "Formula:"; break;
+        case ProFormaKey::Glycan:   text = "Glycan:"; break;
+        case ProFormaKey::Info:     text = "Info:"; break;
+        case ProFormaKey::Name:
+        case ProFormaKey::Mass:
+            switch (descriptor.EvidenceType())
+            {
+            case ProFormaEvidenceType::Observed:    text = "Obs:"; break;
+            case ProFormaEvidenceType::Unimod:      text = "U:"; break;
+            case ProFormaEvidenceType::Resid:       text = "R:"; break;
+            case ProFormaEvidenceType::PsiMod:      text = "M:"; break;
+            case ProFormaEvidenceType::XlMod:       text = "X:"; break;
+            case ProFormaEvidenceType::Gno:         text = "G:"; break;
+            case ProFormaEvidenceType::Brno:        text = "B:"; break;
+            default: break;
+            }
+            break;
+        case ProFormaKey::Identifier:
+            if (descriptor.EvidenceType() == ProFormaEvidenceType::Resid)
+                text = "RESID:";
+            break;
+        default:
+            break;
+        }
+
+        return text + descriptor.Value();
+    }
+
+    std::string DescriptorsText(const std::list<ProFormaDescriptor>& descriptors)
+    {
+        std::string text;
+        for (auto& descriptor : descriptors)
+        {
+            if (!text.empty())
+                text += '|';
+            text += DescriptorText(descriptor);
+        }
+        return text;
+    }
+
+    std::string SiteText(const ProFormaSite& site)
+    {
+        std::string text;
+        switch (site.Kind)
+        {
+        case ProFormaSiteKind::NTerminal:   text = "N-term"; break;
+        case ProFormaSiteKind::CTerminal:   text = "C-term"; break;
+        case ProFormaSiteKind::Unlocalized: text = "unlocalized"; break;
+        case ProFormaSiteKind::Labile:      text = "labile"; break;
+        case ProFormaSiteKind::Global:      text = "global"; break;
+        default:
+            text = std::to_string(site.Start);
+            if (site.End != site.Start)
+                text += "-" + std::to_string(site.End);
+            break;
+        }
+        return text + "[" + site.Name + "]";
+    }
+
+    std::string Shorten(const std::string& text)
+    {
+        return text.length() <= 60 ? text : text.substr(0, 57) + "...";
+    }
+}
+
+/*****************************************************************************/
+// PUBLIC
+/*****************************************************************************/
+
+ProFormaSiteView ProFormaSiteView::FromTerm(const ProFormaTerm& term)
+{
+    ProFormaSiteView view;
+    view.Sequence = term.Sequence();
+
+    for (auto& globalModification : term.GlobalModifications())
+    {
+        std::string name = DescriptorsText(globalModification.Descriptors());
+        if (globalModification.TargetAminoAcids().size())
+        {
+            name += '@';
+            for (char target : globalModification.TargetAminoAcids())
+                name += target;
+        }
+        view.Add(ProFormaSiteKind::Global, 0, 0, std::move(name));
+    }
+
+    for (auto& unlocalizedTag : term.UnlocalizedTags())
+        view.Add(ProFormaSiteKind::Unlocalized, 0, 0, DescriptorsText(unlocalizedTag.Descriptors()));
+
+    if (term.LabileDescriptors().size())
+        view.Add(ProFormaSiteKind::Labile, 0, 0, DescriptorsText(term.LabileDescriptors()));
+
+    if (term.NTerminalDescriptors().size())
+        view.Add(ProFormaSiteKind::NTerminal, 0, 0, DescriptorsText(term.NTerminalDescriptors()));
+
+    if (term.CTerminalDescriptors().size())
+        view.Add(ProFormaSiteKind::CTerminal, view.Sequence.length() + 1, view.Sequence.length() + 1, DescriptorsText(term.CTerminalDescriptors()));
+
+    for (auto& tag : term.Tags())
+        view.Add(ProFormaSiteKind::Residue, tag.ZeroBasedStartIndex() + 1, tag.ZeroBasedEndIndex() + 1, DescriptorsText(tag.Descriptors()));
+
+    for (auto& group : term.TagGroups())
+    {
+        std::string name = DescriptorText(*group.second);
+        for (auto& member : group.second->Members())
+            view.Add(ProFormaSiteKind::Residue, member.ZeroBasedStartIndex() + 1, member.ZeroBasedEndIndex() + 1, name);
+    }
+
+    view.Sort();
+    return view;
+}
+
+bool ProFormaSiteView::FromOpenMSString(const std::string& text, ProFormaSiteView& view)
+{
+    view = ProFormaSiteView();
+    size_t pos = 0;
+    size_t rangeStart = 0;
+    bool inRange = false;
+
+    // The class writes an N-terminal tag as "[name]-" and a C-terminal one as "-[name]"
+    if (text.compare(0, 1, "[") == 0)
+    {
+        size_t end = text.find("]-");
+        if (end == std::string::npos)
+            return false;
+        view.Add(ProFormaSiteKind::NTerminal, 0, 0, text.substr(1, end - 1));
+        pos = end + 2;
+    }
+
+    while (pos < text.length())
+    {
+        char current = text[pos];
+
+        if (std::isupper(static_cast<unsigned char>(current)))
+        {
+            view.Sequence += current;
+            pos++;
+        }
+        else if (current == '(' && !inRange)
+        {
+            rangeStart = view.Sequence.length() + 1;
+            inRange = true;
+            pos++;
+        }
+        else if (current == ')' && inRange)
+        {
+            inRange = false;
+            pos++;
+
+            // A range without a name is closed without a tag
+            if (pos < text.length() && text[pos] == '[')
+            {
+                size_t end = text.find(']', pos);
+                if (end == std::string::npos)
+                    return false;
+                view.Add(ProFormaSiteKind::Residue, rangeStart, view.Sequence.length(), text.substr(pos + 1, end - pos - 1));
+                pos = end + 1;
+            }
+        }
+        else if (current == '[' && !view.Sequence.empty())
+        {
+            size_t end = text.find(']', pos);
+            if (end == std::string::npos)
+                return false;
+            view.Add(ProFormaSiteKind::Residue, view.Sequence.length(), view.Sequence.length(), text.substr(pos + 1, end - pos - 1));
+            pos = end + 1;
+
+            // Ambiguous start, not a position of its own
+            if (pos < text.length() && text[pos] == '?')
+                pos++;
+        }
+        else if (current == '-' && text.compare(pos, 2, "-[") == 0 && text.back() == ']')
+        {
+            view.Add(ProFormaSiteKind::CTerminal, view.Sequence.length() + 1, view.Sequence.length() + 1, text.substr(pos + 2, text.length() - pos - 3));
+            pos = text.length();
+        }
+        else
+            return false;
+    }
+
+    view.Sort();
+    return !inRange;
+}
+
+ProFormaDisagreement ProFormaSiteView::Compare(const ProFormaSiteView& expected, const ProFormaSiteView& actual, double massTolerance, std::string& detail)
+{
+    detail.clear();
+
+    if (expected.Sequence != actual.Sequence)
+    {
+        detail = "sequence " + Shorten(expected.Sequence) + " vs " + Shorten(actual.Sequence);
+        return ProFormaDisagreement::Sequence;
+    }
+
+    size_t count = std::max(expected.Sites.size(), actual.Sites.size());
+    for (size_t i = 0; i < count; i++)
+    {
+        const ProFormaSite* a = i < expected.Sites.size() ? &expected.Sites[i] : nullptr;
+        const ProFormaSite* b = i < actual.Sites.size() ? &actual.Sites[i] : nullptr;
+
+        if (!a || !b || a->Kind != b->Kind || a->Start != b->Start || a->End != b->End)
+        {
+            detail = (a ? SiteText(*a) : std::string("nothing")) + " vs " + (b ? SiteText(*b) : std::string("nothing"));
+            return ProFormaDisagreement::Positions;
+        }
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        auto& a = expected.Sites[i];
+        auto& b = actual.Sites[i];
+
+        if (a.HasMass != b.HasMass || (!a.HasMass && a.Name != b.Name))
+        {
+            detail = SiteText(a) + " vs " + SiteText(b);
+            return ProFormaDisagreement::Names;
+        }
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        auto& a = expected.Sites[i];
+        auto& b = actual.Sites[i];
+
+        if (a.HasMass && std::fabs(a.Mass - b.Mass) > massTolerance)
+        {
+            detail = SiteText(a) + " vs " + SiteText(b);
+            return ProFormaDisagreement::Masses;
+        }
+    }
+
+    return ProFormaDisagreement::None;
+}
+
+const char* ProFormaSiteView::DisagreementName(ProFormaDisagreement disagreement)
+{
+    switch (disagreement)
+    {
+    case ProFormaDisagreement::Sequence:  return "sequence";
+    case ProFormaDisagreement::Positions: return "positions";
+    case ProFormaDisagreement::Names:     return "names";
+    case ProFormaDisagreement::Masses:    return "masses";
+    default:                              return "none";
+    }
+}
+
+/*****************************************************************************/
+// PRIVATE
+/*****************************************************************************/
+
+void ProFormaSiteView::Add(ProFormaSiteKind kind, size_t start, size_t end, std::string name)
+{
+    ProFormaSite site;
+    site.Kind = kind;
+    site.Start = start;
+    site.End = end;
+
+    // A signed number is a delta mass whatever the engine kept it as
+    if (!name.empty() && (name[0] == '+' || name[0] == '-'))
+    {
+        char* stop = nullptr;
+        double mass = std::strtod(name.c_str(), &stop);
+        if (stop == name.c_str() + name.length())
+        {
+            site.HasMass = true;
+            site.Mass = mass;
+        }
+    }
+
+    site.Name = std::move(name);
+    Sites.push_back(std::move(site));
+}
+
+void ProFormaSiteView::Sort()
+{
+    std::sort(Sites.begin(), Sites.end(), [](const ProFormaSite& a, const ProFormaSite& b)
+    {
+        return std::tie(a.Kind, a.Start, a.End, a.Name) < std::tie(b.Kind, b.Start, b.End, b.Name);
+    });
+}
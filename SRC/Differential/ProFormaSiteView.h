@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "ProFormaTerm.h"
+
+namespace ProForma {
+	/** @enum ProFormaSiteKind
+	 *  @brief Where a modification applies
+	 */
+	enum class ProFormaSiteKind {
+		Residue = 0,
+		NTerminal,
+		CTerminal,
+		Unlocalized,
+		Labile,
+		Global,
+	};
+
+	/**
+	 * \struct ProFormaSite
+	 *
+	 * \brief One modification, positions are one-based and inclusive like the OpenMS ProForma class.
+	 *
+	 */
+	struct ProFormaSite {
+		ProFormaSiteKind Kind = ProFormaSiteKind::Residue;
+		size_t Start = 0;
+		size_t End = 0;
+
+		/**< Descriptors as written in ProForma, joined with '|' */
+		std::string Name;
+
+		/**< Set when the name is a signed delta mass */
+		bool HasMass = false;
+		double Mass = 0.0;
+	};
+
+	/** @enum ProFormaDisagreement
+	 *  @brief First difference found between two views, in the order they are checked
+	 */
+	enum class ProFormaDisagreement {
+		None = 0,
+		Sequence,
+		Positions,
+		Names,
+		Masses,
+	};
+
+	/**
+	 * \class ProFormaSiteView
+	 *
+	 * \brief Engine neutral reading of a ProForma string: the sequence and the modification sites sorted
+	 *        by position. Both parsers of the differential harness are reduced to it before comparing.
+	 *
+	 */
+	class ProFormaSiteView {
+	public:
+		std::string Sequence;
+		std::vector<ProFormaSite> Sites;
+
+		/** \brief  View of a term of ProFormaParser, tag group members carry the value of their group */
+		static ProFormaSiteView FromTerm(const ProFormaTerm& term);
+
+		/** \brief  Reads the output of OpenMS::ProForma::toProFormaString: residues, tags, ranges and terminal tags
+		  * \param  text String written by the OpenMS class.
+		  * \param  view Receives the view.
+		  * \return false if the text is not in the subset that class writes
+		  */
+		static bool FromOpenMSString(const std::string& text, ProFormaSiteView& view);
+
+		/** \brief  Compares two views
+		  * \param  expected View taken as the reference.
+		  * \param  actual View compared with it.
+		  * \param  massTolerance Largest accepted difference of two delta masses, in Da.
+		  * \param  detail Receives a description of the first difference.
+		  * \return the kind of the first difference
+		  */
+		static ProFormaDisagreement Compare(const ProFormaSiteView& expected, const ProFormaSiteView& actual, double massTolerance, std::string& detail);
+
+		/** \brief  Name of a disagreement, for reports */
+		static const char* DisagreementName(ProFormaDisagreement disagreement);
+
+	private:
+		void Add(ProFormaSiteKind kind, size_t start, size_t end, std::string name);
+		void Sort();
+	};
+}
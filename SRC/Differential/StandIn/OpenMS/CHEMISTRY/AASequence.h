@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cctype>
+#include <string>
+#include <vector>
+
+#include <OpenMS/CHEMISTRY/ResidueDB.h>
+
+#ifndef OPENMS_DLLAPI
+#define OPENMS_DLLAPI
+#endif
+
+namespace OpenMS
+{
+	/**
+	 * \class AASequence
+	 *
+	 * \brief Stand-in of the OpenMS amino acid sequence, with the members ProForma2.cpp uses. Like the real
+	 *        one it holds residue pointers and operator+ returns a new sequence, so appending residues one
+	 *        by one costs the same copies.
+	 *
+	 */
+	class AASequence {
+	public:
+		size_t size() const { return _residues.size(); }
+
+		const Residue& getResidue(size_t index) const { return *_residues[index]; }
+
+		std::string toString() const
+		{
+			std::string text;
+			text.reserve(_residues.size());
+			for (const Residue* residue : _residues)
+				text += residue->getOneLetterCode();
+			return text;
+		}
+
+		AASequence operator+(const Residue* residue) const
+		{
+			AASequence sequence(*this);
+			sequence._residues.push_back(residue);
+			return sequence;
+		}
+
+		static AASequence fromString(const std::string& text)
+		{
+			AASequence sequence;
+			for (char c : text)
+				sequence._residues.push_back(ResidueDB::getInstance()->getResidue(std::string(1, c)));
+			return sequence;
+		}
+
+	private:
+		std::vector<const Residue*> _residues;
+	};
+}
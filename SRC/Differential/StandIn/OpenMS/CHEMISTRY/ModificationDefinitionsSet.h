@@ -0,0 +1,8 @@
+#pragma once
+
+// Only included by ProForma2.h, nothing of it is used
+namespace OpenMS
+{
+	class ModificationDefinitionsSet {
+	};
+}
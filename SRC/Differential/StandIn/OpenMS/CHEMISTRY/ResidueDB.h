@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+
+namespace OpenMS
+{
+	/**
+	 * \class Residue
+	 *
+	 * \brief Stand-in of the OpenMS residue, only the one letter code.
+	 *
+	 */
+	class Residue {
+	public:
+		explicit Residue(char code = 'X') : _code(1, code) {}
+
+		const std::string& getOneLetterCode() const { return _code; }
+
+	private:
+		std::string _code;
+	};
+
+	/**
+	 * \class ResidueDB
+	 *
+	 * \brief Stand-in of the OpenMS residue database. Knows the 26 upper case one letter codes, like the
+	 *        real one with its ambiguous and non-standard residues, and throws for anything else.
+	 *
+	 */
+	class ResidueDB {
+	public:
+		static ResidueDB* getInstance()
+		{
+			static ResidueDB instance;
+			return &instance;
+		}
+
+		const Residue* getResidue(const std::string& name) const
+		{
+			if (name.length() != 1 || name[0] < 'A' || name[0] > 'Z')
+				throw std::runtime_error("Residue not found: " + name);
+
+			return &_residues[name[0] - 'A'];
+		}
+
+	private:
+		ResidueDB()
+		{
+			for (char code = 'A'; code <= 'Z'; code++)
+				_residues[code - 'A'] = Residue(code);
+		}
+
+		Residue _residues[26];
+	};
+}
@@ -0,0 +1,303 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "ProFormaLatencyHistogram.h"
+#include "ProFormaOpenMSEngine.h"
+#include "ProFormaParseException.h"
+#include "ProFormaParser.h"
+#include "ProFormaSiteView.h"
+
+using namespace ProForma;
+
+static std::atomic<size_t> _allocations(0);
+
+// Count every heap allocation of the process, both engines are compared on the same counter
+void* operator new(size_t size)
+{
+    _allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+// Timing of one engine over the corpus
+struct EngineResult {
+    const char* Name;
+    ProFormaLatencyHistogram Latency;
+    double Seconds = 0;
+    size_t Parses = 0;
+    size_t Rejected = 0;
+    size_t Allocations = 0;
+};
+
+// Outcomes of the semantic comparison, one per corpus string
+enum Outcome {
+    Agree = 0,
+    BothReject,
+    OnlyProFormaRejects,
+    OnlyOpenMSRejects,
+    SequenceDiffers,
+    PositionsDiffer,
+    NamesDiffer,
+    MassesDiffer,
+    OutcomeCount
+};
+
+static const char* const OutcomeNames[OutcomeCount] = {
+    "agree", "both_reject", "only_proforma_rejects", "only_openms_rejects", "sequence", "positions", "names", "masses"
+};
+
+struct Example {
+    Outcome Kind;
+    std::string Input;
+    std::string Detail;
+};
+
+static void usage(const char* program)
+{
+    fprintf(stderr, "Usage: %s [--input PATH|-] [--repeat N] [--tolerance DA] [--examples N] [--json PATH]\n", program);
+    fprintf(stderr, "  --input PATH|-    corpus, one ProForma string per line, stdin by default\n");
+    fprintf(stderr, "  --repeat N        timed passes over the corpus per engine, 3 by default\n");
+    fprintf(stderr, "  --tolerance DA    largest accepted difference of two delta masses, 0.001 by default\n");
+    fprintf(stderr, "  --examples N      inputs shown per kind of disagreement, 5 by default\n");
+    fprintf(stderr, "  --json PATH       also write the results as JSON\n");
+}
+
+static std::string shorten(const std::string& text, size_t length)
+{
+    return text.length() <= length ? text : text.substr(0, length - 3) + "...";
+}
+
+static bool parseWithProForma(ProFormaQuietParser& parser, const std::string& input, ProFormaSiteView* view, std::string& error)
+{
+    try
+    {
+        if (view)
+            *view = ProFormaSiteView::FromTerm(parser.ParseString(input));
+        else
+            parser.ParseString(input);
+        return true;
+    }
+    catch (ProFormaParseException* e)
+    {
+        error = e->what();
+        delete e;
+    }
+    catch (const std::exception& e)
+    {
+        error = e.what();
+    }
+
+    return false;
+}
+
+template <typename ParseFunction>
+static void measure(EngineResult& result, const std::vector<std::string>& corpus, size_t repeat, ParseFunction parse)
+{
+    // Untimed pass over the head of the corpus for the caches and the lazily built tables
+    for (size_t i = 0; i < corpus.size() && i < 1000; i++)
+        parse(corpus[i]);
+
+    size_t allocations = _allocations.load(std::memory_order_relaxed);
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t pass = 0; pass < repeat; pass++)
+    {
+        for (auto& input : corpus)
+        {
+            auto parseStart = std::chrono::steady_clock::now();
+            bool accepted = parse(input);
+            result.Latency.Record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - parseStart).count()));
+            result.Parses++;
+            if (!accepted)
+                result.Rejected++;
+        }
+    }
+
+    result.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.Allocations = _allocations.load(std::memory_order_relaxed) - allocations;
+}
+
+static Outcome compare(ProFormaQuietParser& parser, const std::string& input, double tolerance, std::string& detail)
+{
+    ProFormaSiteView proFormaView, openMSView;
+    std::string proFormaError, openMSError;
+
+    bool proFormaAccepts = parseWithProForma(parser, input, &proFormaView, proFormaError);
+    bool openMSAccepts = ProFormaOpenMSEngine::View(input, openMSView, openMSError);
+
+    if (!proFormaAccepts && !openMSAccepts)
+    {
+        detail = "ProFormaParser: " + proFormaError + " / OpenMS: " + openMSError;
+        return BothReject;
+    }
+    if (!proFormaAccepts)
+    {
+        detail = "ProFormaParser: " + proFormaError;
+        return OnlyProFormaRejects;
+    }
+    if (!openMSAccepts)
+    {
+        detail = "OpenMS: " + openMSError;
+        return OnlyOpenMSRejects;
+    }
+
+    switch (ProFormaSiteView::Compare(proFormaView, openMSView, tolerance, detail))
+    {
+    case ProFormaDisagreement::Sequence:  return SequenceDiffers;
+    case ProFormaDisagreement::Positions: return PositionsDiffer;
+    case ProFormaDisagreement::Names:     return NamesDiffer;
+    case ProFormaDisagreement::Masses:    return MassesDiffer;
+    default:                              return Agree;
+    }
+}
+
+static bool writeJson(const std::string& path, size_t strings, size_t bytes, size_t repeat, const EngineResult* engines, size_t engineCount, const size_t* outcomes)
+{
+    FILE* file = fopen(path.c_str(), "w");
+    if (file == nullptr)
+        return false;
+
+    time_t now = time(nullptr);
+    char date[32];
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+
+    fprintf(file, "{\n  \"context\": {\"date\": \"%s\", \"strings\": %zu, \"bytes\": %zu, \"openms\": \"%s\"},\n  \"engines\": [",
+        date, strings, bytes, ProFormaOpenMSEngine::StandIn() ? "stand-in" : "library");
+    for (size_t i = 0; i < engineCount; i++)
+    {
+        const EngineResult& engine = engines[i];
+        fprintf(file, "%s\n    {\"name\": \"%s\", \"parses\": %zu, \"parses_per_second\": %.1f, \"bytes_per_second\": %.1f, \"mean_ns\": %.1f, \"p50_ns\": %llu, \"p99_ns\": %llu, \"allocs_per_parse\": %.3f, \"rejected\": %zu}",
+            i > 0 ? "," : "", engine.Name, engine.Parses, engine.Parses / engine.Seconds, bytes * repeat / engine.Seconds,
+            engine.Latency.Mean(), static_cast<unsigned long long>(engine.Latency.ValueAtQuantile(0.5)), static_cast<unsigned long long>(engine.Latency.ValueAtQuantile(0.99)),
+            engine.Allocations / static_cast<double>(engine.Parses), engine.Rejected / repeat);
+    }
+    fprintf(file, "\n  ],\n  \"outcomes\": {");
+    for (size_t i = 0; i < OutcomeCount; i++)
+        fprintf(file, "%s\"%s\": %zu", i > 0 ? ", " : "", OutcomeNames[i], outcomes[i]);
+    fprintf(file, "}\n}\n");
+
+    return fclose(file) == 0;
+}
+
+int main(int argc, char** argv) {
+    const char* inputFile = "-";
+    const char* jsonFile = nullptr;
+    size_t repeat = 3;
+    size_t examplesPerKind = 5;
+    double tolerance = 0.001;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+
+        if (strcmp(argv[i], "--input") == 0 && hasValue) {
+            inputFile = argv[++i];
+        } else if (strcmp(argv[i], "--repeat") == 0 && hasValue) {
+            repeat = std::max<size_t>(1, static_cast<size_t>(std::strtoull(argv[++i], nullptr, 10)));
+        } else if (strcmp(argv[i], "--tolerance") == 0 && hasValue) {
+            tolerance = std::atof(argv[++i]);
+        } else if (strcmp(argv[i], "--examples") == 0 && hasValue) {
+            examplesPerKind = static_cast<size_t>(std::strtoull(argv[++i], nullptr, 10));
+        } else if (strcmp(argv[i], "--json") == 0 && hasValue) {
+            jsonFile = argv[++i];
+        } else {
+            usage(argv[0]);
+            return strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0 ? 0 : 1;
+        }
+    }
+
+    std::vector<std::string> corpus;
+    size_t bytes = 0;
+    {
+        std::ifstream file;
+        if (strcmp(inputFile, "-") != 0) {
+            file.open(inputFile, std::ios::binary);
+            if (!file) {
+                std::cerr << "Cannot open " << inputFile << std::endl;
+                return 1;
+            }
+        }
+
+        std::istream& input = strcmp(inputFile, "-") == 0 ? std::cin : file;
+        std::string line;
+        while (std::getline(input, line)) {
+            if (!line.empty() && line.back() == '\r')
+                line.pop_back();
+            if (line.empty())
+                continue;
+            bytes += line.length();
+            corpus.push_back(std::move(line));
+        }
+    }
+
+    if (corpus.empty()) {
+        std::cerr << "The corpus is empty" << std::endl;
+        return 1;
+    }
+
+    ProFormaQuietParser parser;
+
+    // What each engine understood
+    size_t outcomes[OutcomeCount] = {};
+    std::vector<Example> examples;
+    std::string detail;
+
+    for (auto& input : corpus) {
+        Outcome outcome = compare(parser, input, tolerance, detail);
+        if (outcome != Agree && outcomes[outcome] < examplesPerKind)
+            examples.push_back(Example{ outcome, input, detail });
+        outcomes[outcome]++;
+    }
+
+    // How fast, on the same inputs
+    EngineResult engines[2];
+    engines[0].Name = "ProFormaParser";
+    engines[1].Name = "OpenMS::ProForma";
+
+    std::string error;
+    measure(engines[0], corpus, repeat, [&](const std::string& input) { return parseWithProForma(parser, input, nullptr, error); });
+    measure(engines[1], corpus, repeat, [&](const std::string& input) { return ProFormaOpenMSEngine::Parse(input, error); });
+
+    printf("Corpus: %zu strings, %zu bytes, OpenMS %s, %zu passes\n\n", corpus.size(), bytes,
+        ProFormaOpenMSEngine::StandIn() ? "stand-in (OpenMS not found by CMake)" : "library", repeat);
+
+    printf("%-18s %12s %9s %10s %10s %10s %13s %10s\n", "engine", "parses/s", "MB/s", "mean ns", "p50 ns", "p99 ns", "allocs/parse", "rejected");
+    for (auto& engine : engines) {
+        printf("%-18s %12.0f %9.1f %10.0f %10llu %10llu %13.1f %10zu\n", engine.Name,
+            engine.Parses / engine.Seconds, bytes * repeat / engine.Seconds / 1e6, engine.Latency.Mean(),
+            static_cast<unsigned long long>(engine.Latency.ValueAtQuantile(0.5)), static_cast<unsigned long long>(engine.Latency.ValueAtQuantile(0.99)),
+            engine.Allocations / static_cast<double>(engine.Parses), engine.Rejected / repeat);
+    }
+
+    printf("\n%-24s %10s %8s\n", "outcome", "strings", "share");
+    for (size_t i = 0; i < OutcomeCount; i++)
+        printf("%-24s %10zu %7.2f%%\n", OutcomeNames[i], outcomes[i], 100.0 * outcomes[i] / corpus.size());
+
+    if (!examples.empty()) {
+        std::stable_sort(examples.begin(), examples.end(), [](const Example& a, const Example& b) { return a.Kind < b.Kind; });
+
+        printf("\nExamples\n");
+        for (auto& example : examples)
+            printf("  [%s] %s\n      %s\n", OutcomeNames[example.Kind], shorten(example.Input, 100).c_str(), shorten(example.Detail, 160).c_str());
+    }
+
+    if (jsonFile && !writeJson(jsonFile, corpus.size(), bytes, repeat, engines, 2, outcomes)) {
+        std::cerr << "Cannot write " << jsonFile << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
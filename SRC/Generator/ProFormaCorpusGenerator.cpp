@@ -0,0 +1,316 @@
+#include "ProFormaCorpusGenerator.h"
+
+#include <cmath>
+#include <cstdio>
+
+using namespace ProForma;
+
+namespace {
+    // Amino acid frequencies of UniProtKB/Swiss-Prot, in percent
+    const struct { char Residue; double Percent; } Frequencies[] = {
+        { 'L', 9.9 }, { 'A', 8.3 }, { 'G', 7.1 }, { 'V', 6.9 }, { 'E', 6.8 }, { 'S', 6.6 }, { 'I', 5.9 },
+        { 'K', 5.8 }, { 'R', 5.5 }, { 'D', 5.5 }, { 'T', 5.3 }, { 'P', 4.7 }, { 'N', 4.1 }, { 'Q', 3.9 },
+        { 'F', 3.9 }, { 'Y', 2.9 }, { 'M', 2.4 }, { 'H', 2.3 }, { 'C', 1.4 }, { 'W', 1.1 }
+    };
+
+    const char* const Names[] = {
+        "Phospho", "Oxidation", "Acetyl", "Methyl", "Dimethyl", "Trimethyl", "Carbamidomethyl", "Deamidated",
+        "Amidated", "GlyGly", "Nitro", "Sulfo", "Formyl", "Hydroxylation", "Citrullination", "Succinyl",
+        "Crotonyl", "Myristoyl", "Palmitoyl", "Pyro-glu"
+    };
+
+    const char* const Formulas[] = {
+        "HPO3", "O", "C2H2O", "CH2", "C2H4", "C3H6", "C2H3NO", "H-1N-1O", "C4H6N2O2", "C6H10O5", "SO3", "C14H26O"
+    };
+
+    const char* const Glycans[] = {
+        "Hex", "HexNAc", "HexNAc2Hex3", "HexNAc2Hex5", "HexNAc4Hex5Fuc1", "HexNAc4Hex5NeuAc2", "Hex1HexNAc1NeuAc1"
+    };
+
+    const char* const GlobalTargets[] = { "C", "M", "K", "C,M", "S,T,Y" };
+
+    uint64_t SplitMix64(uint64_t& state)
+    {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    template <typename T, size_t N>
+    const T& Pick(const T (&items)[N], uint64_t value) { return items[value % N]; }
+}
+
+// xoshiro256**, seeded through SplitMix64
+class ProFormaCorpusGenerator::Random {
+public:
+    Random(uint64_t seed, uint64_t stream)
+    {
+        uint64_t state = seed ^ (stream * 0xD1B54A32D192ED03ull);
+        for (auto& word : _state)
+            word = SplitMix64(state);
+    }
+
+    uint64_t Next()
+    {
+        uint64_t result = Rotate(_state[1] * 5, 7) * 9;
+        uint64_t t = _state[1] << 17;
+        _state[2] ^= _state[0];
+        _state[3] ^= _state[1];
+        _state[1] ^= _state[2];
+        _state[0] ^= _state[3];
+        _state[2] ^= t;
+        _state[3] = Rotate(_state[3], 45);
+        return result;
+    }
+
+    /** Uniform in [0, 1) */
+    double Real() { return static_cast<double>(Next() >> 11) * (1.0 / 9007199254740992.0); }
+
+    /** Uniform in [0, count) */
+    size_t Below(size_t count) { return static_cast<size_t>(Next() % count); }
+
+    bool Chance(double probability) { return probability > 0.0 && Real() < probability; }
+
+private:
+    static uint64_t Rotate(uint64_t value, int bits) { return (value << bits) | (value >> (64 - bits)); }
+
+    uint64_t _state[4];
+};
+
+/*****************************************************************************/
+// PUBLIC
+/*****************************************************************************/
+
+ProFormaCorpusGenerator::ProFormaCorpusGenerator(const ProFormaCorpusOptions& options)
+    : _options(options)
+{
+    if (_options.MinLength < 1)
+        _options.MinLength = 1;
+    if (_options.MaxLength < _options.MinLength)
+        _options.MaxLength = _options.MinLength;
+    if (_options.ProteoformMaxLength < _options.ProteoformMinLength)
+        _options.ProteoformMaxLength = _options.ProteoformMinLength;
+
+    _kindWeights[0] = options.NameWeight;
+    _kindWeights[1] = options.MassWeight;
+    _kindWeights[2] = options.AccessionWeight;
+    _kindWeights[3] = options.FormulaWeight;
+    _kindWeights[4] = options.GlycanWeight;
+    _kindTotal = 0;
+    for (double weight : _kindWeights)
+        _kindTotal += weight > 0 ? weight : 0;
+
+    size_t filled = 0;
+    double cumulative = 0;
+    for (auto& frequency : Frequencies)
+    {
+        cumulative += frequency.Percent;
+        size_t end = static_cast<size_t>(cumulative / 100.0 * sizeof(_residueTable) + 0.5);
+        while (filled < end && filled < sizeof(_residueTable))
+            _residueTable[filled++] = frequency.Residue;
+    }
+    while (filled < sizeof(_residueTable))
+        _residueTable[filled++] = 'L';
+}
+
+bool ProFormaCorpusGenerator::AppendLine(std::string& out, uint64_t index) const
+{
+    Random random(_options.Seed, index);
+
+    // Prefix features in the order the grammar requires
+    if (random.Chance(_options.GlobalRate))
+    {
+        out += "<[";
+        out += random.Chance(0.5) ? "Carbamidomethyl" : Pick(Names, random.Next());
+        out += "]@";
+        out += Pick(GlobalTargets, random.Next());
+        out += '>';
+    }
+
+    if (random.Chance(_options.UnlocalizedRate))
+    {
+        out += '[';
+        AppendDescriptor(out, random, true);
+        out += ']';
+        if (random.Chance(0.3))
+            out += "^2";
+        out += '?';
+    }
+
+    if (random.Chance(_options.LabileRate))
+    {
+        out += "{Glycan:";
+        out += Pick(Glycans, random.Next());
+        out += '}';
+    }
+
+    if (random.Chance(_options.TerminalRate))
+        out += random.Chance(0.7) ? "[Acetyl]-" : "[Formyl]-";
+
+    size_t sequenceStart = out.length();
+    size_t length = DrawLength(random);
+    std::string groupName;
+    int groupMembers = 0, groupCount = 0;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        // A range of a few residues closed by its tag, never past the end of the chain
+        if (random.Chance(_options.ModificationDensity * _options.RangeRate) && i + 2 <= length)
+        {
+            size_t rangeLength = 2 + random.Below(4);
+            if (i + rangeLength > length)
+                rangeLength = length - i;
+
+            out += '(';
+            for (size_t k = 0; k < rangeLength; k++)
+                out += _residueTable[random.Below(sizeof(_residueTable))];
+            out += ')';
+            AppendTag(out, random, groupName, groupMembers, groupCount);
+            i += rangeLength - 1;
+            continue;
+        }
+
+        out += _residueTable[random.Below(sizeof(_residueTable))];
+
+        // Members left in an open group are placed first
+        if (groupMembers > 0 ? random.Chance(0.3) || i + 3 >= length : random.Chance(_options.ModificationDensity))
+            AppendTag(out, random, groupName, groupMembers, groupCount);
+    }
+
+    if (random.Chance(_options.TerminalRate))
+        out += random.Chance(0.7) ? "-[Amidated]" : "-[Methyl]";
+
+    if (random.Chance(_options.InvalidRate))
+    {
+        Corrupt(out, sequenceStart, random);
+        return false;
+    }
+
+    return true;
+}
+
+size_t ProFormaCorpusGenerator::AppendLines(std::string& out, uint64_t first, size_t count) const
+{
+    size_t invalid = 0;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (!AppendLine(out, first + i))
+            invalid++;
+        out += '\n';
+    }
+
+    return invalid;
+}
+
+/*****************************************************************************/
+// PRIVATE
+/*****************************************************************************/
+
+size_t ProFormaCorpusGenerator::DrawLength(Random& random) const
+{
+    bool proteoform = random.Chance(_options.ProteoformRate);
+    double low = static_cast<double>(proteoform ? _options.ProteoformMinLength : _options.MinLength);
+    double high = static_cast<double>(proteoform ? _options.ProteoformMaxLength : _options.MaxLength) + 1.0;
+
+    size_t length = static_cast<size_t>(std::exp(std::log(low) + random.Real() * (std::log(high) - std::log(low))));
+    return length < 1 ? 1 : length;
+}
+
+void ProFormaCorpusGenerator::AppendDescriptor(std::string& out, Random& random, bool allowInfo) const
+{
+    double draw = random.Real() * _kindTotal;
+    size_t kind = 0;
+    while (kind < 4 && (draw -= (_kindWeights[kind] > 0 ? _kindWeights[kind] : 0)) >= 0)
+        kind++;
+
+    char text[32];
+    switch (kind)
+    {
+    case 0:
+        out += Pick(Names, random.Next());
+        break;
+    case 1:
+        // Always signed, an unsigned number reads as a name
+        snprintf(text, sizeof(text), "%+.4f", (random.Chance(0.2) ? -1.0 : 1.0) * (0.01 + random.Real() * 500.0));
+        out += text;
+        break;
+    case 2:
+        switch (random.Below(3))
+        {
+        case 0: snprintf(text, sizeof(text), "UNIMOD:%u", static_cast<unsigned>(1 + random.Below(1500))); break;
+        case 1: snprintf(text, sizeof(text), "MOD:%05u", static_cast<unsigned>(1 + random.Below(2000))); break;
+        default: snprintf(text, sizeof(text), "RESID:AA%04u", static_cast<unsigned>(1 + random.Below(500))); break;
+        }
+        out += text;
+        break;
+    case 3:
+        out += "Formula:";
+        out += Pick(Formulas, random.Next());
+        break;
+    default:
+        out += "Glycan:";
+        out += Pick(Glycans, random.Next());
+        break;
+    }
+
+    if (allowInfo && random.Chance(0.02))
+        out += "|Info:synthetic";
+}
+
+void ProFormaCorpusGenerator::AppendTag(std::string& out, Random& random, std::string& groupName, int& groupMembers, int& groupCount) const
+{
+    char weight[16];
+    out += '[';
+
+    if (groupMembers > 0)
+    {
+        // Further member of the open group, without a value
+        groupMembers--;
+        out += '#';
+        out += groupName;
+    }
+    else if (random.Chance(_options.GroupRate))
+    {
+        // First member carries the value, one or two more members follow
+        groupName = "g" + std::to_string(++groupCount);
+        groupMembers = 1 + static_cast<int>(random.Below(2));
+        AppendDescriptor(out, random, false);
+        out += '#';
+        out += groupName;
+    }
+    else
+    {
+        AppendDescriptor(out, random, true);
+        out += ']';
+        return;
+    }
+
+    if (random.Chance(0.5))
+    {
+        snprintf(weight, sizeof(weight), "(%.2f)", 0.01 + random.Real() * 0.98);
+        out += weight;
+    }
+    out += ']';
+}
+
+void ProFormaCorpusGenerator::Corrupt(std::string& out, size_t sequenceStart, Random& random)
+{
+    switch (random.Below(4))
+    {
+    case 0:
+        out += '[';
+        break;
+    case 1:
+        out.insert(sequenceStart, 1, static_cast<char>('a' + random.Below(26)));
+        break;
+    case 2:
+        out.insert(sequenceStart, 1, static_cast<char>('0' + random.Below(10)));
+        break;
+    default:
+        // Followed by a residue, a parenthesis closing before a tag would pass
+        out.insert(sequenceStart, 1, ')');
+        break;
+    }
+}
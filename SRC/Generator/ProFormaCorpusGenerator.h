@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace ProForma {
+	/**
+	 * \struct ProFormaCorpusOptions
+	 *
+	 * \brief Properties of a synthetic corpus, rates are probabilities between 0 and 1.
+	 *
+	 */
+	struct ProFormaCorpusOptions {
+		/**< Seed of the corpus, the same seed gives the same lines */
+		uint64_t Seed = 1;
+
+		/**< Peptide lengths, drawn log-uniformly */
+		size_t MinLength = 7;
+		size_t MaxLength = 40;
+
+		/**< Share of intact proteoforms and their lengths, drawn log-uniformly */
+		double ProteoformRate = 0.001;
+		size_t ProteoformMinLength = 100;
+		size_t ProteoformMaxLength = 2000;
+
+		/**< Probability of a tag after a residue */
+		double ModificationDensity = 0.05;
+
+		/**< Relative weights of the descriptor kinds */
+		double NameWeight = 40;
+		double MassWeight = 25;
+		double AccessionWeight = 20;
+		double FormulaWeight = 10;
+		double GlycanWeight = 5;
+
+		/**< Probability of a tag being spread over a tag group, or placed on a range */
+		double GroupRate = 0.05;
+		double RangeRate = 0.02;
+
+		/**< Probability of a line carrying each feature */
+		double GlobalRate = 0.02;
+		double LabileRate = 0.02;
+		double UnlocalizedRate = 0.02;
+		double TerminalRate = 0.05;
+
+		/**< Probability of a line being made invalid */
+		double InvalidRate = 0.0;
+	};
+
+	/**
+	 * \class ProFormaCorpusGenerator
+	 *
+	 * \brief Generates ProForma strings for benchmarks and stress tests. Every line is drawn from its own
+	 *        random stream, seeded from the corpus seed and the line number, so a corpus is identical
+	 *        whatever the number of threads producing it and any range of lines can be generated alone.
+	 *
+	 *        Residues follow the amino acid frequencies of UniProtKB. Invalid lines carry one defect that
+	 *        the parser rejects: an unclosed bracket, a lower case letter or a digit in the sequence, or a
+	 *        parenthesis closing no range.
+	 *
+	 */
+	class ProFormaCorpusGenerator {
+	public:
+		/** \brief  Object constructor
+		  * \param  options Properties of the corpus.
+		  * \return void
+		  */
+		explicit ProFormaCorpusGenerator(const ProFormaCorpusOptions& options);
+
+		/** \brief  Appends one line without the line break
+		  * \param  out String receiving the line.
+		  * \param  index Line number in the corpus.
+		  * \return false if the line was made invalid
+		  */
+		bool AppendLine(std::string& out, uint64_t index) const;
+
+		/** \brief  Appends consecutive lines, each followed by a line break
+		  * \param  out String receiving the lines.
+		  * \param  first Number of the first line.
+		  * \param  count Number of lines.
+		  * \return the number of invalid lines
+		  */
+		size_t AppendLines(std::string& out, uint64_t first, size_t count) const;
+
+		/** \brief  Options of the generator */
+		const ProFormaCorpusOptions& Options() const { return _options; }
+
+	private:
+		class Random;
+
+		size_t DrawLength(Random& random) const;
+		void AppendDescriptor(std::string& out, Random& random, bool allowInfo) const;
+		void AppendTag(std::string& out, Random& random, std::string& groupName, int& groupMembers, int& groupCount) const;
+		static void Corrupt(std::string& out, size_t sequenceStart, Random& random);
+
+		ProFormaCorpusOptions _options;
+		double _kindWeights[5];
+		double _kindTotal;
+
+		// Residues drawn by indexing a table filled in proportion to their frequency
+		char _residueTable[1000];
+	};
+}
@@ -0,0 +1,206 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ProFormaCorpusGenerator.h"
+
+using namespace ProForma;
+
+static void usage(const char* program) {
+    std::cerr << "Usage: " << program << " [--lines N] [--seed N] [--threads N] [--output PATH|-] [options]" << std::endl
+              << "  --lines N                lines to generate, 1000 by default" << std::endl
+              << "  --seed N                 seed of the corpus, 1 by default" << std::endl
+              << "  --threads N              generating threads, the hardware concurrency by default" << std::endl
+              << "  --output PATH|-          file receiving the corpus, stdout by default" << std::endl
+              << "  --length MIN:MAX         peptide lengths, 7:40 by default" << std::endl
+              << "  --proteoform-rate P      share of intact proteoforms, 0.001 by default" << std::endl
+              << "  --proteoform-length MIN:MAX  proteoform lengths, 100:2000 by default" << std::endl
+              << "  --mod-density P          probability of a tag after a residue, 0.05 by default" << std::endl
+              << "  --descriptors N:M:A:F:G  weights of names, masses, accessions, formulas and glycans, 40:25:20:10:5 by default" << std::endl
+              << "  --group-rate P           probability of a tag starting a tag group, 0.05 by default" << std::endl
+              << "  --range-rate P           probability of a tag being placed on a range, 0.02 by default" << std::endl
+              << "  --global-rate P          probability of a global modification, 0.02 by default" << std::endl
+              << "  --labile-rate P          probability of a labile modification, 0.02 by default" << std::endl
+              << "  --unlocalized-rate P     probability of an unlocalized modification, 0.02 by default" << std::endl
+              << "  --terminal-rate P        probability of each terminal modification, 0.05 by default" << std::endl
+              << "  --invalid-rate P         probability of a line being made invalid, 0 by default" << std::endl;
+}
+
+static bool parseRange(const char* text, size_t& low, size_t& high) {
+    char* end = nullptr;
+    low = static_cast<size_t>(std::strtoull(text, &end, 10));
+    if (*end != ':')
+        return false;
+    high = static_cast<size_t>(std::strtoull(end + 1, &end, 10));
+    return *end == '\0' && low > 0 && high >= low;
+}
+
+static bool parseWeights(const char* text, ProFormaCorpusOptions& options) {
+    double* weights[] = { &options.NameWeight, &options.MassWeight, &options.AccessionWeight, &options.FormulaWeight, &options.GlycanWeight };
+    char* end = const_cast<char*>(text);
+
+    for (size_t i = 0; i < 5; i++) {
+        *weights[i] = std::strtod(i == 0 ? end : end + 1, &end);
+        if (*end != (i == 4 ? '\0' : ':') || *weights[i] < 0)
+            return false;
+    }
+
+    return options.NameWeight + options.MassWeight + options.AccessionWeight + options.FormulaWeight + options.GlycanWeight > 0;
+}
+
+// Chunks are generated by the workers in any order and written by the calling thread in corpus order,
+// at most 'slots' chunks are held in memory
+static size_t generate(const ProFormaCorpusGenerator& generator, uint64_t lines, size_t threads, FILE* output) {
+    const size_t chunkLines = 16384;
+    const uint64_t chunks = (lines + chunkLines - 1) / chunkLines;
+    const size_t slots = threads * 4;
+
+    struct Slot {
+        std::string Text;
+        uint64_t Chunk = UINT64_MAX;
+        size_t Invalid = 0;
+    };
+
+    std::vector<Slot> ring(slots);
+    std::mutex mutex;
+    std::condition_variable ready, freed;
+    std::atomic<uint64_t> next(0);
+    uint64_t written = 0;
+    size_t invalid = 0;
+
+    auto work = [&]() {
+        std::string text;
+        for (uint64_t chunk = next++; chunk < chunks; chunk = next++) {
+            uint64_t first = chunk * chunkLines;
+            size_t count = static_cast<size_t>(std::min<uint64_t>(chunkLines, lines - first));
+
+            // Wait for the slot of this chunk to be written out before reusing it
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                freed.wait(lock, [&] { return chunk < written + slots; });
+            }
+
+            text.clear();
+            size_t chunkInvalid = generator.AppendLines(text, first, count);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            Slot& slot = ring[chunk % slots];
+            slot.Text.swap(text);
+            slot.Chunk = chunk;
+            slot.Invalid = chunkInvalid;
+            ready.notify_all();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < threads; i++)
+        workers.emplace_back(work);
+
+    std::string text;
+    while (written < chunks) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            Slot& slot = ring[written % slots];
+            ready.wait(lock, [&] { return slot.Chunk == written; });
+            text.swap(slot.Text);
+            invalid += slot.Invalid;
+        }
+
+        fwrite(text.data(), 1, text.size(), output);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        written++;
+        freed.notify_all();
+    }
+
+    for (auto& worker : workers)
+        worker.join();
+
+    return invalid;
+}
+
+int main(int argc, char** argv) {
+    ProFormaCorpusOptions options;
+    uint64_t lines = 1000;
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    const char* outputFile = "-";
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        bool valid = true;
+
+        if (strcmp(argv[i], "--lines") == 0 && hasValue) {
+            lines = std::strtoull(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--seed") == 0 && hasValue) {
+            options.Seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--threads") == 0 && hasValue) {
+            threads = std::max<size_t>(1, static_cast<size_t>(std::strtoull(argv[++i], nullptr, 10)));
+        } else if (strcmp(argv[i], "--output") == 0 && hasValue) {
+            outputFile = argv[++i];
+        } else if (strcmp(argv[i], "--length") == 0 && hasValue) {
+            valid = parseRange(argv[++i], options.MinLength, options.MaxLength);
+        } else if (strcmp(argv[i], "--proteoform-rate") == 0 && hasValue) {
+            options.ProteoformRate = std::atof(argv[++i]);
+        } else if (strcmp(argv[i], "--proteoform-length") == 0 && hasValue) {
+            valid = parseRange(argv[++i], options.ProteoformMinLength, options.ProteoformMaxLength);
+        } else if (strcmp(argv[i], "--mod-density") == 0 && hasValue) {
+            options.ModificationDensity = std::atof(argv[++i]);
+        } else if (strcmp(argv[i], "--descriptors") == 0 && hasValue) {
+            valid = parseWeights(argv[++i], options);
+        } else if (strcmp(argv[i], "--group-rate") == 0 && hasValue) {
+            options.GroupRate = std::atof(argv[++i]);
+        } else if (strcmp(argv[i], "--range-rate") == 0 && hasValue) {
+            options.RangeRate = std::atof(argv[++i]);
+        } else if (strcmp(argv[i], "--global-rate") == 0 && hasValue) {
+            options.GlobalRate = std::atof(argv[++i]);
+        } else if (strcmp(argv[i], "--labile-rate") == 0 && hasValue) {
+            options.LabileRate = std::atof(argv[++i]);
+        } else if (strcmp(argv[i], "--unlocalized-rate") == 0 && hasValue) {
+            options.UnlocalizedRate = std::atof(argv[++i]);
+        } else if (strcmp(argv[i], "--terminal-rate") == 0 && hasValue) {
+            options.TerminalRate = std::atof(argv[++i]);
+        } else if (strcmp(argv[i], "--invalid-rate") == 0 && hasValue) {
+            options.InvalidRate = std::atof(argv[++i]);
+        } else {
+            usage(argv[0]);
+            return strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0 ? 0 : 1;
+        }
+
+        if (!valid) {
+            std::cerr << "Invalid value for " << argv[i - 1] << ": " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    FILE* output = strcmp(outputFile, "-") == 0 ? stdout : fopen(outputFile, "wb");
+    if (!output) {
+        std::cerr << "Cannot open " << outputFile << std::endl;
+        return 1;
+    }
+
+    ProFormaCorpusGenerator generator(options);
+    auto start = std::chrono::steady_clock::now();
+    size_t invalid = generate(generator, lines, threads, output);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    bool failed = fflush(output) != 0 || ferror(output) != 0;
+    if (output != stdout)
+        failed = fclose(output) != 0 || failed;
+
+    if (failed) {
+        std::cerr << "Cannot write " << outputFile << std::endl;
+        return 1;
+    }
+
+    std::cerr << lines << " lines, " << invalid << " invalid, seed " << options.Seed << ", "
+              << static_cast<uint64_t>(seconds > 0 ? lines / seconds : 0) << " lines/s" << std::endl;
+    return 0;
+}
@@ -0,0 +1,96 @@
+#include "ProFormaCapture.h"
+
+#include <cstdlib>
+#include <fstream>
+
+#include "ProFormaMetricsFile.h"
+
+using namespace ProForma;
+
+namespace {
+    const char* const Header = "# ProForma capture v1";
+}
+
+/*****************************************************************************/
+// PUBLIC
+/*****************************************************************************/
+
+ProFormaCapture::ProFormaCapture(size_t capacity, uint64_t seed)
+    : _capacity(capacity), _random(seed)
+{
+    _records.reserve(capacity < 65536 ? capacity : 65536);
+}
+
+void ProFormaCapture::Add(const std::string& input, uint64_t nanoseconds, int code)
+{
+    _seen++;
+
+    // Algorithm R: the n-th input replaces a random record with probability capacity / n
+    size_t slot = _records.size();
+    if (slot >= _capacity)
+    {
+        slot = static_cast<size_t>(_random() % _seen);
+        if (slot >= _capacity)
+            return;
+    }
+
+    if (slot == _records.size())
+        _records.emplace_back();
+
+    ProFormaCaptureRecord& record = _records[slot];
+    record.Input = input;
+    record.Nanoseconds = nanoseconds;
+    record.Code = code;
+}
+
+bool ProFormaCapture::Write(const std::string& path) const
+{
+    std::string text;
+    text.append(Header).append("\n# seen ").append(std::to_string(_seen)).append(" kept ").append(std::to_string(_records.size())).append("\n");
+
+    for (auto& record : _records)
+    {
+        text.append(std::to_string(record.Nanoseconds)).append("\t");
+        text.append(record.Code == ProFormaCaptureRecord::Success ? "ok" : std::to_string(record.Code)).append("\t");
+        text.append(record.Input).append("\n");
+    }
+
+    return ProFormaMetricsFile::WriteAtomically(path, text);
+}
+
+bool ProFormaCapture::Read(const std::string& path, std::vector<ProFormaCaptureRecord>& records, uint64_t& seen)
+{
+    std::ifstream file(path, std::ios::binary);
+    std::string line;
+
+    if (!std::getline(file, line) || line != Header)
+        return false;
+
+    seen = 0;
+    records.clear();
+
+    while (std::getline(file, line))
+    {
+        if (line.compare(0, 7, "# seen ") == 0)
+        {
+            seen = std::strtoull(line.c_str() + 7, nullptr, 10);
+            continue;
+        }
+
+        size_t first = line.find('\t');
+        size_t second = first == std::string::npos ? first : line.find('\t', first + 1);
+        if (second == std::string::npos)
+            continue;
+
+        ProFormaCaptureRecord record;
+        record.Nanoseconds = std::strtoull(line.c_str(), nullptr, 10);
+        record.Code = line.compare(first + 1, second - first - 1, "ok") == 0 ? ProFormaCaptureRecord::Success : std::atoi(line.c_str() + first + 1);
+        record.Input = line.substr(second + 1);
+        records.push_back(std::move(record));
+    }
+
+    if (seen < records.size())
+        seen = records.size();
+
+    return true;
+}
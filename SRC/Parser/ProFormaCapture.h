@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace ProForma {
+	/**
+	 * \struct ProFormaCaptureRecord
+	 *
+	 * \brief One sampled parse: the input, its duration and its outcome.
+	 *
+	 */
+	struct ProFormaCaptureRecord {
+		/**< The ProForma string as received */
+		std::string Input;
+
+		/**< Duration of the ParseString call */
+		uint64_t Nanoseconds = 0;
+
+		/**< ProFormaParseErrorCode of a failed parse, Success otherwise */
+		int Code = Success;
+
+		static constexpr int Success = -1;
+	};
+
+	/**
+	 * \class ProFormaCapture
+	 *
+	 * \brief Uniform sample of a parse workload, kept with reservoir sampling so the memory is bounded by
+	 *        the capacity whatever the number of inputs. The capture file is plain text:
+	 *
+	 *            # ProForma capture v1
+	 *            # seen <inputs> kept <records>
+	 *            <nanoseconds> TAB <ok or error code> TAB <input>
+	 *
+	 */
+	class ProFormaCapture {
+	public:
+		/** \brief  Object constructor
+		  * \param  capacity Maximum number of records kept.
+		  * \param  seed Seed of the sampling.
+		  * \return void
+		  */
+		ProFormaCapture(size_t capacity, uint64_t seed = std::random_device()());
+
+		/** \brief  Offers a parse to the sample, kept with probability capacity / inputs seen */
+		void Add(const std::string& input, uint64_t nanoseconds, int code);
+
+		/** \brief  Records of the sample, in no particular order */
+		const std::vector<ProFormaCaptureRecord>& Records() const { return _records; }
+
+		/** \brief  Number of parses offered */
+		uint64_t Seen() const { return _seen; }
+
+		/** \brief  Writes the capture file, replacing it atomically
+		  * \param  path File to write.
+		  * \return false if the file could not be written
+		  */
+		bool Write(const std::string& path) const;
+
+		/** \brief  Reads a capture file
+		  * \param  path File written by Write.
+		  * \param  records Receives the records.
+		  * \param  seen Receives the number of parses the sample was taken from.
+		  * \return false if the file cannot be opened or is not a capture
+		  */
+		static bool Read(const std::string& path, std::vector<ProFormaCaptureRecord>& records, uint64_t& seen);
+
+	private:
+		size_t _capacity;
+		uint64_t _seen = 0;
+		std::mt19937_64 _random;
+		std::vector<ProFormaCaptureRecord> _records;
+	};
+}
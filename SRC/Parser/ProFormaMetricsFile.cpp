@@ -0,0 +1,220 @@
+#include "ProFormaMetricsFile.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+#ifdef WIN32
+#include <windows.h>
+#include <psapi.h>
+#if defined(_MSC_VER)
+#pragma comment(lib, "psapi.lib")
+#endif
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "ProFormaLatencyHistogram.h"
+#include "ProFormaParserPolicy.h"
+#include "ProFormaParserStats.h"
+
+using namespace ProForma;
+
+namespace {
+    // Label values of ProFormaParseErrorCode
+    const char* const ErrorCodeNames[] = {
+        "syntax", "input_too_long", "too_many_residues", "too_many_tags",
+        "too_many_descriptors", "nesting_too_deep", "allocation_limit_exceeded"
+    };
+    static_assert(sizeof(ErrorCodeNames) / sizeof(ErrorCodeNames[0]) == ProFormaParseErrorCodeCount, "One label per ProFormaParseErrorCode");
+
+    const double Quantiles[] = { 0.5, 0.9, 0.99, 0.999 };
+
+    void AppendHeader(std::string& text, const char* name, const char* type, const char* help)
+    {
+        text.append("# HELP ").append(name).append(" ").append(help).append("\n");
+        text.append("# TYPE ").append(name).append(" ").append(type).append("\n");
+    }
+
+    void AppendSample(std::string& text, const char* name, const std::string& labels, double value)
+    {
+        char number[32];
+        snprintf(number, sizeof(number), "%.9g", value);
+        text.append(name);
+        if (!labels.empty())
+            text.append("{").append(labels).append("}");
+        text.append(" ").append(number).append("\n");
+    }
+
+    void AppendSample(std::string& text, const char* name, const std::string& labels, uint64_t value)
+    {
+        text.append(name);
+        if (!labels.empty())
+            text.append("{").append(labels).append("}");
+        text.append(" ").append(std::to_string(value)).append("\n");
+    }
+
+    void AppendCounters(std::string& text, const ProFormaParserStatsSnapshot& stats)
+    {
+        AppendHeader(text, "proforma_parser_strings_parsed_total", "counter", "ProForma strings parsed successfully.");
+        AppendSample(text, "proforma_parser_strings_parsed_total", "", stats[ProFormaParserCounter::Parses]);
+
+        AppendHeader(text, "proforma_parser_errors_total", "counter", "ProForma strings rejected, by error code.");
+        for (size_t i = 0; i < ProFormaParseErrorCodeCount; i++)
+            AppendSample(text, "proforma_parser_errors_total", std::string("code=\"") + ErrorCodeNames[i] + "\"", stats.Errors[i]);
+
+        AppendHeader(text, "proforma_parser_input_bytes_total", "counter", "Bytes of ProForma strings processed, rejected ones included.");
+        AppendSample(text, "proforma_parser_input_bytes_total", "", stats[ProFormaParserCounter::InputBytes]);
+
+        AppendHeader(text, "proforma_parser_residues_total", "counter", "Residues of the parsed chains.");
+        AppendSample(text, "proforma_parser_residues_total", "", stats[ProFormaParserCounter::Residues]);
+
+        AppendHeader(text, "proforma_parser_tags_total", "counter", "Tags of the parsed strings.");
+        AppendSample(text, "proforma_parser_tags_total", "", stats[ProFormaParserCounter::Tags]);
+    }
+}
+
+/*****************************************************************************/
+// PUBLIC
+/*****************************************************************************/
+
+ProFormaMetricsFile::ProFormaMetricsFile(const std::string& path, double intervalSeconds)
+    : _path(path), _intervalSeconds(intervalSeconds > 0.0 ? intervalSeconds : 1.0)
+{
+    ProFormaLatency::SetEnabled(true);
+    Write();
+    _thread = std::thread(&ProFormaMetricsFile::Run, this);
+}
+
+ProFormaMetricsFile::~ProFormaMetricsFile()
+{
+    Stop();
+}
+
+void ProFormaMetricsFile::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_stopping)
+            return;
+        _stopping = true;
+    }
+
+    _wake.notify_one();
+    _thread.join();
+    Write();
+}
+
+std::string ProFormaMetricsFile::Format()
+{
+    std::string text;
+
+    // Without PROFORMA_PARSER_STATS the counters stay at zero, only the latency and memory are exported
+    if (ProFormaDefaultPolicy::CollectStats)
+        AppendCounters(text, ProFormaParserStats::Snapshot());
+
+    // Quantiles since the start of the process, the histograms are never reset
+    AppendHeader(text, "proforma_parser_latency_seconds", "summary", "Duration of the parse calls.");
+    for (ProFormaOperation operation : { ProFormaOperation::Parse, ProFormaOperation::ParseMulti })
+    {
+        ProFormaLatencyHistogram histogram = ProFormaLatency::Snapshot(operation);
+        std::string label = std::string("operation=\"") + ProFormaLatency::OperationName(operation) + "\"";
+
+        for (double quantile : Quantiles)
+        {
+            char value[16];
+            snprintf(value, sizeof(value), "%g", quantile);
+            AppendSample(text, "proforma_parser_latency_seconds", label + ",quantile=\"" + value + "\"", histogram.ValueAtQuantile(quantile) * 1e-9);
+        }
+
+        AppendSample(text, "proforma_parser_latency_seconds_sum", label, static_cast<double>(histogram.Sum) * 1e-9);
+        AppendSample(text, "proforma_parser_latency_seconds_count", label, histogram.Count);
+    }
+
+    size_t resident = ResidentBytes();
+    if (resident > 0)
+    {
+        AppendHeader(text, "process_resident_memory_bytes", "gauge", "Resident memory size in bytes.");
+        AppendSample(text, "process_resident_memory_bytes", "", static_cast<uint64_t>(resident));
+    }
+
+    return text;
+}
+
+bool ProFormaMetricsFile::WriteAtomically(const std::string& path, const std::string& content)
+{
+    // Same directory as the target, so the rename does not cross file systems
+    std::string temporary = path + ".tmp";
+
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write(content.data(), static_cast<std::streamsize>(content.size()));
+        file.close();
+        if (!file)
+        {
+            std::remove(temporary.c_str());
+            return false;
+        }
+    }
+
+#ifdef WIN32
+    return MoveFileExA(temporary.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+#endif
+}
+
+size_t ProFormaMetricsFile::ResidentBytes()
+{
+#ifdef WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return counters.WorkingSetSize;
+    return 0;
+#elif defined(__APPLE__)
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) == KERN_SUCCESS)
+        return info.resident_size;
+    return 0;
+#else
+    // Second field of statm is the resident size in pages
+    unsigned long size = 0, resident = 0;
+    FILE* statm = fopen("/proc/self/statm", "r");
+    if (statm == nullptr)
+        return 0;
+    int read = fscanf(statm, "%lu %lu", &size, &resident);
+    fclose(statm);
+    return read == 2 ? static_cast<size_t>(resident) * static_cast<size_t>(sysconf(_SC_PAGESIZE)) : 0;
+#endif
+}
+
+/*****************************************************************************/
+// PRIVATE
+/*****************************************************************************/
+
+void ProFormaMetricsFile::Run()
+{
+    auto interval = std::chrono::duration<double>(_intervalSeconds);
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    while (!_wake.wait_for(lock, interval, [this] { return _stopping; }))
+    {
+        lock.unlock();
+        Write();
+        lock.lock();
+    }
+}
+
+void ProFormaMetricsFile::Write()
+{
+    // Complain once, a scraper reading a stale file is better than a stage failing over telemetry
+    if (!WriteAtomically(_path, Format()) && !_failed)
+    {
+        _failed = true;
+        std::cerr << "WARNING: Cannot write metrics file " << _path << std::endl;
+    }
+}
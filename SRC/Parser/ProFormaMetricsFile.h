@@ -0,0 +1,63 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace ProForma {
+	/**
+	 * \class ProFormaMetricsFile
+	 *
+	 * \brief Keeps a file in the Prometheus text exposition format up to date with the parser counters,
+	 *        the parse latency quantiles and the resident memory, for the textfile collector of a local
+	 *        node exporter. A background thread rewrites the file every interval and once more on Stop().
+	 *        Each rewrite goes to "<path>.tmp" first and is renamed over the file, so a scrape never reads
+	 *        a partial file.
+	 *
+	 */
+	class ProFormaMetricsFile {
+	public:
+		/** \brief  Object constructor, writes the file and starts the background thread
+		  * \param  path File to rewrite, ending in .prom for the textfile collector.
+		  * \param  intervalSeconds Time between two rewrites.
+		  * \return void
+		  */
+		ProFormaMetricsFile(const std::string& path, double intervalSeconds);
+
+		/** \brief  Object destructor, calls Stop() */
+		~ProFormaMetricsFile();
+
+		ProFormaMetricsFile(const ProFormaMetricsFile&) = delete;
+		ProFormaMetricsFile& operator=(const ProFormaMetricsFile&) = delete;
+
+		/** \brief  Stops the background thread and writes the final values */
+		void Stop();
+
+		/** \brief  Current metrics in the Prometheus text exposition format */
+		static std::string Format();
+
+		/** \brief  Replaces the content of a file through a temporary file and a rename
+		  * \param  path File to replace.
+		  * \param  content New content.
+		  * \return false if the file could not be written
+		  */
+		static bool WriteAtomically(const std::string& path, const std::string& content);
+
+		/** \brief  Resident set size of the process in bytes, 0 where unknown */
+		static size_t ResidentBytes();
+
+	private:
+		void Run();
+		void Write();
+
+		std::string _path;
+		double _intervalSeconds;
+		bool _stopping = false;
+		bool _failed = false;
+		std::mutex _mutex;
+		std::condition_variable _wake;
+		std::thread _thread;
+	};
+}
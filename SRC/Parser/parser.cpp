@@ -1,21 +1,225 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <vector>
 
+#include "ProFormaCapture.h"
+#include "ProFormaLatencyHistogram.h"
+#include "ProFormaMetricsFile.h"
 #include "ProFormaParser.h"
 #include "ProFormaParseException.h"
 #include "ProFormaWriter.h"
 
 using namespace ProForma;
 
+static void usage(const char* program) {
+    std::cerr << "Usage: " << program << " [--metrics-file PATH] [--metrics-interval SECONDS] [--input PATH|-] [--memory-report]" << std::endl
+              << "       [--capture PATH] [--capture-size N] [--replay PATH] [--replay-repeat N] [PROFORMA]" << std::endl
+              << "  --metrics-file PATH         rewrite PATH with Prometheus metrics while running" << std::endl
+              << "  --metrics-interval SECONDS  time between two rewrites, 10 by default" << std::endl
+              << "  --input PATH|-              parse one string per line of PATH or stdin, one JSON line each" << std::endl
+              << "  --memory-report             print the memory held by the parsed terms, by component" << std::endl
+              << "  --capture PATH              keep a sample of the inputs of --input and their parse times in PATH" << std::endl
+              << "  --capture-size N            inputs kept in the sample, 10000 by default" << std::endl
+              << "  --replay PATH               parse the inputs of a capture and compare the times with the captured ones" << std::endl
+              << "  --replay-repeat N           passes over the captured inputs, 1 by default" << std::endl;
+}
+
+static uint64_t elapsedNs(std::chrono::steady_clock::time_point start) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+// Batch mode, the errors go to stderr so stdout only holds JSON lines
+static void parseLines(std::istream& input, bool memoryReport, ProFormaCapture* capture) {
+    ProFormaQuietParser parser;
+    ProFormaMemoryUsage memory;
+    std::string line, json;
+    size_t number = 0;
+
+    while (std::getline(input, line)) {
+        number++;
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (line.empty())
+            continue;
+
+        auto start = std::chrono::steady_clock::now();
+        try {
+            json.clear();
+            ProFormaTerm term = parser.ParseString(line);
+            if (capture)
+                capture->Add(line, elapsedNs(start), ProFormaCaptureRecord::Success);
+            ProFormaWriter::AppendJsonTo(json, term);
+            std::cout << json << '\n';
+            if (memoryReport)
+                memory.Add(term);
+        } catch (ProForma::ProFormaParseException* e) {
+            if (capture)
+                capture->Add(line, elapsedNs(start), static_cast<int>(e->Code()));
+            std::cerr << "ERROR: Line " << number << ": parsing exception => " << e->what() << std::endl;
+            delete e;
+        }
+    }
+
+    std::cout.flush();
+
+    if (memoryReport)
+        memory.Report(std::cerr);
+}
+
+static void printComparison(const char* name, double captured, double replayed) {
+    double change = captured > 0 ? (replayed - captured) / captured * 100.0 : 0.0;
+    printf("%-24s %14.1f %14.1f %+9.1f%%\n", name, captured, replayed, change);
+}
+
+// Parses the captured inputs again and compares the parse times with the captured ones
+static int replay(const std::string& path, size_t repeat) {
+    std::vector<ProFormaCaptureRecord> records;
+    uint64_t seen = 0;
+
+    if (!ProFormaCapture::Read(path, records, seen)) {
+        std::cerr << "ERROR: " << path << " is not a ProForma capture" << std::endl;
+        return 1;
+    }
+
+    // One histogram per length class, the last one for every input
+    const size_t classes = ProFormaLatency::LengthClassCount;
+    std::vector<ProFormaLatencyHistogram> captured(classes + 1), replayed(classes + 1);
+    uint64_t bytes = 0, mismatches = 0;
+
+    for (auto& record : records) {
+        size_t lengthClass = static_cast<size_t>(ProFormaLatency::LengthClass(record.Input.length()));
+        captured[lengthClass].Record(record.Nanoseconds);
+        captured[classes].Record(record.Nanoseconds);
+        bytes += record.Input.length();
+    }
+
+    ProFormaQuietParser parser;
+    for (size_t pass = 0; pass < repeat; pass++) {
+        for (auto& record : records) {
+            int code = ProFormaCaptureRecord::Success;
+            auto start = std::chrono::steady_clock::now();
+            try {
+                parser.ParseString(record.Input);
+            } catch (ProForma::ProFormaParseException* e) {
+                code = static_cast<int>(e->Code());
+                delete e;
+            }
+            uint64_t nanoseconds = elapsedNs(start);
+
+            size_t lengthClass = static_cast<size_t>(ProFormaLatency::LengthClass(record.Input.length()));
+            replayed[lengthClass].Record(nanoseconds);
+            replayed[classes].Record(nanoseconds);
+            if (pass == 0 && code != record.Code)
+                mismatches++;
+        }
+    }
+
+    const ProFormaLatencyHistogram& before = captured[classes];
+    const ProFormaLatencyHistogram& after = replayed[classes];
+    double capturedSeconds = before.Sum * 1e-9, replayedSeconds = after.Sum * 1e-9 / repeat;
+
+    printf("Replayed %zu of %llu captured parses, %zu pass(es), %.1f KB\n\n", records.size(), static_cast<unsigned long long>(seen), repeat, bytes / 1024.0);
+    printf("%-24s %14s %14s %10s\n", "", "captured", "replayed", "change");
+    if (capturedSeconds > 0 && replayedSeconds > 0) {
+        printComparison("parses/s", records.size() / capturedSeconds, records.size() / replayedSeconds);
+        printComparison("MB/s", bytes / capturedSeconds * 1e-6, bytes / replayedSeconds * 1e-6);
+    }
+    printComparison("mean ns", before.Mean(), after.Mean());
+    for (double quantile : { 0.5, 0.9, 0.99, 0.999 }) {
+        char name[32];
+        snprintf(name, sizeof(name), "p%g ns", quantile * 100);
+        printComparison(name, static_cast<double>(before.ValueAtQuantile(quantile)), static_cast<double>(after.ValueAtQuantile(quantile)));
+    }
+
+    printf("\n");
+    for (size_t i = 0; i < classes; i++) {
+        if (captured[i].Count == 0)
+            continue;
+        char name[48];
+        snprintf(name, sizeof(name), "p50 ns %s (%llu)", ProFormaLatency::LengthClassName(static_cast<ProFormaLengthClass>(i)), static_cast<unsigned long long>(captured[i].Count));
+        printComparison(name, static_cast<double>(captured[i].ValueAtQuantile(0.5)), static_cast<double>(replayed[i].ValueAtQuantile(0.5)));
+    }
+
+    if (mismatches > 0)
+        printf("\nWARNING: %llu inputs parsed with a different outcome than captured\n", static_cast<unsigned long long>(mismatches));
+
+    return 0;
+}
+
 int main(int argc, char** argv) {
     std::string proformaString = "EM[+15.9949]EVEES[-79.9663]PEK";
+    std::string metricsFile, inputFile;
+    double metricsInterval = 10.0;
+    bool memoryReport = false;
+    std::string captureFile, replayFile;
+    size_t captureSize = 10000, replayRepeat = 1;
 
-    // Define a parser and parse the string received as argv[1], use default one otherwise
-    ProFormaParser parser;
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+
+        if (strcmp(argv[i], "--metrics-file") == 0 && hasValue) {
+            metricsFile = argv[++i];
+        } else if (strcmp(argv[i], "--metrics-interval") == 0 && hasValue) {
+            metricsInterval = std::atof(argv[++i]);
+        } else if (strcmp(argv[i], "--input") == 0 && hasValue) {
+            inputFile = argv[++i];
+        } else if (strcmp(argv[i], "--capture") == 0 && hasValue) {
+            captureFile = argv[++i];
+        } else if (strcmp(argv[i], "--capture-size") == 0 && hasValue) {
+            captureSize = static_cast<size_t>(std::strtoull(argv[++i], nullptr, 10));
+        } else if (strcmp(argv[i], "--replay") == 0 && hasValue) {
+            replayFile = argv[++i];
+        } else if (strcmp(argv[i], "--replay-repeat") == 0 && hasValue) {
+            replayRepeat = std::max<size_t>(1, static_cast<size_t>(std::strtoull(argv[++i], nullptr, 10)));
+        } else if (strcmp(argv[i], "--memory-report") == 0) {
+            memoryReport = true;
+        } else if (strncmp(argv[i], "--", 2) == 0 || strcmp(argv[i], "-h") == 0) {
+            usage(argv[0]);
+            return strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0 ? 0 : 1;
+        } else {
+            proformaString = argv[i];
+        }
+    }
+
+    std::unique_ptr<ProFormaMetricsFile> metrics;
+    if (!metricsFile.empty())
+        metrics.reset(new ProFormaMetricsFile(metricsFile, metricsInterval));
 
-    if(argc > 1) {
-        proformaString = argv[1];
+    if (!replayFile.empty())
+        return replay(replayFile, replayRepeat);
+
+    if (!inputFile.empty()) {
+        std::unique_ptr<ProFormaCapture> capture;
+        if (!captureFile.empty())
+            capture.reset(new ProFormaCapture(captureSize));
+
+        if (inputFile == "-") {
+            parseLines(std::cin, memoryReport, capture.get());
+        } else {
+            std::ifstream input(inputFile);
+            if (!input) {
+                std::cerr << "ERROR: Cannot open " << inputFile << std::endl;
+                return 1;
+            }
+            parseLines(input, memoryReport, capture.get());
+        }
+
+        if (capture && !capture->Write(captureFile)) {
+            std::cerr << "ERROR: Cannot write capture file " << captureFile << std::endl;
+            return 1;
+        }
+        return 0;
     }
 
+    // Define a parser and parse the string received as argument, use default one otherwise
+    ProFormaParser parser;
+
     ProFormaLogger::GetLogger()->Log("Parsing proforma string: %s", proformaString.c_str());
 
     try {
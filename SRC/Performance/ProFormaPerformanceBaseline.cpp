@@ -0,0 +1,106 @@
+#include "ProFormaPerformanceBaseline.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+
+using namespace ProForma;
+
+namespace {
+    const char* const Header = "# ProForma performance baseline v2";
+}
+
+/*****************************************************************************/
+// PUBLIC
+/*****************************************************************************/
+
+bool ProFormaPerformanceBaseline::Read(const std::string& path, std::map<std::string, ProFormaPerformanceEntry>& entries, std::string& toolchain)
+{
+    std::ifstream file(path, std::ios::binary);
+    std::string line;
+
+    if (!std::getline(file, line))
+        return false;
+    if (!line.empty() && line.back() == '\r')
+        line.pop_back();
+    if (line != Header)
+        return false;
+
+    entries.clear();
+    toolchain.clear();
+
+    while (std::getline(file, line))
+    {
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        if (line.back() == '\r')
+            line.pop_back();
+
+        size_t first = line.find('\t');
+        if (first != std::string::npos && line.compare(0, first, "toolchain") == 0)
+        {
+            toolchain = line.substr(first + 1);
+            continue;
+        }
+
+        size_t second = first == std::string::npos ? first : line.find('\t', first + 1);
+        if (second == std::string::npos)
+            continue;
+
+        ProFormaPerformanceEntry entry;
+        entry.RelativeCost = std::strtod(line.c_str() + first + 1, nullptr);
+        entry.AllocationsPerItem = std::strtod(line.c_str() + second + 1, nullptr);
+        entries[line.substr(0, first)] = entry;
+    }
+
+    return true;
+}
+
+bool ProFormaPerformanceBaseline::Write(const std::string& path, const std::map<std::string, ProFormaPerformanceEntry>& entries, const std::string& toolchain)
+{
+    FILE* file = fopen(path.c_str(), "w");
+    if (file == nullptr)
+        return false;
+
+    fprintf(file, "%s\ntoolchain\t%s\n# gate\trelative cost\tallocations per item\n", Header, toolchain.c_str());
+    for (auto& entry : entries)
+        fprintf(file, "%s\t%.3f\t%.3f\n", entry.first.c_str(), entry.second.RelativeCost, entry.second.AllocationsPerItem);
+
+    return fclose(file) == 0;
+}
+
+std::string ProFormaPerformanceBaseline::Toolchain()
+{
+#if defined(_LIBCPP_VERSION)
+    return "libc++ " + std::to_string(_LIBCPP_VERSION);
+#elif defined(_GLIBCXX_RELEASE)
+    return "libstdc++ " + std::to_string(_GLIBCXX_RELEASE);
+#elif defined(_MSVC_STL_VERSION)
+    return "msvc " + std::to_string(_MSVC_STL_VERSION);
+#else
+    return "unknown";
+#endif
+}
+
+bool ProFormaPerformanceBaseline::AppendHistory(const std::string& path, const std::string& gate, const char* build, double itemsPerSecond,
+    const ProFormaPerformanceEntry& measured, const ProFormaPerformanceEntry& baseline, const char* status)
+{
+    bool exists = std::ifstream(path).good();
+
+    FILE* file = fopen(path.c_str(), "a");
+    if (file == nullptr)
+        return false;
+
+    time_t now = time(nullptr);
+    char date[32];
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+
+    if (!exists)
+        fprintf(file, "date,gate,build,items_per_second,relative_cost,baseline_relative_cost,allocs_per_item,baseline_allocs_per_item,status\n");
+    fprintf(file, "%s,%s,%s,%.1f,%.3f,%.3f,%.3f,%.3f,%s\n", date, gate.c_str(), build, itemsPerSecond,
+        measured.RelativeCost, baseline.RelativeCost, measured.AllocationsPerItem, baseline.AllocationsPerItem, status);
+
+    return fclose(file) == 0;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <map>
+#include <string>
+
+namespace ProForma {
+	/**
+	 * \struct ProFormaPerformanceEntry
+	 *
+	 * \brief Measure of one performance gate.
+	 *
+	 */
+	struct ProFormaPerformanceEntry {
+		/**< Nanoseconds per item divided by those of the reference pass over the same corpus, lower is better */
+		double RelativeCost = 0.0;
+
+		/**< Heap allocations per item */
+		double AllocationsPerItem = 0.0;
+	};
+
+	/**
+	 * \class ProFormaPerformanceBaseline
+	 *
+	 * \brief Checked-in measures the gates are compared with, and the history of the runs. The baseline
+	 *        is plain text, the toolchain it was recorded with then one gate per line:
+	 *
+	 *            # ProForma performance baseline v2
+	 *            toolchain TAB <standard library and version>
+	 *            <gate> TAB <relative cost> TAB <allocations per item>
+	 *
+	 *        Allocation counts depend on the standard library (small string size, node allocations), they
+	 *        are only comparable between runs of the same toolchain.
+	 *
+	 *        The history is a CSV file, one row per gate and run, appended so trends can be plotted.
+	 *
+	 */
+	class ProFormaPerformanceBaseline {
+	public:
+		/** \brief  Reads a baseline file
+		  * \param  path File written by Write.
+		  * \param  entries Receives the entries by gate name.
+		  * \param  toolchain Receives the toolchain the baseline was recorded with.
+		  * \return false if the file cannot be opened or is not a baseline
+		  */
+		static bool Read(const std::string& path, std::map<std::string, ProFormaPerformanceEntry>& entries, std::string& toolchain);
+
+		/** \brief  Writes a baseline file, gates sorted by name
+		  * \param  path File to write.
+		  * \param  entries Entries by gate name.
+		  * \param  toolchain Toolchain the entries were measured with.
+		  * \return false if the file could not be written
+		  */
+		static bool Write(const std::string& path, const std::map<std::string, ProFormaPerformanceEntry>& entries, const std::string& toolchain);
+
+		/** \brief  Standard library of this build and its version, "libstdc++ 12" for instance */
+		static std::string Toolchain();
+
+		/** \brief  Appends one row to the history, with the header when the file is new
+		  * \param  path CSV file.
+		  * \param  gate Gate name.
+		  * \param  build "optimized" or "unoptimized".
+		  * \param  itemsPerSecond Throughput of the run.
+		  * \param  measured Measure of the run.
+		  * \param  baseline Baseline the run was compared with.
+		  * \param  status "pass", "fail" or "unchecked".
+		  * \return false if the file could not be written
+		  */
+		static bool AppendHistory(const std::string& path, const std::string& gate, const char* build, double itemsPerSecond,
+			const ProFormaPerformanceEntry& measured, const ProFormaPerformanceEntry& baseline, const char* status);
+	};
+}
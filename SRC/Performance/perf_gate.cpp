@@ -0,0 +1,376 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "ProFormaParseException.h"
+#include "ProFormaParser.h"
+#include "ProFormaPerformanceBaseline.h"
+#include "ProFormaWriter.h"
+
+using namespace ProForma;
+
+// Performance regression gates, registered with ctest under the "performance" label.
+//
+// The corpora under Corpora/ were written by ProFormaGenerator with --seed 20261019 --threads 1:
+//   peptides.txt     --lines 2000
+//   proteoforms.txt  --lines 100 --proteoform-rate 1
+//   mixed.txt        --lines 2000 --mod-density 0.15 --group-rate 0.2 --range-rate 0.2 --global-rate 0.1
+//                    --labile-rate 0.1 --unlocalized-rate 0.1 --terminal-rate 0.2
+//
+// Throughput depends on the machine, so the baseline holds a relative cost instead: nanoseconds per item
+// of the gate divided by those of a reference pass tokenizing the same corpus, both the best of interleaved
+// samples. Allocations per item do not depend on the machine and have their own, tighter, band, but they do
+// depend on the standard library: they are only checked when the baseline was recorded with the toolchain of
+// the build. Relative costs are only checked in NDEBUG builds, CMakeLists.txt defaults to Release for this.
+
+static std::atomic<size_t> _allocations(0);
+
+// Count every heap allocation of the process
+void* operator new(size_t size)
+{
+    _allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+enum class GateKind { Parse, WriteString, WriteJson };
+
+struct Gate {
+    const char* Name;
+    const char* Corpus;
+    GateKind Kind;
+};
+
+static const Gate Gates[] = {
+    { "parse/peptides",    "peptides.txt",    GateKind::Parse },
+    { "parse/proteoforms", "proteoforms.txt", GateKind::Parse },
+    { "parse/mixed",       "mixed.txt",       GateKind::Parse },
+    { "write/string",      "mixed.txt",       GateKind::WriteString },
+    { "write/json",        "mixed.txt",       GateKind::WriteJson },
+};
+
+#if defined(NDEBUG)
+static const bool Optimized = true;
+#else
+static const bool Optimized = false;
+#endif
+
+static volatile uint64_t _sink;
+
+static void usage(const char* program)
+{
+    fprintf(stderr, "Usage: %s --corpora DIR --baseline PATH [--gate NAME]... [options]\n", program);
+    fprintf(stderr, "  --corpora DIR           directory of the corpus files\n");
+    fprintf(stderr, "  --baseline PATH         baseline the gates are compared with\n");
+    fprintf(stderr, "  --gate NAME             gate to run, every gate by default\n");
+    fprintf(stderr, "  --history PATH          append the measures to a CSV file\n");
+    fprintf(stderr, "  --tolerance X           accepted relative cost increase, 0.30 by default or PROFORMA_PERF_TOLERANCE\n");
+    fprintf(stderr, "  --alloc-tolerance X     accepted allocations per item increase, 0.05 by default\n");
+    fprintf(stderr, "  --samples N             interleaved samples of the gate and the reference, 5 by default\n");
+    fprintf(stderr, "  --min-time MS           minimum duration of a sample, 100 by default\n");
+    fprintf(stderr, "  --update-baseline       write the measures to the baseline instead of checking them\n");
+}
+
+static bool readCorpus(const std::string& path, std::vector<std::string>& corpus)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return false;
+
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (!line.empty())
+            corpus.push_back(std::move(line));
+    }
+
+    return !corpus.empty();
+}
+
+// Best nanoseconds per item of a pass over the corpus, repeated for at least minNs
+template <typename Pass>
+static double sampleNsPerItem(size_t items, double minNs, Pass pass)
+{
+    size_t passes = 0;
+    auto start = std::chrono::steady_clock::now();
+    double elapsed = 0;
+
+    do
+    {
+        pass();
+        passes++;
+        elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    } while (elapsed < minNs);
+
+    return elapsed / (static_cast<double>(passes) * items);
+}
+
+// Naive tokenizer splitting at brackets into strings, branches and allocations in the proportions of a
+// parser so a busy machine slows it about as much
+static void referencePass(const std::vector<std::string>& corpus)
+{
+    std::vector<std::string> tokens;
+    size_t residues = 0;
+
+    for (auto& input : corpus)
+    {
+        tokens.clear();
+        size_t start = 0;
+        for (size_t i = 0; i < input.length(); i++)
+        {
+            char c = input[i];
+            if (c == '[' || c == ']' || c == '(' || c == ')')
+            {
+                tokens.emplace_back(input, start, i - start);
+                start = i + 1;
+            }
+            else if (c >= 'A' && c <= 'Z')
+                residues++;
+        }
+        tokens.emplace_back(input, start, input.length() - start);
+        residues += tokens.size();
+    }
+
+    _sink = _sink + residues;
+}
+
+static void runGate(const Gate& gate, const std::vector<std::string>& corpus, int samples, double minNs, ProFormaPerformanceEntry& measured, double& itemsPerSecond)
+{
+    ProFormaQuietParser parser;
+    std::vector<ProFormaTerm> terms;
+    std::string out;
+
+    if (gate.Kind != GateKind::Parse)
+    {
+        terms.reserve(corpus.size());
+        for (auto& input : corpus)
+            terms.push_back(parser.ParseString(input));
+    }
+
+    auto pass = [&]()
+    {
+        switch (gate.Kind)
+        {
+        case GateKind::Parse:
+            for (auto& input : corpus)
+                _sink = _sink + parser.ParseString(input).Sequence().length();
+            break;
+        case GateKind::WriteString:
+            for (auto& term : terms)
+            {
+                out.clear();
+                ProFormaWriter::AppendTo(out, term);
+                _sink = _sink + out.length();
+            }
+            break;
+        case GateKind::WriteJson:
+            for (auto& term : terms)
+            {
+                out.clear();
+                ProFormaWriter::AppendJsonTo(out, term);
+                _sink = _sink + out.length();
+            }
+            break;
+        }
+    };
+
+    // Warm-up, then one pass counted on its own since allocations do not vary between passes
+    pass();
+    size_t allocations = _allocations.load(std::memory_order_relaxed);
+    pass();
+    measured.AllocationsPerItem = (_allocations.load(std::memory_order_relaxed) - allocations) / static_cast<double>(corpus.size());
+
+    // Interleaved so a change of clock speed during the run affects both sides
+    double gateNs = 1e300, referenceNs = 1e300;
+    for (int i = 0; i < samples; i++)
+    {
+        gateNs = std::min(gateNs, sampleNsPerItem(corpus.size(), minNs, pass));
+        referenceNs = std::min(referenceNs, sampleNsPerItem(corpus.size(), minNs, [&]() { referencePass(corpus); }));
+    }
+
+    measured.RelativeCost = gateNs / referenceNs;
+    itemsPerSecond = 1e9 / gateNs;
+}
+
+int main(int argc, char** argv)
+{
+    std::string corporaPath, baselinePath, historyPath;
+    std::vector<std::string> selected;
+    double tolerance = 0.30;
+    double allocationTolerance = 0.05;
+    int samples = 5;
+    double minNs = 100e6;
+    bool updateBaseline = false;
+
+    if (const char* value = std::getenv("PROFORMA_PERF_TOLERANCE"))
+        tolerance = std::atof(value);
+
+    for (int i = 1; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+
+        if (strcmp(argv[i], "--corpora") == 0 && hasValue)
+            corporaPath = argv[++i];
+        else if (strcmp(argv[i], "--baseline") == 0 && hasValue)
+            baselinePath = argv[++i];
+        else if (strcmp(argv[i], "--gate") == 0 && hasValue)
+            selected.push_back(argv[++i]);
+        else if (strcmp(argv[i], "--history") == 0 && hasValue)
+            historyPath = argv[++i];
+        else if (strcmp(argv[i], "--tolerance") == 0 && hasValue)
+            tolerance = std::atof(argv[++i]);
+        else if (strcmp(argv[i], "--alloc-tolerance") == 0 && hasValue)
+            allocationTolerance = std::atof(argv[++i]);
+        else if (strcmp(argv[i], "--samples") == 0 && hasValue)
+            samples = std::max(1, std::atoi(argv[++i]));
+        else if (strcmp(argv[i], "--min-time") == 0 && hasValue)
+            minNs = std::atof(argv[++i]) * 1e6;
+        else if (strcmp(argv[i], "--update-baseline") == 0)
+            updateBaseline = true;
+        else
+        {
+            usage(argv[0]);
+            return strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0 ? 0 : 2;
+        }
+    }
+
+    if (corporaPath.empty() || baselinePath.empty())
+    {
+        usage(argv[0]);
+        return 2;
+    }
+
+    for (auto& name : selected)
+    {
+        if (std::none_of(std::begin(Gates), std::end(Gates), [&](const Gate& gate) { return name == gate.Name; }))
+        {
+            fprintf(stderr, "Unknown gate %s\n", name.c_str());
+            return 2;
+        }
+    }
+
+    if (updateBaseline && !Optimized)
+    {
+        fprintf(stderr, "The baseline is only updated from an optimized build\n");
+        return 2;
+    }
+
+    std::map<std::string, ProFormaPerformanceEntry> baseline;
+    std::string baselineToolchain;
+    std::string toolchain = ProFormaPerformanceBaseline::Toolchain();
+    if (!ProFormaPerformanceBaseline::Read(baselinePath, baseline, baselineToolchain) && !updateBaseline)
+    {
+        fprintf(stderr, "Cannot read the baseline %s\n", baselinePath.c_str());
+        return 2;
+    }
+
+    bool checkAllocations = toolchain == baselineToolchain && toolchain != "unknown";
+
+    if (!Optimized)
+        printf("Unoptimized build: relative costs are recorded but not checked, configure with -DCMAKE_BUILD_TYPE=Release\n");
+    if (!checkAllocations && !updateBaseline)
+        printf("Baseline recorded with %s, this build uses %s: allocations are recorded but not checked\n",
+            baselineToolchain.empty() ? "an unknown toolchain" : baselineToolchain.c_str(), toolchain.c_str());
+
+    bool failed = false;
+
+    for (auto& gate : Gates)
+    {
+        if (!selected.empty() && std::find(selected.begin(), selected.end(), gate.Name) == selected.end())
+            continue;
+
+        std::vector<std::string> corpus;
+        std::string corpusPath = corporaPath + "/" + gate.Corpus;
+        if (!readCorpus(corpusPath, corpus))
+        {
+            fprintf(stderr, "%s: cannot read the corpus %s\n", gate.Name, corpusPath.c_str());
+            failed = true;
+            continue;
+        }
+
+        ProFormaPerformanceEntry measured;
+        double itemsPerSecond = 0;
+
+        try
+        {
+            runGate(gate, corpus, samples, minNs, measured, itemsPerSecond);
+        }
+        catch (ProFormaParseException* e)
+        {
+            fprintf(stderr, "%s: the corpus does not parse: %s\n", gate.Name, e->what());
+            delete e;
+            failed = true;
+            continue;
+        }
+
+        if (updateBaseline)
+        {
+            baseline[gate.Name] = measured;
+            printf("%-18s %12.0f items/s  relative cost %8.3f  %6.2f allocs/item  recorded\n", gate.Name, itemsPerSecond, measured.RelativeCost, measured.AllocationsPerItem);
+            continue;
+        }
+
+        auto found = baseline.find(gate.Name);
+        if (found == baseline.end())
+        {
+            fprintf(stderr, "%s: no baseline, run with --update-baseline\n", gate.Name);
+            failed = true;
+            continue;
+        }
+
+        const ProFormaPerformanceEntry& expected = found->second;
+        double costLimit = expected.RelativeCost * (1.0 + tolerance);
+        double allocationLimit = expected.AllocationsPerItem * (1.0 + allocationTolerance);
+
+        // A slowdown of the machine rarely lasts two runs, a regression does
+        if (Optimized && measured.RelativeCost > costLimit)
+        {
+            ProFormaPerformanceEntry again;
+            double itemsPerSecondAgain = 0;
+            runGate(gate, corpus, samples, minNs, again, itemsPerSecondAgain);
+            if (again.RelativeCost < measured.RelativeCost)
+            {
+                measured = again;
+                itemsPerSecond = itemsPerSecondAgain;
+            }
+        }
+
+        bool costRegressed = Optimized && measured.RelativeCost > costLimit;
+        bool allocationsRegressed = checkAllocations && measured.AllocationsPerItem > allocationLimit + 1e-9;
+        const char* status = costRegressed || allocationsRegressed ? "fail" : (Optimized && checkAllocations ? "pass" : "unchecked");
+
+        printf("%-18s %12.0f items/s  relative cost %8.3f (baseline %.3f, limit %.3f)  %6.2f allocs/item (baseline %.2f, limit %.2f)  %s\n",
+            gate.Name, itemsPerSecond, measured.RelativeCost, expected.RelativeCost, costLimit,
+            measured.AllocationsPerItem, expected.AllocationsPerItem, allocationLimit, status);
+
+        if (Optimized && measured.RelativeCost < expected.RelativeCost * (1.0 - tolerance))
+            printf("%-18s faster than the baseline by %.0f%%, consider --update-baseline\n", gate.Name, 100.0 * (1.0 - measured.RelativeCost / expected.RelativeCost));
+
+        if (!historyPath.empty() && !ProFormaPerformanceBaseline::AppendHistory(historyPath, gate.Name, Optimized ? "optimized" : "unoptimized", itemsPerSecond, measured, expected, status))
+            fprintf(stderr, "Cannot write the history %s\n", historyPath.c_str());
+
+        failed = failed || costRegressed || allocationsRegressed;
+    }
+
+    if (updateBaseline && !ProFormaPerformanceBaseline::Write(baselinePath, baseline, toolchain))
+    {
+        fprintf(stderr, "Cannot write the baseline %s\n", baselinePath.c_str());
+        return 2;
+    }
+
+    return failed ? 1 : 0;
+}
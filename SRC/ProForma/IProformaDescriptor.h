@@ -13,13 +13,16 @@ namespace ProForma {
 	 */
 	class IProFormaDescriptor {
 	public:
+		/** \brief  Tag groups are deleted through their base class */
+		virtual ~IProFormaDescriptor() = default;
+
 		/** \brief  Key getter */
-		virtual ProFormaKey Key() = 0;
+		virtual ProFormaKey Key() const = 0;
 
         /** \brief The type of the evidence getter */
-        virtual ProFormaEvidenceType EvidenceType() = 0;
+        virtual ProFormaEvidenceType EvidenceType() const = 0;
 
         /** \brief The value getter. */
-        virtual std::string Value() = 0;
+        virtual const std::string& Value() const = 0;
 	};
 }
@@ -0,0 +1,243 @@
+#include "ProFormaAllocationStats.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <vector>
+
+using namespace ProForma;
+
+namespace {
+    // Counters of one thread, only the owning thread writes
+    struct AllocationBlock {
+        std::atomic<uint64_t> Allocations[ProFormaAllocationCategoryCount] = {};
+        std::atomic<uint64_t> Bytes[ProFormaAllocationCategoryCount] = {};
+        std::atomic<uint64_t> Terms{ 0 };
+        std::atomic<uint64_t> Writes{ 0 };
+
+        static void Increment(std::atomic<uint64_t>& counter, uint64_t value = 1)
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+
+        void AddTo(ProFormaAllocationSnapshot& snapshot) const
+        {
+            for (size_t i = 0; i < ProFormaAllocationCategoryCount; i++)
+            {
+                snapshot.Allocations[i] += Allocations[i].load(std::memory_order_relaxed);
+                snapshot.Bytes[i] += Bytes[i].load(std::memory_order_relaxed);
+            }
+            snapshot.Terms += Terms.load(std::memory_order_relaxed);
+            snapshot.Writes += Writes.load(std::memory_order_relaxed);
+        }
+    };
+
+    // Same scheme as the parser counters: blocks are never freed, the block of a finished thread goes
+    // to the next new thread
+    class AllocationRegistry {
+    public:
+        static AllocationRegistry& Instance()
+        {
+            // Leaked on purpose, threads may still allocate during the static destruction
+            static AllocationRegistry* registry = new AllocationRegistry();
+            return *registry;
+        }
+
+        AllocationBlock* Acquire()
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            if (!_free.empty())
+            {
+                AllocationBlock* block = _free.back();
+                _free.pop_back();
+                return block;
+            }
+
+            _all.push_back(new AllocationBlock());
+            return _all.back();
+        }
+
+        void Release(AllocationBlock* block)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _free.push_back(block);
+        }
+
+        ProFormaAllocationSnapshot Total()
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            ProFormaAllocationSnapshot snapshot;
+
+            for (auto block : _all)
+                block->AddTo(snapshot);
+
+            for (size_t i = 0; i < ProFormaAllocationCategoryCount; i++)
+            {
+                snapshot.Allocations[i] -= _baseline.Allocations[i];
+                snapshot.Bytes[i] -= _baseline.Bytes[i];
+            }
+            snapshot.Terms -= _baseline.Terms;
+            snapshot.Writes -= _baseline.Writes;
+            return snapshot;
+        }
+
+        void Reset()
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            ProFormaAllocationSnapshot snapshot;
+
+            for (auto block : _all)
+                block->AddTo(snapshot);
+
+            _baseline = snapshot;
+        }
+
+    private:
+        std::mutex _mutex;
+        std::vector<AllocationBlock*> _all;
+        std::vector<AllocationBlock*> _free;
+        ProFormaAllocationSnapshot _baseline;
+    };
+
+    // Category and block of the calling thread. Busy stops the counting while the registry itself
+    // allocates a block.
+    struct ThreadAllocations {
+        ProFormaAllocationCategory Category = ProFormaAllocationCategory::None;
+        bool Busy = false;
+        AllocationBlock* Block = nullptr;
+
+        AllocationBlock& Local()
+        {
+            if (Block == nullptr)
+            {
+                Busy = true;
+                Block = AllocationRegistry::Instance().Acquire();
+                Busy = false;
+            }
+            return *Block;
+        }
+
+        ~ThreadAllocations()
+        {
+            Category = ProFormaAllocationCategory::None;
+            if (Block != nullptr)
+                AllocationRegistry::Instance().Release(Block);
+            Block = nullptr;
+        }
+    };
+
+    thread_local ThreadAllocations _thread;
+}
+
+/*****************************************************************************/
+// PUBLIC
+/*****************************************************************************/
+
+ProFormaAllocationSnapshot ProFormaAllocationStats::Snapshot()
+{
+    return AllocationRegistry::Instance().Total();
+}
+
+void ProFormaAllocationStats::Reset()
+{
+    AllocationRegistry::Instance().Reset();
+}
+
+void ProFormaAllocationStats::Report(std::ostream& out, const ProFormaAllocationSnapshot& snapshot)
+{
+    char line[128];
+
+    snprintf(line, sizeof(line), "%-14s %14s %14s\n", "category", "allocs/term", "bytes/term");
+    out << line;
+
+    for (size_t i = 1; i < ProFormaAllocationCategoryCount; i++)
+    {
+        // The writer categories are per written term, the others per parsed term
+        bool writer = i == static_cast<size_t>(ProFormaAllocationCategory::WriterBuffer);
+        double terms = static_cast<double>(writer ? snapshot.Writes : snapshot.Terms);
+        if (terms == 0.0)
+            continue;
+
+        snprintf(line, sizeof(line), "%-14s %14.2f %14.1f\n", CategoryName(static_cast<ProFormaAllocationCategory>(i)),
+            static_cast<double>(snapshot.Allocations[i]) / terms, static_cast<double>(snapshot.Bytes[i]) / terms);
+        out << line;
+    }
+
+    if (snapshot.Terms > 0)
+    {
+        snprintf(line, sizeof(line), "%-14s %14.2f\n", "parse total", static_cast<double>(snapshot.ParserAllocations()) / static_cast<double>(snapshot.Terms));
+        out << line;
+    }
+}
+
+const char* ProFormaAllocationStats::CategoryName(ProFormaAllocationCategory category)
+{
+    switch (category)
+    {
+    case ProFormaAllocationCategory::None: return "none";
+    case ProFormaAllocationCategory::Sequence: return "sequence";
+    case ProFormaAllocationCategory::Tag: return "tag";
+    case ProFormaAllocationCategory::Descriptor: return "descriptor";
+    case ProFormaAllocationCategory::Group: return "group";
+    case ProFormaAllocationCategory::WriterBuffer: return "writer_buffer";
+    case ProFormaAllocationCategory::Other: return "other";
+    }
+    return "unknown";
+}
+
+void ProFormaAllocationStats::AddTerm()
+{
+    AllocationBlock::Increment(_thread.Local().Terms);
+}
+
+void ProFormaAllocationStats::AddWrite()
+{
+    AllocationBlock::Increment(_thread.Local().Writes);
+}
+
+ProFormaAllocationCategory ProFormaAllocationStats::Exchange(ProFormaAllocationCategory category)
+{
+    ProFormaAllocationCategory previous = _thread.Category;
+    _thread.Category = category;
+    return previous;
+}
+
+/*****************************************************************************/
+// GLOBAL OPERATOR NEW
+/*****************************************************************************/
+
+#if PROFORMA_ALLOCATION_TRACKING
+
+// The array and nothrow forms, and the sized delete, forward to these two
+void* operator new(std::size_t size)
+{
+    if (_thread.Category != ProFormaAllocationCategory::None && !_thread.Busy)
+    {
+        AllocationBlock& block = _thread.Local();
+        size_t category = static_cast<size_t>(_thread.Category);
+        AllocationBlock::Increment(block.Allocations[category]);
+        AllocationBlock::Increment(block.Bytes[category], size);
+    }
+
+    for (;;)
+    {
+        void* memory = std::malloc(size == 0 ? 1 : size);
+        if (memory != nullptr)
+            return memory;
+
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr)
+            throw std::bad_alloc();
+        handler();
+    }
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+#endif
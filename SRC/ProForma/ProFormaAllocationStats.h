@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#include "PlatformHelper.h"
+
+// Build option replacing the global operator new to attribute the allocations of the parser and the
+// writer, off by default, see ProFormaAllocationStats
+#ifndef PROFORMA_ALLOCATION_TRACKING
+#define PROFORMA_ALLOCATION_TRACKING 0
+#endif
+
+namespace ProForma {
+	/** @enum ProFormaAllocationCategory
+	 *  @brief Call sites of the allocations counted by ProFormaAllocationStats
+	 */
+	enum class ProFormaAllocationCategory {
+		/**< Outside the parser and the writer, not counted */
+		None = 0,
+
+		/**< Residues of the parsed chains */
+		Sequence = 1,
+
+		/**< Tags, their text and their place in the term */
+		Tag = 2,
+
+		/**< Descriptors of the tags */
+		Descriptor = 3,
+
+		/**< Tag groups and their members */
+		Group = 4,
+
+		/**< Output buffers and working memory of ProFormaWriter */
+		WriterBuffer = 5,
+
+		/**< Rest of a parse: builder, scratch buffers and the final term */
+		Other = 6
+	};
+
+	/** \brief  Number of ProFormaAllocationCategory values */
+	const size_t ProFormaAllocationCategoryCount = 7;
+
+	/**
+	 * \struct ProFormaAllocationSnapshot
+	 *
+	 * \brief Allocations counted since the last ProFormaAllocationStats::Reset().
+	 *
+	 */
+	struct ProFormaAllocationSnapshot {
+		/**< Calls to operator new, indexed by ProFormaAllocationCategory */
+		uint64_t Allocations[ProFormaAllocationCategoryCount] = {};
+
+		/**< Bytes requested, indexed by ProFormaAllocationCategory */
+		uint64_t Bytes[ProFormaAllocationCategoryCount] = {};
+
+		/**< Successful parses */
+		uint64_t Terms = 0;
+
+		/**< Terms written by ProFormaWriter */
+		uint64_t Writes = 0;
+
+		/** \brief  Allocations of a category */
+		uint64_t operator[](ProFormaAllocationCategory category) const { return Allocations[static_cast<size_t>(category)]; }
+
+		/** \brief  Allocations of the parser categories, every one but WriterBuffer */
+		uint64_t ParserAllocations() const
+		{
+			uint64_t total = 0;
+			for (size_t i = 0; i < ProFormaAllocationCategoryCount; i++)
+				total += i == static_cast<size_t>(ProFormaAllocationCategory::WriterBuffer) ? 0 : Allocations[i];
+			return total;
+		}
+	};
+
+	/**
+	 * \class ProFormaAllocationStats
+	 *
+	 * \brief Allocation counts of the parser and the writer by call site, in builds configured with
+	 *        PROFORMA_ALLOCATION_TRACKING=ON. Such builds replace the global operator new, which counts the
+	 *        calls made while a ProFormaAllocationScope is active on the thread into a per-thread block. In
+	 *        the default build nothing is counted and the scopes compile to nothing.
+	 *
+	 */
+	class EXPORT ProFormaAllocationStats {
+	public:
+		/** \brief  Whether the library was built with the allocation tracking */
+		static constexpr bool Enabled = PROFORMA_ALLOCATION_TRACKING != 0;
+
+		/** \brief  Sums the counts of every thread since the last Reset() */
+		static ProFormaAllocationSnapshot Snapshot();
+
+		/** \brief  Restarts the counts from zero */
+		static void Reset();
+
+		/** \brief  Prints the allocations and bytes per parsed term of every parser category, and per
+		  *         written term for the writer.
+		  * \param  out Stream receiving one line per category.
+		  * \param  snapshot Counts to report.
+		  * \return void
+		  */
+		static void Report(std::ostream& out, const ProFormaAllocationSnapshot& snapshot);
+
+		/** \brief  Lower case name of a category, e.g. "descriptor" */
+		static const char* CategoryName(ProFormaAllocationCategory category);
+
+		/** \brief  Counts a successful parse, used by the parser */
+		static void AddTerm();
+
+		/** \brief  Counts a written term, used by the writer */
+		static void AddWrite();
+
+		/** \brief  Category of the calling thread, returns the previous one. Used by ProFormaAllocationScope. */
+		static ProFormaAllocationCategory Exchange(ProFormaAllocationCategory category);
+	};
+
+	/**
+	 * \class ProFormaAllocationScope
+	 *
+	 * \brief Attributes the allocations of the calling thread to a category until the end of the scope,
+	 *        the previous category is restored on exit. Empty unless ProFormaAllocationStats::Enabled.
+	 *
+	 */
+	class ProFormaAllocationScope {
+	public:
+		explicit ProFormaAllocationScope(ProFormaAllocationCategory category)
+		{
+			if constexpr (ProFormaAllocationStats::Enabled)
+				_previous = ProFormaAllocationStats::Exchange(category);
+		}
+
+		~ProFormaAllocationScope()
+		{
+			if constexpr (ProFormaAllocationStats::Enabled)
+				ProFormaAllocationStats::Exchange(_previous);
+		}
+
+		ProFormaAllocationScope(const ProFormaAllocationScope&) = delete;
+		ProFormaAllocationScope& operator=(const ProFormaAllocationScope&) = delete;
+
+	private:
+		ProFormaAllocationCategory _previous = ProFormaAllocationCategory::None;
+	};
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "ProFormaKey.h"
+#include "ProFormaParseException.h"
+
+namespace ProForma {
+	/**
+	 * \brief Layout shared by ProFormaBinaryWriter and ProFormaBinaryReader.
+	 *
+	 *  stream  := magic "PFMB", version byte, flags byte (0), record*
+	 *  record  := varint payload length, payload
+	 *  payload := varint new string count, (varint length, bytes)*, term
+	 *  term    := varint length, sequence bytes
+	 *             varint count, (descriptors, varint count, target bytes)*      global modifications
+	 *             descriptors, descriptors, descriptors                         N-terminal, C-terminal, labile
+	 *             varint count, (varint start, varint end, descriptors)*        tags
+	 *             varint count, (zigzag varint count, descriptors)*             unlocalized tags
+	 *             varint count, (varint name, packed, flags, varint value,      tag groups
+	 *                            varint count, (varint start, varint end, [weight])*)*
+	 *  descriptors := varint count, (packed, varint value)*
+	 *  packed  := key in bits 0-3, evidence type in bits 4-7
+	 *  flags   := bit 0 changing value group, bit 1 members carry weights (8 bytes, IEEE 754 little endian)
+	 *
+	 *  Names and values are indexes in the string table of the stream, new strings are appended to it
+	 *  by the record that uses them first.
+	 */
+	namespace Binary {
+		const char Magic[4] = { 'P', 'F', 'M', 'B' };
+		const uint8_t Version = 1;
+		const size_t HeaderSize = 6;
+
+		const uint8_t GroupChanging = 0x01;
+		const uint8_t GroupWeights = 0x02;
+
+		inline void PutVarint(std::string& out, uint64_t value)
+		{
+			while (value >= 0x80)
+			{
+				out.push_back(static_cast<char>(value | 0x80));
+				value >>= 7;
+			}
+			out.push_back(static_cast<char>(value));
+		}
+
+		inline uint64_t ZigZag(int64_t value) { return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63); }
+		inline int64_t UnZigZag(uint64_t value) { return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1); }
+
+		inline uint8_t Pack(ProFormaKey key, ProFormaEvidenceType evidenceType)
+		{
+			return static_cast<uint8_t>(static_cast<int>(key) | (static_cast<int>(evidenceType) << 4));
+		}
+
+		inline ProFormaKey UnpackKey(uint8_t packed)
+		{
+			int key = packed & 0x0F;
+			if (key > static_cast<int>(ProFormaKey::Info))
+				throw new ProFormaParseException("Binary record has an unknown descriptor key %d.", key);
+			return static_cast<ProFormaKey>(key);
+		}
+
+		inline ProFormaEvidenceType UnpackEvidenceType(uint8_t packed)
+		{
+			int evidenceType = packed >> 4;
+			if (evidenceType > static_cast<int>(ProFormaEvidenceType::Brno))
+				throw new ProFormaParseException("Binary record has an unknown evidence type %d.", evidenceType);
+			return static_cast<ProFormaEvidenceType>(evidenceType);
+		}
+
+		inline void PutDouble(std::string& out, double value)
+		{
+			uint64_t bits;
+			memcpy(&bits, &value, sizeof(bits));
+			for (int i = 0; i < 8; i++)
+				out.push_back(static_cast<char>(bits >> (8 * i)));
+		}
+
+		/**
+		 * \brief Bounds checked cursor over a record payload, corrupted input raises ProFormaParseException.
+		 */
+		class Cursor {
+		public:
+			Cursor(const char* data, size_t length) : _current(reinterpret_cast<const uint8_t*>(data)), _end(_current + length) { }
+
+			bool AtEnd() const { return _current == _end; }
+
+			uint8_t Byte()
+			{
+				if (_current == _end)
+					throw new ProFormaParseException("Binary record is truncated.");
+				return *_current++;
+			}
+
+			uint64_t Varint()
+			{
+				uint64_t value = 0;
+				for (int shift = 0; shift < 64; shift += 7)
+				{
+					uint8_t byte = Byte();
+					value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+					if (!(byte & 0x80))
+						return value;
+				}
+				throw new ProFormaParseException("Binary record has an invalid varint.");
+			}
+
+			/** \brief  A varint bounded by the bytes left, for counts and lengths */
+			size_t Size()
+			{
+				uint64_t value = Varint();
+				if (value > static_cast<uint64_t>(_end - _current))
+					throw new ProFormaParseException("Binary record is truncated.");
+				return static_cast<size_t>(value);
+			}
+
+			const char* Bytes(size_t length)
+			{
+				if (length > static_cast<size_t>(_end - _current))
+					throw new ProFormaParseException("Binary record is truncated.");
+				const char* bytes = reinterpret_cast<const char*>(_current);
+				_current += length;
+				return bytes;
+			}
+
+			double Double()
+			{
+				const uint8_t* bytes = reinterpret_cast<const uint8_t*>(Bytes(8));
+				uint64_t bits = 0;
+				for (int i = 0; i < 8; i++)
+					bits |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+
+				double value;
+				memcpy(&value, &bits, sizeof(value));
+				return value;
+			}
+		private:
+			const uint8_t* _current;
+			const uint8_t* _end;
+		};
+	}
+}
@@ -0,0 +1,175 @@
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "ProFormaBinaryReader.h"
+#include "ProFormaBinaryFormat.h"
+#include "ProFormaTagGroupChangingValue.h"
+#include "ProFormaTermBuilder.h"
+
+using namespace ProForma;
+
+namespace {
+    // Largest piece of a record read at once, a corrupt length prefix cannot make the reader allocate more
+    // than what the stream actually holds plus one chunk
+    const size_t RecordChunkSize = 64 * 1024;
+
+    void CheckRange(size_t start, size_t end, size_t sequenceLength, const char* what)
+    {
+        if (start > end || end >= sequenceLength)
+            throw new ProFormaParseException("Binary record has %s at %zu-%zu, outside the %zu residues of the sequence.", what, start, end, sequenceLength);
+    }
+}
+
+/*****************************************************************************/
+// PUBLIC
+/*****************************************************************************/
+
+ProFormaBinaryReader::ProFormaBinaryReader(std::istream& stream)
+    : _stream(stream)
+{
+    char header[Binary::HeaderSize];
+
+    if (!_stream.read(header, sizeof(header)) || memcmp(header, Binary::Magic, sizeof(Binary::Magic)) != 0)
+        throw new ProFormaParseException("Not a ProForma binary stream.");
+
+    _version = static_cast<uint8_t>(header[4]);
+    if (_version == 0 || _version > Binary::Version)
+        throw new ProFormaParseException("Unsupported ProForma binary format version %d, this reader supports up to %d.", _version, Binary::Version);
+}
+
+bool ProFormaBinaryReader::Read(ProFormaTerm& term)
+{
+    // Length prefix, the end of the stream is only valid between records
+    uint64_t length = 0;
+    int shift = 0;
+    for (;; shift += 7)
+    {
+        int byte = _stream.get();
+        if (byte == std::char_traits<char>::eof())
+        {
+            if (shift == 0)
+                return false;
+            throw new ProFormaParseException("Binary stream is truncated.");
+        }
+
+        if (shift > 63)
+            throw new ProFormaParseException("Binary stream has an invalid record length.");
+
+        length |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            break;
+    }
+
+    // The length is not trusted, the record grows as its bytes are read
+    _record.clear();
+    while (_record.length() < length)
+    {
+        size_t offset = _record.length();
+        size_t chunk = static_cast<size_t>(std::min<uint64_t>(length - offset, RecordChunkSize));
+
+        _record.resize(offset + chunk);
+        if (!_stream.read(&_record[offset], static_cast<std::streamsize>(chunk)))
+            throw new ProFormaParseException("Binary stream is truncated.");
+    }
+
+    Binary::Cursor cursor(_record.data(), _record.length());
+
+    // Strings used for the first time
+    for (size_t count = cursor.Size(); count > 0; count--)
+    {
+        size_t size = cursor.Size();
+        _strings.emplace_back(cursor.Bytes(size), size);
+    }
+
+    ProFormaTermBuilder builder;
+
+    size_t sequenceLength = cursor.Size();
+    builder.SetSequence(std::string(cursor.Bytes(sequenceLength), sequenceLength));
+
+    for (size_t count = cursor.Size(); count > 0; count--)
+    {
+        auto descriptors = ReadDescriptors(cursor);
+        size_t targetCount = cursor.Size();
+        const char* targets = cursor.Bytes(targetCount);
+        builder.AddGlobalModification(std::move(descriptors), std::vector<char>(targets, targets + targetCount));
+    }
+
+    builder.SetNTerminalDescriptors(ReadDescriptors(cursor));
+    builder.SetCTerminalDescriptors(ReadDescriptors(cursor));
+    builder.SetLabileDescriptors(ReadDescriptors(cursor));
+
+    for (size_t count = cursor.Size(); count > 0; count--)
+    {
+        size_t start = static_cast<size_t>(cursor.Varint());
+        size_t end = static_cast<size_t>(cursor.Varint());
+        CheckRange(start, end, sequenceLength, "a tag");
+        builder.AddTag(start, end, ReadDescriptors(cursor));
+    }
+
+    for (size_t count = cursor.Size(); count > 0; count--)
+    {
+        int tagCount = static_cast<int>(Binary::UnZigZag(cursor.Varint()));
+        builder.AddUnlocalizedTag(tagCount, ReadDescriptors(cursor));
+    }
+
+    for (size_t count = cursor.Size(); count > 0; count--)
+    {
+        const std::string& name = ReadString(cursor);
+        uint8_t packed = cursor.Byte();
+        uint8_t flags = cursor.Byte();
+        const std::string& value = ReadString(cursor);
+
+        std::list<ProFormaMembershipDescriptor> members;
+        for (size_t memberCount = cursor.Size(); memberCount > 0; memberCount--)
+        {
+            size_t start = static_cast<size_t>(cursor.Varint());
+            size_t end = static_cast<size_t>(cursor.Varint());
+            CheckRange(start, end, sequenceLength, "a tag group member");
+            members.emplace_back(start, end, (flags & Binary::GroupWeights) ? cursor.Double() : 0.0);
+        }
+
+        if (builder.FindTagGroup(name))
+            throw new ProFormaParseException("Binary record has tag group %s twice.", name.c_str());
+
+        if (flags & Binary::GroupChanging)
+        {
+            auto group = new ProFormaTagGroupChangingValue(name, Binary::UnpackKey(packed), Binary::UnpackEvidenceType(packed), std::move(members));
+            group->SetValueFlux(value);
+            builder.AddTagGroup(group);
+        }
+        else
+            builder.AddTagGroup(new ProFormaTagGroup(name, Binary::UnpackKey(packed), Binary::UnpackEvidenceType(packed), value, std::move(members)));
+    }
+
+    if (!cursor.AtEnd())
+        throw new ProFormaParseException("Binary record is longer than the term it holds.");
+
+    term = std::move(builder).Build();
+    return true;
+}
+
+/*****************************************************************************/
+// PRIVATE
+/*****************************************************************************/
+
+std::list<ProFormaDescriptor> ProFormaBinaryReader::ReadDescriptors(Binary::Cursor& cursor)
+{
+    std::list<ProFormaDescriptor> descriptors;
+
+    for (size_t count = cursor.Size(); count > 0; count--)
+    {
+        uint8_t packed = cursor.Byte();
+        descriptors.emplace_back(Binary::UnpackKey(packed), Binary::UnpackEvidenceType(packed), ReadString(cursor));
+    }
+
+    return descriptors;
+}
+
+const std::string& ProFormaBinaryReader::ReadString(Binary::Cursor& cursor)
+{
+    uint64_t index = cursor.Varint();
+    if (index >= _strings.size())
+        throw new ProFormaParseException("Binary record refers to unknown string %llu.", static_cast<unsigned long long>(index));
+    return _strings[static_cast<size_t>(index)];
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "PlatformHelper.h"
+
+#include "ProFormaTerm.h"
+
+namespace ProForma {
+	namespace Binary { class Cursor; }
+
+	/**
+	 * \class ProFormaBinaryReader
+	 *
+	 * \brief Reads back the ProFormaTerm objects written by ProFormaBinaryWriter, record by record.
+	 *        A bad header, a newer format version or a corrupted record raises a ProFormaParseException.
+	 *
+	 */
+	class EXPORT ProFormaBinaryReader {
+	public:
+        /** \brief  Initializes a reader and checks the stream header
+		  * \param  stream The input stream, opened in binary mode.
+		  * \return void
+		  */
+        explicit ProFormaBinaryReader(std::istream& stream);
+
+        /** \brief  Reads the next term
+		  * \param  term Receives the term.
+		  * \return false at the end of the stream
+		  */
+        bool Read(ProFormaTerm& term);
+
+        /** \brief  Format version found in the stream header. */
+        uint8_t Version() const { return _version; }
+    private:
+        std::list<ProFormaDescriptor> ReadDescriptors(Binary::Cursor& cursor);
+        const std::string& ReadString(Binary::Cursor& cursor);
+
+        std::istream& _stream;
+        std::vector<std::string> _strings;
+        std::string _record;
+        uint8_t _version = 0;
+	};
+}
@@ -0,0 +1,119 @@
+#include "ProFormaBinaryWriter.h"
+#include "ProFormaBinaryFormat.h"
+
+using namespace ProForma;
+
+/*****************************************************************************/
+// PUBLIC
+/*****************************************************************************/
+
+ProFormaBinaryWriter::ProFormaBinaryWriter(std::ostream& stream)
+    : _stream(stream)
+{
+    char header[Binary::HeaderSize] = { Binary::Magic[0], Binary::Magic[1], Binary::Magic[2], Binary::Magic[3], static_cast<char>(Binary::Version), 0 };
+    _stream.write(header, sizeof(header));
+}
+
+void ProFormaBinaryWriter::Write(const ProFormaTerm& term)
+{
+    _body.clear();
+    _newStrings.clear();
+    _newStringCount = 0;
+
+    // Sequence bytes as they are
+    Binary::PutVarint(_body, term.Sequence().length());
+    _body.append(term.Sequence());
+
+    Binary::PutVarint(_body, term.GlobalModifications().size());
+    for (auto& modification : term.GlobalModifications())
+    {
+        WriteDescriptors(modification.Descriptors());
+        Binary::PutVarint(_body, modification.TargetAminoAcids().size());
+        _body.append(modification.TargetAminoAcids().data(), modification.TargetAminoAcids().size());
+    }
+
+    WriteDescriptors(term.NTerminalDescriptors());
+    WriteDescriptors(term.CTerminalDescriptors());
+    WriteDescriptors(term.LabileDescriptors());
+
+    Binary::PutVarint(_body, term.Tags().size());
+    for (auto& tag : term.Tags())
+    {
+        Binary::PutVarint(_body, tag.ZeroBasedStartIndex());
+        Binary::PutVarint(_body, tag.ZeroBasedEndIndex());
+        WriteDescriptors(tag.Descriptors());
+    }
+
+    Binary::PutVarint(_body, term.UnlocalizedTags().size());
+    for (auto& tag : term.UnlocalizedTags())
+    {
+        Binary::PutVarint(_body, Binary::ZigZag(tag.Count()));
+        WriteDescriptors(tag.Descriptors());
+    }
+
+    Binary::PutVarint(_body, term.TagGroups().size());
+    for (auto& item : term.TagGroups())
+    {
+        const ProFormaTagGroup* group = item.second;
+
+        bool hasWeights = false;
+        for (auto& member : group->Members())
+            hasWeights = hasWeights || member.Weight() != 0.0;
+
+        WriteString(group->Name());
+        _body.push_back(static_cast<char>(Binary::Pack(group->Key(), group->EvidenceType())));
+        _body.push_back(static_cast<char>((group->IsChanging() ? Binary::GroupChanging : 0) | (hasWeights ? Binary::GroupWeights : 0)));
+        WriteString(group->Value());
+
+        Binary::PutVarint(_body, group->Members().size());
+        for (auto& member : group->Members())
+        {
+            Binary::PutVarint(_body, member.ZeroBasedStartIndex());
+            Binary::PutVarint(_body, member.ZeroBasedEndIndex());
+            if (hasWeights)
+                Binary::PutDouble(_body, member.Weight());
+        }
+    }
+
+    // Record: length prefix, strings seen for the first time, then the term
+    _record.clear();
+    Binary::PutVarint(_record, _newStringCount);
+    _record.append(_newStrings);
+
+    std::string prefix;
+    Binary::PutVarint(prefix, _record.length() + _body.length());
+
+    _stream.write(prefix.data(), prefix.length());
+    _stream.write(_record.data(), _record.length());
+    _stream.write(_body.data(), _body.length());
+    _termCount++;
+}
+
+/*****************************************************************************/
+// PRIVATE
+/*****************************************************************************/
+
+void ProFormaBinaryWriter::WriteDescriptors(const std::list<ProFormaDescriptor>& descriptors)
+{
+    Binary::PutVarint(_body, descriptors.size());
+    for (auto& descriptor : descriptors)
+    {
+        _body.push_back(static_cast<char>(Binary::Pack(descriptor.Key(), descriptor.EvidenceType())));
+        WriteString(descriptor.Value());
+    }
+}
+
+void ProFormaBinaryWriter::WriteString(const std::string& text)
+{
+    auto item = _strings.find(text);
+    if (item == _strings.end())
+    {
+        // First use in the stream, the record carries the text
+        item = _strings.emplace(text, static_cast<uint32_t>(_strings.size())).first;
+        Binary::PutVarint(_newStrings, text.length());
+        _newStrings.append(text);
+        _newStringCount++;
+    }
+
+    Binary::PutVarint(_body, item->second);
+}
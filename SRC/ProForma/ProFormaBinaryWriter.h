@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+
+#include "PlatformHelper.h"
+
+#include "ProFormaTerm.h"
+
+namespace ProForma {
+	/**
+	 * \class ProFormaBinaryWriter
+	 *
+	 * \brief Writes ProFormaTerm objects to a stream in the compact binary format read by ProFormaBinaryReader.
+	 *        Sequences are stored as they are, positions and counts as varints, descriptor key and evidence
+	 *        type packed in one byte, and names and values as references into a string table kept for the
+	 *        whole stream. See ProFormaBinaryFormat.h for the layout.
+	 *
+	 */
+	class EXPORT ProFormaBinaryWriter {
+	public:
+        /** \brief  Initializes a writer and writes the stream header
+		  * \param  stream The output stream, opened in binary mode.
+		  * \return void
+		  */
+        explicit ProFormaBinaryWriter(std::ostream& stream);
+
+        /** \brief  Appends a term as one record
+		  * \param  term The term.
+		  * \return void
+		  */
+        void Write(const ProFormaTerm& term);
+
+        /** \brief  Number of terms written so far. */
+        size_t TermCount() const { return _termCount; }
+    private:
+        void WriteDescriptors(const std::list<ProFormaDescriptor>& descriptors);
+        void WriteString(const std::string& text);
+
+        std::ostream& _stream;
+        std::unordered_map<std::string, uint32_t> _strings;
+        std::string _newStrings;
+        size_t _newStringCount = 0;
+        std::string _body;
+        std::string _record;
+        size_t _termCount = 0;
+	};
+}
@@ -0,0 +1,624 @@
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <tuple>
+#include <vector>
+
+#include "ProFormaCanonicalizer.h"
+#include "ProFormaBinaryFormat.h"
+#include "ProFormaTagGroupChangingValue.h"
+#include "ProFormaTermBuilder.h"
+
+using namespace ProForma;
+
+namespace {
+    // Streaming 64-bit hash, xxHash64 style rounds over 8 byte words and a murmur finalizer
+    class HashSink {
+    public:
+        void Byte(uint8_t value) { Number(value); }
+
+        void Number(uint64_t value)
+        {
+            _state ^= value * 0xC2B2AE3D27D4EB4Full;
+            _state = ((_state << 31) | (_state >> 33)) * 0x9E3779B185EBCA87ull;
+            _count++;
+        }
+
+        void Text(std::string_view text)
+        {
+            Number(text.length());
+
+            size_t i = 0;
+            for (; i + 8 <= text.length(); i += 8)
+            {
+                uint64_t word;
+                memcpy(&word, text.data() + i, sizeof(word));
+                Number(word);
+            }
+
+            uint64_t tail = 0;
+            memcpy(&tail, text.data() + i, text.length() - i);
+            Number(tail);
+        }
+
+        uint64_t Final() const
+        {
+            uint64_t hash = _state ^ _count;
+            hash ^= hash >> 33;
+            hash *= 0xFF51AFD7ED558CCDull;
+            hash ^= hash >> 33;
+            hash *= 0xC4CEB9FE1A85EC53ull;
+            hash ^= hash >> 33;
+            return hash;
+        }
+    private:
+        uint64_t _state = 0x27D4EB2F165667C5ull;
+        uint64_t _count = 0;
+    };
+
+    // Byte encoding of the same stream, numbers big endian so encodings sort by their leading numbers
+    struct BufferSink {
+        std::string& Out;
+
+        void Byte(uint8_t value) { Out.push_back(static_cast<char>(value)); }
+
+        void Number(uint64_t value)
+        {
+            char bytes[8];
+            for (int i = 0; i < 8; i++)
+                bytes[i] = static_cast<char>(value >> (8 * (7 - i)));
+            Out.append(bytes, sizeof(bytes));
+        }
+
+        void Text(std::string_view text)
+        {
+            Number(text.length());
+            Out.append(text.data(), text.length());
+        }
+    };
+
+    uint64_t WeightBits(double weight)
+    {
+        // -0.0 and 0.0 are the same weight
+        if (weight == 0.0)
+            weight = 0.0;
+
+        uint64_t bits;
+        memcpy(&bits, &weight, sizeof(bits));
+        return bits;
+    }
+
+    bool DescriptorLess(const ProFormaDescriptor& left, const ProFormaDescriptor& right)
+    {
+        if (left.Key() != right.Key())
+            return left.Key() < right.Key();
+        if (left.EvidenceType() != right.EvidenceType())
+            return left.EvidenceType() < right.EvidenceType();
+        return left.Value() < right.Value();
+    }
+
+    bool DescriptorEqual(const ProFormaDescriptor& left, const ProFormaDescriptor& right)
+    {
+        return left.Key() == right.Key() && left.EvidenceType() == right.EvidenceType() && left.Value() == right.Value();
+    }
+
+    bool DescriptorsLess(const std::list<ProFormaDescriptor>& left, const std::list<ProFormaDescriptor>& right)
+    {
+        return std::lexicographical_compare(left.begin(), left.end(), right.begin(), right.end(), DescriptorLess);
+    }
+
+    bool DescriptorsEqual(const std::list<ProFormaDescriptor>& left, const std::list<ProFormaDescriptor>& right)
+    {
+        return left.size() == right.size() && std::equal(left.begin(), left.end(), right.begin(), DescriptorEqual);
+    }
+
+    // Same spelling, element by element. Terms parsed from the same string take this path.
+    bool SpelledAlike(const ProFormaTerm& left, const ProFormaTerm& right)
+    {
+        if (left.Sequence() != right.Sequence()
+            || !DescriptorsEqual(left.NTerminalDescriptors(), right.NTerminalDescriptors())
+            || !DescriptorsEqual(left.CTerminalDescriptors(), right.CTerminalDescriptors())
+            || !DescriptorsEqual(left.LabileDescriptors(), right.LabileDescriptors())
+            || left.Tags().size() != right.Tags().size()
+            || left.GlobalModifications().size() != right.GlobalModifications().size()
+            || left.UnlocalizedTags().size() != right.UnlocalizedTags().size()
+            || left.TagGroups().size() != right.TagGroups().size())
+            return false;
+
+        auto tagEqual = [](const ProFormaTag& first, const ProFormaTag& second)
+        {
+            return first.ZeroBasedStartIndex() == second.ZeroBasedStartIndex() && first.ZeroBasedEndIndex() == second.ZeroBasedEndIndex()
+                && DescriptorsEqual(first.Descriptors(), second.Descriptors());
+        };
+        auto globalEqual = [](const ProFormaGlobalModification& first, const ProFormaGlobalModification& second)
+        {
+            return first.TargetAminoAcids() == second.TargetAminoAcids() && DescriptorsEqual(first.Descriptors(), second.Descriptors());
+        };
+        auto unlocalizedEqual = [](const ProFormaUnlocalizedTag& first, const ProFormaUnlocalizedTag& second)
+        {
+            return first.Count() == second.Count() && DescriptorsEqual(first.Descriptors(), second.Descriptors());
+        };
+        auto memberEqual = [](const ProFormaMembershipDescriptor& first, const ProFormaMembershipDescriptor& second)
+        {
+            return first.ZeroBasedStartIndex() == second.ZeroBasedStartIndex() && first.ZeroBasedEndIndex() == second.ZeroBasedEndIndex()
+                && first.Weight() == second.Weight();
+        };
+        auto groupEqual = [&memberEqual](const std::pair<const std::string, ProFormaTagGroup*>& first, const std::pair<const std::string, ProFormaTagGroup*>& second)
+        {
+            const ProFormaTagGroup* a = first.second;
+            const ProFormaTagGroup* b = second.second;
+            return first.first == second.first && a->Key() == b->Key() && a->EvidenceType() == b->EvidenceType() && a->Value() == b->Value()
+                && a->IsChanging() == b->IsChanging() && a->Members().size() == b->Members().size()
+                && std::equal(a->Members().begin(), a->Members().end(), b->Members().begin(), memberEqual);
+        };
+
+        return std::equal(left.Tags().begin(), left.Tags().end(), right.Tags().begin(), tagEqual)
+            && std::equal(left.GlobalModifications().begin(), left.GlobalModifications().end(), right.GlobalModifications().begin(), globalEqual)
+            && std::equal(left.UnlocalizedTags().begin(), left.UnlocalizedTags().end(), right.UnlocalizedTags().begin(), unlocalizedEqual)
+            && std::equal(left.TagGroups().begin(), left.TagGroups().end(), right.TagGroups().begin(), groupEqual);
+    }
+}
+
+/**
+ * \brief Per-thread buffers of the canonical walk. Strings handed out stay valid until the next Reset,
+ *        lists are leased and given back in reverse order.
+ */
+struct ProFormaCanonicalizer::Scratch {
+    std::deque<std::string> Strings;
+    size_t StringsUsed = 0;
+    std::deque<std::vector<std::string_view>> Lists;
+    size_t ListsUsed = 0;
+    std::vector<std::pair<std::string_view, int64_t>> Counts;
+
+    void Reset()
+    {
+        StringsUsed = 0;
+        ListsUsed = 0;
+    }
+
+    std::string& NextString()
+    {
+        if (StringsUsed == Strings.size())
+            Strings.emplace_back();
+
+        std::string& text = Strings[StringsUsed++];
+        text.clear();
+        return text;
+    }
+
+    /** \brief  Encoded elements of one list, sorted before they are written */
+    struct List {
+        Scratch& Owner;
+        std::vector<std::string_view>& Items;
+
+        explicit List(Scratch& owner) : Owner(owner), Items(Acquire(owner)) { }
+        ~List() { Owner.ListsUsed--; }
+
+        template <typename Sink>
+        void Write(Sink& sink, bool unique)
+        {
+            std::sort(Items.begin(), Items.end());
+            if (unique)
+                Items.erase(std::unique(Items.begin(), Items.end()), Items.end());
+
+            sink.Number(Items.size());
+            for (auto& item : Items)
+                sink.Text(item);
+        }
+    private:
+        static std::vector<std::string_view>& Acquire(Scratch& owner)
+        {
+            if (owner.ListsUsed == owner.Lists.size())
+                owner.Lists.emplace_back();
+
+            std::vector<std::string_view>& items = owner.Lists[owner.ListsUsed++];
+            items.clear();
+            return items;
+        }
+    };
+};
+
+/*****************************************************************************/
+// PUBLIC
+/*****************************************************************************/
+
+void ProFormaCanonicalizer::AddSynonym(const ProFormaDescriptor& synonym, const ProFormaDescriptor& canonical)
+{
+    std::string buffer;
+    auto from = Normalize(synonym.Key(), synonym.EvidenceType(), synonym.Value(), buffer);
+    std::string key(1, static_cast<char>(from.first));
+    key.append(from.second.data(), from.second.length());
+
+    auto to = Normalize(canonical.Key(), canonical.EvidenceType(), canonical.Value(), buffer);
+    _synonyms[key] = std::make_pair(to.first, std::string(to.second));
+}
+
+ProFormaTerm ProFormaCanonicalizer::Canonicalize(const ProFormaTerm& term) const
+{
+    std::string buffer;
+
+    auto canonical = [this, &buffer](const std::list<ProFormaDescriptor>& descriptors)
+    {
+        std::vector<ProFormaDescriptor> items;
+        for (auto& descriptor : descriptors)
+        {
+            auto normalized = Normalize(descriptor.Key(), descriptor.EvidenceType(), descriptor.Value(), buffer);
+            items.emplace_back(Binary::UnpackKey(normalized.first), Binary::UnpackEvidenceType(normalized.first), std::string(normalized.second));
+        }
+
+        std::sort(items.begin(), items.end(), DescriptorLess);
+        items.erase(std::unique(items.begin(), items.end(), DescriptorEqual), items.end());
+        return std::list<ProFormaDescriptor>(std::make_move_iterator(items.begin()), std::make_move_iterator(items.end()));
+    };
+
+    ProFormaTermBuilder builder;
+    builder.SetSequence(term.Sequence());
+
+    // Global modifications with sorted targets, duplicates dropped
+    std::vector<std::pair<std::list<ProFormaDescriptor>, std::vector<char>>> globals;
+    for (auto& modification : term.GlobalModifications())
+    {
+        std::vector<char> targets = modification.TargetAminoAcids();
+        std::sort(targets.begin(), targets.end());
+        targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
+        globals.emplace_back(canonical(modification.Descriptors()), std::move(targets));
+    }
+
+    auto globalLess = [](const auto& left, const auto& right)
+    {
+        return DescriptorsLess(left.first, right.first) || (DescriptorsEqual(left.first, right.first) && left.second < right.second);
+    };
+    auto globalEqual = [](const auto& left, const auto& right) { return DescriptorsEqual(left.first, right.first) && left.second == right.second; };
+
+    std::sort(globals.begin(), globals.end(), globalLess);
+    globals.erase(std::unique(globals.begin(), globals.end(), globalEqual), globals.end());
+    for (auto& modification : globals)
+        builder.AddGlobalModification(std::move(modification.first), std::move(modification.second));
+
+    builder.SetNTerminalDescriptors(canonical(term.NTerminalDescriptors()));
+    builder.SetCTerminalDescriptors(canonical(term.CTerminalDescriptors()));
+    builder.SetLabileDescriptors(canonical(term.LabileDescriptors()));
+
+    // Tags by position, then by descriptors
+    std::vector<std::tuple<size_t, size_t, std::list<ProFormaDescriptor>>> tags;
+    for (auto& tag : term.Tags())
+        tags.emplace_back(tag.ZeroBasedStartIndex(), tag.ZeroBasedEndIndex(), canonical(tag.Descriptors()));
+
+    std::sort(tags.begin(), tags.end(), [](const auto& left, const auto& right)
+    {
+        if (std::get<0>(left) != std::get<0>(right))
+            return std::get<0>(left) < std::get<0>(right);
+        if (std::get<1>(left) != std::get<1>(right))
+            return std::get<1>(left) < std::get<1>(right);
+        return DescriptorsLess(std::get<2>(left), std::get<2>(right));
+    });
+    for (auto& tag : tags)
+        builder.AddTag(std::get<0>(tag), std::get<1>(tag), std::move(std::get<2>(tag)));
+
+    // Unlocalized tags with the same descriptors are merged, [Phospho]?[Phospho]? is [Phospho]^2?
+    std::vector<std::pair<std::list<ProFormaDescriptor>, int>> unlocalized;
+    for (auto& tag : term.UnlocalizedTags())
+        unlocalized.emplace_back(canonical(tag.Descriptors()), tag.Count());
+
+    std::stable_sort(unlocalized.begin(), unlocalized.end(), [](const auto& left, const auto& right) { return DescriptorsLess(left.first, right.first); });
+    for (size_t i = 0; i < unlocalized.size(); i++)
+    {
+        int count = unlocalized[i].second;
+        while (i + 1 < unlocalized.size() && DescriptorsEqual(unlocalized[i].first, unlocalized[i + 1].first))
+            count += unlocalized[++i].second;
+        builder.AddUnlocalizedTag(count, std::move(unlocalized[i].first));
+    }
+
+    // Tag groups with sorted members, ordered and renamed by their first position. Groups without members come
+    // first, groups at the same position are ordered by key, evidence type, value and then their original name
+    struct Group {
+        ProFormaDescriptor Descriptor;
+        bool IsChanging;
+        std::vector<ProFormaMembershipDescriptor> Members;
+        const std::string* Name;
+    };
+
+    std::vector<Group> groups;
+    for (auto& item : term.TagGroups())
+    {
+        const ProFormaTagGroup* group = item.second;
+        auto normalized = Normalize(group->Key(), group->EvidenceType(), group->Value(), buffer);
+
+        Group canonicalGroup{ ProFormaDescriptor(Binary::UnpackKey(normalized.first), Binary::UnpackEvidenceType(normalized.first), std::string(normalized.second)),
+            group->IsChanging(), std::vector<ProFormaMembershipDescriptor>(group->Members().begin(), group->Members().end()), &group->Name() };
+
+        std::sort(canonicalGroup.Members.begin(), canonicalGroup.Members.end(), [](const ProFormaMembershipDescriptor& left, const ProFormaMembershipDescriptor& right)
+        {
+            return std::make_tuple(left.ZeroBasedStartIndex(), left.ZeroBasedEndIndex(), left.Weight())
+                < std::make_tuple(right.ZeroBasedStartIndex(), right.ZeroBasedEndIndex(), right.Weight());
+        });
+        groups.push_back(std::move(canonicalGroup));
+    }
+
+    std::sort(groups.begin(), groups.end(), [](const Group& left, const Group& right)
+    {
+        if (left.Members.empty() != right.Members.empty())
+            return left.Members.empty();
+
+        if (!left.Members.empty())
+        {
+            auto& first = left.Members.front();
+            auto& second = right.Members.front();
+            if (first.ZeroBasedStartIndex() != second.ZeroBasedStartIndex())
+                return first.ZeroBasedStartIndex() < second.ZeroBasedStartIndex();
+            if (first.ZeroBasedEndIndex() != second.ZeroBasedEndIndex())
+                return first.ZeroBasedEndIndex() < second.ZeroBasedEndIndex();
+        }
+
+        if (!DescriptorEqual(left.Descriptor, right.Descriptor))
+            return DescriptorLess(left.Descriptor, right.Descriptor);
+        if (left.IsChanging != right.IsChanging)
+            return left.IsChanging < right.IsChanging;
+        return *left.Name < *right.Name;
+    });
+
+    for (size_t i = 0; i < groups.size(); i++)
+    {
+        std::string name = "g" + std::to_string(i + 1);
+        std::list<ProFormaMembershipDescriptor> members(groups[i].Members.begin(), groups[i].Members.end());
+        const ProFormaDescriptor& descriptor = groups[i].Descriptor;
+
+        if (groups[i].IsChanging)
+        {
+            auto group = new ProFormaTagGroupChangingValue(std::move(name), descriptor.Key(), descriptor.EvidenceType(), std::move(members));
+            group->SetValueFlux(descriptor.Value());
+            builder.AddTagGroup(group);
+        }
+        else
+            builder.AddTagGroup(new ProFormaTagGroup(std::move(name), descriptor.Key(), descriptor.EvidenceType(), descriptor.Value(), std::move(members)));
+    }
+
+    return std::move(builder).Build();
+}
+
+uint64_t ProFormaCanonicalizer::Hash(const ProFormaTerm& term) const
+{
+    static thread_local Scratch scratch;
+    scratch.Reset();
+
+    HashSink sink;
+    WriteTerm(sink, term, scratch);
+    return sink.Final();
+}
+
+bool ProFormaCanonicalizer::Equivalent(const ProFormaTerm& left, const ProFormaTerm& right) const
+{
+    // Canonicalization never touches the sequence
+    if (left.Sequence() != right.Sequence())
+        return false;
+    if (SpelledAlike(left, right))
+        return true;
+
+    static thread_local Scratch scratch;
+    static thread_local std::string leftText, rightText;
+
+    scratch.Reset();
+    leftText.clear();
+    BufferSink leftSink{ leftText };
+    WriteTerm(leftSink, left, scratch);
+
+    scratch.Reset();
+    rightText.clear();
+    BufferSink rightSink{ rightText };
+    WriteTerm(rightSink, right, scratch);
+
+    return leftText == rightText;
+}
+
+const ProFormaCanonicalizer& ProFormaCanonicalizer::Default()
+{
+    static const ProFormaCanonicalizer canonicalizer;
+    return canonicalizer;
+}
+
+bool ProForma::operator==(const ProFormaTerm& left, const ProFormaTerm& right)
+{
+    return ProFormaCanonicalizer::Default().Equivalent(left, right);
+}
+
+/*****************************************************************************/
+// PRIVATE
+/*****************************************************************************/
+
+template <typename Sink>
+void ProFormaCanonicalizer::WriteTerm(Sink& sink, const ProFormaTerm& term, Scratch& scratch) const
+{
+    sink.Text(term.Sequence());
+
+    // Most lists are empty, they are written without leasing scratch space
+    if (term.GlobalModifications().empty())
+        sink.Number(0);
+    else
+    {
+        Scratch::List list(scratch);
+        for (auto& modification : term.GlobalModifications())
+        {
+            std::string& encoded = scratch.NextString();
+            BufferSink out{ encoded };
+            WriteDescriptors(out, modification.Descriptors(), scratch);
+
+            std::string& targets = scratch.NextString();
+            targets.assign(modification.TargetAminoAcids().begin(), modification.TargetAminoAcids().end());
+            std::sort(targets.begin(), targets.end());
+            targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
+            out.Text(targets);
+
+            list.Items.push_back(encoded);
+        }
+        list.Write(sink, true);
+    }
+
+    WriteDescriptors(sink, term.NTerminalDescriptors(), scratch);
+    WriteDescriptors(sink, term.CTerminalDescriptors(), scratch);
+    WriteDescriptors(sink, term.LabileDescriptors(), scratch);
+
+    if (term.Tags().empty())
+        sink.Number(0);
+    else
+    {
+        Scratch::List list(scratch);
+        for (auto& tag : term.Tags())
+        {
+            std::string& encoded = scratch.NextString();
+            BufferSink out{ encoded };
+            out.Number(tag.ZeroBasedStartIndex());
+            out.Number(tag.ZeroBasedEndIndex());
+            WriteDescriptors(out, tag.Descriptors(), scratch);
+            list.Items.push_back(encoded);
+        }
+        list.Write(sink, false);
+    }
+
+    // Unlocalized tags, counts of equal descriptors summed
+    if (term.UnlocalizedTags().empty())
+        sink.Number(0);
+    else
+    {
+        scratch.Counts.clear();
+        for (auto& tag : term.UnlocalizedTags())
+        {
+            std::string& encoded = scratch.NextString();
+            BufferSink out{ encoded };
+            WriteDescriptors(out, tag.Descriptors(), scratch);
+            scratch.Counts.emplace_back(encoded, tag.Count());
+        }
+
+        std::sort(scratch.Counts.begin(), scratch.Counts.end());
+        size_t merged = 0;
+        for (size_t i = 0; i < scratch.Counts.size(); i++)
+        {
+            if (merged > 0 && scratch.Counts[merged - 1].first == scratch.Counts[i].first)
+                scratch.Counts[merged - 1].second += scratch.Counts[i].second;
+            else
+                scratch.Counts[merged++] = scratch.Counts[i];
+        }
+
+        sink.Number(merged);
+        for (size_t i = 0; i < merged; i++)
+        {
+            sink.Text(scratch.Counts[i].first);
+            sink.Number(Binary::ZigZag(scratch.Counts[i].second));
+        }
+    }
+
+    // Tag groups without their names
+    if (term.TagGroups().empty())
+        sink.Number(0);
+    else
+    {
+        Scratch::List list(scratch);
+        for (auto& item : term.TagGroups())
+        {
+            const ProFormaTagGroup* group = item.second;
+
+            std::string& encoded = scratch.NextString();
+            std::string& buffer = scratch.NextString();
+            BufferSink out{ encoded };
+
+            auto normalized = Normalize(group->Key(), group->EvidenceType(), group->Value(), buffer);
+            out.Byte(normalized.first);
+            out.Text(normalized.second);
+            out.Byte(group->IsChanging() ? 1 : 0);
+
+            Scratch::List members(scratch);
+            for (auto& member : group->Members())
+            {
+                std::string& memberEncoded = scratch.NextString();
+                BufferSink memberOut{ memberEncoded };
+                memberOut.Number(member.ZeroBasedStartIndex());
+                memberOut.Number(member.ZeroBasedEndIndex());
+                memberOut.Number(WeightBits(member.Weight()));
+                members.Items.push_back(memberEncoded);
+            }
+            members.Write(out, false);
+
+            list.Items.push_back(encoded);
+        }
+        list.Write(sink, false);
+    }
+}
+
+template <typename Sink>
+void ProFormaCanonicalizer::WriteDescriptors(Sink& sink, const std::list<ProFormaDescriptor>& descriptors, Scratch& scratch) const
+{
+    if (descriptors.empty())
+    {
+        sink.Number(0);
+        return;
+    }
+
+    Scratch::List list(scratch);
+
+    for (auto& descriptor : descriptors)
+    {
+        std::string& buffer = scratch.NextString();
+        std::string& encoded = scratch.NextString();
+
+        auto normalized = Normalize(descriptor.Key(), descriptor.EvidenceType(), descriptor.Value(), buffer);
+        BufferSink out{ encoded };
+        out.Byte(normalized.first);
+        out.Text(normalized.second);
+        list.Items.push_back(encoded);
+    }
+
+    list.Write(sink, true);
+}
+
+std::pair<uint8_t, std::string_view> ProFormaCanonicalizer::Normalize(ProFormaKey key, ProFormaEvidenceType evidenceType, const std::string& value, std::string& buffer) const
+{
+    uint8_t packed = Binary::Pack(key, evidenceType);
+    std::string_view text = value;
+
+    if (key == ProFormaKey::Mass)
+    {
+        // Explicit sign and the shortest digits that read back the same number
+        char* end = nullptr;
+        double mass = strtod(value.c_str(), &end);
+        if (end != value.c_str() && *end == '\0')
+        {
+            if (mass == 0.0)
+                mass = 0.0;
+
+            char digits[32];
+            auto result = std::to_chars(digits, digits + sizeof(digits), mass);
+
+            buffer.clear();
+            if (mass >= 0.0)
+                buffer.push_back('+');
+            buffer.append(digits, result.ptr);
+            text = buffer;
+        }
+    }
+    else if (key == ProFormaKey::Identifier)
+    {
+        // Ontology prefixes in upper case, mod:00719 is MOD:00719
+        size_t colon = value.find(':');
+        if (colon != std::string::npos && std::any_of(value.begin(), value.begin() + colon, [](char c) { return islower(static_cast<unsigned char>(c)) != 0; }))
+        {
+            buffer = value;
+            std::transform(buffer.begin(), buffer.begin() + colon, buffer.begin(), [](char c) { return static_cast<char>(toupper(static_cast<unsigned char>(c))); });
+            text = buffer;
+        }
+    }
+
+    if (!_synonyms.empty())
+    {
+        static thread_local std::string lookup;
+        lookup.assign(1, static_cast<char>(packed));
+        lookup.append(text.data(), text.length());
+
+        auto item = _synonyms.find(lookup);
+        if (item != _synonyms.end())
+            return std::make_pair(item->second.first, std::string_view(item->second.second));
+    }
+
+    return std::make_pair(packed, text);
+}
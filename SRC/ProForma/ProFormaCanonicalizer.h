@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+#include "PlatformHelper.h"
+
+#include "ProFormaTerm.h"
+
+namespace ProForma {
+	/**
+	 * \class ProFormaCanonicalizer
+	 *
+	 * \brief Brings the different spellings of a proteoform to a single form. Within a term the descriptors
+	 *        of a list, the tags, the global modifications, the unlocalized tags (equal ones are merged)
+	 *        and the group members are sorted, mass shifts and identifier prefixes are normalized
+	 *        (+79.9660 and 79.966 are +79.966, mod:00719 is MOD:00719) and tag groups are renamed
+	 *        g1, g2, ... by their first position. Synonyms that need an ontology, such as U:Phospho and
+	 *        UNIMOD:21, are mapped through AddSynonym.
+	 *
+	 *        Hash and Equivalent work on the canonical form without building it, the elements of every
+	 *        list are encoded in per-thread scratch buffers and fed in sorted order to a streaming
+	 *        64-bit hash.
+	 *
+	 */
+	class EXPORT ProFormaCanonicalizer {
+	public:
+        /** \brief  Initializes a canonicalizer without synonyms */
+        ProFormaCanonicalizer() = default;
+
+        /** \brief  Registers a descriptor spelled differently that means the same modification
+		  * \param  synonym The other spelling, e.g. U:Phospho.
+		  * \param  canonical The spelling used in the canonical form, e.g. UNIMOD:21.
+		  * \return void
+		  */
+        void AddSynonym(const ProFormaDescriptor& synonym, const ProFormaDescriptor& canonical);
+
+        /** \brief  Returns the canonical form of a term
+		  * \param  term The input term.
+		  * \return the canonical term
+		  */
+        ProFormaTerm Canonicalize(const ProFormaTerm& term) const;
+
+        /** \brief  64-bit hash of the canonical form, equal for all the spellings of a term
+		  * \param  term The input term.
+		  * \return the hash
+		  */
+        uint64_t Hash(const ProFormaTerm& term) const;
+
+        /** \brief  Compares the canonical forms of two terms
+		  * \param  left The first term.
+		  * \param  right The second term.
+		  * \return true when both terms are spellings of the same proteoform
+		  */
+        bool Equivalent(const ProFormaTerm& left, const ProFormaTerm& right) const;
+
+        /** \brief  Canonicalizer without synonyms used by operator== and std::hash. */
+        static const ProFormaCanonicalizer& Default();
+    private:
+        struct Scratch;
+
+        template <typename Sink> void WriteTerm(Sink& sink, const ProFormaTerm& term, Scratch& scratch) const;
+        template <typename Sink> void WriteDescriptors(Sink& sink, const std::list<ProFormaDescriptor>& descriptors, Scratch& scratch) const;
+
+        std::pair<uint8_t, std::string_view> Normalize(ProFormaKey key, ProFormaEvidenceType evidenceType, const std::string& value, std::string& buffer) const;
+
+        // Packed key and evidence type followed by the normalized value, to the canonical packed and value
+        std::unordered_map<std::string, std::pair<uint8_t, std::string>> _synonyms;
+	};
+
+	/** \brief  Terms are equal when their canonical forms are, see ProFormaCanonicalizer */
+	EXPORT bool operator==(const ProFormaTerm& left, const ProFormaTerm& right);
+	inline bool operator!=(const ProFormaTerm& left, const ProFormaTerm& right) { return !(left == right); }
+}
+
+namespace std {
+	/** \brief  Hash of the canonical form, consistent with operator== */
+	template <>
+	struct hash<ProForma::ProFormaTerm> {
+		size_t operator()(const ProForma::ProFormaTerm& term) const
+		{
+			return static_cast<size_t>(ProForma::ProFormaCanonicalizer::Default().Hash(term));
+		}
+	};
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace ProForma {
+	/**
+	 * \class ProFormaCborEmitter
+	 *
+	 * \brief Streams CBOR (RFC 8949) straight into a caller buffer, with the calls of ProFormaJsonEmitter.
+	 *        Containers have definite lengths given to BeginObject and BeginArray. Output matches
+	 *        nlohmann::json::to_cbor(): smallest integer heads, doubles stored as float when exact.
+	 *
+	 */
+	class ProFormaCborEmitter {
+	public:
+        /** \brief  Initializes an emitter appending to the given buffer
+		  * \param  out The buffer, its current content is kept.
+		  * \return void
+		  */
+        explicit ProFormaCborEmitter(std::vector<uint8_t>& out) : _out(out) { }
+
+        void BeginObject(size_t count) { Head(0xA0, count); }
+        void EndObject() { }
+        void BeginArray(size_t count) { Head(0x80, count); }
+        void EndArray() { }
+
+        template <size_t N>
+        void Key(const char (&name)[N])
+        {
+            Head(0x60, N - 1);
+            _out.insert(_out.end(), name, name + N - 1);
+        }
+
+        void String(const std::string& value)
+        {
+            Head(0x60, value.length());
+            _out.insert(_out.end(), value.begin(), value.end());
+        }
+
+        void Unsigned(uint64_t value) { Head(0x00, value); }
+
+        void Integer(int64_t value)
+        {
+            if (value >= 0)
+                Head(0x00, static_cast<uint64_t>(value));
+            else
+                Head(0x20, static_cast<uint64_t>(-1 - value));
+        }
+
+        void Double(double value)
+        {
+            if (std::isnan(value))
+                _out.insert(_out.end(), { 0xF9, 0x7E, 0x00 });
+            else if (std::isinf(value))
+                _out.insert(_out.end(), { 0xF9, static_cast<uint8_t>(value > 0 ? 0x7C : 0xFC), 0x00 });
+            else if (std::fabs(value) <= 3.4028234663852886e38 && static_cast<double>(static_cast<float>(value)) == value)
+            {
+                float single = static_cast<float>(value);
+                uint32_t bits;
+                memcpy(&bits, &single, sizeof(bits));
+                _out.push_back(0xFA);
+                BigEndian(bits, 4);
+            }
+            else
+            {
+                uint64_t bits;
+                memcpy(&bits, &value, sizeof(bits));
+                _out.push_back(0xFB);
+                BigEndian(bits, 8);
+            }
+        }
+
+        void Null() { _out.push_back(0xF6); }
+    private:
+        // Major type and argument, the argument in the smallest form
+        void Head(uint8_t major, uint64_t value)
+        {
+            if (value <= 0x17)
+                _out.push_back(static_cast<uint8_t>(major + value));
+            else if (value <= 0xFF)
+            {
+                _out.push_back(static_cast<uint8_t>(major + 0x18));
+                BigEndian(value, 1);
+            }
+            else if (value <= 0xFFFF)
+            {
+                _out.push_back(static_cast<uint8_t>(major + 0x19));
+                BigEndian(value, 2);
+            }
+            else if (value <= 0xFFFFFFFFull)
+            {
+                _out.push_back(static_cast<uint8_t>(major + 0x1A));
+                BigEndian(value, 4);
+            }
+            else
+            {
+                _out.push_back(static_cast<uint8_t>(major + 0x1B));
+                BigEndian(value, 8);
+            }
+        }
+
+        void BigEndian(uint64_t value, int bytes)
+        {
+            for (int i = bytes - 1; i >= 0; i--)
+                _out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+        }
+
+        std::vector<uint8_t>& _out;
+	};
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+
+#include "ProFormaBinaryFormat.h"
+#include "ProFormaTerm.h"
+
+namespace ProForma {
+	/**
+	 * \brief Layout shared by ProFormaColumnarWriter and ProFormaColumnarReader.
+	 *
+	 *  file      := magic "PFMC", version byte, flags byte (0), column chunk*, footer, footer length (8 bytes LE), magic "PFMC"
+	 *  footer    := varint row group count, (varint rows, min mass, max mass, (varint offset, varint length) per column)*
+	 *
+	 *  Every row group writes one chunk per column, in Column order. A chunk only refers to the dictionaries
+	 *  of its own row group, so a row group can be read alone, and a column can be read without the others.
+	 *
+	 *  Symbols      varint count, (varint length, bytes)*                         names and values of the row group
+	 *  Sequences    varint count, (varint length, bytes)*, varint index per row    distinct sequences, then one index per row
+	 *  TagPositions per row: varint count, (zigzag start delta, varint span)*      start relative to the previous tag of the row
+	 *  TagSymbols   per tag: descriptors
+	 *  Termini      per row: descriptors x3 (N-term, C-term, labile), varint count, (zigzag count, descriptors)*
+	 *  Globals      per row: varint count, (descriptors, varint count, target bytes)*
+	 *  Groups       per row: varint count, (varint name, packed, flags, varint value,
+	 *                                       varint count, (zigzag start delta, varint span, [weight])*)*
+	 *  descriptors := varint count, (packed, varint symbol)*
+	 *
+	 *  packed and flags are the ones of ProFormaBinaryFormat.h, masses are IEEE 754 little endian.
+	 */
+	namespace Columnar {
+		const char Magic[4] = { 'P', 'F', 'M', 'C' };
+		const uint8_t Version = 1;
+		const size_t HeaderSize = 6;
+		const size_t TrailerSize = 12;
+
+		enum class Column {
+			Symbols = 0,
+			Sequences = 1,
+			TagPositions = 2,
+			TagSymbols = 3,
+			Termini = 4,
+			Globals = 5,
+			Groups = 6,
+		};
+
+		const size_t ColumnCount = 7;
+
+		/** \brief  Monoisotopic residue mass, 0 for the ambiguous and unknown residues */
+		inline double ResidueMass(char residue)
+		{
+			switch (residue)
+			{
+				case 'G': return 57.02146;
+				case 'A': return 71.03711;
+				case 'S': return 87.03203;
+				case 'P': return 97.05276;
+				case 'V': return 99.06841;
+				case 'T': return 101.04768;
+				case 'C': return 103.00919;
+				case 'L': return 113.08406;
+				case 'I': return 113.08406;
+				case 'N': return 114.04293;
+				case 'D': return 115.02694;
+				case 'Q': return 128.05858;
+				case 'K': return 128.09496;
+				case 'E': return 129.04259;
+				case 'M': return 131.04049;
+				case 'H': return 137.05891;
+				case 'F': return 147.06841;
+				case 'U': return 150.95364;
+				case 'R': return 156.10111;
+				case 'Y': return 163.06333;
+				case 'W': return 186.07931;
+				case 'O': return 237.14773;
+				default: return 0.0;
+			}
+		}
+
+		/** \brief  First mass shift of a descriptor list, alternatives such as [Phospho|+79.966] count once */
+		inline double MassShift(const std::list<ProFormaDescriptor>& descriptors)
+		{
+			for (auto& descriptor : descriptors)
+				if (descriptor.Key() == ProFormaKey::Mass)
+					return strtod(descriptor.Value().c_str(), nullptr);
+			return 0.0;
+		}
+
+		/**
+		 * \brief  Mass used for the row group statistics: residues, water and the explicit mass shifts.
+		 *         Named modifications need an ontology to be resolved and do not contribute.
+		 */
+		inline double TermMass(const ProFormaTerm& term)
+		{
+			double mass = 18.010565;
+
+			for (char residue : term.Sequence())
+				mass += ResidueMass(residue);
+
+			for (auto& tag : term.Tags())
+				mass += MassShift(tag.Descriptors());
+			for (auto& tag : term.UnlocalizedTags())
+				mass += tag.Count() * MassShift(tag.Descriptors());
+
+			mass += MassShift(term.NTerminalDescriptors());
+			mass += MassShift(term.CTerminalDescriptors());
+			mass += MassShift(term.LabileDescriptors());
+
+			for (auto& item : term.TagGroups())
+				if (item.second->Key() == ProFormaKey::Mass)
+					mass += strtod(item.second->Value().c_str(), nullptr);
+
+			for (auto& modification : term.GlobalModifications())
+			{
+				double shift = MassShift(modification.Descriptors());
+				if (shift == 0.0)
+					continue;
+
+				for (char residue : term.Sequence())
+					for (char target : modification.TargetAminoAcids())
+						if (residue == target)
+							mass += shift;
+			}
+
+			return mass;
+		}
+	}
+
+	/**
+	 * \brief Row group entry of the archive footer.
+	 */
+	struct ProFormaColumnarRowGroup {
+		/**< Index of the first row of the group in the archive */
+		uint64_t FirstRow;
+
+		/**< Number of rows */
+		uint64_t Rows;
+
+		/**< Smallest and largest mass of the group, see Columnar::TermMass */
+		double MinMass;
+		double MaxMass;
+
+		/**< Position and size of every column chunk */
+		uint64_t Offsets[Columnar::ColumnCount];
+		uint64_t Lengths[Columnar::ColumnCount];
+	};
+}
@@ -0,0 +1,310 @@
+#include <cstring>
+#include <utility>
+
+#include "ProFormaColumnarReader.h"
+#include "ProFormaTagGroupChangingValue.h"
+#include "ProFormaTermBuilder.h"
+
+using namespace ProForma;
+
+namespace {
+    // Tags and group members must lie on the sequence of their row, the writer cannot produce anything else
+    void CheckRange(uint64_t row, uint64_t start, uint64_t end, size_t sequenceLength, const char* what)
+    {
+        if (start > end || end >= sequenceLength)
+            throw new ProFormaParseException("Columnar archive row %llu has %s at %llu-%llu, outside the %zu residues of its sequence.",
+                static_cast<unsigned long long>(row), what, static_cast<unsigned long long>(start), static_cast<unsigned long long>(end), sequenceLength);
+    }
+}
+
+/*****************************************************************************/
+// PUBLIC
+/*****************************************************************************/
+
+ProFormaColumnarReader::ProFormaColumnarReader(std::istream& stream)
+    : _stream(stream)
+{
+    char header[Columnar::HeaderSize];
+
+    if (!_stream.read(header, sizeof(header)) || memcmp(header, Columnar::Magic, sizeof(Columnar::Magic)) != 0)
+        throw new ProFormaParseException("Not a ProForma columnar archive.");
+
+    _version = static_cast<uint8_t>(header[4]);
+    if (_version == 0 || _version > Columnar::Version)
+        throw new ProFormaParseException("Unsupported ProForma columnar format version %d, this reader supports up to %d.", _version, Columnar::Version);
+
+    // Trailer: footer length and the magic again, a missing one means the writer was not closed
+    char trailer[Columnar::TrailerSize];
+    if (!_stream.seekg(0, std::ios::end))
+        throw new ProFormaParseException("Columnar archive stream is not seekable.");
+
+    uint64_t size = static_cast<uint64_t>(_stream.tellg());
+    if (size < Columnar::HeaderSize + Columnar::TrailerSize
+        || !_stream.seekg(static_cast<std::streamoff>(size - Columnar::TrailerSize))
+        || !_stream.read(trailer, sizeof(trailer))
+        || memcmp(trailer + 8, Columnar::Magic, sizeof(Columnar::Magic)) != 0)
+        throw new ProFormaParseException("Columnar archive is truncated.");
+
+    uint64_t footerLength = 0;
+    for (int i = 0; i < 8; i++)
+        footerLength |= static_cast<uint64_t>(static_cast<uint8_t>(trailer[i])) << (8 * i);
+
+    uint64_t dataEnd = size - Columnar::TrailerSize;
+    if (footerLength > dataEnd - Columnar::HeaderSize)
+        throw new ProFormaParseException("Columnar archive is truncated.");
+    dataEnd -= footerLength;
+
+    std::string footer(static_cast<size_t>(footerLength), '\0');
+    if (!_stream.seekg(static_cast<std::streamoff>(dataEnd)) || !_stream.read(&footer[0], static_cast<std::streamsize>(footerLength)))
+        throw new ProFormaParseException("Columnar archive is truncated.");
+
+    Binary::Cursor cursor(footer.data(), footer.length());
+    for (size_t count = cursor.Size(); count > 0; count--)
+    {
+        ProFormaColumnarRowGroup rowGroup;
+        rowGroup.FirstRow = _rowCount;
+        rowGroup.Rows = cursor.Varint();
+        rowGroup.MinMass = cursor.Double();
+        rowGroup.MaxMass = cursor.Double();
+
+        for (size_t i = 0; i < Columnar::ColumnCount; i++)
+        {
+            rowGroup.Offsets[i] = cursor.Varint();
+            rowGroup.Lengths[i] = cursor.Varint();
+            if (rowGroup.Offsets[i] < Columnar::HeaderSize || rowGroup.Offsets[i] > dataEnd || rowGroup.Lengths[i] > dataEnd - rowGroup.Offsets[i])
+                throw new ProFormaParseException("Columnar archive footer points outside of the file.");
+        }
+
+        _rowCount += rowGroup.Rows;
+        _rowGroups.push_back(rowGroup);
+    }
+
+    if (!cursor.AtEnd())
+        throw new ProFormaParseException("Columnar archive footer is longer than its row groups.");
+}
+
+std::vector<size_t> ProFormaColumnarReader::RowGroupsInMassRange(double minMass, double maxMass) const
+{
+    std::vector<size_t> indexes;
+
+    for (size_t i = 0; i < _rowGroups.size(); i++)
+        if (_rowGroups[i].MaxMass >= minMass && _rowGroups[i].MinMass <= maxMass)
+            indexes.push_back(i);
+
+    return indexes;
+}
+
+void ProFormaColumnarReader::ReadRowGroup(size_t rowGroup, std::vector<ProFormaTerm>& terms)
+{
+    const ProFormaColumnarRowGroup& info = RowGroup(rowGroup);
+
+    LoadSymbols(rowGroup);
+    for (size_t i = static_cast<size_t>(Columnar::Column::Sequences); i < Columnar::ColumnCount; i++)
+        LoadColumn(rowGroup, static_cast<Columnar::Column>(i));
+
+    Binary::Cursor sequences(Chunk(Columnar::Column::Sequences).data(), Chunk(Columnar::Column::Sequences).length());
+    Binary::Cursor positions(Chunk(Columnar::Column::TagPositions).data(), Chunk(Columnar::Column::TagPositions).length());
+    Binary::Cursor tagSymbols(Chunk(Columnar::Column::TagSymbols).data(), Chunk(Columnar::Column::TagSymbols).length());
+    Binary::Cursor termini(Chunk(Columnar::Column::Termini).data(), Chunk(Columnar::Column::Termini).length());
+    Binary::Cursor globals(Chunk(Columnar::Column::Globals).data(), Chunk(Columnar::Column::Globals).length());
+    Binary::Cursor groups(Chunk(Columnar::Column::Groups).data(), Chunk(Columnar::Column::Groups).length());
+
+    ReadSequenceDictionary(sequences);
+
+    for (uint64_t row = 0; row < info.Rows; row++)
+    {
+        ProFormaTermBuilder builder;
+
+        const std::string& sequence = ReadSequence(sequences);
+        builder.SetSequence(sequence);
+
+        uint64_t start = 0;
+        for (size_t count = positions.Size(); count > 0; count--)
+        {
+            start += static_cast<uint64_t>(Binary::UnZigZag(positions.Varint()));
+            uint64_t end = start + positions.Varint();
+            CheckRange(info.FirstRow + row, start, end, sequence.length(), "a tag");
+            builder.AddTag(static_cast<size_t>(start), static_cast<size_t>(end), ReadDescriptors(tagSymbols));
+        }
+
+        builder.SetNTerminalDescriptors(ReadDescriptors(termini));
+        builder.SetCTerminalDescriptors(ReadDescriptors(termini));
+        builder.SetLabileDescriptors(ReadDescriptors(termini));
+        for (size_t count = termini.Size(); count > 0; count--)
+        {
+            int tagCount = static_cast<int>(Binary::UnZigZag(termini.Varint()));
+            builder.AddUnlocalizedTag(tagCount, ReadDescriptors(termini));
+        }
+
+        for (size_t count = globals.Size(); count > 0; count--)
+        {
+            auto descriptors = ReadDescriptors(globals);
+            size_t targetCount = globals.Size();
+            const char* targets = globals.Bytes(targetCount);
+            builder.AddGlobalModification(std::move(descriptors), std::vector<char>(targets, targets + targetCount));
+        }
+
+        for (size_t count = groups.Size(); count > 0; count--)
+        {
+            const std::string& name = ReadSymbol(groups);
+            uint8_t packed = groups.Byte();
+            uint8_t flags = groups.Byte();
+            const std::string& value = ReadSymbol(groups);
+
+            std::list<ProFormaMembershipDescriptor> members;
+            uint64_t memberStart = 0;
+            for (size_t memberCount = groups.Size(); memberCount > 0; memberCount--)
+            {
+                memberStart += static_cast<uint64_t>(Binary::UnZigZag(groups.Varint()));
+                uint64_t memberEnd = memberStart + groups.Varint();
+                CheckRange(info.FirstRow + row, memberStart, memberEnd, sequence.length(), "a tag group member");
+                members.emplace_back(static_cast<size_t>(memberStart), static_cast<size_t>(memberEnd), (flags & Binary::GroupWeights) ? groups.Double() : 0.0);
+            }
+
+            if (builder.FindTagGroup(name))
+                throw new ProFormaParseException("Columnar archive has tag group %s twice in a row.", name.c_str());
+
+            if (flags & Binary::GroupChanging)
+            {
+                auto group = new ProFormaTagGroupChangingValue(name, Binary::UnpackKey(packed), Binary::UnpackEvidenceType(packed), std::move(members));
+                group->SetValueFlux(value);
+                builder.AddTagGroup(group);
+            }
+            else
+                builder.AddTagGroup(new ProFormaTagGroup(name, Binary::UnpackKey(packed), Binary::UnpackEvidenceType(packed), value, std::move(members)));
+        }
+
+        terms.push_back(std::move(builder).Build());
+    }
+
+    if (!sequences.AtEnd() || !positions.AtEnd() || !tagSymbols.AtEnd() || !termini.AtEnd() || !globals.AtEnd() || !groups.AtEnd())
+        throw new ProFormaParseException("Columnar archive row group %zu is longer than its rows.", rowGroup);
+}
+
+void ProFormaColumnarReader::ReadSequences(size_t rowGroup, const std::function<void(uint64_t, const std::string&)>& onSequence)
+{
+    const ProFormaColumnarRowGroup& info = RowGroup(rowGroup);
+
+    LoadColumn(rowGroup, Columnar::Column::Sequences);
+    Binary::Cursor sequences(Chunk(Columnar::Column::Sequences).data(), Chunk(Columnar::Column::Sequences).length());
+    ReadSequenceDictionary(sequences);
+
+    for (uint64_t row = 0; row < info.Rows; row++)
+        onSequence(info.FirstRow + row, ReadSequence(sequences));
+}
+
+void ProFormaColumnarReader::ReadTags(size_t rowGroup, const std::function<void(uint64_t, const ProFormaTag&)>& onTag)
+{
+    const ProFormaColumnarRowGroup& info = RowGroup(rowGroup);
+
+    // The sequences are read to check the positions against them
+    LoadSymbols(rowGroup);
+    LoadColumn(rowGroup, Columnar::Column::Sequences);
+    LoadColumn(rowGroup, Columnar::Column::TagPositions);
+    LoadColumn(rowGroup, Columnar::Column::TagSymbols);
+
+    Binary::Cursor sequences(Chunk(Columnar::Column::Sequences).data(), Chunk(Columnar::Column::Sequences).length());
+    Binary::Cursor positions(Chunk(Columnar::Column::TagPositions).data(), Chunk(Columnar::Column::TagPositions).length());
+    Binary::Cursor tagSymbols(Chunk(Columnar::Column::TagSymbols).data(), Chunk(Columnar::Column::TagSymbols).length());
+
+    ReadSequenceDictionary(sequences);
+
+    for (uint64_t row = 0; row < info.Rows; row++)
+    {
+        size_t sequenceLength = ReadSequence(sequences).length();
+
+        uint64_t start = 0;
+        for (size_t count = positions.Size(); count > 0; count--)
+        {
+            start += static_cast<uint64_t>(Binary::UnZigZag(positions.Varint()));
+            uint64_t end = start + positions.Varint();
+            CheckRange(info.FirstRow + row, start, end, sequenceLength, "a tag");
+            onTag(info.FirstRow + row, ProFormaTag(static_cast<size_t>(start), static_cast<size_t>(end), ReadDescriptors(tagSymbols)));
+        }
+    }
+}
+
+/*****************************************************************************/
+// PRIVATE
+/*****************************************************************************/
+
+const ProFormaColumnarRowGroup& ProFormaColumnarReader::RowGroup(size_t rowGroup) const
+{
+    if (rowGroup >= _rowGroups.size())
+        throw new ProFormaParseException("Columnar archive has no row group %zu.", rowGroup);
+    return _rowGroups[rowGroup];
+}
+
+void ProFormaColumnarReader::LoadColumn(size_t rowGroup, Columnar::Column column)
+{
+    const ProFormaColumnarRowGroup& info = RowGroup(rowGroup);
+    size_t index = static_cast<size_t>(column);
+    std::string& chunk = _columns[index];
+
+    chunk.resize(static_cast<size_t>(info.Lengths[index]));
+    _stream.clear();
+    if (!_stream.seekg(static_cast<std::streamoff>(info.Offsets[index])) || !_stream.read(&chunk[0], static_cast<std::streamsize>(chunk.length())))
+        throw new ProFormaParseException("Columnar archive is truncated.");
+
+    _bytesRead += chunk.length();
+}
+
+void ProFormaColumnarReader::LoadSymbols(size_t rowGroup)
+{
+    if (rowGroup == _symbolsRowGroup)
+        return;
+
+    LoadColumn(rowGroup, Columnar::Column::Symbols);
+    Binary::Cursor cursor(Chunk(Columnar::Column::Symbols).data(), Chunk(Columnar::Column::Symbols).length());
+
+    _symbolsRowGroup = static_cast<size_t>(-1);
+    _symbols.clear();
+    for (size_t count = cursor.Size(); count > 0; count--)
+    {
+        size_t size = cursor.Size();
+        _symbols.emplace_back(cursor.Bytes(size), size);
+    }
+
+    if (!cursor.AtEnd())
+        throw new ProFormaParseException("Columnar archive symbol dictionary is longer than its symbols.");
+    _symbolsRowGroup = rowGroup;
+}
+
+void ProFormaColumnarReader::ReadSequenceDictionary(Binary::Cursor& cursor)
+{
+    _sequences.clear();
+    for (size_t count = cursor.Size(); count > 0; count--)
+    {
+        size_t size = cursor.Size();
+        _sequences.emplace_back(cursor.Bytes(size), size);
+    }
+}
+
+const std::string& ProFormaColumnarReader::ReadSequence(Binary::Cursor& cursor)
+{
+    uint64_t sequence = cursor.Varint();
+    if (sequence >= _sequences.size())
+        throw new ProFormaParseException("Columnar archive refers to unknown sequence %llu.", static_cast<unsigned long long>(sequence));
+    return _sequences[static_cast<size_t>(sequence)];
+}
+
+std::list<ProFormaDescriptor> ProFormaColumnarReader::ReadDescriptors(Binary::Cursor& cursor)
+{
+    std::list<ProFormaDescriptor> descriptors;
+
+    for (size_t count = cursor.Size(); count > 0; count--)
+    {
+        uint8_t packed = cursor.Byte();
+        descriptors.emplace_back(Binary::UnpackKey(packed), Binary::UnpackEvidenceType(packed), ReadSymbol(cursor));
+    }
+
+    return descriptors;
+}
+
+const std::string& ProFormaColumnarReader::ReadSymbol(Binary::Cursor& cursor)
+{
+    uint64_t index = cursor.Varint();
+    if (index >= _symbols.size())
+        throw new ProFormaParseException("Columnar archive refers to unknown symbol %llu.", static_cast<unsigned long long>(index));
+    return _symbols[static_cast<size_t>(index)];
+}
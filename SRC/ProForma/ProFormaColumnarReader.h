@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "PlatformHelper.h"
+
+#include "ProFormaColumnarFormat.h"
+#include "ProFormaTerm.h"
+
+namespace ProForma {
+	/**
+	 * \class ProFormaColumnarReader
+	 *
+	 * \brief Reads the archives written by ProFormaColumnarWriter. The footer is read when the reader
+	 *        is created, the column chunks only when a row group or a column is asked for, so a query
+	 *        on tags reads the symbols, the sequences its positions are checked against and the two
+	 *        tag columns, and nothing else. The stream must be seekable. A bad header, a newer format
+	 *        version or a corrupted chunk, positions outside their sequence included, raises a
+	 *        ProFormaParseException.
+	 *
+	 */
+	class EXPORT ProFormaColumnarReader {
+	public:
+        /** \brief  Initializes a reader, checks the header and reads the footer
+		  * \param  stream The input stream, opened in binary mode.
+		  * \return void
+		  */
+        explicit ProFormaColumnarReader(std::istream& stream);
+
+        /** \brief  Format version found in the header. */
+        uint8_t Version() const { return _version; }
+
+        /** \brief  Total number of rows. */
+        uint64_t RowCount() const { return _rowCount; }
+
+        /** \brief  The row groups, in file order. */
+        const std::vector<ProFormaColumnarRowGroup>& RowGroups() const { return _rowGroups; }
+
+        /** \brief  Row groups whose mass range overlaps [minMass, maxMass]
+		  * \param  minMass Lower bound.
+		  * \param  maxMass Upper bound.
+		  * \return the indexes of the row groups
+		  */
+        std::vector<size_t> RowGroupsInMassRange(double minMass, double maxMass) const;
+
+        /** \brief  Decodes every column of a row group
+		  * \param  rowGroup Index of the row group.
+		  * \param  terms Receives the terms, appended in row order.
+		  * \return void
+		  */
+        void ReadRowGroup(size_t rowGroup, std::vector<ProFormaTerm>& terms);
+
+        /** \brief  Reads the sequence column of a row group
+		  * \param  rowGroup Index of the row group.
+		  * \param  onSequence Called with the archive row index and the sequence of every row.
+		  * \return void
+		  */
+        void ReadSequences(size_t rowGroup, const std::function<void(uint64_t, const std::string&)>& onSequence);
+
+        /** \brief  Reads the tag columns of a row group, and its sequences to check the tag positions
+		  * \param  rowGroup Index of the row group.
+		  * \param  onTag Called with the archive row index and every tag of the row.
+		  * \return void
+		  */
+        void ReadTags(size_t rowGroup, const std::function<void(uint64_t, const ProFormaTag&)>& onTag);
+
+        /** \brief  Bytes of column chunks read from the stream so far. */
+        uint64_t BytesRead() const { return _bytesRead; }
+    private:
+        const ProFormaColumnarRowGroup& RowGroup(size_t rowGroup) const;
+        void LoadColumn(size_t rowGroup, Columnar::Column column);
+        void LoadSymbols(size_t rowGroup);
+        void ReadSequenceDictionary(Binary::Cursor& cursor);
+        const std::string& ReadSequence(Binary::Cursor& cursor);
+        std::list<ProFormaDescriptor> ReadDescriptors(Binary::Cursor& cursor);
+        const std::string& ReadSymbol(Binary::Cursor& cursor);
+        const std::string& Chunk(Columnar::Column column) const { return _columns[static_cast<size_t>(column)]; }
+
+        std::istream& _stream;
+        uint8_t _version = 0;
+        uint64_t _rowCount = 0;
+        uint64_t _bytesRead = 0;
+        std::vector<ProFormaColumnarRowGroup> _rowGroups;
+
+        std::string _columns[Columnar::ColumnCount];
+        std::vector<std::string> _symbols;
+        size_t _symbolsRowGroup = static_cast<size_t>(-1);
+        std::vector<std::string> _sequences;
+	};
+}
@@ -0,0 +1,222 @@
+#include "ProFormaColumnarWriter.h"
+
+using namespace ProForma;
+
+/*****************************************************************************/
+// PUBLIC
+/*****************************************************************************/
+
+ProFormaColumnarWriter::ProFormaColumnarWriter(std::ostream& stream, size_t rowGroupSize)
+    : _stream(stream), _rowGroupSize(rowGroupSize == 0 ? 1 : rowGroupSize)
+{
+    char header[Columnar::HeaderSize] = { Columnar::Magic[0], Columnar::Magic[1], Columnar::Magic[2], Columnar::Magic[3], static_cast<char>(Columnar::Version), 0 };
+    _stream.write(header, sizeof(header));
+    _offset = sizeof(header);
+}
+
+ProFormaColumnarWriter::~ProFormaColumnarWriter()
+{
+    if (_closed)
+        return;
+
+    try
+    {
+        Close();
+    }
+    catch (...)
+    {
+    }
+}
+
+void ProFormaColumnarWriter::Write(const ProFormaTerm& term)
+{
+    // Sequences: dictionary index per row, the distinct sequences are written with the row group
+    auto sequence = _sequences.find(term.Sequence());
+    if (sequence == _sequences.end())
+    {
+        sequence = _sequences.emplace(term.Sequence(), static_cast<uint32_t>(_sequenceOrder.size())).first;
+        _sequenceOrder.push_back(&sequence->first);
+    }
+    Binary::PutVarint(_sequenceIndexes, sequence->second);
+
+    // Tags: positions and symbols in separate columns, starts relative to the previous tag
+    std::string& positions = Chunk(Columnar::Column::TagPositions);
+    std::string& tagSymbols = Chunk(Columnar::Column::TagSymbols);
+    int64_t previous = 0;
+
+    Binary::PutVarint(positions, term.Tags().size());
+    for (auto& tag : term.Tags())
+    {
+        Binary::PutVarint(positions, Binary::ZigZag(static_cast<int64_t>(tag.ZeroBasedStartIndex()) - previous));
+        Binary::PutVarint(positions, tag.ZeroBasedEndIndex() - tag.ZeroBasedStartIndex());
+        previous = static_cast<int64_t>(tag.ZeroBasedStartIndex());
+        WriteDescriptors(tagSymbols, tag.Descriptors());
+    }
+
+    std::string& termini = Chunk(Columnar::Column::Termini);
+    WriteDescriptors(termini, term.NTerminalDescriptors());
+    WriteDescriptors(termini, term.CTerminalDescriptors());
+    WriteDescriptors(termini, term.LabileDescriptors());
+    Binary::PutVarint(termini, term.UnlocalizedTags().size());
+    for (auto& tag : term.UnlocalizedTags())
+    {
+        Binary::PutVarint(termini, Binary::ZigZag(tag.Count()));
+        WriteDescriptors(termini, tag.Descriptors());
+    }
+
+    std::string& globals = Chunk(Columnar::Column::Globals);
+    Binary::PutVarint(globals, term.GlobalModifications().size());
+    for (auto& modification : term.GlobalModifications())
+    {
+        WriteDescriptors(globals, modification.Descriptors());
+        Binary::PutVarint(globals, modification.TargetAminoAcids().size());
+        globals.append(modification.TargetAminoAcids().data(), modification.TargetAminoAcids().size());
+    }
+
+    std::string& groups = Chunk(Columnar::Column::Groups);
+    Binary::PutVarint(groups, term.TagGroups().size());
+    for (auto& item : term.TagGroups())
+    {
+        const ProFormaTagGroup* group = item.second;
+
+        bool hasWeights = false;
+        for (auto& member : group->Members())
+            hasWeights = hasWeights || member.Weight() != 0.0;
+
+        WriteSymbol(groups, group->Name());
+        groups.push_back(static_cast<char>(Binary::Pack(group->Key(), group->EvidenceType())));
+        groups.push_back(static_cast<char>((group->IsChanging() ? Binary::GroupChanging : 0) | (hasWeights ? Binary::GroupWeights : 0)));
+        WriteSymbol(groups, group->Value());
+
+        previous = 0;
+        Binary::PutVarint(groups, group->Members().size());
+        for (auto& member : group->Members())
+        {
+            Binary::PutVarint(groups, Binary::ZigZag(static_cast<int64_t>(member.ZeroBasedStartIndex()) - previous));
+            Binary::PutVarint(groups, member.ZeroBasedEndIndex() - member.ZeroBasedStartIndex());
+            previous = static_cast<int64_t>(member.ZeroBasedStartIndex());
+            if (hasWeights)
+                Binary::PutDouble(groups, member.Weight());
+        }
+    }
+
+    double mass = Columnar::TermMass(term);
+    if (_rows == 0 || mass < _minMass)
+        _minMass = mass;
+    if (_rows == 0 || mass > _maxMass)
+        _maxMass = mass;
+
+    _rowCount++;
+    if (++_rows == _rowGroupSize)
+        FlushRowGroup();
+}
+
+void ProFormaColumnarWriter::Write(const std::vector<ProFormaTerm>& terms)
+{
+    for (auto& term : terms)
+        Write(term);
+}
+
+void ProFormaColumnarWriter::Close()
+{
+    if (_closed)
+        return;
+
+    if (_rows > 0)
+        FlushRowGroup();
+
+    std::string footer;
+    Binary::PutVarint(footer, _rowGroups.size());
+    for (auto& rowGroup : _rowGroups)
+    {
+        Binary::PutVarint(footer, rowGroup.Rows);
+        Binary::PutDouble(footer, rowGroup.MinMass);
+        Binary::PutDouble(footer, rowGroup.MaxMass);
+        for (size_t i = 0; i < Columnar::ColumnCount; i++)
+        {
+            Binary::PutVarint(footer, rowGroup.Offsets[i]);
+            Binary::PutVarint(footer, rowGroup.Lengths[i]);
+        }
+    }
+
+    // Fixed size trailer, the reader finds the footer from the end of the file
+    uint64_t length = footer.length();
+    for (int i = 0; i < 8; i++)
+        footer.push_back(static_cast<char>(length >> (8 * i)));
+    footer.append(Columnar::Magic, sizeof(Columnar::Magic));
+
+    _stream.write(footer.data(), footer.length());
+    _stream.flush();
+    _closed = true;
+}
+
+/*****************************************************************************/
+// PRIVATE
+/*****************************************************************************/
+
+void ProFormaColumnarWriter::FlushRowGroup()
+{
+    // The dictionaries are complete once the last row is in
+    std::string& symbols = Chunk(Columnar::Column::Symbols);
+    Binary::PutVarint(symbols, _symbolOrder.size());
+    for (const std::string* symbol : _symbolOrder)
+    {
+        Binary::PutVarint(symbols, symbol->length());
+        symbols.append(*symbol);
+    }
+
+    std::string& sequences = Chunk(Columnar::Column::Sequences);
+    Binary::PutVarint(sequences, _sequenceOrder.size());
+    for (const std::string* sequence : _sequenceOrder)
+    {
+        Binary::PutVarint(sequences, sequence->length());
+        sequences.append(*sequence);
+    }
+    sequences.append(_sequenceIndexes);
+
+    ProFormaColumnarRowGroup rowGroup;
+    rowGroup.FirstRow = _rowCount - _rows;
+    rowGroup.Rows = _rows;
+    rowGroup.MinMass = _minMass;
+    rowGroup.MaxMass = _maxMass;
+
+    for (size_t i = 0; i < Columnar::ColumnCount; i++)
+    {
+        rowGroup.Offsets[i] = _offset;
+        rowGroup.Lengths[i] = _columns[i].length();
+        _stream.write(_columns[i].data(), _columns[i].length());
+        _offset += _columns[i].length();
+        _columns[i].clear();
+    }
+
+    _rowGroups.push_back(rowGroup);
+
+    _symbols.clear();
+    _symbolOrder.clear();
+    _sequences.clear();
+    _sequenceOrder.clear();
+    _sequenceIndexes.clear();
+    _rows = 0;
+}
+
+void ProFormaColumnarWriter::WriteDescriptors(std::string& column, const std::list<ProFormaDescriptor>& descriptors)
+{
+    Binary::PutVarint(column, descriptors.size());
+    for (auto& descriptor : descriptors)
+    {
+        column.push_back(static_cast<char>(Binary::Pack(descriptor.Key(), descriptor.EvidenceType())));
+        WriteSymbol(column, descriptor.Value());
+    }
+}
+
+void ProFormaColumnarWriter::WriteSymbol(std::string& column, const std::string& text)
+{
+    auto item = _symbols.find(text);
+    if (item == _symbols.end())
+    {
+        item = _symbols.emplace(text, static_cast<uint32_t>(_symbolOrder.size())).first;
+        _symbolOrder.push_back(&item->first);
+    }
+
+    Binary::PutVarint(column, item->second);
+}
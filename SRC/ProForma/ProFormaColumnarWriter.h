@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "PlatformHelper.h"
+
+#include "ProFormaColumnarFormat.h"
+#include "ProFormaTerm.h"
+
+namespace ProForma {
+	/**
+	 * \class ProFormaColumnarWriter
+	 *
+	 * \brief Writes ProFormaTerm objects to a columnar archive read by ProFormaColumnarReader. Terms are
+	 *        grouped in row groups, each one storing sequences, tag positions, descriptor symbols,
+	 *        termini, global modifications and tag groups as separate columns, with the names, values
+	 *        and sequences dictionary encoded and the positions delta encoded. The footer keeps the
+	 *        offset of every column and the mass range of every row group. See ProFormaColumnarFormat.h.
+	 *
+	 */
+	class EXPORT ProFormaColumnarWriter {
+	public:
+        /** \brief  Initializes a writer and writes the file header
+		  * \param  stream The output stream, opened in binary mode.
+		  * \param  rowGroupSize Number of terms per row group.
+		  * \return void
+		  */
+        explicit ProFormaColumnarWriter(std::ostream& stream, size_t rowGroupSize = 65536);
+
+        /** \brief  Writes the footer if Close() was not called, errors are ignored */
+        ~ProFormaColumnarWriter();
+
+        ProFormaColumnarWriter(const ProFormaColumnarWriter&) = delete;
+        ProFormaColumnarWriter& operator=(const ProFormaColumnarWriter&) = delete;
+
+        /** \brief  Appends a term to the current row group
+		  * \param  term The term.
+		  * \return void
+		  */
+        void Write(const ProFormaTerm& term);
+
+        /** \brief  Appends a batch of terms
+		  * \param  terms The terms.
+		  * \return void
+		  */
+        void Write(const std::vector<ProFormaTerm>& terms);
+
+        /** \brief  Writes the last row group and the footer, the archive is complete afterwards
+		  * \return void
+		  */
+        void Close();
+
+        /** \brief  Number of terms written so far. */
+        uint64_t RowCount() const { return _rowCount; }
+    private:
+        void FlushRowGroup();
+        void WriteDescriptors(std::string& column, const std::list<ProFormaDescriptor>& descriptors);
+        void WriteSymbol(std::string& column, const std::string& text);
+        std::string& Chunk(Columnar::Column column) { return _columns[static_cast<size_t>(column)]; }
+
+        std::ostream& _stream;
+        size_t _rowGroupSize;
+        uint64_t _offset = 0;
+        uint64_t _rowCount = 0;
+        bool _closed = false;
+
+        // Current row group
+        std::string _columns[Columnar::ColumnCount];
+        std::unordered_map<std::string, uint32_t> _symbols;
+        std::vector<const std::string*> _symbolOrder;
+        std::unordered_map<std::string, uint32_t> _sequences;
+        std::vector<const std::string*> _sequenceOrder;
+        std::string _sequenceIndexes;
+        size_t _rows = 0;
+        double _minMass = 0.0;
+        double _maxMass = 0.0;
+
+        std::vector<ProFormaColumnarRowGroup> _rowGroups;
+	};
+}
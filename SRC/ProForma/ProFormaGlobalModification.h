@@ -2,6 +2,7 @@
 
 #include <list>
 #include <vector>
+#include <utility>
 
 #include "ProFormaDescriptor.h"
 
@@ -22,16 +23,15 @@ namespace ProForma {
 		  * \return void
 		  */
         ProFormaGlobalModification(std::list<ProFormaDescriptor> descriptors, std::vector<char> targetAminoAcids)
+            : _targetAminoAcids(std::move(targetAminoAcids)), _descriptors(std::move(descriptors))
         {
-            _descriptors = descriptors;
-            _targetAminoAcids = targetAminoAcids;
         }
 
         /** \brief  The descriptors for this global modification. */
-        std::list<ProFormaDescriptor> Descriptors() { return _descriptors; }
+        const std::list<ProFormaDescriptor>& Descriptors() const { return _descriptors; }
 
         /** \brief  The amino acids targeted by this global modification (null if representing isotopes). */
-        std::vector<char> TargetAminoAcids() { return _targetAminoAcids; }
+        const std::vector<char>& TargetAminoAcids() const { return _targetAminoAcids; }
 
     private:
         std::vector<char> _targetAminoAcids;
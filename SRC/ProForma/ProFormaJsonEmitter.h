@@ -0,0 +1,231 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace ProForma {
+	/**
+	 * \class ProFormaJsonEmitter
+	 *
+	 * \brief Streams JSON text straight into a caller buffer, without building a document first.
+	 *        Output matches nlohmann::json::dump() (compact form): same escaping, same number formatting.
+	 *        Strings are copied through unchanged apart from escaping, they are expected to be UTF-8.
+	 *
+	 */
+	class ProFormaJsonEmitter {
+	public:
+        /** \brief  Initializes an emitter appending to the given buffer
+		  * \param  out The buffer, its current content is kept.
+		  * \return void
+		  */
+        explicit ProFormaJsonEmitter(std::string& out) : _out(out) { }
+
+        /** \brief  Containers take their number of members for the binary emitters, JSON text ignores it. */
+        void BeginObject(size_t = 0) { Separator(); _out.push_back('{'); _first = true; }
+        void EndObject() { _out.push_back('}'); _first = false; }
+        void BeginArray(size_t = 0) { Separator(); _out.push_back('['); _first = true; }
+        void EndArray() { _out.push_back(']'); _first = false; }
+
+        /** \brief  Writes an object key, keys are literals that never need escaping. */
+        template <size_t N>
+        void Key(const char (&name)[N])
+        {
+            Separator();
+            _out.push_back('"');
+            _out.append(name, N - 1);
+            _out.append("\":", 2);
+            _afterKey = true;
+        }
+
+        void String(const std::string& value)
+        {
+            Separator();
+            _out.push_back('"');
+            AppendEscaped(_out, value.data(), value.length());
+            _out.push_back('"');
+        }
+
+        void Unsigned(uint64_t value)
+        {
+            Separator();
+            char text[24];
+            _out.append(text, std::to_chars(text, text + sizeof(text), value).ptr - text);
+        }
+
+        void Integer(int64_t value)
+        {
+            Separator();
+            char text[24];
+            _out.append(text, std::to_chars(text, text + sizeof(text), value).ptr - text);
+        }
+
+        void Double(double value)
+        {
+            Separator();
+            AppendDouble(_out, value);
+        }
+
+        void Null()
+        {
+            Separator();
+            _out.append("null", 4);
+        }
+
+        /** \brief  Appends text with JSON escaping, eight bytes are checked at a time. */
+        static void AppendEscaped(std::string& out, const char* text, size_t length)
+        {
+            size_t i = 0;
+            size_t run = 0;
+
+            while (i + 8 <= length)
+            {
+                uint64_t block;
+                memcpy(&block, text + i, 8);
+
+                if (!NeedsEscape(block))
+                {
+                    i += 8;
+                    continue;
+                }
+
+                // Copy the clean run, then escape this block byte by byte
+                out.append(text + run, i - run);
+                for (size_t end = i + 8; i < end; i++)
+                    AppendEscaped(out, text[i]);
+                run = i;
+            }
+
+            out.append(text + run, i - run);
+            for (; i < length; i++)
+                AppendEscaped(out, text[i]);
+        }
+
+        /** \brief  Appends a number laid out as nlohmann::json does (".0" on integral values, exponent form
+		  *         outside 1e-5 ... 1e15) with the shortest round-trip digits of std::to_chars. Grisu2 in
+		  *         nlohmann::json sometimes keeps one more digit, both read back as the same double.
+		  *         Non finite values are written as null.
+		  */
+        static void AppendDouble(std::string& out, double value)
+        {
+            if (!std::isfinite(value))
+            {
+                out.append("null", 4);
+                return;
+            }
+
+            if (std::signbit(value))
+            {
+                out.push_back('-');
+                value = -value;
+            }
+
+            if (value == 0)
+            {
+                out.append("0.0", 3);
+                return;
+            }
+
+            // Shortest digits in scientific form, "d.ddde+XX", then laid out as nlohmann's format_buffer does
+            char scientific[32];
+            char* end = std::to_chars(scientific, scientific + sizeof(scientific), value, std::chars_format::scientific).ptr;
+            char* e = std::find(scientific, end, 'e');
+            int exponent = 0;
+            for (char* c = e + 2; c != end; c++)
+                exponent = exponent * 10 + (*c - '0');
+            if (e[1] == '-')
+                exponent = -exponent;
+
+            char digits[24];
+            int k = 0;
+            for (char* c = scientific; c != e; c++)
+                if (*c != '.')
+                    digits[k++] = *c;
+
+            // Position of the decimal point in the digits
+            int n = exponent + 1;
+
+            if (k <= n && n <= 15)
+            {
+                out.append(digits, k).append(n - k, '0').append(".0", 2);
+            }
+            else if (0 < n && n <= 15)
+            {
+                out.append(digits, n).push_back('.');
+                out.append(digits + n, k - n);
+            }
+            else if (-4 < n && n <= 0)
+            {
+                out.append("0.", 2).append(-n, '0').append(digits, k);
+            }
+            else
+            {
+                out.push_back(digits[0]);
+                if (k > 1)
+                    out.append(1, '.').append(digits + 1, k - 1);
+
+                int shown = n - 1;
+                out.push_back('e');
+                out.push_back(shown < 0 ? '-' : '+');
+                shown = shown < 0 ? -shown : shown;
+                if (shown >= 100)
+                    out.push_back(static_cast<char>('0' + shown / 100));
+                out.push_back(static_cast<char>('0' + shown / 10 % 10));
+                out.push_back(static_cast<char>('0' + shown % 10));
+            }
+        }
+    private:
+        void Separator()
+        {
+            if (_afterKey)
+                _afterKey = false;
+            else if (!_first)
+                _out.push_back(',');
+            _first = false;
+        }
+
+        // True when any of the eight bytes is a control character, a quote or a backslash
+        static bool NeedsEscape(uint64_t block)
+        {
+            const uint64_t ones = 0x0101010101010101ull;
+            const uint64_t highs = 0x8080808080808080ull;
+
+            uint64_t control = (block - ones * 0x20) & ~block & highs;
+            uint64_t quote = block ^ (ones * '"');
+            uint64_t backslash = block ^ (ones * '\\');
+
+            return (control | ((quote - ones) & ~quote & highs) | ((backslash - ones) & ~backslash & highs)) != 0;
+        }
+
+        static void AppendEscaped(std::string& out, char c)
+        {
+            switch (c)
+            {
+            case '"':  out.append("\\\"", 2); break;
+            case '\\': out.append("\\\\", 2); break;
+            case '\b': out.append("\\b", 2); break;
+            case '\f': out.append("\\f", 2); break;
+            case '\n': out.append("\\n", 2); break;
+            case '\r': out.append("\\r", 2); break;
+            case '\t': out.append("\\t", 2); break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    static const char hex[] = "0123456789abcdef";
+                    char text[6] = { '\\', 'u', '0', '0', hex[(c >> 4) & 0xF], hex[c & 0xF] };
+                    out.append(text, 6);
+                }
+                else
+                    out.push_back(c);
+                break;
+            }
+        }
+
+        std::string& _out;
+        bool _first = true;
+        bool _afterKey = false;
+	};
+}
@@ -0,0 +1,420 @@
+#include <cctype>
+#include <utility>
+#include <vector>
+
+#include "ProFormaJsonReader.h"
+#include "ProFormaParseException.h"
+#include "ProFormaTagGroupChangingValue.h"
+#include "ProFormaTermBuilder.h"
+#include "nlohmann/json.hpp"
+
+using namespace ProForma;
+
+/*****************************************************************************/
+// SAX HANDLER
+/*****************************************************************************/
+
+namespace {
+    // Members of the ProFormaWriter::TermToJson schema
+    enum class Field {
+        None, Sequence, GlobalModifications, NTerminalDescriptors, CTerminalDescriptors, LabileDescriptors, Tags, UnlocalizedTags, TagGroups,
+        Descriptors, TargetAminoacids, Members, Key, EvidenceType, Value, ZeroBasedStartIndex, ZeroBasedEndIndex, Count, Weight,
+        Name, ValueFlux, KeyFlux, EvidenceFlux
+    };
+
+    Field FieldOf(const std::string& name)
+    {
+        static const std::pair<const char*, Field> fields[] = {
+            { "Sequence", Field::Sequence }, { "GlobalModifications", Field::GlobalModifications },
+            { "NTerminalDescriptors", Field::NTerminalDescriptors }, { "CTerminalDescriptors", Field::CTerminalDescriptors },
+            { "LabileDescriptors", Field::LabileDescriptors }, { "Tags", Field::Tags }, { "UnlocalizedTags", Field::UnlocalizedTags },
+            { "TagGroups", Field::TagGroups }, { "Descriptors", Field::Descriptors }, { "TargetAminoacids", Field::TargetAminoacids },
+            { "Members", Field::Members }, { "Key", Field::Key }, { "EvidenceType", Field::EvidenceType }, { "Value", Field::Value },
+            { "ZeroBasedStartIndex", Field::ZeroBasedStartIndex }, { "ZeroBasedEndIndex", Field::ZeroBasedEndIndex },
+            { "Count", Field::Count }, { "Weight", Field::Weight }, { "Name", Field::Name }, { "ValueFlux", Field::ValueFlux },
+            { "KeyFlux", Field::KeyFlux }, { "EvidenceFlux", Field::EvidenceFlux },
+        };
+
+        for (auto& field : fields)
+            if (name == field.first)
+                return field.second;
+
+        throw new ProFormaParseException("Unexpected member \"%s\" in JSON term.", name.c_str());
+    }
+
+    // Descriptor lists written directly as members of the term
+    bool IsDescriptorSection(Field field)
+    {
+        return field == Field::NTerminalDescriptors || field == Field::CTerminalDescriptors || field == Field::LabileDescriptors;
+    }
+
+    // Scalar members of the object being read
+    struct ObjectFields {
+        int Key = 0;
+        int EvidenceType = 0;
+        std::string Value;
+        std::string Name;
+        size_t Start = 0;
+        size_t End = 0;
+        int Count = 1;
+        double Weight = 0.0;
+        bool IsChanging = false;
+
+        void Reset()
+        {
+            Key = EvidenceType = 0;
+            Value.clear();
+            Name.clear();
+            Start = End = 0;
+            Count = 1;
+            Weight = 0.0;
+            IsChanging = false;
+        }
+    };
+
+    // Builds a term from the SAX events of nlohmann::json. Containers are tracked on a fixed stack:
+    // the term object, the section arrays, their items (tags, groups, ...), the nested lists of an
+    // item and the descriptors or members in them.
+    class TermHandler {
+    public:
+        bool null()
+        {
+            // Only empty lists are written as null
+            switch (CurrentField())
+            {
+            case Field::GlobalModifications: case Field::NTerminalDescriptors: case Field::CTerminalDescriptors:
+            case Field::LabileDescriptors: case Field::Tags: case Field::UnlocalizedTags: case Field::TagGroups:
+            case Field::Descriptors: case Field::TargetAminoacids: case Field::Members:
+                return true;
+            default:
+                return Unexpected("null");
+            }
+        }
+
+        bool boolean(bool) { return Unexpected("boolean"); }
+        bool binary(nlohmann::json::binary_t&) { return Unexpected("binary"); }
+
+        bool number_integer(nlohmann::json::number_integer_t value) { return Number(static_cast<double>(value), value >= 0, static_cast<uint64_t>(value)); }
+        bool number_unsigned(nlohmann::json::number_unsigned_t value) { return Number(static_cast<double>(value), true, value); }
+        bool number_float(nlohmann::json::number_float_t value, const std::string&) { return Number(value, false, 0); }
+
+        bool string(std::string& value)
+        {
+            Field field = CurrentField();
+
+            if (_depth == 1 && field == Field::Sequence)
+                _builder.SetSequence(std::move(value));
+            else if (_depth > 1 && field == Field::Value)
+                Current().Value = std::move(value);
+            else if (_depth == 3 && field == Field::Name)
+                _item.Name = std::move(value);
+            else if (_depth == 3 && field == Field::ValueFlux)
+            {
+                _item.IsChanging = true;
+                _item.Value = std::move(value);
+            }
+            else
+                return Unexpected("string");
+
+            return true;
+        }
+
+        bool key(std::string& name)
+        {
+            _field = FieldOf(name);
+            return true;
+        }
+
+        bool start_object(size_t)
+        {
+            Field field = Open(false);
+
+            if (_depth == 1)
+                return true;
+
+            // Tag, unlocalized tag, global modification or group
+            if (_depth == 3 && !IsDescriptorSection(field) && field != Field::Sequence)
+            {
+                _item.Reset();
+                _descriptors.clear();
+                _targets.clear();
+                _members.clear();
+                return true;
+            }
+
+            // Descriptor or group member
+            if ((_depth == 3 && IsDescriptorSection(field)) || (_depth == 5 && (field == Field::Descriptors || field == Field::Members)))
+            {
+                _leaf.Reset();
+                return true;
+            }
+
+            return Unexpected("object");
+        }
+
+        bool end_object()
+        {
+            Field field = _levels[_depth - 1].Member;
+            size_t depth = _depth;
+            _depth--;
+
+            if (depth == 1)
+                _complete = true;
+            else if (depth == 3 && !IsDescriptorSection(field))
+                AddItem(field);
+            else if (field == Field::Members)
+                _members.emplace_back(_leaf.Start, _leaf.End, _leaf.Weight);
+            else
+                _descriptors.emplace_back(ToKey(_leaf.Key), ToEvidenceType(_leaf.EvidenceType), std::move(_leaf.Value));
+
+            return true;
+        }
+
+        bool start_array(size_t)
+        {
+            Field field = Open(true);
+
+            if (_depth == 2 && (IsDescriptorSection(field) || field == Field::GlobalModifications || field == Field::Tags ||
+                field == Field::UnlocalizedTags || field == Field::TagGroups))
+            {
+                _descriptors.clear();
+                return true;
+            }
+
+            if (_depth == 4 && (field == Field::Descriptors || field == Field::TargetAminoacids || field == Field::Members))
+                return true;
+
+            return Unexpected("array");
+        }
+
+        bool end_array()
+        {
+            Field field = _levels[--_depth].Member;
+
+            if (field == Field::NTerminalDescriptors)
+                _builder.SetNTerminalDescriptors(std::move(_descriptors));
+            else if (field == Field::CTerminalDescriptors)
+                _builder.SetCTerminalDescriptors(std::move(_descriptors));
+            else if (field == Field::LabileDescriptors)
+                _builder.SetLabileDescriptors(std::move(_descriptors));
+
+            return true;
+        }
+
+        bool parse_error(size_t position, const std::string&, const nlohmann::detail::exception& ex)
+        {
+            throw new ProFormaParseException("Invalid JSON at byte %zu: %s", position, ex.what());
+        }
+
+        /** \brief  The term read, once the whole object was seen. */
+        ProFormaTerm Build() &&
+        {
+            if (!_complete)
+                throw new ProFormaParseException("Incomplete JSON term.");
+
+            return std::move(_builder).Build();
+        }
+    private:
+        struct Level {
+            Field Member;
+            bool IsArray;
+        };
+
+        static const size_t MaxDepth = 6;
+
+        // Field a value belongs to: the member just named, or the array holding it
+        Field CurrentField() const
+        {
+            if (_depth > 0 && _levels[_depth - 1].IsArray)
+                return _levels[_depth - 1].Member;
+            return _field;
+        }
+
+        // Scalars of a descriptor or member go to the leaf, the rest to the item
+        ObjectFields& Current()
+        {
+            if (_depth == 3 && !IsDescriptorSection(_levels[1].Member))
+                return _item;
+            return _leaf;
+        }
+
+        Field Open(bool isArray)
+        {
+            if (_depth == MaxDepth)
+                throw new ProFormaParseException("JSON term nested deeper than its schema.");
+
+            Field field = _depth == 0 ? Field::None : CurrentField();
+            _levels[_depth++] = Level{ field, isArray };
+            return field;
+        }
+
+        bool Number(double value, bool isIndex, uint64_t index)
+        {
+            Field field = CurrentField();
+            bool isInteger = value == static_cast<double>(static_cast<int64_t>(value));
+
+            if (field == Field::Weight)
+            {
+                Current().Weight = value;
+                return true;
+            }
+
+            if (!isInteger || !isIndex)
+                return Unexpected("number");
+
+            switch (field)
+            {
+            case Field::Key:                    Current().Key = static_cast<int>(index); break;
+            case Field::EvidenceType:           Current().EvidenceType = static_cast<int>(index); break;
+            case Field::ZeroBasedStartIndex:    Current().Start = static_cast<size_t>(index); break;
+            case Field::ZeroBasedEndIndex:      Current().End = static_cast<size_t>(index); break;
+            case Field::Count:                  _item.Count = static_cast<int>(index); break;
+            case Field::TargetAminoacids:       _targets.push_back(static_cast<char>(index)); break;
+            case Field::KeyFlux:                // Same as Key and EvidenceType on a changing group
+            case Field::EvidenceFlux:           break;
+            default:
+                return Unexpected("number");
+            }
+
+            return true;
+        }
+
+        void AddItem(Field section)
+        {
+            switch (section)
+            {
+            case Field::GlobalModifications:
+                _builder.AddGlobalModification(std::move(_descriptors), std::move(_targets));
+                break;
+            case Field::Tags:
+                _builder.AddTag(_item.Start, _item.End, std::move(_descriptors));
+                break;
+            case Field::UnlocalizedTags:
+                _builder.AddUnlocalizedTag(_item.Count, std::move(_descriptors));
+                break;
+            default: // TagGroups
+                if (_builder.FindTagGroup(_item.Name))
+                    throw new ProFormaParseException("Tag group %s appears twice in JSON term.", _item.Name.c_str());
+
+                if (_item.IsChanging)
+                {
+                    auto group = new ProFormaTagGroupChangingValue(std::move(_item.Name), ToKey(_item.Key), ToEvidenceType(_item.EvidenceType), std::move(_members));
+                    group->SetValueFlux(std::move(_item.Value));
+                    _builder.AddTagGroup(group);
+                }
+                else
+                    _builder.AddTagGroup(new ProFormaTagGroup(std::move(_item.Name), ToKey(_item.Key), ToEvidenceType(_item.EvidenceType), std::move(_item.Value), std::move(_members)));
+                break;
+            }
+        }
+
+        static ProFormaKey ToKey(int key)
+        {
+            if (key < static_cast<int>(ProFormaKey::None) || key > static_cast<int>(ProFormaKey::Info))
+                throw new ProFormaParseException("Unknown descriptor key %d in JSON term.", key);
+            return static_cast<ProFormaKey>(key);
+        }
+
+        static ProFormaEvidenceType ToEvidenceType(int evidenceType)
+        {
+            if (evidenceType < static_cast<int>(ProFormaEvidenceType::None) || evidenceType > static_cast<int>(ProFormaEvidenceType::Brno))
+                throw new ProFormaParseException("Unknown evidence type %d in JSON term.", evidenceType);
+            return static_cast<ProFormaEvidenceType>(evidenceType);
+        }
+
+        bool Unexpected(const char* what)
+        {
+            throw new ProFormaParseException("Unexpected %s in JSON term at depth %zu.", what, _depth);
+        }
+
+        ProFormaTermBuilder _builder;
+        Level _levels[MaxDepth];
+        size_t _depth = 0;
+        Field _field = Field::None;
+        bool _complete = false;
+
+        ObjectFields _item;
+        ObjectFields _leaf;
+        std::list<ProFormaDescriptor> _descriptors;
+        std::vector<char> _targets;
+        std::list<ProFormaMembershipDescriptor> _members;
+    };
+
+    // Reads one line of a JSON Lines input, failures report the line number
+    bool ReadLine(const char* line, size_t length, size_t lineNumber, const std::function<void(ProFormaTerm&&)>& onTerm)
+    {
+        while (length > 0 && isspace(static_cast<unsigned char>(line[length - 1])))
+            length--;
+        while (length > 0 && isspace(static_cast<unsigned char>(*line)))
+        {
+            line++;
+            length--;
+        }
+
+        if (length == 0)
+            return false;
+
+        try
+        {
+            onTerm(ProFormaJsonReader::ReadTerm(line, length));
+        }
+        catch (ProFormaParseException* e)
+        {
+            auto lineError = new ProFormaParseException("Line %zu: %s", lineNumber, e->what());
+            delete e;
+            throw lineError;
+        }
+
+        return true;
+    }
+}
+
+/*****************************************************************************/
+// PUBLIC
+/*****************************************************************************/
+
+ProFormaTerm ProFormaJsonReader::ReadTerm(const std::string& json)
+{
+    return ReadTerm(json.data(), json.length());
+}
+
+ProFormaTerm ProFormaJsonReader::ReadTerm(const char* json, size_t length)
+{
+    TermHandler handler;
+    nlohmann::json::sax_parse(json, json + length, &handler);
+    return std::move(handler).Build();
+}
+
+size_t ProFormaJsonReader::ReadJsonLines(const std::string& text, const std::function<void(ProFormaTerm&&)>& onTerm)
+{
+    size_t count = 0;
+    size_t lineNumber = 1;
+
+    for (size_t start = 0; start < text.length(); lineNumber++)
+    {
+        size_t end = text.find('\n', start);
+        if (end == std::string::npos)
+            end = text.length();
+
+        if (ReadLine(text.data() + start, end - start, lineNumber, onTerm))
+            count++;
+
+        start = end + 1;
+    }
+
+    return count;
+}
+
+size_t ProFormaJsonReader::ReadJsonLines(std::istream& stream, const std::function<void(ProFormaTerm&&)>& onTerm)
+{
+    std::string line;
+    size_t count = 0;
+
+    for (size_t lineNumber = 1; std::getline(stream, line); lineNumber++)
+    {
+        if (ReadLine(line.data(), line.length(), lineNumber, onTerm))
+            count++;
+    }
+
+    return count;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <functional>
+#include <istream>
+#include <string>
+
+#include "PlatformHelper.h"
+
+#include "ProFormaTerm.h"
+
+namespace ProForma {
+	/**
+	 * \class ProFormaJsonReader
+	 *
+	 * \brief Reads back ProFormaTerm objects from the JSON written by ProFormaWriter::TermToJson, in both
+	 *        the standard and the compact format. The JSON is consumed as SAX events and the term is
+	 *        built directly, no JSON document is created. Invalid JSON or JSON not following the
+	 *        schema raises a ProFormaParseException.
+	 *
+	 */
+	class EXPORT ProFormaJsonReader {
+	public:
+		/** No constructors for this class, just helper methods */
+		ProFormaJsonReader() = delete;
+
+        /** \brief  Reads a term from a single JSON object
+		  * \param  json The JSON text.
+		  * \return the term
+		  */
+        static ProFormaTerm ReadTerm(const std::string& json);
+
+        /** \brief  Reads a term from a single JSON object
+		  * \param  json The JSON text.
+		  * \param  length The length of the JSON text.
+		  * \return the term
+		  */
+        static ProFormaTerm ReadTerm(const char* json, size_t length);
+
+        /** \brief  Reads a JSON Lines text, one term per line. Blank lines are skipped.
+		  * \param  text The JSON Lines text.
+		  * \param  onTerm Called with every term, in order.
+		  * \return the number of terms read
+		  */
+        static size_t ReadJsonLines(const std::string& text, const std::function<void(ProFormaTerm&&)>& onTerm);
+
+        /** \brief  Reads a JSON Lines stream, one term per line. Blank lines are skipped.
+		  * \param  stream The JSON Lines stream.
+		  * \param  onTerm Called with every term, in order.
+		  * \return the number of terms read
+		  */
+        static size_t ReadJsonLines(std::istream& stream, const std::function<void(ProFormaTerm&&)>& onTerm);
+	};
+}
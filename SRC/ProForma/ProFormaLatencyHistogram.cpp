@@ -0,0 +1,137 @@
+#include "ProFormaLatencyHistogram.h"
+
+#include <atomic>
+
+using namespace ProForma;
+
+namespace {
+    // Recording form of ProFormaLatencyHistogram, zero initialized as a static
+    struct AtomicHistogram {
+        std::atomic<uint64_t> Buckets[ProFormaLatencyHistogram::BucketCount];
+        std::atomic<uint64_t> Sum;
+
+        // Min + 1, so 0 means empty like the other fields
+        std::atomic<uint64_t> MinPlusOne;
+        std::atomic<uint64_t> Max;
+    };
+
+    AtomicHistogram _histograms[ProFormaLatency::OperationCount][ProFormaLatency::LengthClassCount];
+    std::atomic<bool> _enabled{ false };
+
+    void CopyTo(ProFormaLatencyHistogram& histogram, const AtomicHistogram& recorded)
+    {
+        ProFormaLatencyHistogram copy;
+
+        for (size_t i = 0; i < ProFormaLatencyHistogram::BucketCount; i++)
+        {
+            copy.Buckets[i] = recorded.Buckets[i].load(std::memory_order_relaxed);
+            copy.Count += copy.Buckets[i];
+        }
+
+        copy.Sum = recorded.Sum.load(std::memory_order_relaxed);
+        uint64_t minPlusOne = recorded.MinPlusOne.load(std::memory_order_relaxed);
+        copy.Min = minPlusOne > 0 ? minPlusOne - 1 : 0;
+        copy.Max = recorded.Max.load(std::memory_order_relaxed);
+
+        histogram.Merge(copy);
+    }
+}
+
+/*****************************************************************************/
+// PUBLIC
+/*****************************************************************************/
+
+void ProFormaLatency::SetEnabled(bool enabled)
+{
+    _enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool ProFormaLatency::Enabled()
+{
+    return _enabled.load(std::memory_order_relaxed);
+}
+
+void ProFormaLatency::Record(ProFormaOperation operation, size_t length, uint64_t nanoseconds)
+{
+    AtomicHistogram& histogram = _histograms[static_cast<size_t>(operation)][static_cast<size_t>(LengthClass(length))];
+
+    histogram.Buckets[ProFormaLatencyHistogram::BucketIndex(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+    histogram.Sum.fetch_add(nanoseconds, std::memory_order_relaxed);
+
+    // Compare and swap only while the value improves on the current bounds, which is rare
+    uint64_t max = histogram.Max.load(std::memory_order_relaxed);
+    while (nanoseconds > max && !histogram.Max.compare_exchange_weak(max, nanoseconds, std::memory_order_relaxed))
+        ;
+
+    uint64_t minPlusOne = histogram.MinPlusOne.load(std::memory_order_relaxed);
+    while ((minPlusOne == 0 || nanoseconds + 1 < minPlusOne) && !histogram.MinPlusOne.compare_exchange_weak(minPlusOne, nanoseconds + 1, std::memory_order_relaxed))
+        ;
+}
+
+ProFormaLatencyHistogram ProFormaLatency::Snapshot(ProFormaOperation operation, ProFormaLengthClass lengthClass)
+{
+    ProFormaLatencyHistogram histogram;
+    CopyTo(histogram, _histograms[static_cast<size_t>(operation)][static_cast<size_t>(lengthClass)]);
+    return histogram;
+}
+
+ProFormaLatencyHistogram ProFormaLatency::Snapshot(ProFormaOperation operation)
+{
+    ProFormaLatencyHistogram histogram;
+    for (size_t i = 0; i < LengthClassCount; i++)
+        CopyTo(histogram, _histograms[static_cast<size_t>(operation)][i]);
+    return histogram;
+}
+
+void ProFormaLatency::Reset()
+{
+    for (auto& operation : _histograms)
+    {
+        for (auto& histogram : operation)
+        {
+            for (auto& bucket : histogram.Buckets)
+                bucket.store(0, std::memory_order_relaxed);
+            histogram.Sum.store(0, std::memory_order_relaxed);
+            histogram.MinPlusOne.store(0, std::memory_order_relaxed);
+            histogram.Max.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+ProFormaLengthClass ProFormaLatency::LengthClass(size_t length)
+{
+    if (length <= 16) return ProFormaLengthClass::UpTo16;
+    if (length <= 64) return ProFormaLengthClass::UpTo64;
+    if (length <= 256) return ProFormaLengthClass::UpTo256;
+    if (length <= 1024) return ProFormaLengthClass::UpTo1024;
+    if (length <= 4096) return ProFormaLengthClass::UpTo4096;
+    return ProFormaLengthClass::Longer;
+}
+
+const char* ProFormaLatency::OperationName(ProFormaOperation operation)
+{
+    switch (operation)
+    {
+    case ProFormaOperation::Parse: return "parse";
+    case ProFormaOperation::ParseMulti: return "parse_multi";
+    case ProFormaOperation::WriteString: return "write_string";
+    case ProFormaOperation::WriteJson: return "write_json";
+    case ProFormaOperation::WriteCbor: return "write_cbor";
+    case ProFormaOperation::WriteMsgPack: return "write_msgpack";
+    }
+    return "unknown";
+}
+
+const char* ProFormaLatency::LengthClassName(ProFormaLengthClass lengthClass)
+{
+    switch (lengthClass)
+    {
+    case ProFormaLengthClass::UpTo16: return "0-16";
+    case ProFormaLengthClass::UpTo64: return "17-64";
+    case ProFormaLengthClass::UpTo256: return "65-256";
+    case ProFormaLengthClass::UpTo1024: return "257-1024";
+    case ProFormaLengthClass::UpTo4096: return "1025-4096";
+    case ProFormaLengthClass::Longer: return "4097+";
+    }
+    return "unknown";
+}
@@ -0,0 +1,229 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "PlatformHelper.h"
+
+namespace ProForma {
+	/**
+	 * \struct ProFormaLatencyHistogram
+	 *
+	 * \brief Log-linear histogram of durations in nanoseconds, in the manner of HdrHistogram. Values below 64
+	 *        have a bucket each, above every power of two is split in 32 buckets of equal width, so a value
+	 *        is known within 1/32 (3%). Durations from 2^36 ns (about 68 s) up share the last bucket, Max
+	 *        stays exact. The memory is fixed, 8 KB of buckets.
+	 *
+	 *        This is the plain form, returned by ProFormaLatency::Snapshot and usable on its own.
+	 *
+	 */
+	struct ProFormaLatencyHistogram {
+		static const unsigned SubBucketBits = 6;
+		static const unsigned MaxBits = 36;
+		static const size_t HalfSubBucketCount = size_t(1) << (SubBucketBits - 1);
+		static const size_t BucketCount = (MaxBits - SubBucketBits + 2) * HalfSubBucketCount;
+
+		/**< Number of values per bucket */
+		uint64_t Buckets[BucketCount] = {};
+
+		/**< Number of values */
+		uint64_t Count = 0;
+
+		/**< Sum of the values, for the mean */
+		uint64_t Sum = 0;
+
+		/**< Smallest and largest value, 0 while empty */
+		uint64_t Min = 0;
+		uint64_t Max = 0;
+
+		/** \brief  Bucket of a value */
+		static size_t BucketIndex(uint64_t value)
+		{
+			if (value < (uint64_t(1) << SubBucketBits))
+				return static_cast<size_t>(value);
+			if (value >= (uint64_t(1) << MaxBits))
+				return BucketCount - 1;
+
+			unsigned shift = HighestBit(value) - SubBucketBits + 1;
+			return shift * HalfSubBucketCount + static_cast<size_t>(value >> shift);
+		}
+
+		/** \brief  Smallest value of a bucket */
+		static uint64_t BucketLowerBound(size_t index)
+		{
+			if (index < 2 * HalfSubBucketCount)
+				return index;
+
+			unsigned shift = static_cast<unsigned>(index / HalfSubBucketCount - 1);
+			return static_cast<uint64_t>(index % HalfSubBucketCount + HalfSubBucketCount) << shift;
+		}
+
+		/** \brief  Largest value of a bucket */
+		static uint64_t BucketUpperBound(size_t index)
+		{
+			return index + 1 < BucketCount ? BucketLowerBound(index + 1) - 1 : UINT64_MAX;
+		}
+
+		/** \brief  Adds a value */
+		void Record(uint64_t value)
+		{
+			Buckets[BucketIndex(value)]++;
+			Min = (Count == 0 || value < Min) ? value : Min;
+			Max = value > Max ? value : Max;
+			Count++;
+			Sum += value;
+		}
+
+		/** \brief  Adds the values of another histogram */
+		void Merge(const ProFormaLatencyHistogram& other)
+		{
+			if (other.Count == 0)
+				return;
+
+			for (size_t i = 0; i < BucketCount; i++)
+				Buckets[i] += other.Buckets[i];
+
+			Min = (Count == 0 || other.Min < Min) ? other.Min : Min;
+			Max = other.Max > Max ? other.Max : Max;
+			Count += other.Count;
+			Sum += other.Sum;
+		}
+
+		/** \brief  Removes every value */
+		void Reset() { *this = ProFormaLatencyHistogram(); }
+
+		/** \brief  Mean of the values, 0 while empty */
+		double Mean() const { return Count == 0 ? 0.0 : static_cast<double>(Sum) / static_cast<double>(Count); }
+
+		/** \brief  Value below which the given fraction of the values falls, the top of its bucket
+		  * \param  quantile Fraction between 0 and 1, 0.99 for the 99th percentile.
+		  * \return the value, 0 while empty
+		  */
+		uint64_t ValueAtQuantile(double quantile) const
+		{
+			if (Count == 0)
+				return 0;
+			if (quantile <= 0.0)
+				return Min;
+
+			uint64_t rank = static_cast<uint64_t>(quantile * static_cast<double>(Count) + 0.5);
+			rank = rank < 1 ? 1 : (rank > Count ? Count : rank);
+
+			uint64_t seen = 0;
+			for (size_t i = 0; i < BucketCount; i++)
+			{
+				seen += Buckets[i];
+				if (seen >= rank)
+				{
+					uint64_t upper = BucketUpperBound(i);
+					return upper < Max ? (upper > Min ? upper : Min) : Max;
+				}
+			}
+
+			return Max;
+		}
+
+	private:
+		static unsigned HighestBit(uint64_t value)
+		{
+#if defined(__GNUC__) || defined(__clang__)
+			return 63 - static_cast<unsigned>(__builtin_clzll(value));
+#elif defined(_MSC_VER) && defined(_WIN64)
+			unsigned long bit;
+			_BitScanReverse64(&bit, value);
+			return static_cast<unsigned>(bit);
+#else
+			unsigned bit = 0;
+			while (value >>= 1)
+				bit++;
+			return bit;
+#endif
+		}
+	};
+
+	/** @enum ProFormaOperation
+	 *  @brief Entry points timed by ProFormaLatency
+	 */
+	enum class ProFormaOperation {
+		/**< ProFormaParser::ParseString */
+		Parse = 0,
+
+		/**< ProFormaParser::ParseMultiString */
+		ParseMulti = 1,
+
+		/**< ProFormaWriter::TermToString and AppendTo */
+		WriteString = 2,
+
+		/**< ProFormaWriter::TermToJson and AppendJsonTo, once per term of WriteJsonLines */
+		WriteJson = 3,
+
+		/**< ProFormaWriter::TermToCbor and AppendCborTo */
+		WriteCbor = 4,
+
+		/**< ProFormaWriter::TermToMsgPack and AppendMsgPackTo */
+		WriteMsgPack = 5
+	};
+
+	/** @enum ProFormaLengthClass
+	 *  @brief Input size of a timed call: the string length for the parser, the sequence length for the writer
+	 */
+	enum class ProFormaLengthClass {
+		UpTo16 = 0,
+		UpTo64 = 1,
+		UpTo256 = 2,
+		UpTo1024 = 3,
+		UpTo4096 = 4,
+		Longer = 5
+	};
+
+	/**
+	 * \class ProFormaLatency
+	 *
+	 * \brief Latency histograms of the parser and writer entry points, one per operation and length class.
+	 *        Recording is off until SetEnabled(true), then every call reads the clock twice and adds to the
+	 *        histogram with relaxed atomic increments, no lock is taken. The parsers and the writer record
+	 *        whenever Enabled() is true, whatever the CollectStats setting of the parser policy.
+	 *
+	 */
+	class EXPORT ProFormaLatency {
+	public:
+		static const size_t OperationCount = 6;
+		static const size_t LengthClassCount = 6;
+
+		/** \brief  Turns the recording on or off for every thread */
+		static void SetEnabled(bool enabled);
+
+		/** \brief  Whether the calls are being timed */
+		static bool Enabled();
+
+		/** \brief  Adds a duration, used by the parser and the writer
+		  * \param  operation The timed entry point.
+		  * \param  length Input length, see ProFormaLengthClass.
+		  * \param  nanoseconds Duration of the call.
+		  * \return void
+		  */
+		static void Record(ProFormaOperation operation, size_t length, uint64_t nanoseconds);
+
+		/** \brief  Copy of the histogram of an operation for one length class */
+		static ProFormaLatencyHistogram Snapshot(ProFormaOperation operation, ProFormaLengthClass lengthClass);
+
+		/** \brief  Copy of the histogram of an operation, every length class merged */
+		static ProFormaLatencyHistogram Snapshot(ProFormaOperation operation);
+
+		/** \brief  Empties every histogram, values recorded meanwhile may be kept or lost */
+		static void Reset();
+
+		/** \brief  Length class of an input length */
+		static ProFormaLengthClass LengthClass(size_t length);
+
+		/** \brief  Lower case name of an operation, e.g. "parse" or "write_json" */
+		static const char* OperationName(ProFormaOperation operation);
+
+		/** \brief  Name of a length class, e.g. "17-64" or "4097+" */
+		static const char* LengthClassName(ProFormaLengthClass lengthClass);
+	};
+}
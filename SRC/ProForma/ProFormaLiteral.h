@@ -0,0 +1,358 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "ProFormaKey.h"
+#include "ProFormaParseException.h"
+#include "ProFormaTerm.h"
+
+namespace ProForma {
+	/**
+	 * \struct ProFormaStaticDescriptor
+	 *
+	 * \brief Descriptor of a compile-time parsed term. The value is Prefix followed by Text, both
+	 *        viewing static storage (the literal itself or the constant prefix table).
+	 *
+	 */
+	struct ProFormaStaticDescriptor {
+		ProFormaKey Key = ProFormaKey::None;
+		ProFormaEvidenceType EvidenceType = ProFormaEvidenceType::None;
+		std::string_view Prefix;
+		std::string_view Text;
+
+		/** \brief  The descriptor value, as ProFormaParser would have stored it. */
+		std::string Value() const { return std::string(Prefix).append(Text); }
+	};
+
+	/**
+	 * \struct ProFormaStaticRange
+	 *
+	 * \brief Location of a tag (or the descriptors of a global modification) inside a ProFormaStaticTerm.
+	 *
+	 */
+	struct ProFormaStaticRange {
+		size_t ZeroBasedIndex = 0;
+		size_t FirstDescriptor = 0;
+		size_t DescriptorCount = 0;
+		std::string_view Targets;
+	};
+
+	/**
+	 * \class ProFormaStaticTerm
+	 *
+	 * \brief Fixed capacity term filled by a constexpr parser, meant for ProForma literals embedded in code:
+	 *
+	 *        constexpr auto fixedMods = "<[Carbamidomethyl]@C>"_proforma;
+	 *
+	 * Declaring the result constexpr forces the parse at compile time, syntax errors and exceeded capacities
+	 * become compilation errors and the term lives in static data. The supported subset is global modifications
+	 * (with or without targets), N/C-terminal modifications and localized tags with '|' separated descriptors.
+	 * Tag groups, ranges, labile and unlocalized modifications are rejected.
+	 *
+	 */
+	template <size_t MaxResidues, size_t MaxTags, size_t MaxDescriptors>
+	class ProFormaStaticTerm {
+	public:
+		/** \brief  Parses the literal, evaluated at compile time when the result is declared constexpr.
+		  * \param  text The ProForma text, must outlive the term (string literals do).
+		  * \return The parsed term.
+		  */
+		static constexpr ProFormaStaticTerm Parse(std::string_view text)
+		{
+			ProFormaStaticTerm term;
+			size_t i = 0;
+
+			if (text.empty())
+				throw new ProFormaParseException("Empty proforma string");
+
+			// Global modifications come first
+			while (i < text.length() && text[i] == '<')
+			{
+				size_t end = Find(text, '>', i);
+				std::string_view inner = text.substr(i + 1, end - i - 1);
+				size_t at = inner.rfind('@');
+				ProFormaStaticRange global;
+
+				if (at != std::string_view::npos)
+				{
+					if (inner.length() < 2 || inner[0] != '[' || inner[at - 1] != ']')
+						throw new ProFormaParseException("Global modification with targets must be written <[...]@...>.");
+
+					global.Targets = inner.substr(at + 1);
+					for (char target : global.Targets)
+						if (!IsUpper(target) && target != ',')
+							throw new ProFormaParseException("Unexpected character in global modification target list.");
+
+					inner = inner.substr(1, at - 2);
+				}
+
+				term.AddDescriptors(inner, global);
+				term.Push(term._globalModifications, term._globalModificationCount, MaxTags, global);
+				i = end + 1;
+			}
+
+			// N-terminal modification
+			if (i < text.length() && text[i] == '[')
+			{
+				size_t end = Find(text, ']', i);
+				if (end + 1 >= text.length() || text[end + 1] != '-')
+					throw new ProFormaParseException("Only N-terminal modifications may precede the sequence in a literal.");
+
+				term.AddDescriptors(text.substr(i + 1, end - i - 1), term._nTerminal);
+				i = end + 2;
+			}
+
+			// Residues, localized tags and C-terminal modification
+			while (i < text.length())
+			{
+				char current = text[i];
+
+				if (current == '[')
+				{
+					if (term._residueCount == 0)
+						throw new ProFormaParseException("Invalid n terminal descriptor.");
+
+					size_t end = Find(text, ']', i);
+					ProFormaStaticRange tag;
+					tag.ZeroBasedIndex = term._residueCount - 1;
+
+					term.AddDescriptors(text.substr(i + 1, end - i - 1), tag);
+					term.Push(term._tags, term._tagCount, MaxTags, tag);
+					i = end + 1;
+
+					if (i < text.length() && text[i] == '[')
+						throw new ProFormaParseException("Two tags next to eachother are not allowed.");
+				}
+				else if (current == '-')
+				{
+					if (i + 1 >= text.length() || text[i + 1] != '[' || text[text.length() - 1] != ']' || Find(text, ']', i) != text.length() - 1)
+						throw new ProFormaParseException("- must be followed by the C-terminal modification ending the string.");
+
+					term.AddDescriptors(text.substr(i + 2, text.length() - i - 3), term._cTerminal);
+					i = text.length();
+				}
+				else if (IsUpper(current))
+				{
+					if (term._residueCount == MaxResidues)
+						throw new ProFormaParseException("Literal exceeds the residue capacity of the static term.");
+
+					term._residues[term._residueCount++] = current;
+					i++;
+				}
+				else
+				{
+					throw new ProFormaParseException("Character not supported in ProForma literals, only upper case residues and tags are allowed.");
+				}
+			}
+
+			return term;
+		}
+
+		/** \brief  The amino acid sequence. */
+		constexpr std::string_view Sequence() const { return std::string_view(_residues, _residueCount); }
+
+		/** \brief  Number of localized tags. */
+		constexpr size_t TagCount() const { return _tagCount; }
+
+		/** \brief  Localized tag at the given position. */
+		constexpr const ProFormaStaticRange& Tag(size_t index) const { return _tags[index]; }
+
+		/** \brief  Number of global modifications. */
+		constexpr size_t GlobalModificationCount() const { return _globalModificationCount; }
+
+		/** \brief  Global modification at the given position. */
+		constexpr const ProFormaStaticRange& GlobalModification(size_t index) const { return _globalModifications[index]; }
+
+		/** \brief  Descriptors of the N-terminal modification. */
+		constexpr const ProFormaStaticRange& NTerminal() const { return _nTerminal; }
+
+		/** \brief  Descriptors of the C-terminal modification. */
+		constexpr const ProFormaStaticRange& CTerminal() const { return _cTerminal; }
+
+		/** \brief  Descriptor referenced by a range. */
+		constexpr const ProFormaStaticDescriptor& Descriptor(size_t index) const { return _descriptors[index]; }
+
+		/** \brief  Creates the equivalent runtime ProFormaTerm, no parsing involved.
+		  * \return The term, as ProFormaParser::ParseString would return it.
+		  */
+		ProFormaTerm ToTerm() const
+		{
+			std::list<ProFormaTag> tags;
+			std::list<ProFormaGlobalModification> globalModifications;
+
+			for (size_t i = 0; i < _tagCount; i++)
+				tags.push_back(ProFormaTag(_tags[i].ZeroBasedIndex, ToDescriptors(_tags[i])));
+
+			for (size_t i = 0; i < _globalModificationCount; i++)
+			{
+				std::vector<char> targets;
+				for (char target : _globalModifications[i].Targets)
+					if (target != ',')
+						targets.push_back(target);
+
+				globalModifications.push_back(ProFormaGlobalModification(ToDescriptors(_globalModifications[i]), targets));
+			}
+
+			return ProFormaTerm(std::string(Sequence()), tags, ToDescriptors(_nTerminal), ToDescriptors(_cTerminal),
+				std::list<ProFormaDescriptor>(), std::list<ProFormaUnlocalizedTag>(), std::map<std::string, ProFormaTagGroup*>(),
+				globalModifications);
+		}
+
+	private:
+		char _residues[MaxResidues] = {};
+		size_t _residueCount = 0;
+		ProFormaStaticDescriptor _descriptors[MaxDescriptors] = {};
+		size_t _descriptorCount = 0;
+		ProFormaStaticRange _tags[MaxTags] = {};
+		size_t _tagCount = 0;
+		ProFormaStaticRange _globalModifications[MaxTags] = {};
+		size_t _globalModificationCount = 0;
+		ProFormaStaticRange _nTerminal = {};
+		ProFormaStaticRange _cTerminal = {};
+
+		static constexpr bool IsUpper(char c) { return c >= 'A' && c <= 'Z'; }
+		static constexpr char ToLower(char c) { return IsUpper(c) ? static_cast<char>(c - 'A' + 'a') : c; }
+
+		static constexpr size_t Find(std::string_view text, char c, size_t from)
+		{
+			size_t index = text.find(c, from);
+			if (index == std::string_view::npos)
+				throw new ProFormaParseException("Unclosed tag in ProForma literal.");
+			return index;
+		}
+
+		static constexpr bool KeyEquals(std::string_view key, std::string_view lower)
+		{
+			if (key.length() != lower.length())
+				return false;
+			for (size_t i = 0; i < key.length(); i++)
+				if (ToLower(key[i]) != lower[i])
+					return false;
+			return true;
+		}
+
+		template <typename T>
+		static constexpr void Push(T* items, size_t& count, size_t capacity, const T& item)
+		{
+			if (count == capacity)
+				throw new ProFormaParseException("Literal exceeds the tag capacity of the static term.");
+			items[count++] = item;
+		}
+
+		// Splits the tag content on '|' and classifies each descriptor like ProFormaParser::ParseDescriptor
+		constexpr void AddDescriptors(std::string_view tag, ProFormaStaticRange& range)
+		{
+			range.FirstDescriptor = _descriptorCount;
+
+			while (true)
+			{
+				size_t bar = tag.find('|');
+				std::string_view text = tag.substr(0, bar);
+
+				while (!text.empty() && text[0] == ' ')
+					text.remove_prefix(1);
+
+				if (text.empty())
+					throw new ProFormaParseException("Cannot have an empty descriptor.");
+				if (text.find('#') != std::string_view::npos)
+					throw new ProFormaParseException("Tag groups are not supported in ProForma literals.");
+
+				Push(_descriptors, _descriptorCount, MaxDescriptors, ClassifyDescriptor(text));
+				range.DescriptorCount++;
+
+				if (bar == std::string_view::npos)
+					break;
+				tag.remove_prefix(bar + 1);
+			}
+		}
+
+		static constexpr ProFormaStaticDescriptor ClassifyDescriptor(std::string_view text)
+		{
+			ProFormaStaticDescriptor descriptor;
+			size_t colon = text.find(':');
+
+			if (colon == std::string_view::npos)
+			{
+				descriptor.Key = (text[0] == '+' || text[0] == '-') ? ProFormaKey::Mass : ProFormaKey::Name;
+				descriptor.Text = text;
+				return descriptor;
+			}
+
+			std::string_view key = text.substr(0, colon);
+			while (!key.empty() && key[key.length() - 1] == ' ')
+				key.remove_suffix(1);
+
+			std::string_view value = text.substr(colon + 1);
+			ProFormaKey nameOrMass = (!value.empty() && (value[0] == '+' || value[0] == '-')) ? ProFormaKey::Mass : ProFormaKey::Name;
+
+			struct Entry { std::string_view Key; ProFormaKey DescriptorKey; ProFormaEvidenceType Evidence; bool KeepPrefix; };
+			const Entry entries[] = {
+				{ "formula", ProFormaKey::Formula,    ProFormaEvidenceType::None,     false },
+				{ "glycan",  ProFormaKey::Glycan,     ProFormaEvidenceType::None,     false },
+				{ "info",    ProFormaKey::Info,       ProFormaEvidenceType::None,     false },
+				{ "mod",     ProFormaKey::Identifier, ProFormaEvidenceType::PsiMod,   true },
+				{ "unimod",  ProFormaKey::Identifier, ProFormaEvidenceType::Unimod,   true },
+				{ "xlmod",   ProFormaKey::Identifier, ProFormaEvidenceType::XlMod,    true },
+				{ "gno",     ProFormaKey::Identifier, ProFormaEvidenceType::Gno,      true },
+				{ "resid",   ProFormaKey::Identifier, ProFormaEvidenceType::Resid,    false },
+				{ "u",       nameOrMass,              ProFormaEvidenceType::Unimod,   false },
+				{ "m",       nameOrMass,              ProFormaEvidenceType::PsiMod,   false },
+				{ "r",       nameOrMass,              ProFormaEvidenceType::Resid,    false },
+				{ "x",       nameOrMass,              ProFormaEvidenceType::XlMod,    false },
+				{ "g",       nameOrMass,              ProFormaEvidenceType::Gno,      false },
+				{ "b",       nameOrMass,              ProFormaEvidenceType::Brno,     false },
+				{ "obs",     nameOrMass,              ProFormaEvidenceType::Observed, false },
+			};
+
+			for (const Entry& entry : entries)
+			{
+				if (!KeyEquals(key, entry.Key))
+					continue;
+
+				descriptor.Key = entry.DescriptorKey;
+				descriptor.EvidenceType = entry.Evidence;
+				descriptor.Text = value;
+
+				// The parser keeps the accession prefix of identifiers, Unimod ones upper cased
+				if (entry.KeepPrefix)
+				{
+					if (entry.Evidence == ProFormaEvidenceType::Unimod)
+						descriptor.Prefix = "UNIMOD:";
+					else
+						descriptor.Text = text;
+				}
+
+				return descriptor;
+			}
+
+			// Unknown prefix, the whole text is the name
+			descriptor.Key = ProFormaKey::Name;
+			descriptor.Text = text;
+			return descriptor;
+		}
+
+		std::list<ProFormaDescriptor> ToDescriptors(const ProFormaStaticRange& range) const
+		{
+			std::list<ProFormaDescriptor> descriptors;
+
+			for (size_t i = range.FirstDescriptor; i < range.FirstDescriptor + range.DescriptorCount; i++)
+				descriptors.push_back(ProFormaDescriptor(_descriptors[i].Key, _descriptors[i].EvidenceType, _descriptors[i].Value()));
+
+			return descriptors;
+		}
+	};
+
+	/** \brief  Capacity used by the _proforma literal, enough for fixed modification sets and peptides */
+	typedef ProFormaStaticTerm<256, 32, 64> ProFormaLiteralTerm;
+
+	inline namespace Literals {
+		/** \brief  ProForma literal, declare the result constexpr to parse it at compile time:
+		  *         constexpr auto fixedMods = "<[Carbamidomethyl]@C>"_proforma;
+		  */
+		constexpr ProFormaLiteralTerm operator""_proforma(const char* text, size_t length)
+		{
+			return ProFormaLiteralTerm::Parse(std::string_view(text, length));
+		}
+	}
+}
@@ -1,75 +1,414 @@
 #include "ProFormaLogger.h"
 
+#include <chrono>
+#include <cstdio>
+
 using namespace ProForma;
 
 
 const string ProFormaLogger::_sFileName = "Log.txt";
-ProFormaLogger* ProFormaLogger::_pThis = NULL;
-ofstream ProFormaLogger::_Logfile;
 
+namespace {
+    // Ring of the calling thread, marked retired when the thread ends so the background thread can free it.
+    // The flag is shared, the slot of a thread ending after the static logger was destroyed still owns it.
+    struct ThreadRingSlot {
+        void* Ring = nullptr;
+        std::shared_ptr<std::atomic<bool>> Retired;
+
+        ~ThreadRingSlot()
+        {
+            if (Retired != nullptr)
+                Retired->store(true, std::memory_order_release);
+        }
+    };
+
+    thread_local ThreadRingSlot _threadRing;
+
+    // Records buffered before a write to the output
+    const size_t WriteThreshold = 64 * 1024;
+
+    // printf conversion of a single argument, appended to the buffer
+    template <typename T>
+    void AppendFormatted(std::string& buffer, const char* spec, T value)
+    {
+        char text[256];
+        int length = snprintf(text, sizeof(text), spec, value);
+        if (length < 0)
+            return;
+
+        if (static_cast<size_t>(length) < sizeof(text))
+        {
+            buffer.append(text, length);
+            return;
+        }
+
+        size_t offset = buffer.length();
+        buffer.resize(offset + length + 1);
+        snprintf(&buffer[offset], length + 1, spec, value);
+        buffer.resize(offset + length);
+    }
+}
 
 ProFormaLogger::ProFormaLogger()
+    : _output(&std::cout), _ringCapacity(1024)
 {
 
 }
 
+ProFormaLogger::~ProFormaLogger()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _wake.notify_one();
+
+    if (_thread.joinable())
+        _thread.join();
+}
+
 ProFormaLogger* ProFormaLogger::GetLogger() {
-    if (_pThis = NULL) {
-        _pThis = new ProFormaLogger();
-        //_Logfile.open(std::cout, ios::out | ios::app);
+    static ProFormaLogger logger;
+    return &logger;
+}
+
+bool ProFormaLogger::Open(const std::string& fileName)
+{
+    Flush();
+
+    std::lock_guard<std::mutex> lock(_outputMutex);
+    if (_Logfile.is_open())
+        _Logfile.close();
+
+    _Logfile.open(fileName, ios::out | ios::app | ios::binary);
+    _output = _Logfile.is_open() ? static_cast<std::ostream*>(&_Logfile) : &std::cout;
+    return _Logfile.is_open();
+}
+
+void ProFormaLogger::Flush()
+{
+    {
+        // Nothing was logged yet
+        std::lock_guard<std::mutex> lock(_ringsMutex);
+        if (!_thread.joinable())
+            return;
     }
-    return _pThis;
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    uint64_t request = ++_flushRequests;
+    _wake.notify_one();
+    _done.wait(lock, [this, request] { return _flushesDone >= request; });
 }
 
-void ProFormaLogger::Log(const char* format, ...)
+void ProFormaLogger::SetRingCapacity(size_t records)
 {
-#ifndef RELEASE
-    char* sMessage = NULL;
-    int nLength = 0;
-    va_list args;
-    va_start(args, format);
-    //  Return the number of characters in the string referenced the list of arguments.
-    // _vscprintf doesn't count terminating '\0' (that's why +1)
-    nLength = _vscprintf(format, args) + 1;
-    sMessage = new char[nLength];
-    vsprintf_s(sMessage, nLength, format, args);
-    //vsprintf(sMessage, format, args);
-    //_Logfile << ProFormaLogger::CurrentDateTime() << ":\t";
-    //_Logfile << sMessage << "\n";
-    std::cout << ProFormaLogger::CurrentDateTime() << ":\t";
-    std::cout << sMessage << "\n";
-    va_end(args);
-
-    delete[] sMessage;
-#endif
+    size_t capacity = 1;
+    while (capacity < records)
+        capacity <<= 1;
+
+    std::lock_guard<std::mutex> lock(_ringsMutex);
+    _ringCapacity = capacity;
+}
+
+uint64_t ProFormaLogger::Dropped() const
+{
+    std::lock_guard<std::mutex> lock(_ringsMutex);
+    uint64_t dropped = _retiredDropped.load(std::memory_order_relaxed);
+    for (auto& ring : _rings)
+        dropped += ring->Dropped.load(std::memory_order_relaxed);
+    return dropped;
 }
 
 void ProFormaLogger::Log(const string& sMessage)
 {
-#ifndef RELEASE
-    //_Logfile << ProFormaLogger::CurrentDateTime() << ":\t";
-    //_Logfile << sMessage << "\n";
-    std::cout << ProFormaLogger::CurrentDateTime() << ":\t";
-    std::cout << sMessage << "\n";
-#endif
+    Log("%s", sMessage);
 }
 
 ProFormaLogger& ProFormaLogger::operator<<(const string& sMessage)
 {
-    //_Logfile << "\n" << ProFormaLogger::CurrentDateTime() << ":\t";
-    //_Logfile << sMessage << "\n";
-    std::cout << "\n" << ProFormaLogger::CurrentDateTime() << ":\t";
-    std::cout << sMessage << "\n";
+    Log("%s", sMessage);
     return *this;
 }
 
-// Get current date/time, format is YYYY-MM-DD.HH:mm:ss
-const std::string ProFormaLogger::CurrentDateTime()
+/*****************************************************************************************************************/
+// PRIVATE
+/*****************************************************************************************************************/
+
+void ProFormaLogger::StoreText(Record& record, Argument& argument, const char* text, size_t length)
+{
+    // Truncated to the space left, always null terminated
+    size_t available = sizeof(record.Text) - record.TextLength;
+    if (length >= available)
+        length = available > 0 ? available - 1 : 0;
+
+    argument.Type = ArgumentType::Text;
+    argument.Text.Length = static_cast<uint16_t>(length);
+
+    // A full record ends with the terminator of its last string
+    if (available == 0)
+        argument.Text.Offset = static_cast<uint16_t>(sizeof(record.Text) - 1);
+    else
+    {
+        argument.Text.Offset = record.TextLength;
+        memcpy(record.Text + record.TextLength, text, length);
+        record.Text[record.TextLength + length] = '\0';
+        record.TextLength += static_cast<uint16_t>(length + 1);
+    }
+}
+
+ProFormaLogger::Ring* ProFormaLogger::ThreadRing()
+{
+    if (_threadRing.Ring == nullptr)
+    {
+        Ring* ring = CreateRing();
+        _threadRing.Ring = ring;
+        _threadRing.Retired = ring->Retired;
+    }
+
+    return static_cast<Ring*>(_threadRing.Ring);
+}
+
+ProFormaLogger::Ring* ProFormaLogger::CreateRing()
+{
+    std::lock_guard<std::mutex> lock(_ringsMutex);
+    _rings.push_back(std::make_unique<Ring>(_ringCapacity));
+
+    // Started with the first ring, so parsers that never log do not run it
+    if (!_thread.joinable())
+        _thread = std::thread(&ProFormaLogger::Run, this);
+    return _rings.back().get();
+}
+
+void ProFormaLogger::Run()
+{
+    std::string buffer;
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    while (true)
+    {
+        uint64_t requests = _flushRequests;
+        bool stop = _stop;
+        lock.unlock();
+
+        Drain(buffer);
+        Write(buffer, requests != _flushesDone || stop);
+
+        lock.lock();
+        _flushesDone = requests;
+        _done.notify_all();
+
+        if (stop)
+            break;
+        if (_flushRequests == requests && !_stop)
+            _wake.wait_for(lock, std::chrono::milliseconds(10));
+    }
+}
+
+size_t ProFormaLogger::Drain(std::string& buffer)
+{
+    // Only this thread removes rings, so the pointers stay valid once the lock is released: the records are
+    // formatted and written without holding it, CreateRing() and Dropped() never wait for the output
+    {
+        std::lock_guard<std::mutex> lock(_ringsMutex);
+        _draining.clear();
+        for (auto& ring : _rings)
+            _draining.push_back(ring.get());
+    }
+
+    size_t count = 0;
+    uint64_t dropped = _retiredDropped.load(std::memory_order_relaxed);
+    bool anyRetired = false;
+
+    for (Ring* ring : _draining)
+    {
+        // Read before the head, a retired ring receives nothing after it
+        bool retired = ring->Retired->load(std::memory_order_acquire);
+        uint64_t head = ring->Head.load(std::memory_order_acquire);
+        uint64_t tail = ring->Tail.load(std::memory_order_relaxed);
+        size_t mask = ring->Records.size() - 1;
+
+        for (; tail != head; tail++)
+        {
+            Format(buffer, ring->Records[tail & mask]);
+            if (buffer.length() >= WriteThreshold)
+                Write(buffer, false);
+            count++;
+        }
+        ring->Tail.store(tail, std::memory_order_release);
+
+        dropped += ring->Dropped.load(std::memory_order_relaxed);
+        anyRetired = anyRetired || retired;
+    }
+
+    if (anyRetired)
+    {
+        std::lock_guard<std::mutex> lock(_ringsMutex);
+        for (size_t i = 0; i < _rings.size(); )
+        {
+            Ring& ring = *_rings[i];
+            if (ring.Retired->load(std::memory_order_acquire) && ring.Tail.load(std::memory_order_relaxed) == ring.Head.load(std::memory_order_acquire))
+            {
+                _retiredDropped.fetch_add(ring.Dropped.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                _rings.erase(_rings.begin() + i);
+            }
+            else
+                i++;
+        }
+    }
+
+    if (dropped > _droppedReported)
+    {
+        Record record;
+        record.Format = "%llu messages dropped, the log ring of their thread was full";
+        record.Time = time(nullptr);
+        record.Count = 0;
+        record.TextLength = 0;
+        Store(record, dropped - _droppedReported);
+        Format(buffer, record);
+        _droppedReported = dropped;
+    }
+
+    return count;
+}
+
+void ProFormaLogger::Format(std::string& buffer, const Record& record)
 {
-    time_t     now = time(NULL);
-    struct tm  tstruct;
-    char       buf[80];
-    localtime_s(&tstruct, &now);
-    strftime(buf, sizeof(buf), "%Y-%m-%d.%X", &tstruct);
-    return buf;
+    // Date and time prefix, format is YYYY-MM-DD.HH:mm:ss
+    if (record.Time != _stampTime)
+    {
+        struct tm tstruct;
+#ifdef WIN32
+        localtime_s(&tstruct, &record.Time);
+#else
+        localtime_r(&record.Time, &tstruct);
+#endif
+        strftime(_stamp, sizeof(_stamp), "%Y-%m-%d.%X", &tstruct);
+        _stampTime = record.Time;
+    }
+    buffer += _stamp;
+    buffer += ":\t";
+
+    // Every conversion is formatted alone with its argument, the length modifiers are replaced by the
+    // ones of the stored type
+    const char* format = record.Format;
+    size_t next = 0;
+    char spec[32];
+
+    while (*format != '\0')
+    {
+        const char* percent = strchr(format, '%');
+        if (percent == nullptr)
+        {
+            buffer += format;
+            break;
+        }
+        buffer.append(format, percent - format);
+
+        if (percent[1] == '%')
+        {
+            buffer += '%';
+            format = percent + 2;
+            continue;
+        }
+
+        const char* end = percent + 1;
+        size_t length = 0;
+        spec[length++] = '%';
+        while (*end != '\0' && strchr("-+ #0123456789.", *end) != nullptr)
+        {
+            if (length < sizeof(spec) - 4)
+                spec[length++] = *end;
+            end++;
+        }
+        while (*end != '\0' && strchr("hljztL", *end) != nullptr)
+            end++;
+
+        char conversion = *end;
+        if (conversion == '\0' || next >= record.Count)
+        {
+            // Malformed or missing argument, written as is
+            buffer.append(percent, end - percent + (conversion != '\0' ? 1 : 0));
+            format = end + (conversion != '\0' ? 1 : 0);
+            continue;
+        }
+        format = end + 1;
+
+        const Argument& argument = record.Arguments[next++];
+        bool text = argument.Type == ArgumentType::Text;
+        bool floating = argument.Type == ArgumentType::Floating;
+        long long integer = argument.Type == ArgumentType::Signed ? argument.Signed : static_cast<long long>(argument.Unsigned);
+
+        switch (conversion)
+        {
+        case 'd': case 'i': case 'u': case 'o': case 'x': case 'X':
+            if (!text && !floating)
+            {
+                spec[length++] = 'l';
+                spec[length++] = 'l';
+                spec[length++] = conversion;
+                spec[length] = '\0';
+                AppendFormatted(buffer, spec, integer);
+                continue;
+            }
+            break;
+        case 'c':
+            if (!text && !floating)
+            {
+                spec[length++] = 'c';
+                spec[length] = '\0';
+                AppendFormatted(buffer, spec, static_cast<int>(integer));
+                continue;
+            }
+            break;
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+            if (!text)
+            {
+                spec[length++] = conversion;
+                spec[length] = '\0';
+                AppendFormatted(buffer, spec, floating ? argument.Floating : static_cast<double>(integer));
+                continue;
+            }
+            break;
+        case 's':
+            if (text)
+            {
+                spec[length++] = 's';
+                spec[length] = '\0';
+                AppendFormatted(buffer, spec, static_cast<const char*>(record.Text + argument.Text.Offset));
+                continue;
+            }
+            break;
+        case 'p':
+            if (argument.Type == ArgumentType::Pointer)
+            {
+                AppendFormatted(buffer, "%p", argument.Pointer);
+                continue;
+            }
+            break;
+        }
+
+        // Conversion that does not match the argument, written the natural way
+        switch (argument.Type)
+        {
+        case ArgumentType::Signed: AppendFormatted(buffer, "%lld", argument.Signed); break;
+        case ArgumentType::Unsigned: AppendFormatted(buffer, "%llu", argument.Unsigned); break;
+        case ArgumentType::Floating: AppendFormatted(buffer, "%g", argument.Floating); break;
+        case ArgumentType::Pointer: AppendFormatted(buffer, "%p", argument.Pointer); break;
+        case ArgumentType::Text: buffer.append(record.Text + argument.Text.Offset, argument.Text.Length); break;
+        }
+    }
+
+    buffer += '\n';
+}
+
+void ProFormaLogger::Write(std::string& buffer, bool flush)
+{
+    std::lock_guard<std::mutex> lock(_outputMutex);
+
+    if (!buffer.empty())
+        _output->write(buffer.data(), buffer.length());
+    if (flush)
+        _output->flush();
+
+    buffer.clear();
 }
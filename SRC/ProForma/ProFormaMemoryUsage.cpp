@@ -0,0 +1,142 @@
+#include "ProFormaMemoryUsage.h"
+
+#include <cstdio>
+#include <list>
+#include <map>
+#include <string>
+
+#include "ProFormaTagGroupChangingValue.h"
+#include "ProFormaTerm.h"
+
+using namespace ProForma;
+
+namespace {
+    // Capacity of the small string buffer of this standard library
+    const size_t InlineStringCapacity = std::string().capacity();
+
+    // MSVC allocates the sentinel node of every list and map, the other libraries keep it inline
+#if defined(_MSC_VER)
+    const size_t SentinelNodes = 1;
+#else
+    const size_t SentinelNodes = 0;
+#endif
+
+    size_t StringBytes(const std::string& text)
+    {
+        return text.capacity() > InlineStringCapacity ? ProFormaMemoryUsage::HeapBlock(text.capacity() + 1) : 0;
+    }
+
+    // Nodes of a list: two links and the element
+    template <typename T>
+    size_t ListBytes(const std::list<T>& items)
+    {
+        return (items.size() + SentinelNodes) * ProFormaMemoryUsage::HeapBlock(2 * sizeof(void*) + sizeof(T));
+    }
+
+    size_t DescriptorBytes(const std::list<ProFormaDescriptor>& descriptors)
+    {
+        size_t bytes = ListBytes(descriptors);
+        for (auto& descriptor : descriptors)
+            bytes += StringBytes(descriptor.Value());
+        return bytes;
+    }
+}
+
+/*****************************************************************************/
+// PUBLIC
+/*****************************************************************************/
+
+ProFormaMemoryUsage ProFormaTerm::ApproximateMemoryUsage() const
+{
+    ProFormaMemoryUsage usage;
+    usage.Terms = 1;
+    usage.Term = sizeof(ProFormaTerm);
+    usage.Sequence = StringBytes(_sequence);
+
+    usage.Descriptors = DescriptorBytes(_nTerminalDescriptors) + DescriptorBytes(_cTerminalDescriptors) + DescriptorBytes(_labileDescriptors);
+
+    usage.Tags = ListBytes(_tags) + ListBytes(_unlocalizedTags);
+    for (auto& tag : _tags)
+        usage.Descriptors += DescriptorBytes(tag.Descriptors());
+    for (auto& tag : _unlocalizedTags)
+        usage.Descriptors += DescriptorBytes(tag.Descriptors());
+
+    usage.GlobalModifications = ListBytes(_globalModifications);
+    for (auto& modification : _globalModifications)
+    {
+        usage.GlobalModifications += ProFormaMemoryUsage::HeapBlock(modification.TargetAminoAcids().capacity());
+        usage.Descriptors += DescriptorBytes(modification.Descriptors());
+    }
+
+    // Red-black tree nodes: three links and the color, then the key and the group pointer
+    typedef std::map<std::string, ProFormaTagGroup*>::value_type GroupEntry;
+    usage.TagGroups = (_tagGroups.size() + SentinelNodes) * ProFormaMemoryUsage::HeapBlock(4 * sizeof(void*) + sizeof(GroupEntry));
+    for (auto& entry : _tagGroups)
+    {
+        const ProFormaTagGroup* group = entry.second;
+        usage.TagGroups += StringBytes(entry.first);
+        if (group == nullptr)
+            continue;
+
+        usage.TagGroups += ProFormaMemoryUsage::HeapBlock(group->IsChanging() ? sizeof(ProFormaTagGroupChangingValue) : sizeof(ProFormaTagGroup));
+        usage.TagGroups += StringBytes(group->Name()) + StringBytes(group->Value()) + ListBytes(group->Members());
+    }
+
+    return usage;
+}
+
+void ProFormaMemoryUsage::Add(const ProFormaMemoryUsage& other)
+{
+    Term += other.Term;
+    Sequence += other.Sequence;
+    Tags += other.Tags;
+    Descriptors += other.Descriptors;
+    TagGroups += other.TagGroups;
+    GlobalModifications += other.GlobalModifications;
+    Terms += other.Terms;
+}
+
+void ProFormaMemoryUsage::Add(const ProFormaTerm& term)
+{
+    Add(term.ApproximateMemoryUsage());
+}
+
+ProFormaMemoryUsage ProFormaMemoryUsage::Of(const ProFormaTerm* terms, size_t count)
+{
+    ProFormaMemoryUsage usage;
+    for (size_t i = 0; i < count; i++)
+        usage.Add(terms[i]);
+    return usage;
+}
+
+void ProFormaMemoryUsage::Report(std::ostream& out) const
+{
+    const struct { const char* Name; size_t Bytes; } components[] = {
+        { "term", Term },
+        { "sequence", Sequence },
+        { "tags", Tags },
+        { "descriptors", Descriptors },
+        { "tag_groups", TagGroups },
+        { "global_mods", GlobalModifications },
+        { "total", Total() }
+    };
+
+    double terms = Terms > 0 ? static_cast<double>(Terms) : 1.0;
+    double total = Total() > 0 ? static_cast<double>(Total()) : 1.0;
+    char line[128];
+
+    snprintf(line, sizeof(line), "%-12s %16s %12s %8s\n", "component", "bytes", "bytes/term", "share");
+    out << line;
+
+    for (auto& component : components)
+    {
+        snprintf(line, sizeof(line), "%-12s %16zu %12.1f %7.1f%%\n", component.Name, component.Bytes,
+            static_cast<double>(component.Bytes) / terms, 100.0 * static_cast<double>(component.Bytes) / total);
+        out << line;
+    }
+}
+
+size_t ProFormaMemoryUsage::HeapBlock(size_t bytes)
+{
+    return bytes == 0 ? 0 : (bytes + sizeof(void*) + 15) & ~size_t(15);
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+
+#include "PlatformHelper.h"
+
+namespace ProForma {
+	class ProFormaTerm;
+
+	/**
+	 * \struct ProFormaMemoryUsage
+	 *
+	 * \brief Approximate memory of one or more ProFormaTerm objects, broken down by component, see
+	 *        ProFormaTerm::ApproximateMemoryUsage. Heap blocks are counted as the allocator hands them out:
+	 *        the requested size plus a pointer of bookkeeping, rounded up to 16 bytes. Strings short enough
+	 *        for the small string buffer cost nothing on the heap.
+	 *
+	 *        Adding the usage of every term of a corpus gives the capacity needed to cache it.
+	 *
+	 */
+	struct EXPORT ProFormaMemoryUsage {
+		/**< sizeof(ProFormaTerm) per term, the part stored inline in a container of terms */
+		size_t Term = 0;
+
+		/**< Heap buffer of the residue sequence */
+		size_t Sequence = 0;
+
+		/**< Nodes of the localized and unlocalized tag lists */
+		size_t Tags = 0;
+
+		/**< Descriptor nodes and values of every tag, terminal, labile and global modification */
+		size_t Descriptors = 0;
+
+		/**< Map nodes, names, values, group objects and members of the tag groups */
+		size_t TagGroups = 0;
+
+		/**< Nodes and target residues of the global modifications */
+		size_t GlobalModifications = 0;
+
+		/**< Number of terms added */
+		size_t Terms = 0;
+
+		/** \brief  Sum of every component */
+		size_t Total() const { return Term + Sequence + Tags + Descriptors + TagGroups + GlobalModifications; }
+
+		/** \brief  Heap bytes owned by the terms, Total() without the inline part */
+		size_t Heap() const { return Total() - Term; }
+
+		/** \brief  Adds the usage of another term or corpus */
+		void Add(const ProFormaMemoryUsage& other);
+
+		/** \brief  Adds the usage of a term */
+		void Add(const ProFormaTerm& term);
+
+		/** \brief  Usage of every term of a corpus
+		  * \param  terms First term.
+		  * \param  count Number of terms.
+		  * \return the sum of the terms
+		  */
+		static ProFormaMemoryUsage Of(const ProFormaTerm* terms, size_t count);
+
+		/** \brief  Prints the bytes of each component, per term and as a share of the total
+		  * \param  out Stream receiving one line per component.
+		  * \return void
+		  */
+		void Report(std::ostream& out) const;
+
+		/** \brief  Size of the heap block holding a request of the given size, 0 for 0 bytes */
+		static size_t HeapBlock(size_t bytes);
+	};
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace ProForma {
+	/**
+	 * \class ProFormaMsgPackEmitter
+	 *
+	 * \brief Streams MessagePack straight into a caller buffer, with the calls of ProFormaJsonEmitter.
+	 *        Containers have definite lengths given to BeginObject and BeginArray. Output matches
+	 *        nlohmann::json::to_msgpack(): fix formats first, doubles stored as float 32 when exact.
+	 *
+	 */
+	class ProFormaMsgPackEmitter {
+	public:
+        /** \brief  Initializes an emitter appending to the given buffer
+		  * \param  out The buffer, its current content is kept.
+		  * \return void
+		  */
+        explicit ProFormaMsgPackEmitter(std::vector<uint8_t>& out) : _out(out) { }
+
+        void BeginObject(size_t count) { Container(0x80, 0xDE, count); }
+        void EndObject() { }
+        void BeginArray(size_t count) { Container(0x90, 0xDC, count); }
+        void EndArray() { }
+
+        template <size_t N>
+        void Key(const char (&name)[N])
+        {
+            StringHead(N - 1);
+            _out.insert(_out.end(), name, name + N - 1);
+        }
+
+        void String(const std::string& value)
+        {
+            StringHead(value.length());
+            _out.insert(_out.end(), value.begin(), value.end());
+        }
+
+        void Unsigned(uint64_t value)
+        {
+            if (value <= 0x7F)
+                _out.push_back(static_cast<uint8_t>(value));
+            else if (value <= 0xFF)
+                Prefixed(0xCC, value, 1);
+            else if (value <= 0xFFFF)
+                Prefixed(0xCD, value, 2);
+            else if (value <= 0xFFFFFFFFull)
+                Prefixed(0xCE, value, 4);
+            else
+                Prefixed(0xCF, value, 8);
+        }
+
+        void Integer(int64_t value)
+        {
+            if (value >= 0)
+                Unsigned(static_cast<uint64_t>(value));
+            else if (value >= -32)
+                _out.push_back(static_cast<uint8_t>(value));
+            else if (value >= INT8_MIN)
+                Prefixed(0xD0, static_cast<uint64_t>(value), 1);
+            else if (value >= INT16_MIN)
+                Prefixed(0xD1, static_cast<uint64_t>(value), 2);
+            else if (value >= INT32_MIN)
+                Prefixed(0xD2, static_cast<uint64_t>(value), 4);
+            else
+                Prefixed(0xD3, static_cast<uint64_t>(value), 8);
+        }
+
+        void Double(double value)
+        {
+            if (std::fabs(value) <= 3.4028234663852886e38 && static_cast<double>(static_cast<float>(value)) == value)
+            {
+                float single = static_cast<float>(value);
+                uint32_t bits;
+                memcpy(&bits, &single, sizeof(bits));
+                Prefixed(0xCA, bits, 4);
+            }
+            else
+            {
+                uint64_t bits;
+                memcpy(&bits, &value, sizeof(bits));
+                Prefixed(0xCB, bits, 8);
+            }
+        }
+
+        void Null() { _out.push_back(0xC0); }
+    private:
+        // fixmap and fixarray hold up to 15 members, then the 16 and 32 bit forms
+        void Container(uint8_t fix, uint8_t prefix16, size_t count)
+        {
+            if (count <= 15)
+                _out.push_back(static_cast<uint8_t>(fix | count));
+            else if (count <= 0xFFFF)
+                Prefixed(prefix16, count, 2);
+            else
+                Prefixed(static_cast<uint8_t>(prefix16 + 1), count, 4);
+        }
+
+        void StringHead(size_t length)
+        {
+            if (length <= 31)
+                _out.push_back(static_cast<uint8_t>(0xA0 | length));
+            else if (length <= 0xFF)
+                Prefixed(0xD9, length, 1);
+            else if (length <= 0xFFFF)
+                Prefixed(0xDA, length, 2);
+            else
+                Prefixed(0xDB, length, 4);
+        }
+
+        void Prefixed(uint8_t prefix, uint64_t value, int bytes)
+        {
+            _out.push_back(prefix);
+            for (int i = bytes - 1; i >= 0; i--)
+                _out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+        }
+
+        std::vector<uint8_t>& _out;
+	};
+}
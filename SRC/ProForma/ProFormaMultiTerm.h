@@ -0,0 +1,137 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "PlatformHelper.h"
+#include "ProFormaTerm.h"
+
+namespace ProForma {
+    /** @enum ProFormaChainSeparator
+     *  @brief How a chain is joined to the previous one in a multi-chain ProForma string
+     */
+    enum class ProFormaChainSeparator {
+        /**< First chain of the string */
+        None = 0,
+
+        /**< Crosslinked chains, written '//' */
+        Crosslink = 1,
+
+        /**< Chimeric spectrum, written '+' */
+        Chimeric = 2
+    };
+
+    /**
+     * \struct ProFormaCrosslinkSite
+     *
+     * \brief A member of a crosslink, located by chain index and residue index.
+     *
+     */
+    struct ProFormaCrosslinkSite {
+        size_t ChainIndex;
+        size_t ZeroBasedStartIndex;
+        size_t ZeroBasedEndIndex;
+        double Weight;
+    };
+
+    /**
+     * \struct ProFormaCrosslink
+     *
+     * \brief A crosslink ('#XL...') or branch ('#BRANCH') group, merged across every chain it appears in.
+     *
+     */
+    struct ProFormaCrosslink {
+        std::string Name;
+        ProFormaKey Key;
+        ProFormaEvidenceType EvidenceType;
+        std::string Value;
+        std::vector<ProFormaCrosslinkSite> Sites;
+    };
+
+	/**
+	 * \class ProFormaMultiTerm
+	 *
+	 * \brief Several ProForma chains parsed from one string. Each chain is moved in as parsed, its residues
+	 *        are not copied, and crosslink groups are resolved to chain and residue indexes while parsing
+	 *        so consumers never look them up by name.
+	 *
+	 */
+	class EXPORT ProFormaMultiTerm {
+    public:
+        /** \brief  Appends a chain and resolves its crosslink groups
+		  * \param  separator How the chain is joined to the previous one.
+          * \param  chain The parsed chain, moved into the multi-chain term.
+		  * \return void
+		  */
+        void AddChain(ProFormaChainSeparator separator, ProFormaTerm chain)
+        {
+            size_t chainIndex = _chains.size();
+            _chains.push_back(ChainEntry{ std::move(chain), separator, std::vector<size_t>() });
+
+            for (auto& item : _chains[chainIndex].Term.TagGroups())
+            {
+                ProFormaTagGroup* group = item.second;
+
+                if (!IsCrosslinkName(group->Name()))
+                    continue;
+
+                // Group names are only compared here, once per chain
+                size_t crosslinkIndex = 0;
+                while (crosslinkIndex < _crosslinks.size() && _crosslinks[crosslinkIndex].Name != group->Name())
+                    crosslinkIndex++;
+
+                if (crosslinkIndex == _crosslinks.size())
+                    _crosslinks.push_back(ProFormaCrosslink{ group->Name(), group->Key(), group->EvidenceType(), group->Value(), std::vector<ProFormaCrosslinkSite>() });
+
+                ProFormaCrosslink& crosslink = _crosslinks[crosslinkIndex];
+
+                // The crosslinker is usually named on one chain only
+                if (crosslink.Value.empty() && group->Value().length())
+                {
+                    crosslink.Key = group->Key();
+                    crosslink.EvidenceType = group->EvidenceType();
+                    crosslink.Value = group->Value();
+                }
+
+                for (auto& member : group->Members())
+                    crosslink.Sites.push_back(ProFormaCrosslinkSite{ chainIndex, member.ZeroBasedStartIndex(), member.ZeroBasedEndIndex(), member.Weight() });
+
+                _chains[chainIndex].Crosslinks.push_back(crosslinkIndex);
+            }
+        }
+
+        /** \brief  Number of chains. */
+        size_t ChainCount() const { return _chains.size(); }
+
+        /** \brief  The chain at the given index. */
+        ProFormaTerm& Chain(size_t index) { return _chains[index].Term; }
+
+        /** \brief  How the chain at the given index is joined to the previous one (None for the first). */
+        ProFormaChainSeparator Separator(size_t index) const { return _chains[index].Separator; }
+
+        /** \brief  Residues of the chain at the given index, a view into the sequence of the chain. */
+        std::string_view ChainSequence(size_t index) const { return _chains[index].Term.Sequence(); }
+
+        /** \brief  All crosslinks, with their sites in every chain. */
+        const std::vector<ProFormaCrosslink>& Crosslinks() const { return _crosslinks; }
+
+        /** \brief  Indexes into Crosslinks() of the crosslinks with a site on the given chain. */
+        const std::vector<size_t>& ChainCrosslinks(size_t index) const { return _chains[index].Crosslinks; }
+
+    private:
+        struct ChainEntry {
+            ProFormaTerm Term;
+            ProFormaChainSeparator Separator;
+            std::vector<size_t> Crosslinks;
+        };
+
+        std::vector<ChainEntry> _chains;
+        std::vector<ProFormaCrosslink> _crosslinks;
+
+        static bool IsCrosslinkName(const std::string& name)
+        {
+            return name.compare(0, 2, "XL") == 0 || name == "BRANCH";
+        }
+	};
+}
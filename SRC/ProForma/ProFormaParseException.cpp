@@ -12,6 +12,14 @@ ProFormaParseException::ProFormaParseException(const char* format, ...)  : std::
     va_end(args);
 }
 
+ProFormaParseException::ProFormaParseException(ProFormaParseErrorCode code, const char* format, ...)  : std::exception(), _code(code) {
+    // format string description and store in error buffer 
+    va_list args;
+    va_start(args, format);
+    vsnprintf(_errorMsg, EXCEPTION_MAX_ERROR_LEN, format, args);
+    va_end(args);
+}
+
 ProFormaParseException::ProFormaParseException(const std::string& message)  : std::exception() {
     // format string description and store in error buffer 
     snprintf(_errorMsg, EXCEPTION_MAX_ERROR_LEN, "%s", message.c_str());
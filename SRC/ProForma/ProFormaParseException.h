@@ -13,6 +13,33 @@
  */
 
 namespace ProForma {
+	/** @enum ProFormaParseErrorCode
+	 *  @brief Reason of a parsing failure, resource limits are those of ProFormaParserLimits. New codes go
+	 *         last, ProFormaParseErrorCodeCount is derived from the last one
+	 */
+	enum class ProFormaParseErrorCode {
+		/**< Invalid ProForma notation */
+		Syntax = 0,
+
+		/**< Input longer than the maximum input length */
+		InputTooLong = 1,
+
+		/**< More residues than allowed */
+		TooManyResidues = 2,
+
+		/**< More tags than allowed */
+		TooManyTags = 3,
+
+		/**< More descriptors in a single tag than allowed */
+		TooManyDescriptors = 4,
+
+		/**< Brackets or braces nested deeper than allowed */
+		NestingTooDeep = 5,
+
+		/**< The parse allocated more bytes than allowed */
+		AllocationLimitExceeded = 6
+	};
+
 	class ProFormaParseException : public std::exception  {
 	public:
 
@@ -24,8 +51,13 @@ namespace ProForma {
 
 		/** \brief  Object constructor passing exception code and error
 		  * \param  code Exception code
-		  * \param  error Internal error code when it is an API error (0 otherwise)
-		  * \param  Exception description with variable length format
+		  * \param  format Exception description with variable length format
+		  * \return void
+		  */
+		ProFormaParseException(ProFormaParseErrorCode code, const char* format, ...);
+
+		/** \brief  Object constructor passing the error message
+		  * \param  message Exception description
 		  * \return void
 		  */
 		ProFormaParseException(const std::string& message);
@@ -42,8 +74,15 @@ namespace ProForma {
 		  */
 		virtual const char* what() { return _errorMsg; };
 
+		/** \brief  Gets the reason of the failure
+		  * \param  None
+		  * \return Exception code, Syntax unless a resource limit was exceeded
+		  */
+		ProFormaParseErrorCode Code() const { return _code; };
+
 	private:
 		char _errorMsg[EXCEPTION_MAX_ERROR_LEN];
+		ProFormaParseErrorCode _code = ProFormaParseErrorCode::Syntax;
 
 	};
 }
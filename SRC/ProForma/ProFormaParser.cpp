@@ -1,91 +1,267 @@
 #include <cctype>
+#include <chrono>
 #include <tuple>
 #include <typeinfo>
 
+#include "ProFormaAllocationStats.h"
 #include "ProFormaParser.h"
 #include "ProFormaParseException.h"
+#include "ProFormaProbes.h"
 #include "ProFormaTagGroupChangingValue.h"
 
 using namespace ProForma;
 
+namespace {
+    // No range start or residue index, 0xFF used to collide with residue 255 of long proteoforms
+    constexpr size_t NoIndex = static_cast<size_t>(-1);
+}
+
 /*****************************************************************************/
 // PUBLIC
 /*****************************************************************************/
 
-ProFormaParser::ProFormaParser() : _logger(ProFormaLogger::GetLogger())
+template <typename Policy>
+BasicProFormaParser<Policy>::BasicProFormaParser() : BasicProFormaParser(ProFormaParserLimits())
 { 
 }
 
+template <typename Policy>
+BasicProFormaParser<Policy>::BasicProFormaParser(const ProFormaParserLimits& limits)
+    : _logger(ProFormaLogger::GetLogger()), _limits(limits), _stats(nullptr), _residueCount(0), _tagCount(0), _allocatedBytes(0)
+{
+}
+
 
-ProFormaTerm ProFormaParser::ParseString(const std::string& proFormaString)
+template <typename Policy>
+ProFormaTerm BasicProFormaParser<Policy>::ParseString(const std::string& proFormaString)
 {
-    auto stringLength = proFormaString.length();
+    return Measure<ProFormaTerm>(ProFormaOperation::Parse, proFormaString, [&]()
+    {
+        StartParse(proFormaString);
+
+        size_t end;
+        ProFormaTerm term = ParseChain(proFormaString, 0, end);
+
+        if (end != proFormaString.length())
+            throw new ProFormaParseException("Chain separator at index %zu, use ParseMultiString for crosslinked or chimeric ProForma strings.", end);
+
+        return term;
+    });
+}
+
+template <typename Policy>
+ProFormaMultiTerm BasicProFormaParser<Policy>::ParseMultiString(const std::string& proFormaString)
+{
+    return Measure<ProFormaMultiTerm>(ProFormaOperation::ParseMulti, proFormaString, [&]()
+    {
+        StartParse(proFormaString);
+
+        ProFormaMultiTerm multiTerm;
+        ProFormaChainSeparator separator = ProFormaChainSeparator::None;
+        size_t start = 0;
+
+        // Each chain stops at the next separator, so the string is walked only once
+        while (true)
+        {
+            size_t end;
+            ProFormaTerm chain = ParseChain(proFormaString, start, end);
+
+            if (end == start)
+                throw new ProFormaParseException("Empty chain at index %zu.", start);
+
+            multiTerm.AddChain(separator, std::move(chain));
+
+            if (end == proFormaString.length())
+                break;
+
+            if (proFormaString[end] == '+')
+            {
+                separator = ProFormaChainSeparator::Chimeric;
+                start = end + 1;
+            }
+            else
+            {
+                separator = ProFormaChainSeparator::Crosslink;
+                start = end + 2;
+            }
+
+            if (start == proFormaString.length())
+                throw new ProFormaParseException("ProForma string cannot end with a chain separator.");
+        }
+
+        Trace("Parsed %d chains with %d crosslinks", static_cast<int>(multiTerm.ChainCount()), static_cast<int>(multiTerm.Crosslinks().size()));
 
-    if(stringLength == 0)
+        return multiTerm;
+    });
+}
+
+/*****************************************************************************/
+// PRIVATE
+/*****************************************************************************/
+
+template <typename Policy>
+template <typename Result, typename Parse>
+Result BasicProFormaParser<Policy>::Measure(ProFormaOperation operation, const std::string& proFormaString, Parse parse)
+{
+    PROFORMA_PROBE2(parse__start, static_cast<int>(operation), proFormaString.length());
+    ProFormaAllocationScope allocations(ProFormaAllocationCategory::Other);
+
+    // Latency is recorded whenever enabled, independently of the compiled-in counters
+    bool timed = Policy::CollectStats || ProFormaLatency::Enabled();
+    std::chrono::steady_clock::time_point start;
+    if constexpr (Policy::CollectStats)
+    {
+        _stats = &ProFormaParserStats::Local();
+        _stats->Add(ProFormaParserCounter::InputBytes, proFormaString.length());
+    }
+    if (timed)
+        start = std::chrono::steady_clock::now();
+
+    auto finish = [&]()
+    {
+        if (!timed)
+            return;
+
+        uint64_t elapsed = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+        if constexpr (Policy::CollectStats)
+            _stats->Add(ProFormaParserCounter::ParseNanoseconds, elapsed);
+        if (ProFormaLatency::Enabled())
+            ProFormaLatency::Record(operation, proFormaString.length(), elapsed);
+    };
+
+    try
+    {
+        Result result = parse();
+        Count(ProFormaParserCounter::Parses);
+        if constexpr (ProFormaAllocationStats::Enabled)
+            ProFormaAllocationStats::AddTerm();
+        finish();
+        PROFORMA_PROBE4(parse__done, static_cast<int>(operation), proFormaString.length(), _residueCount, _tagCount);
+        return result;
+    }
+    catch (ProFormaParseException* e)
+    {
+        if constexpr (Policy::CollectStats)
+            _stats->AddError(e->Code());
+        finish();
+        PROFORMA_PROBE3(parse__error, static_cast<int>(operation), proFormaString.length(), static_cast<int>(e->Code()));
+        throw;
+    }
+    catch (...)
+    {
+        if constexpr (Policy::CollectStats)
+            _stats->AddError(ProFormaParseErrorCode::Syntax);
+        finish();
+        PROFORMA_PROBE3(parse__error, static_cast<int>(operation), proFormaString.length(), static_cast<int>(ProFormaParseErrorCode::Syntax));
+        throw;
+    }
+}
+
+template <typename Policy>
+void BasicProFormaParser<Policy>::StartParse(const std::string& proFormaString)
+{
+    if(proFormaString.length() == 0)
         throw new ProFormaParseException("Empty proforma string");
 
-    // Define the ProFormaTerm fields to be calculated
-    std::stringstream sequence;
-    std::list<ProFormaTag> tags; 
-    std::list<ProFormaDescriptor> nTerminalDescriptors; 
-    std::list<ProFormaDescriptor> cTerminalDescriptors;
-    std::list<ProFormaDescriptor> labileDescriptors;
-    std::list<ProFormaUnlocalizedTag> unlocalizedTags;
-    std::map<std::string, ProFormaTagGroup*> tagGroups;
-    std::list<ProFormaGlobalModification> globalModifications;
+    if (proFormaString.length() > _limits.MaxInputLength)
+        throw new ProFormaParseException(ProFormaParseErrorCode::InputTooLong, "Input length %zu exceeds the limit of %zu.", proFormaString.length(), _limits.MaxInputLength);
+
+    _residueCount = 0;
+    _tagCount = 0;
+    _allocatedBytes = 0;
+}
+
+template <typename Policy>
+void BasicProFormaParser<Policy>::CountAllocation(size_t bytes)
+{
+    _allocatedBytes += bytes;
+
+    if (_allocatedBytes > _limits.MaxAllocatedBytes)
+        throw new ProFormaParseException(ProFormaParseErrorCode::AllocationLimitExceeded, "Parse allocated more than %zu bytes.", _limits.MaxAllocatedBytes);
+}
+
+template <typename Policy>
+ProFormaTerm BasicProFormaParser<Policy>::ParseChain(const std::string& proFormaString, size_t start, size_t& end)
+{
+    auto stringLength = proFormaString.length();
+
+    // Collects the ProFormaTerm fields to be calculated
+    ProFormaTermBuilder builder;
     std::stringstream tag;
 
     bool inTag = false;
     bool inGlobalTag = false;
     bool inCTerminalTag = false;
+    bool inUnlocalizedPrefix = false;
     int openLeftBrackets = 0;
     int openLeftBraces = 0;
-    size_t startRange = 0xFF;
-    size_t endRange = 0xFF;
-
-    // Don't love doing a global index of performance wise, but would need to restructure things to handle multiple unlocalized tags
-    auto unlocalizedIndex = proFormaString.find_first_of('?');
+    size_t startRange = NoIndex;
+    size_t endRange = NoIndex;
+    size_t tagDescriptors = 1;
 
-    _logger->Log("unlocalizedIndex [%d]", unlocalizedIndex);
+    end = stringLength;
 
-    for (int i = 0; i < stringLength; i++)
+    for (size_t i = start; i < stringLength; i++)
     {
-        if (unlocalizedIndex == i) continue; // Skip unlocalized separator
-
         char current = proFormaString[i];
 
-        _logger->Log("Processing char [%c]", current);
+        Trace("Processing char [%c]", current);
+
+        if (!inTag && !inGlobalTag)
+        {
+            // Skip unlocalized separator
+            if (inUnlocalizedPrefix && current == '?')
+            {
+                inUnlocalizedPrefix = false;
+                continue;
+            }
+
+            // A crosslink '//' or chimeric '+' separator ends this chain
+            if (current == '+' || (current == '/' && i + 1 < stringLength && proFormaString[i + 1] == '/'))
+            {
+                end = i;
+                break;
+            }
+        }
 
         if (current == '<')
         {
-            _logger->Log("Starting global tag <");
+            if constexpr (!Policy::AllowGlobalModifications)
+                throw new ProFormaParseException("Global modifications are not supported by this parser.");
+
+            Trace("Starting global tag <");
             inGlobalTag = true;
         }
-        else if (current == '>')
+        else if (Policy::AllowGlobalModifications && current == '>')
         {
             std::string tagText = tag.str();
 
-            _logger->Log("Finished global tag >");
+            Trace("Finished global tag >");
 
             // Make sure nothing happen before this global mod
-            if (sequence.str().length() > 0 || unlocalizedTags.size() > 0 || nTerminalDescriptors.size() > 0 || tagGroups.size() > 0)
+            if (builder.SequenceLength() > 0 || builder.UnlocalizedTagCount() > 0 || builder.NTerminalDescriptorCount() > 0 || builder.TagGroupCount() > 0)
                 throw new ProFormaParseException("Global modifications must be the first element in ProForma string.");
 
-            HandleGlobalModification(tagGroups, globalModifications, sequence, startRange, endRange, tagText);
+            HandleGlobalModification(builder, startRange, endRange, tagText);
 
             inGlobalTag = false;
             tag.str("");
+            tagDescriptors = 1;
         }
         else if (current == '(' && !inTag)
         {
-            if (startRange != 0xFF)
+            if constexpr (!Policy::AllowRanges)
+                throw new ProFormaParseException("Ranges are not supported by this parser.");
+
+            if (startRange != NoIndex)
                 throw new ProFormaParseException("Overlapping ranges are not allowed.");
 
-            startRange = sequence.str().length();
+            startRange = builder.SequenceLength();
         }
-        else if (current == ')' && !inTag)
+        else if (Policy::AllowRanges && current == ')' && !inTag)
         {
-            endRange = sequence.str().length();
+            endRange = builder.SequenceLength();
+            Count(ProFormaParserCounter::Ranges);
 
             // Ensure a tag comes next
             if (proFormaString[i + 1] != '[')
@@ -93,18 +269,23 @@ ProFormaTerm ProFormaParser::ParseString(const std::string& proFormaString)
         }
         else if (current == '{' && openLeftBraces++ == 0)
         {
+            if constexpr (!Policy::AllowLabileModifications)
+                throw new ProFormaParseException("Labile modifications are not supported by this parser.");
+
             inTag = true;
         }
-        else if (current == '}' && --openLeftBraces == 0)
+        else if (Policy::AllowLabileModifications && current == '}' && --openLeftBraces == 0)
         {
             std::string tagText = tag.str();
 
-            _logger->Log("Processing labile descriptors for [%s]", tagText.c_str());
+            Trace("Processing labile descriptors for [%s]", tagText.c_str());
 
-            labileDescriptors = ProcessTag(tagText, endRange != 0xFF? startRange : 0xFF, sequence.str().length() - 1, tagGroups);
+            builder.SetLabileDescriptors(ProcessTag(tagText, endRange != NoIndex ? startRange : NoIndex, builder.SequenceLength() - 1, builder));
+            Count(ProFormaParserCounter::LabileModifications);
 
             inTag = false;
             tag.str("");
+            tagDescriptors = 1;
         }
      
         else if (!inGlobalTag && current == '[' && openLeftBrackets++ == 0)
@@ -114,7 +295,7 @@ ProFormaTerm ProFormaParser::ParseString(const std::string& proFormaString)
         else if (!inGlobalTag && current == ']' && --openLeftBrackets == 0)
         {
             // Don't allow 2 tags right next to eachother in the sequence
-            if (sequence.str().length() > 0 && proFormaString.length() > i + 1 && proFormaString[i + 1] == '[')
+            if (builder.SequenceLength() > 0 && proFormaString.length() > i + 1 && proFormaString[i + 1] == '[')
                 throw new ProFormaParseException("Two tags next to eachother are not allowed.");
 
             std::string tagText = tag.str();
@@ -122,24 +303,28 @@ ProFormaTerm ProFormaParser::ParseString(const std::string& proFormaString)
             // Handle terminal modifications and prefix tags
             if (inCTerminalTag)
             {
-                cTerminalDescriptors = ProcessTag(tagText, 0xFF, 0xFF, tagGroups);
+                builder.SetCTerminalDescriptors(ProcessTag(tagText, NoIndex, NoIndex, builder));
+                Count(ProFormaParserCounter::TerminalModifications);
             }           
-            else if (sequence.str().length() == 0 && proFormaString[i + 1] == '-')
+            else if (builder.SequenceLength() == 0 && proFormaString[i + 1] == '-')
             {
-                nTerminalDescriptors = ProcessTag(tagText, 0xFF, 0xFF, tagGroups);
+                builder.SetNTerminalDescriptors(ProcessTag(tagText, NoIndex, NoIndex, builder));
+                Count(ProFormaParserCounter::TerminalModifications);
                 i++; // Skip the - character
             }            
-            else if (unlocalizedIndex != std::string::npos && unlocalizedIndex >= i)
+            else if (Policy::AllowUnlocalizedTags && builder.SequenceLength() == 0 && IsUnlocalizedPrefix(proFormaString, i + 1))
             {
-                _logger->Log("unlocalized candidate at i=[%d]", i);
+                Trace("unlocalized candidate at i=[%zu]", i);
+
+                inUnlocalizedPrefix = true;
 
                 // Make sure the prefix came before the N-terminal modification
-                if (nTerminalDescriptors.size())
+                if (builder.NTerminalDescriptorCount())
                     throw new ProFormaParseException("Unlocalized modification must come before an N-terminal modification.");
 
-                auto descriptors = ProcessTag(tagText, 0xFF, 0xFF, tagGroups);
+                auto descriptors = ProcessTag(tagText, NoIndex, NoIndex, builder);
 
-                _logger->Log("unlocalized descriptors size is [%d]", descriptors.size());
+                Trace("unlocalized descriptors size is [%d]", descriptors.size());
 
                 if (descriptors.size())
                 {
@@ -148,8 +333,8 @@ ProFormaTerm ProFormaParser::ParseString(const std::string& proFormaString)
                     // Check for higher count
                     if (proFormaString[i + 1] == '^')
                     {
-                        int j = i + 2;
-                        while (std::isdigit(proFormaString[j]))
+                        size_t j = i + 2;
+                        while (std::isdigit(static_cast<unsigned char>(proFormaString[j])))
                             j++;
 
                         // verify it is an integer
@@ -162,52 +347,76 @@ ProFormaTerm ProFormaParser::ParseString(const std::string& proFormaString)
                         i = j - 1; // Point i at the last digit
                     }
 
-                    unlocalizedTags.push_back(*(new ProFormaUnlocalizedTag(count, descriptors)));
+                    builder.AddUnlocalizedTag(count, std::move(descriptors));
+                    Count(ProFormaParserCounter::UnlocalizedTags);
 
-                    _logger->Log("unlocalized tags size is [%d]", unlocalizedTags.size());
+                    Trace("unlocalized tags size is [%d]", builder.UnlocalizedTagCount());
                 }
 
-                //i++; // skip the ? character              
             }
-            else if (sequence.str().length() == 0)
+            else if (builder.SequenceLength() == 0)
             {
-                throw new ProFormaParseException("Invalid n terminal descriptor, sequence [%s]", sequence.str().c_str());
+                throw new ProFormaParseException("Invalid n terminal descriptor, sequence []");
             }
             else
             {
-                ProcessTag(tagText, endRange != 0xFF ? startRange : 0xFF, sequence.str().length() - 1, tags, tagGroups);
+                AddTag(tagText, endRange != NoIndex ? startRange : NoIndex, builder.SequenceLength() - 1, builder);
             }
 
             inTag = false;
             tag.str("");
+            tagDescriptors = 1;
 
             // Reset the range if we have processed the tag on the end of it
-            if (endRange != 0xFF)
+            if (endRange != NoIndex)
             {
-                startRange = 0xFF;
-                endRange = 0xFF;
+                startRange = NoIndex;
+                endRange = NoIndex;
             }           
         }        
         else if (inTag || inGlobalTag)
         {
+            // Brackets or braces opened inside a tag
+            if ((current == '[' || current == '{') && static_cast<size_t>(openLeftBrackets + openLeftBraces) > _limits.MaxNestingDepth)
+                throw new ProFormaParseException(ProFormaParseErrorCode::NestingTooDeep, "Tags nested deeper than %zu levels.", _limits.MaxNestingDepth);
+
+            // Bounded while the tag grows, before it is closed and split
+            if (current == '|' && ++tagDescriptors > _limits.MaxDescriptorsPerTag)
+                throw new ProFormaParseException(ProFormaParseErrorCode::TooManyDescriptors, "Tag with more than %zu descriptors.", _limits.MaxDescriptorsPerTag);
+
+            CountAllocation(1);
             tag << current;
         }
         else if (current == '-')
         {
             if (inCTerminalTag)
-                throw new ProFormaParseException("- at index %d is not allowed.", i);
+                throw new ProFormaParseException("- at index %zu is not allowed.", i);
 
             inCTerminalTag = true;
         }
         else
         {
+            if constexpr (!Policy::StrictResidues)
+            {
+                // Lenient parsers ignore blanks and accept lower case residues
+                if (std::isspace(static_cast<unsigned char>(current)))
+                    continue;
+
+                current = static_cast<char>(std::toupper(static_cast<unsigned char>(current)));
+            }
+
             // Validate amino acid character
-            if (!std::isupper(current))
+            if (!std::isupper(static_cast<unsigned char>(current)))
                 throw new ProFormaParseException("%c is not an upper case letter.", current);
             //else if (current == 'X')
             //    throw new ProFormaParseException("X is not allowed.");
 
-            sequence << current;
+            if (++_residueCount > _limits.MaxResidues)
+                throw new ProFormaParseException(ProFormaParseErrorCode::TooManyResidues, "More than %zu residues.", _limits.MaxResidues);
+
+            CountAllocation(1);
+            ProFormaAllocationScope allocations(ProFormaAllocationCategory::Sequence);
+            builder.AddResidue(current);
         }      
     }
 
@@ -217,21 +426,46 @@ ProFormaTerm ProFormaParser::ParseString(const std::string& proFormaString)
     if (openLeftBraces != 0)
         throw new ProFormaParseException("There are %d open braces in ProForma string %s", std::abs(openLeftBraces), proFormaString.c_str());
 
-    return *(new ProFormaTerm(sequence.str(), tags, nTerminalDescriptors, cTerminalDescriptors, labileDescriptors,
-        unlocalizedTags, tagGroups, globalModifications));
+    Count(ProFormaParserCounter::Residues, builder.SequenceLength());
+
+    return std::move(builder).Build();
 
     //return *(new ProFormaTerm("test", 1));   // DEBUG: testing purposes only     
 }
 
-/*****************************************************************************/
-// PRIVATE
-/*****************************************************************************/
+template <typename Policy>
+bool BasicProFormaParser<Policy>::IsUnlocalizedPrefix(const std::string& proFormaString, size_t index)
+{
+    // Look past the '^' counts and further tags of the prefix for the '?' closing it
+    while (index < proFormaString.length())
+    {
+        char current = proFormaString[index];
+
+        if (current == '?')
+            return true;
+        else if (current == '^' || std::isdigit(static_cast<unsigned char>(current)))
+            index++;
+        else if (current == '[')
+        {
+            int depth = 0;
+            do
+            {
+                if (proFormaString[index] == '[') depth++;
+                else if (proFormaString[index] == ']') depth--;
+                index++;
+            } while (depth > 0 && index < proFormaString.length());
+        }
+        else
+            return false;
+    }
+
+    return false;
+}
 
-void ProFormaParser::HandleGlobalModification
+template <typename Policy>
+void BasicProFormaParser<Policy>::HandleGlobalModification
 (
-    std::map<std::string, ProFormaTagGroup*>& tagGroups,
-    std::list<ProFormaGlobalModification>& globalModifications, 
-    std::stringstream& sequence,
+    ProFormaTermBuilder& builder,
     size_t startRange, 
     size_t endRange,
     std::string& tagText
@@ -239,10 +473,11 @@ void ProFormaParser::HandleGlobalModification
 {   
     // Check for '@' to specify targets
     auto atSymbolIndex = tagText.find_last_of('@');
+    ProFormaAllocationScope allocations(ProFormaAllocationCategory::Tag);
     std::string innerTagText;
     std::vector<char> targets;
 
-    _logger->Log("Processing global modification: %s", tagText.c_str());
+    Trace("Processing global modification: %s", tagText.c_str());
 
     if (atSymbolIndex > 0)
     {
@@ -251,7 +486,7 @@ void ProFormaParser::HandleGlobalModification
 
         for (auto k = atSymbolIndex + 1; k < tagText.length(); k++)
         {
-            if (std::isupper(tagText[k]))
+            if (std::isupper(static_cast<unsigned char>(tagText[k])))
                 targets.push_back(tagText[k]);
             else if (tagText[k] != ',')
                 throw new ProFormaParseException("Unexpected character %c in global modification target list.", tagText[k]);
@@ -262,15 +497,17 @@ void ProFormaParser::HandleGlobalModification
         // No targets, global isotope ... assume whole thing should be read
         innerTagText = tagText;
     }
-    std::list<ProFormaDescriptor> descriptors = ProcessTag(innerTagText, endRange != 0xFF ? startRange : 0xFF, static_cast<int>(sequence.str().length() - 1), tagGroups);
+    std::list<ProFormaDescriptor> descriptors = ProcessTag(innerTagText, endRange != NoIndex ? startRange : NoIndex, static_cast<int>(builder.SequenceLength() - 1), builder);
 
     if (descriptors.size())
     {
-        globalModifications.push_back(ProFormaGlobalModification(descriptors, targets));
+        builder.AddGlobalModification(std::move(descriptors), std::move(targets));
+        Count(ProFormaParserCounter::GlobalModifications);
     }    
 }
 
-void ProFormaParser::SplitStr(std::string const &str, const char delim, std::vector<std::string>& out)  
+template <typename Policy>
+void BasicProFormaParser<Policy>::SplitStr(std::string const &str, const char delim, std::vector<std::string>& out)  
 {  
     // create a stream from the string  
     std::stringstream s(str);  
@@ -282,13 +519,15 @@ void ProFormaParser::SplitStr(std::string const &str, const char delim, std::vec
     }  
 } 
 
-std::tuple<ProFormaKey, ProFormaEvidenceType, std::string, std::string, double> ProFormaParser::ParseDescriptor(std::string& text)
+template <typename Policy>
+std::tuple<ProFormaKey, ProFormaEvidenceType, std::string, std::string, double> BasicProFormaParser<Policy>::ParseDescriptor(std::string& text)
 {   
     if (text.length() == 0)
         throw new ProFormaParseException("Cannot have an empty descriptor.");
 
+    Count(ProFormaParserCounter::Descriptors);
 
-    _logger->Log("Processing descriptor: %s", text.c_str());
+    Trace("Processing descriptor: %s", text.c_str());
 
     // Let's look for a group
     auto groupIndex = text.find_first_of('#');
@@ -326,7 +565,7 @@ std::tuple<ProFormaKey, ProFormaEvidenceType, std::string, std::string, double>
             throw new ProFormaParseException("Group name cannot be empty.");
     }
 
-    _logger->Log("Processing descriptor before colon: %s", text.c_str());
+    Trace("Processing descriptor before colon: %s", text.c_str());
 
     // Check for naked group tag
     if (text.empty())
@@ -337,21 +576,21 @@ std::tuple<ProFormaKey, ProFormaEvidenceType, std::string, std::string, double>
 
     if (colon == std::string::npos)
     {
-        _logger->Log("Processing isMass descriptor: %s", text.c_str());
+        Trace("Processing isMass descriptor: %s", text.c_str());
 
         bool isMass2 = (text[0] == '+' || text[0] == '-');
 
-        return std::make_tuple(ProFormaParser::GetKey(isMass2), ProFormaEvidenceType::None, text, groupName, weight);
+        return std::make_tuple(GetKey(isMass2), ProFormaEvidenceType::None, text, groupName, weight);
     }
 
     // Let's see if the bit before the colon is a known key
     auto newText = text.substr(0, colon);
-    ProFormaParser::ToLower(newText);
-    ProFormaParser::Trim(newText);
+    ToLower(newText);
+    Trim(newText);
     std::string keyText = newText;
     bool isMass = text[colon + 1] == '+' || text[colon + 1] == '-';
 
-    _logger->Log("Descriptor keyText: %s", keyText.c_str());
+    Trace("Descriptor keyText: %s", keyText.c_str());
 
     // Check text and return tuple
     if(keyText == "formula")     return std::make_tuple(ProFormaKey::Formula, ProFormaEvidenceType::None, text.substr(colon + 1), groupName, weight);
@@ -359,7 +598,7 @@ std::tuple<ProFormaKey, ProFormaEvidenceType, std::string, std::string, double>
     else if(keyText == "info")   return std::make_tuple(ProFormaKey::Info, ProFormaEvidenceType::None, text.substr(colon + 1), groupName, weight);
 
     else if(keyText == "mod")    return std::make_tuple(ProFormaKey::Identifier, ProFormaEvidenceType::PsiMod, text, groupName, weight);
-    else if (keyText == "unimod") { ProFormaParser::ToUpper(text); return std::make_tuple(ProFormaKey::Identifier, ProFormaEvidenceType::Unimod, text, groupName, weight); }
+    else if (keyText == "unimod") { ToUpper(text); return std::make_tuple(ProFormaKey::Identifier, ProFormaEvidenceType::Unimod, text, groupName, weight); }
     else if(keyText == "xlmod")  return std::make_tuple(ProFormaKey::Identifier, ProFormaEvidenceType::XlMod, text, groupName, weight);
     else if(keyText == "gno")    return std::make_tuple(ProFormaKey::Identifier, ProFormaEvidenceType::Gno, text, groupName, weight);
 
@@ -379,32 +618,47 @@ std::tuple<ProFormaKey, ProFormaEvidenceType, std::string, std::string, double>
     // return std::tuple(ProFormaKey::Formula, ProFormaEvidenceType::Brno, "", "", 0.2);  // TODO: testing purposes only  
 }
 
-void ProFormaParser::ProcessTag(std::string& tag, size_t startIndex, size_t index, std::list<ProFormaTag>& tags, std::map<std::string, ProFormaTagGroup*>& tagGroups)
+template <typename Policy>
+void BasicProFormaParser<Policy>::AddTag(std::string& tag, size_t startIndex, size_t index, ProFormaTermBuilder& builder)
 {
-    auto descriptors = ProcessTag(tag, startIndex, index, tagGroups);
+    ProFormaAllocationScope allocations(ProFormaAllocationCategory::Tag);
+    auto descriptors = ProcessTag(tag, startIndex, index, builder);
 
-    _logger->Log("Processing tag with list: %s", tag.c_str());
+    Trace("Processing tag with list: %s", tag.c_str());
 
     // Only add a tag if descriptors come back
     if (descriptors.size())
     {
-        if (startIndex != 0xFF)
-            tags.push_back(*(new ProFormaTag(startIndex, index, descriptors)));
+        CountAllocation(sizeof(ProFormaTag));
+
+        if (startIndex != NoIndex)
+            builder.AddTag(startIndex, index, std::move(descriptors));
         else
-            tags.push_back(*(new ProFormaTag(index, descriptors)));
+            builder.AddTag(index, std::move(descriptors));
+
+        Count(ProFormaParserCounter::LocalizedTags);
     }
 }
 
-std::list<ProFormaDescriptor> ProFormaParser::ProcessTag(std::string& tag, size_t startIndex, size_t index, std::map<std::string, ProFormaTagGroup*>& tagGroups)
+template <typename Policy>
+std::list<ProFormaDescriptor> BasicProFormaParser<Policy>::ProcessTag(std::string& tag, size_t startIndex, size_t index, ProFormaTermBuilder& builder)
 {
+    ProFormaAllocationScope allocations(ProFormaAllocationCategory::Tag);
     std::list<ProFormaDescriptor> descriptors;
     std::vector<std::string> descriptorText;
 
-    _logger->Log("Processing tag: %s", tag.c_str());
+    Trace("Processing tag: %s", tag.c_str());
+    PROFORMA_PROBE2(tag__start, index, tag.length());
+
+    if (++_tagCount > _limits.MaxTags)
+        throw new ProFormaParseException(ProFormaParseErrorCode::TooManyTags, "More than %zu tags.", _limits.MaxTags);
+
+    // The tag text and its descriptor count were checked against the limits as ParseChain read it
+    Count(ProFormaParserCounter::Tags);
     
-    ProFormaParser::SplitStr(tag, '|', descriptorText);
+    SplitStr(tag, '|', descriptorText);
 
-    for (auto i = 0; i < descriptorText.size(); i++)
+    for (size_t i = 0; i < descriptorText.size(); i++)
     {
         ProFormaKey key;
         ProFormaEvidenceType evidence;
@@ -412,71 +666,89 @@ std::list<ProFormaDescriptor> ProFormaParser::ProcessTag(std::string& tag, size_
         std::string group;
         double weight;
 
+        ProFormaAllocationScope descriptorAllocations(ProFormaAllocationCategory::Descriptor);
         std::tie(key, evidence, value, group, weight) = ParseDescriptor(descriptorText[i].substr(descriptorText[i].find_first_not_of(' ')));
       
-        _logger->Log("Descriptor info obtained: %d, %d, %s, %s, %f", 
+        Trace("Descriptor info obtained: %d, %d, %s, %s, %f", 
             static_cast<int>(key),
             static_cast<int>(evidence),
             value.c_str(),
             group.c_str(),
             weight);
 
-        if (group.length())
+        if constexpr (Policy::CollectStats)
+            _stats->AddDescriptor(key);
+        PROFORMA_PROBE3(descriptor, static_cast<int>(key), static_cast<int>(evidence), value.length());
+
+        if constexpr (!Policy::AllowTagGroups)
         {
-            auto item = tagGroups.find(group);
-            if (item == tagGroups.end())
+            if (group.length())
+                throw new ProFormaParseException("Tag groups are not supported by this parser, found group %s.", group.c_str());
+        }
+
+        if (Policy::AllowTagGroups && group.length())
+        {
+            ProFormaAllocationScope groupAllocations(ProFormaAllocationCategory::Group);
+            auto currentGroup = builder.FindTagGroup(group);
+            if (currentGroup == nullptr)
             {
-                ProFormaTagGroupChangingValue* newTagGroup = new ProFormaTagGroupChangingValue(group, key, evidence, std::list<ProFormaMembershipDescriptor>());
-                tagGroups.insert(make_pair(group, newTagGroup));
-                _logger->Log("New group created: %s, %d", group.c_str(), newTagGroup->IsChanging());
+                CountAllocation(sizeof(ProFormaTagGroupChangingValue) + group.length());
+
+                currentGroup = builder.AddTagGroup(new ProFormaTagGroupChangingValue(group, key, evidence, std::list<ProFormaMembershipDescriptor>()));
+                Count(ProFormaParserCounter::TagGroups);
+                Trace("New group created: %s, %d", group.c_str(), currentGroup->IsChanging());
             }
             else
             {
-                _logger->Log("Group already exists: %s and has %d members", group.c_str(), item->second->Members().size());
+                Trace("Group already exists: %s and has %d members", group.c_str(), currentGroup->Members().size());
             }
 
-            auto currentGroup = tagGroups.at(group);
-
-            _logger->Log("Current group: %s, %d", group.c_str(), currentGroup->IsChanging());
+            Trace("Current group: %s, %d", group.c_str(), currentGroup->IsChanging());
 
             // Fix up name of TagGroup
             if (value.length() && currentGroup->IsChanging())
             {
-                _logger->Log("Current group is ProFormaTagGroupChangingValue: %s", group.c_str());
+                Trace("Current group is ProFormaTagGroupChangingValue: %s", group.c_str());
 
                 ProFormaTagGroupChangingValue* x = static_cast<ProFormaTagGroupChangingValue*>(currentGroup);
                 // Only allow the value of the group to be set once
                 if (x->Value().length())
                     throw new ProFormaParseException("You may only set the value of the group %s once.", group.c_str());
 
-                x->SetValueFlux(value);
+                x->SetValueFlux(std::move(value));
                 x->SetKey(key);
                 x->SetEvidenceType(evidence);
             }
 
-            _logger->Log("Current input index value is: %d", index);
+            Trace("Current input index value is: %d", index);
 
             // If the group was defined before the sequence, don't include it in the membership
-            if (index != 0xFF)
+            if (index != NoIndex)
             {
-                _logger->Log("Adding member for index: %d", index);
+                Trace("Adding member for index: %d", index);
 
-               if (startIndex != 0xFF)
-                   currentGroup->AddMember(*(new ProFormaMembershipDescriptor(startIndex, index, weight)));
+                CountAllocation(sizeof(ProFormaMembershipDescriptor));
+
+               if (startIndex != NoIndex)
+                   builder.AddGroupMember(group, ProFormaMembershipDescriptor(startIndex, index, weight));
                 else
-                   currentGroup->AddMember(*(new ProFormaMembershipDescriptor(index, weight)));
+                   builder.AddGroupMember(group, ProFormaMembershipDescriptor(index, weight));
+
 
+               Count(ProFormaParserCounter::GroupMembers);
 
-               _logger->Log("Group %s after adding member has %d members", group.c_str(), currentGroup->Members().size());
+               Trace("Group %s after adding member has %d members", group.c_str(), currentGroup->Members().size());
             }
         }
         else if (key != ProFormaKey::None) // typical descriptor
         {
-            descriptors.push_back(*(new ProFormaDescriptor(key, evidence, value)));
+            CountAllocation(sizeof(ProFormaDescriptor) + value.length());
+            descriptors.emplace_back(key, evidence, std::move(value));
         }
         else if (value.length() > 0) // keyless descriptor (UniMod or PSI-MOD annotation)
         {
-            descriptors.push_back(*(new ProFormaDescriptor(value)));
+            CountAllocation(sizeof(ProFormaDescriptor) + value.length());
+            descriptors.emplace_back(std::move(value));
         }
         else
         {
@@ -484,11 +756,23 @@ std::list<ProFormaDescriptor> ProFormaParser::ProcessTag(std::string& tag, size_
         }    
     }
 
+    PROFORMA_PROBE2(tag__done, index, descriptors.size());
     return descriptors;
 }
 
 
-ProFormaKey ProFormaParser::GetKey(bool isMass) { return (isMass ? ProFormaKey::Mass : ProFormaKey::Name); }
-void ProFormaParser::ToLower(std::string& input) { for(auto& c : input) { c = tolower(c);} }
-void ProFormaParser::ToUpper(std::string& input) { for (auto& c : input) { c = toupper(c); } }
-void ProFormaParser::Trim(std::string& input) {  std::stringstream trimmer; trimmer << input; input.clear(); trimmer >> input; }
+template <typename Policy> ProFormaKey BasicProFormaParser<Policy>::GetKey(bool isMass) { return (isMass ? ProFormaKey::Mass : ProFormaKey::Name); }
+template <typename Policy> void BasicProFormaParser<Policy>::ToLower(std::string& input) { for (auto& c : input) { c = static_cast<char>(tolower(static_cast<unsigned char>(c))); } }
+template <typename Policy> void BasicProFormaParser<Policy>::ToUpper(std::string& input) { for (auto& c : input) { c = static_cast<char>(toupper(static_cast<unsigned char>(c))); } }
+template <typename Policy> void BasicProFormaParser<Policy>::Trim(std::string& input) {  std::stringstream trimmer; trimmer << input; input.clear(); trimmer >> input; }
+
+/*****************************************************************************/
+// INSTANTIATIONS
+/*****************************************************************************/
+
+namespace ProForma {
+    template class BasicProFormaParser<ProFormaDefaultPolicy>;
+    template class BasicProFormaParser<ProFormaQuietPolicy>;
+    template class BasicProFormaParser<ProFormaLenientPolicy>;
+    template class BasicProFormaParser<ProFormaPeptidePolicy>;
+}
@@ -6,22 +6,38 @@
 
 #include "PlatformHelper.h"
 #include "ProFormaTerm.h"
+#include "ProFormaMultiTerm.h"
+#include "ProFormaTermBuilder.h"
 #include "ProFormaLogger.h"
+#include "ProFormaParserPolicy.h"
+#include "ProFormaParserLimits.h"
+#include "ProFormaParserStats.h"
+#include "ProFormaLatencyHistogram.h"
 
 
 namespace ProForma {
 	/**
-	 * \class ProFormaParser
+	 * \class BasicProFormaParser
 	 *
 	 * \brief Parser for the ProForma proteoform notation
 	 *
+	 * The grammar features and the logging are selected at compile time through the Policy type,
+	 * see ProFormaParserPolicy.h. The library instantiates and exports the predefined policies.
+	 * Resource limits are checked on every parse, one parser instance must be used per thread.
+	 *
 	 */
 
-	class EXPORT ProFormaParser {
+	template <typename Policy>
+	class BasicProFormaParser {
 	public:
 		/** \brief  Empty constructor, creates a new instance of the parser
 		  */
-		ProFormaParser();
+		BasicProFormaParser();
+
+		/** \brief  Creates a new instance of the parser enforcing resource limits
+		  * \param  limits Bounds checked on every parse.
+		  */
+		BasicProFormaParser(const ProFormaParserLimits& limits);
 
 		/** \brief  Parses the ProForma string.
 		  * \param  proFormaString The pro forma string to be parsed.
@@ -29,29 +45,83 @@ namespace ProForma {
 		  */
 		ProFormaTerm ParseString(const std::string& proFormaString);
 
+		/** \brief  Parses a ProForma string made of several chains, joined by crosslinks ('//') or
+		  *         as chimeric spectra ('+'), in a single pass.
+		  * \param  proFormaString The pro forma string to be parsed.
+		  * \return ProFormaMultiTerm object holding every chain and the crosslinks between them.
+		  */
+		ProFormaMultiTerm ParseMultiString(const std::string& proFormaString);
+
 		
 	private:
 		ProFormaLogger* _logger;
+		ProFormaParserLimits _limits;
+
+		// counters of the parsing thread, set by Measure
+		ProFormaParserStats* _stats;
+
+		// per parse counters checked against the limits
+		size_t _residueCount;
+		size_t _tagCount;
+		size_t _allocatedBytes;
 
 		// methods
+		ProFormaTerm ParseChain(const std::string& proFormaString, size_t start, size_t& end);
+		static bool IsUnlocalizedPrefix(const std::string& proFormaString, size_t index);
+		void StartParse(const std::string& proFormaString);
+		void CountAllocation(size_t bytes);
+
 		void HandleGlobalModification
 		(
-			std::map<std::string, ProFormaTagGroup*>& tagGroups,
-			std::list<ProFormaGlobalModification>& globalModifications, 
-			std::stringstream& sequence,
+			ProFormaTermBuilder& builder,
 			size_t startRange,
 			size_t endRange,
 			std::string& tagText
 		);
 
 		static void SplitStr(std::string const &str, const char delim, std::vector<std::string>& out);
-		std::list<ProFormaDescriptor> ProcessTag(std::string& tag, size_t startIndex, size_t index, std::map<std::string, ProFormaTagGroup*>& tagGroups);
-		void ProcessTag(std::string& tag, size_t startIndex, size_t index, std::list<ProFormaTag>& tags, std::map<std::string, ProFormaTagGroup*>& tagGroups);
+		std::list<ProFormaDescriptor> ProcessTag(std::string& tag, size_t startIndex, size_t index, ProFormaTermBuilder& builder);
+		void AddTag(std::string& tag, size_t startIndex, size_t index, ProFormaTermBuilder& builder);
 		std::tuple<ProFormaKey, ProFormaEvidenceType, std::string, std::string, double> ParseDescriptor(std::string& text);
 		
 		static ProFormaKey GetKey(bool isMass);
 		static void ToLower(std::string& input);
 		void ToUpper(std::string& input);
 		static void Trim(std::string& input);
+
+		template <typename Result, typename Parse>
+		Result Measure(ProFormaOperation operation, const std::string& proFormaString, Parse parse);
+
+		/** \brief  Updates a counter only when the policy collects stats, compiled out otherwise. */
+		void Count(ProFormaParserCounter counter, uint64_t value = 1)
+		{
+			if constexpr (Policy::CollectStats)
+				_stats->Add(counter, value);
+		}
+
+		/** \brief  Logs the message only when the policy enables logging, compiled out otherwise. */
+		template <typename... Args>
+		void Trace(const char* format, Args... args)
+		{
+			if constexpr (Policy::EnableLogging)
+				_logger->Log(format, args...);
+		}
 	};
+
+	/** \brief  Fully featured parser, logging enabled */
+	typedef BasicProFormaParser<ProFormaDefaultPolicy> ProFormaParser;
+
+	/** \brief  Fully featured parser without logging */
+	typedef BasicProFormaParser<ProFormaQuietPolicy> ProFormaQuietParser;
+
+	/** \brief  Fully featured parser accepting lower case residues */
+	typedef BasicProFormaParser<ProFormaLenientPolicy> ProFormaLenientParser;
+
+	/** \brief  Localized and terminal modifications only */
+	typedef BasicProFormaParser<ProFormaPeptidePolicy> ProFormaPeptideParser;
+
+	extern template class EXPORT BasicProFormaParser<ProFormaDefaultPolicy>;
+	extern template class EXPORT BasicProFormaParser<ProFormaQuietPolicy>;
+	extern template class EXPORT BasicProFormaParser<ProFormaLenientPolicy>;
+	extern template class EXPORT BasicProFormaParser<ProFormaPeptidePolicy>;
 }
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+
+namespace ProForma {
+	/**
+	 * \struct ProFormaParserLimits
+	 *
+	 * \brief Resource bounds enforced by BasicProFormaParser on every parse, so a single pathological
+	 *        input cannot monopolize a shared worker. Exceeding one raises a ProFormaParseException
+	 *        carrying the matching ProFormaParseErrorCode. Everything is unlimited by default.
+	 *
+	 */
+	struct ProFormaParserLimits {
+		/** \brief  Maximum length of the input string. */
+		size_t MaxInputLength = std::numeric_limits<size_t>::max();
+
+		/** \brief  Maximum number of residues, all chains included. */
+		size_t MaxResidues = std::numeric_limits<size_t>::max();
+
+		/** \brief  Maximum number of tags, terminal, labile, unlocalized and global ones included. */
+		size_t MaxTags = std::numeric_limits<size_t>::max();
+
+		/** \brief  Maximum number of descriptors in a single tag. */
+		size_t MaxDescriptorsPerTag = std::numeric_limits<size_t>::max();
+
+		/** \brief  Maximum nesting depth of brackets and braces. */
+		size_t MaxNestingDepth = std::numeric_limits<size_t>::max();
+
+		/** \brief  Maximum number of bytes allocated for the parsed term (approximation of the heap usage). */
+		size_t MaxAllocatedBytes = std::numeric_limits<size_t>::max();
+	};
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+// Build option removing the parser counters from the predefined policies, see ProFormaParserStats
+#ifndef PROFORMA_PARSER_STATS
+#define PROFORMA_PARSER_STATS 1
+#endif
+
+namespace ProForma {
+	/**
+	 * \struct ProFormaDefaultPolicy
+	 *
+	 * \brief Compile-time feature selection for BasicProFormaParser. Every grammar feature is enabled and
+	 *        parsing is logged, this is the behaviour of the classic ProFormaParser.
+	 *
+	 * Custom policies derive from one of the predefined ones and hide the flags they want to change.
+	 * Disabled features are removed from the parser at compile time and raise a ProFormaParseException
+	 * when found in the input.
+	 *
+	 */
+	struct ProFormaDefaultPolicy {
+		/** \brief  Only upper case residues are accepted, lenient parsers upper case them and skip blanks. */
+		static constexpr bool StrictResidues = true;
+
+		/** \brief  Tag groups (#name) spread over several sites. */
+		static constexpr bool AllowTagGroups = true;
+
+		/** \brief  Global modifications and isotopes (<...>). */
+		static constexpr bool AllowGlobalModifications = true;
+
+		/** \brief  Unlocalized modifications ([...]?). */
+		static constexpr bool AllowUnlocalizedTags = true;
+
+		/** \brief  Labile modifications ({...}). */
+		static constexpr bool AllowLabileModifications = true;
+
+		/** \brief  Ambiguity ranges ((...)[...]). */
+		static constexpr bool AllowRanges = true;
+
+		/** \brief  Trace every parsing step through ProFormaLogger. */
+		static constexpr bool EnableLogging = true;
+
+		/** \brief  Update the ProFormaParserStats counters, no code is generated for them otherwise. */
+		static constexpr bool CollectStats = PROFORMA_PARSER_STATS != 0;
+	};
+
+	/**
+	 * \struct ProFormaQuietPolicy
+	 *
+	 * \brief Fully featured grammar without logging.
+	 *
+	 */
+	struct ProFormaQuietPolicy : public ProFormaDefaultPolicy {
+		static constexpr bool EnableLogging = false;
+	};
+
+	/**
+	 * \struct ProFormaLenientPolicy
+	 *
+	 * \brief Fully featured grammar without logging, accepting lower case residues and blanks in the sequence.
+	 *
+	 */
+	struct ProFormaLenientPolicy : public ProFormaQuietPolicy {
+		static constexpr bool StrictResidues = false;
+	};
+
+	/**
+	 * \struct ProFormaPeptidePolicy
+	 *
+	 * \brief Reduced grammar for peptide searches: localized tags and terminal modifications only, no logging.
+	 *
+	 */
+	struct ProFormaPeptidePolicy : public ProFormaQuietPolicy {
+		static constexpr bool AllowTagGroups = false;
+		static constexpr bool AllowGlobalModifications = false;
+		static constexpr bool AllowUnlocalizedTags = false;
+		static constexpr bool AllowLabileModifications = false;
+		static constexpr bool AllowRanges = false;
+	};
+}
@@ -0,0 +1,131 @@
+#include "ProFormaParserStats.h"
+
+#include <mutex>
+#include <vector>
+
+using namespace ProForma;
+
+namespace ProForma {
+    // Blocks of counters of every thread that parsed, never freed: a finished thread hands its block
+    // over to the next new thread, so the totals are kept and the memory is bounded by the peak thread count
+    class ProFormaParserStatsRegistry {
+    public:
+        static ProFormaParserStatsRegistry& Instance()
+        {
+            // Leaked on purpose, threads may still parse during the static destruction
+            static ProFormaParserStatsRegistry* registry = new ProFormaParserStatsRegistry();
+            return *registry;
+        }
+
+        ProFormaParserStats* Acquire()
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            if (!_free.empty())
+            {
+                ProFormaParserStats* stats = _free.back();
+                _free.pop_back();
+                return stats;
+            }
+
+            _all.push_back(new ProFormaParserStats());
+            return _all.back();
+        }
+
+        void Release(ProFormaParserStats* stats)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _free.push_back(stats);
+        }
+
+        ProFormaParserStatsSnapshot Total()
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            ProFormaParserStatsSnapshot snapshot;
+
+            for (auto stats : _all)
+                stats->AddTo(snapshot);
+
+            Subtract(snapshot, _baseline);
+            return snapshot;
+        }
+
+        void Reset()
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            ProFormaParserStatsSnapshot snapshot;
+
+            for (auto stats : _all)
+                stats->AddTo(snapshot);
+
+            _baseline = snapshot;
+        }
+
+    private:
+        static void Subtract(ProFormaParserStatsSnapshot& snapshot, const ProFormaParserStatsSnapshot& baseline)
+        {
+            for (size_t i = 0; i < ProFormaParserCounterCount; i++)
+                snapshot.Counters[i] -= baseline.Counters[i];
+            for (size_t i = 0; i < ProFormaParseErrorCodeCount; i++)
+                snapshot.Errors[i] -= baseline.Errors[i];
+            for (size_t i = 0; i < ProFormaKeyCount; i++)
+                snapshot.DescriptorsByKey[i] -= baseline.DescriptorsByKey[i];
+        }
+
+        std::mutex _mutex;
+        std::vector<ProFormaParserStats*> _all;
+        std::vector<ProFormaParserStats*> _free;
+        ProFormaParserStatsSnapshot _baseline;
+    };
+}
+
+namespace {
+    // Block of the calling thread, handed back to the registry when the thread ends
+    struct ThreadStats {
+        ProFormaParserStats* Stats = nullptr;
+
+        ~ThreadStats()
+        {
+            if (Stats != nullptr)
+                ProFormaParserStatsRegistry::Instance().Release(Stats);
+        }
+    };
+
+    thread_local ThreadStats _threadStats;
+}
+
+/*****************************************************************************/
+// PUBLIC
+/*****************************************************************************/
+
+ProFormaParserStatsSnapshot ProFormaParserStats::Snapshot()
+{
+    return ProFormaParserStatsRegistry::Instance().Total();
+}
+
+void ProFormaParserStats::Reset()
+{
+    ProFormaParserStatsRegistry::Instance().Reset();
+}
+
+ProFormaParserStats& ProFormaParserStats::Local()
+{
+    if (_threadStats.Stats == nullptr)
+        _threadStats.Stats = ProFormaParserStatsRegistry::Instance().Acquire();
+
+    return *_threadStats.Stats;
+}
+
+/*****************************************************************************/
+// PRIVATE
+/*****************************************************************************/
+
+void ProFormaParserStats::AddTo(ProFormaParserStatsSnapshot& snapshot) const
+{
+    for (size_t i = 0; i < ProFormaParserCounterCount; i++)
+        snapshot.Counters[i] += _counters[i].load(std::memory_order_relaxed);
+    for (size_t i = 0; i < ProFormaParseErrorCodeCount; i++)
+        snapshot.Errors[i] += _errors[i].load(std::memory_order_relaxed);
+    for (size_t i = 0; i < ProFormaKeyCount; i++)
+        snapshot.DescriptorsByKey[i] += _descriptorsByKey[i].load(std::memory_order_relaxed);
+}
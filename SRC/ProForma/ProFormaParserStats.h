@@ -0,0 +1,158 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "PlatformHelper.h"
+
+#include "ProFormaParseException.h"
+#include "Proformakey.h"
+
+namespace ProForma {
+	/** @enum ProFormaParserCounter
+	 *  @brief Counters of ProFormaParserStats, summed over every parse of every thread. New counters go last,
+	 *         ProFormaParserCounterCount is derived from the last one
+	 */
+	enum class ProFormaParserCounter {
+		/**< Successful ParseString and ParseMultiString calls */
+		Parses = 0,
+
+		/**< Calls that raised an exception, see ProFormaParserStatsSnapshot::Errors for the codes */
+		Failures = 1,
+
+		/**< Length of the parsed strings, failed ones included */
+		InputBytes = 2,
+
+		/**< Time spent in the parse calls, failed ones included */
+		ParseNanoseconds = 3,
+
+		/**< Residues of the parsed chains */
+		Residues = 4,
+
+		/**< Every tag processed: localized, terminal, labile, unlocalized and global */
+		Tags = 5,
+
+		/**< Tags on a residue or a range */
+		LocalizedTags = 6,
+
+		/**< Unlocalized tags ([...]?) */
+		UnlocalizedTags = 7,
+
+		/**< Global modifications and isotopes (<...>) */
+		GlobalModifications = 8,
+
+		/**< Labile modifications ({...}) */
+		LabileModifications = 9,
+
+		/**< N- and C-terminal modifications */
+		TerminalModifications = 10,
+
+		/**< Ambiguity ranges ((...)[...]) */
+		Ranges = 11,
+
+		/**< Tag groups (#name) */
+		TagGroups = 12,
+
+		/**< Members of the tag groups */
+		GroupMembers = 13,
+
+		/**< Descriptors of every tag, see ProFormaParserStatsSnapshot::DescriptorsByKey */
+		Descriptors = 14
+	};
+
+	/** \brief  Number of ProFormaParserCounter values, Descriptors is the last one */
+	const size_t ProFormaParserCounterCount = static_cast<size_t>(ProFormaParserCounter::Descriptors) + 1;
+
+	/** \brief  Number of ProFormaParseErrorCode values, AllocationLimitExceeded is the last one */
+	const size_t ProFormaParseErrorCodeCount = static_cast<size_t>(ProFormaParseErrorCode::AllocationLimitExceeded) + 1;
+
+	/** \brief  Number of ProFormaKey values, Info is the last one */
+	const size_t ProFormaKeyCount = static_cast<size_t>(ProFormaKey::Info) + 1;
+
+	/**
+	 * \struct ProFormaParserStatsSnapshot
+	 *
+	 * \brief Values of the parser counters at one point in time, see ProFormaParserStats::Snapshot.
+	 *
+	 */
+	struct ProFormaParserStatsSnapshot {
+		/**< Indexed by ProFormaParserCounter */
+		uint64_t Counters[ProFormaParserCounterCount] = {};
+
+		/**< Failures indexed by ProFormaParseErrorCode */
+		uint64_t Errors[ProFormaParseErrorCodeCount] = {};
+
+		/**< Descriptors indexed by ProFormaKey */
+		uint64_t DescriptorsByKey[ProFormaKeyCount] = {};
+
+		/** \brief  Value of a counter */
+		uint64_t operator[](ProFormaParserCounter counter) const { return Counters[static_cast<size_t>(counter)]; }
+
+		/** \brief  Adds the counters of another snapshot, e.g. from another process */
+		void Merge(const ProFormaParserStatsSnapshot& other)
+		{
+			for (size_t i = 0; i < ProFormaParserCounterCount; i++)
+				Counters[i] += other.Counters[i];
+			for (size_t i = 0; i < ProFormaParseErrorCodeCount; i++)
+				Errors[i] += other.Errors[i];
+			for (size_t i = 0; i < ProFormaKeyCount; i++)
+				DescriptorsByKey[i] += other.DescriptorsByKey[i];
+		}
+	};
+
+	/**
+	 * \class ProFormaParserStats
+	 *
+	 * \brief Counters updated by the parsers whose policy has CollectStats set, the predefined ones unless
+	 *        the library is built with PROFORMA_PARSER_STATS=0. Every thread writes its own block of
+	 *        counters, aligned on a cache line so threads do not share lines, with plain relaxed stores.
+	 *        Snapshot() sums the blocks on demand. Blocks of finished threads are kept and reused.
+	 *
+	 */
+	class EXPORT ProFormaParserStats {
+	public:
+		/** \brief  Sums the counters of every thread since the last Reset() */
+		static ProFormaParserStatsSnapshot Snapshot();
+
+		/** \brief  Restarts the counters from zero, the threads keep parsing meanwhile */
+		static void Reset();
+
+		/** \brief  Counters of the calling thread, used by the parser */
+		static ProFormaParserStats& Local();
+
+		/** \brief  Adds to a counter, only the owning thread writes */
+		void Add(ProFormaParserCounter counter, uint64_t value = 1) { Increment(_counters[static_cast<size_t>(counter)], value); }
+
+		/** \brief  Counts a failure with its code */
+		void AddError(ProFormaParseErrorCode code)
+		{
+			Add(ProFormaParserCounter::Failures);
+			Increment(_errors[static_cast<size_t>(code) < ProFormaParseErrorCodeCount ? static_cast<size_t>(code) : 0]);
+		}
+
+		/** \brief  Counts a descriptor with its key */
+		void AddDescriptor(ProFormaKey key)
+		{
+			Increment(_descriptorsByKey[static_cast<size_t>(key) < ProFormaKeyCount ? static_cast<size_t>(key) : 0]);
+		}
+
+	private:
+		ProFormaParserStats() = default;
+
+		static void Increment(std::atomic<uint64_t>& counter, uint64_t value = 1)
+		{
+			// Single writer, no read-modify-write needed
+			counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+		}
+
+		void AddTo(ProFormaParserStatsSnapshot& snapshot) const;
+
+		// First member aligned, so the size is a whole number of cache lines
+		alignas(64) std::atomic<uint64_t> _counters[ProFormaParserCounterCount] = {};
+		std::atomic<uint64_t> _errors[ProFormaParseErrorCodeCount] = {};
+		std::atomic<uint64_t> _descriptorsByKey[ProFormaKeyCount] = {};
+
+		friend class ProFormaParserStatsRegistry;
+	};
+}
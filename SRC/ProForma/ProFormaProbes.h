@@ -0,0 +1,48 @@
+#pragma once
+
+/**
+ * \file ProFormaProbes.h
+ *
+ * \brief USDT static probes of the parser and the writer, provider "proforma". With <sys/sdt.h> from
+ *        systemtap available on Linux each probe is a single NOP plus an ELF note, so perf and bpftrace can
+ *        attach to a running process:
+ *
+ *            bpftrace -e 'usdt:./libTopDownProteomics.so:proforma:parse__done { @[arg1] = count(); }'
+ *
+ *        Elsewhere, or when built with PROFORMA_PROBES=0, the macros expand to nothing.
+ *
+ *        Probe                  Arguments
+ *        parse__start           operation (ProFormaOperation), input length
+ *        parse__done            operation, input length, residues, tags
+ *        parse__error           operation, input length, code (ProFormaParseErrorCode)
+ *        tag__start             residue index, tag length
+ *        tag__done              residue index, descriptors kept
+ *        descriptor             key (ProFormaKey), evidence type (ProFormaEvidenceType), value length
+ *        write__start           operation, residues
+ *        write__done            operation, residues, bytes written
+ *
+ */
+
+#ifndef PROFORMA_PROBES
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#define PROFORMA_PROBES 1
+#endif
+#endif
+#endif
+
+#ifndef PROFORMA_PROBES
+#define PROFORMA_PROBES 0
+#endif
+
+#if PROFORMA_PROBES
+#include <sys/sdt.h>
+
+#define PROFORMA_PROBE2(name, a1, a2) DTRACE_PROBE2(proforma, name, a1, a2)
+#define PROFORMA_PROBE3(name, a1, a2, a3) DTRACE_PROBE3(proforma, name, a1, a2, a3)
+#define PROFORMA_PROBE4(name, a1, a2, a3, a4) DTRACE_PROBE4(proforma, name, a1, a2, a3, a4)
+#else
+#define PROFORMA_PROBE2(name, a1, a2) ((void)0)
+#define PROFORMA_PROBE3(name, a1, a2, a3) ((void)0)
+#define PROFORMA_PROBE4(name, a1, a2, a3, a4) ((void)0)
+#endif
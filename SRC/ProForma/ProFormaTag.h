@@ -1,6 +1,7 @@
 #pragma once
 
 #include <list>
+#include <utility>
 
 #include "ProFormaDescriptor.h"
 
@@ -20,10 +21,8 @@ namespace ProForma {
 		  * \return void
 		  */
         ProFormaTag(size_t zeroBasedIndex, std::list<ProFormaDescriptor> descriptors)
+            : _zeroBasedStartIndex(zeroBasedIndex), _zeroBasedEndIndex(zeroBasedIndex), _descriptors(std::move(descriptors))
         { 
-            this->_zeroBasedStartIndex = zeroBasedIndex;
-            this->_zeroBasedEndIndex = zeroBasedIndex;
-            this->_descriptors = descriptors;
         }
 
         /** \brief  Initializes a new instance of the ProFormaTag class
@@ -33,23 +32,25 @@ namespace ProForma {
 		  * \return void
 		  */
         ProFormaTag(size_t zeroBasedStartIndex, size_t zeroBasedEndIndex, std::list<ProFormaDescriptor> descriptors)
+            : _zeroBasedStartIndex(zeroBasedStartIndex), _zeroBasedEndIndex(zeroBasedEndIndex), _descriptors(std::move(descriptors))
         {
-            this->_zeroBasedStartIndex = zeroBasedStartIndex;
-            this->_zeroBasedEndIndex = zeroBasedEndIndex;
-            this->_descriptors = descriptors;
         }
 
         /** \brief  Gets the zero-based start index in the sequence.
 		  */
-        size_t ZeroBasedStartIndex() { return _zeroBasedStartIndex; }
+        size_t ZeroBasedStartIndex() const { return _zeroBasedStartIndex; }
 
         /** \brief  Gets the zero-based end index in the sequence.
 		  */
-        size_t ZeroBasedEndIndex() { return _zeroBasedEndIndex; }
+        size_t ZeroBasedEndIndex() const { return _zeroBasedEndIndex; }
 
         /** \brief  Gets the descriptors.
 		  */
-        std::list<ProFormaDescriptor> Descriptors() { return _descriptors; }
+        const std::list<ProFormaDescriptor>& Descriptors() const { return _descriptors; }
+
+        /** \brief  Appends a descriptor to the tag.
+		  */
+        void AddDescriptor(ProFormaDescriptor descriptor) { _descriptors.push_back(std::move(descriptor)); }
     private:
         size_t _zeroBasedStartIndex;
         size_t _zeroBasedEndIndex;
@@ -2,6 +2,7 @@
 
 #include <list>
 #include <string>
+#include <utility>
 
 #include "ProFormaMembershipDescriptor.h"
 #include "ProFormaKey.h"
@@ -24,7 +25,7 @@ namespace ProForma {
 		  * \return void
 		  */
         ProFormaTagGroup(std::string name, ProFormaKey key, std::string value, std::list<ProFormaMembershipDescriptor> members)
-            : ProFormaTagGroup(name, key, ProFormaEvidenceType::None, value, members) { }
+            : ProFormaTagGroup(std::move(name), key, ProFormaEvidenceType::None, std::move(value), std::move(members)) { }
 
         /** \brief  Initializes a new instance of the ProFormaTagGroup class
 		  * \param  name The name.
@@ -36,13 +37,8 @@ namespace ProForma {
 		  */
         ProFormaTagGroup(std::string name, ProFormaKey key, ProFormaEvidenceType evidenceType, std::string value,
             std::list<ProFormaMembershipDescriptor> members)
+            : _name(std::move(name)), _key(key), _evidenceType(evidenceType), _value(std::move(value)), _members(std::move(members)), _isChanging(false)
         {
-            this->_name = name;
-            this->_key = key;
-            this->_evidenceType = evidenceType;
-            this->_value = value;
-            this->_members = members;
-            this->_isChanging = false;
         }
 
         /** \brief  Copy constructor for ProFormaTagGroup class
@@ -66,27 +62,27 @@ namespace ProForma {
         }
 
         /** \brief  The name of the group. */
-        std::string Name() { return _name; }
+        const std::string& Name() const { return _name; }
 
         /** \brief The key getter and setter. */
-        ProFormaKey Key() { return _key; }
+        ProFormaKey Key() const { return _key; }
         void SetKey(ProFormaKey key) { _key = key; }
 
         /** \brief The type of the evidence getter and setter. */
-        ProFormaEvidenceType EvidenceType() { return _evidenceType; }
+        ProFormaEvidenceType EvidenceType() const { return _evidenceType; }
         void SetEvidenceType(ProFormaEvidenceType evidenceType) { _evidenceType = evidenceType; }
 
         /** \brief The value getter and setter. */
-        std::string Value() { return _value;  }
+        const std::string& Value() const { return _value;  }
         void SetValue(std::string value) { _value = value; }
 
         /** \brief The members of the group. */
-        std::list<ProFormaMembershipDescriptor> Members() { return _members; }
+        const std::list<ProFormaMembershipDescriptor>& Members() const { return _members; }
 
         /** \brief The value getter and setter. */
-        bool IsChanging() { return _isChanging; }
+        bool IsChanging() const { return _isChanging; }
 
-        void AddMember(ProFormaMembershipDescriptor descriptor) { _members.push_back(descriptor);  }
+        void AddMember(ProFormaMembershipDescriptor descriptor) { _members.push_back(std::move(descriptor));  }
     protected:
         std::string _name;
         ProFormaKey _key;
@@ -20,7 +20,7 @@ namespace ProForma {
 		  * \return void
 		  */
         ProFormaTagGroupChangingValue(std::string name, ProFormaKey key, ProFormaEvidenceType evidenceType,
-                std::list<ProFormaMembershipDescriptor> members) : ProFormaTagGroup(name, key, evidenceType, "", members), _keyFlux(ProFormaKey::None), _evidenceTypeFlux(ProFormaEvidenceType::None), _valueFlux("")
+                std::list<ProFormaMembershipDescriptor> members) : ProFormaTagGroup(std::move(name), key, evidenceType, "", std::move(members)), _keyFlux(ProFormaKey::None), _evidenceTypeFlux(ProFormaEvidenceType::None), _valueFlux("")
         {
             SetKeyFlux(key);
             SetEvidenceFlux(evidenceType);
@@ -30,16 +30,16 @@ namespace ProForma {
 
         // New setters and getters
         /** \brief The key getter and setter. */
-        ProFormaKey KeyFlux() { return _key; }
+        ProFormaKey KeyFlux() const { return _key; }
         void SetKeyFlux(ProFormaKey key) { if(key != ProFormaKey::None) _key = key; }
 
         /** \brief The type of the evidence getter and setter. */
-        ProFormaEvidenceType EvidenceFlux() { return _evidenceType; }
+        ProFormaEvidenceType EvidenceFlux() const { return _evidenceType; }
         void SetEvidenceFlux(ProFormaEvidenceType evidenceType) { if(evidenceType != ProFormaEvidenceType::None) _evidenceType = evidenceType; }
 
         /** \brief The value getter and setter. */
-        std::string ValueFlux() { return _value;  }
-        void SetValueFlux(std::string value) { if(value.length())_value = value; }
+        const std::string& ValueFlux() const { return _value;  }
+        void SetValueFlux(std::string value) { if(value.length())_value = std::move(value); }
     private:
         ProFormaKey _keyFlux;
         ProFormaEvidenceType _evidenceTypeFlux;
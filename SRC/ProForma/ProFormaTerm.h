@@ -4,11 +4,13 @@
 #include <list>
 #include <vector>
 #include <map>
+#include <utility>
 
 #include "ProFormaTag.h"
 #include "ProFormaTagGroup.h"
 #include "ProFormaGlobalModification.h"
 #include "ProFormaUnlocalizedTag.h"
+#include "ProFormaMemoryUsage.h"
 
 namespace ProForma {
 	/**
@@ -40,40 +42,43 @@ namespace ProForma {
             std::map<std::string, ProFormaTagGroup*> tagGroups = std::map<std::string, ProFormaTagGroup*>(),
             std::list<ProFormaGlobalModification> globalModifications = std::list<ProFormaGlobalModification>()
         )
+            : _sequence(std::move(sequence)),
+              _globalModifications(std::move(globalModifications)),
+              _nTerminalDescriptors(std::move(nTerminalDescriptors)),
+              _cTerminalDescriptors(std::move(cTerminalDescriptors)),
+              _labileDescriptors(std::move(labileDescriptors)),
+              _tags(std::move(tags)),
+              _unlocalizedTags(std::move(unlocalizedTags)),
+              _tagGroups(std::move(tagGroups))
         {
-            this->_sequence = sequence;
-            this->_nTerminalDescriptors = nTerminalDescriptors;
-            this->_cTerminalDescriptors = cTerminalDescriptors;
-            this->_labileDescriptors = labileDescriptors;
-            this->_tags = tags;
-            this->_unlocalizedTags = unlocalizedTags;
-            this->_tagGroups = tagGroups;
-            this->_globalModifications = globalModifications;
         }
 
         /** \brief  The amino acid sequence. */
-        std::string Sequence() { return _sequence; }
+        const std::string& Sequence() const { return _sequence; }
 
         /** \brief  Modifications that apply globally based on a target or targets. */
-        std::list<ProFormaGlobalModification> GlobalModifications() { return _globalModifications; }
+        const std::list<ProFormaGlobalModification>& GlobalModifications() const { return _globalModifications; }
 
         /** \brief  N-Terminal descriptors. */
-        std::list<ProFormaDescriptor> NTerminalDescriptors() { return _nTerminalDescriptors; }
+        const std::list<ProFormaDescriptor>& NTerminalDescriptors() const { return _nTerminalDescriptors; }
 
         /** \brief  C-Terminal descriptors. */
-        std::list<ProFormaDescriptor> CTerminalDescriptors() { return _cTerminalDescriptors; }
+        const std::list<ProFormaDescriptor>& CTerminalDescriptors() const { return _cTerminalDescriptors; }
 
         /** \brief  Labile modifications (not visible in the fragmentation MS2 spectrum) descriptors. */
-        std::list<ProFormaDescriptor> LabileDescriptors() { return _labileDescriptors; }
+        const std::list<ProFormaDescriptor>& LabileDescriptors() const { return _labileDescriptors; }
 
         /** \brief  All tags on this term. */
-        std::list<ProFormaTag> Tags() { return _tags; }
+        const std::list<ProFormaTag>& Tags() const { return _tags; }
 
         /** \brief  Descriptors for modifications that are completely unlocalized. */
-        std::list<ProFormaUnlocalizedTag> UnlocalizedTags() { return _unlocalizedTags; }
+        const std::list<ProFormaUnlocalizedTag>& UnlocalizedTags() const { return _unlocalizedTags; }
 
         /** \brief  All tag groups for this term. */
-        std::map<std::string, ProFormaTagGroup*> TagGroups() { return _tagGroups; }
+        const std::map<std::string, ProFormaTagGroup*>& TagGroups() const { return _tagGroups; }
+
+        /** \brief  Approximate bytes held by this term, by component, see ProFormaMemoryUsage. */
+        ProFormaMemoryUsage ApproximateMemoryUsage() const;
     private:
         std::string _sequence;
         std::list<ProFormaGlobalModification> _globalModifications;
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <string>
+#include <list>
+#include <vector>
+#include <map>
+#include <utility>
+
+#include "PlatformHelper.h"
+#include "ProFormaParseException.h"
+#include "ProFormaTerm.h"
+
+namespace ProForma {
+	/**
+	 * \class ProFormaTermBuilder
+	 *
+	 * \brief Assembles a ProFormaTerm piece by piece. Every element is created in place in its final
+	 *        container and moved, never copied, into the term by Build(), so each one is allocated once.
+	 *        Used by ProFormaParser and by producers that create terms without going through a string.
+	 *
+	 */
+	class EXPORT ProFormaTermBuilder {
+    public:
+        ProFormaTermBuilder() = default;
+
+        /** \brief  Frees the tag groups when Build() was never called (a parse that failed half way). */
+        ~ProFormaTermBuilder()
+        {
+            for (auto& item : _tagGroups)
+                delete item.second;
+        }
+
+        /** \brief  The builder owns its tag groups until Build(), it cannot be copied. */
+        ProFormaTermBuilder(const ProFormaTermBuilder&) = delete;
+        ProFormaTermBuilder& operator=(const ProFormaTermBuilder&) = delete;
+
+        /** \brief  Appends a residue to the sequence. */
+        ProFormaTermBuilder& AddResidue(char residue) { _sequence.push_back(residue); return *this; }
+
+        /** \brief  Replaces the whole sequence. */
+        ProFormaTermBuilder& SetSequence(std::string sequence) { _sequence = std::move(sequence); return *this; }
+
+        /** \brief  Number of residues added so far. */
+        size_t SequenceLength() const { return _sequence.length(); }
+
+        /** \brief  Adds a tag on a single residue, descriptors may follow through AddDescriptor
+		  * \param  zeroBasedIndex The zero-based index of the modified amino acid in the sequence.
+          * \param  descriptors The descriptors.
+		  * \return the builder
+		  */
+        ProFormaTermBuilder& AddTag(size_t zeroBasedIndex, std::list<ProFormaDescriptor> descriptors = std::list<ProFormaDescriptor>())
+        {
+            _tags.emplace_back(zeroBasedIndex, std::move(descriptors));
+            return *this;
+        }
+
+        /** \brief  Adds a tag on a range of residues, descriptors may follow through AddDescriptor
+		  * \param  zeroBasedStartIndex The zero-based start index of the modified amino acid in the sequence.
+          * \param  zeroBasedEndIndex The zero-based end index of the modified amino acid in the sequence.
+          * \param  descriptors The descriptors.
+		  * \return the builder
+		  */
+        ProFormaTermBuilder& AddTag(size_t zeroBasedStartIndex, size_t zeroBasedEndIndex, std::list<ProFormaDescriptor> descriptors = std::list<ProFormaDescriptor>())
+        {
+            _tags.emplace_back(zeroBasedStartIndex, zeroBasedEndIndex, std::move(descriptors));
+            return *this;
+        }
+
+        /** \brief  Appends a descriptor to the last tag added, throws when no tag was added. */
+        ProFormaTermBuilder& AddDescriptor(ProFormaDescriptor descriptor)
+        {
+            if (_tags.empty())
+                throw new ProFormaParseException("Descriptor added before any tag.");
+
+            _tags.back().AddDescriptor(std::move(descriptor));
+            return *this;
+        }
+
+        /** \brief  Number of tags added so far. */
+        size_t TagCount() const { return _tags.size(); }
+
+        /** \brief  N-Terminal descriptors setter and count. */
+        ProFormaTermBuilder& SetNTerminalDescriptors(std::list<ProFormaDescriptor> descriptors) { _nTerminalDescriptors = std::move(descriptors); return *this; }
+        size_t NTerminalDescriptorCount() const { return _nTerminalDescriptors.size(); }
+
+        /** \brief  C-Terminal descriptors setter. */
+        ProFormaTermBuilder& SetCTerminalDescriptors(std::list<ProFormaDescriptor> descriptors) { _cTerminalDescriptors = std::move(descriptors); return *this; }
+
+        /** \brief  Labile modification descriptors setter. */
+        ProFormaTermBuilder& SetLabileDescriptors(std::list<ProFormaDescriptor> descriptors) { _labileDescriptors = std::move(descriptors); return *this; }
+
+        /** \brief  Adds an unlocalized modification tag. */
+        ProFormaTermBuilder& AddUnlocalizedTag(int count, std::list<ProFormaDescriptor> descriptors)
+        {
+            _unlocalizedTags.emplace_back(count, std::move(descriptors));
+            return *this;
+        }
+
+        /** \brief  Number of unlocalized tags added so far. */
+        size_t UnlocalizedTagCount() const { return _unlocalizedTags.size(); }
+
+        /** \brief  Adds a global modification. */
+        ProFormaTermBuilder& AddGlobalModification(std::list<ProFormaDescriptor> descriptors, std::vector<char> targetAminoAcids)
+        {
+            _globalModifications.emplace_back(std::move(descriptors), std::move(targetAminoAcids));
+            return *this;
+        }
+
+        /** \brief  Adds a tag group, the builder and then the term take ownership of it. */
+        ProFormaTagGroup* AddTagGroup(ProFormaTagGroup* group)
+        {
+            if (!_tagGroups.emplace(group->Name(), group).second)
+            {
+                std::string name = group->Name();
+                delete group;
+                throw new ProFormaParseException("Tag group %s added twice.", name.c_str());
+            }
+
+            return group;
+        }
+
+        /** \brief  Adds a tag group with a fixed value. */
+        ProFormaTermBuilder& AddTagGroup(std::string name, ProFormaKey key, ProFormaEvidenceType evidenceType, std::string value)
+        {
+            AddTagGroup(new ProFormaTagGroup(std::move(name), key, evidenceType, std::move(value), std::list<ProFormaMembershipDescriptor>()));
+            return *this;
+        }
+
+        /** \brief  Finds a tag group by name, nullptr when it was not added. */
+        ProFormaTagGroup* FindTagGroup(const std::string& name) const
+        {
+            auto item = _tagGroups.find(name);
+            return item == _tagGroups.end() ? nullptr : item->second;
+        }
+
+        /** \brief  Number of tag groups added so far. */
+        size_t TagGroupCount() const { return _tagGroups.size(); }
+
+        /** \brief  Adds a member to a tag group added before. */
+        ProFormaTermBuilder& AddGroupMember(const std::string& name, ProFormaMembershipDescriptor member)
+        {
+            _tagGroups.at(name)->AddMember(std::move(member));
+            return *this;
+        }
+
+        /** \brief  Moves everything added into a new term, the builder is left empty. */
+        ProFormaTerm Build() &&
+        {
+            ProFormaTerm term(std::move(_sequence), std::move(_tags), std::move(_nTerminalDescriptors), std::move(_cTerminalDescriptors),
+                std::move(_labileDescriptors), std::move(_unlocalizedTags), std::move(_tagGroups), std::move(_globalModifications));
+
+            // The term owns the groups now
+            _tagGroups.clear();
+            return term;
+        }
+    private:
+        std::string _sequence;
+        std::list<ProFormaGlobalModification> _globalModifications;
+        std::list<ProFormaDescriptor> _nTerminalDescriptors;
+        std::list<ProFormaDescriptor> _cTerminalDescriptors;
+        std::list<ProFormaDescriptor> _labileDescriptors;
+        std::list<ProFormaTag> _tags;
+        std::list<ProFormaUnlocalizedTag> _unlocalizedTags;
+        std::map<std::string, ProFormaTagGroup*> _tagGroups;
+	};
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <list>
+#include <utility>
 
 #include "ProFormaDescriptor.h"
 
@@ -19,16 +20,15 @@ namespace ProForma {
 		  * \return void
 		  */
         ProFormaUnlocalizedTag(int count, std::list<ProFormaDescriptor> descriptors)
+            : _count(count), _descriptors(std::move(descriptors))
         {
-            _count = count;
-            _descriptors = descriptors;
         }
 
         /** \brief  The number of unlocalized modifications applied. */
-        int Count() { return _count; }
+        int Count() const { return _count; }
 
         /** \brief  Gets the descriptors. */
-        std::list<ProFormaDescriptor> Descriptors() { return _descriptors; }
+        const std::list<ProFormaDescriptor>& Descriptors() const { return _descriptors; }
 
     private:
         int _count;
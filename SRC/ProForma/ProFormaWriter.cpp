@@ -1,382 +1,798 @@
-#include <sstream>
-#include <exception>
 #include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
 
 #include "ProFormaWriter.h"
-#include "ProFormaLogger.h"
 #include "ProFormaTagGroupChangingValue.h"
-#include "nlohmann/json.hpp"
+#include "ProFormaJsonEmitter.h"
+#include "ProFormaCborEmitter.h"
+#include "ProFormaMsgPackEmitter.h"
+#include "ProFormaAllocationStats.h"
+#include "ProFormaLatencyHistogram.h"
+#include "ProFormaProbes.h"
 
 using namespace ProForma;
-using json = nlohmann::json;
 
 /*****************************************************************************/
-// PUBLIC
+// TEXT OUTPUT
 /*****************************************************************************/
- 
-std::string ProFormaWriter::TermToString(ProFormaTerm& term)
-{
-    std::stringstream text;
 
-    // Check global modifications
-    if (term.GlobalModifications().size())
+namespace {
+    // Measures the text, so the buffer can be sized before anything is written
+    struct LengthSink {
+        size_t Length = 0;
+
+        void Append(char) { Length++; }
+        void Append(const char*, size_t length) { Length += length; }
+        void Append(const std::string& text) { Length += text.length(); }
+        void Append(const std::string& text, size_t position, size_t length) { Length += std::min(length, text.length() - std::min(position, text.length())); }
+    };
+
+    // Appends the text to the caller buffer
+    struct StringSink {
+        std::string& Out;
+
+        void Append(char c) { Out.push_back(c); }
+        void Append(const char* text, size_t length) { Out.append(text, length); }
+        void Append(const std::string& text) { Out.append(text); }
+        void Append(const std::string& text, size_t position, size_t length) { Out.append(text, position, length); }
+    };
+
+    // A tag, or a member of a tag group, placed on the sequence
+    struct PlacedItem {
+        size_t Start;
+        size_t End;
+        const ProFormaTag* Tag;
+        const ProFormaTagGroup* Group;
+        const ProFormaMembershipDescriptor* Member;
+        bool DisplayValue;
+        size_t Order;
+    };
+
+    // Items of one sorted stream, the tags or the members of one group, in _streamItems
+    struct ItemStream {
+        size_t Next;
+        size_t End;
+        size_t Index;
+    };
+
+    // Scratch space reused from term to term, so placing the items does not allocate once warm
+    thread_local std::vector<PlacedItem> _placedItems;
+    thread_local std::vector<PlacedItem> _streamItems;
+    thread_local std::vector<ItemStream> _streams;
+
+    template <typename Sink>
+    void AppendText(Sink& sink, const char* text)
     {
-        for(auto globalMod : term.GlobalModifications())
-        {
-            if (globalMod.TargetAminoAcids().size())
-            {
-                std::string info = CreateDescriptorsText(globalMod.Descriptors()) + "@";
-                int id = 0;
-                for (auto targetAminoacid : globalMod.TargetAminoAcids()) {
-                    info += targetAminoacid;
-                    if (id < globalMod.TargetAminoAcids().size() - 1) info += ',';
-                    id++;
-                }
-            }
-            else
-                text << CreateDescriptorsText(globalMod.Descriptors());
-        }
+        sink.Append(text, strlen(text));
     }
 
-    // Check labile modifications
-    if (term.LabileDescriptors().size())
+    bool StartsBefore(const PlacedItem& a, const PlacedItem& b)
     {
-        text << CreateDescriptorsText(term.LabileDescriptors());
+        return a.Start < b.Start;
     }
 
-    // Check unlocalized modifications
-    if (term.UnlocalizedTags().size())
+    // Items of a stream sharing a start keep their order, std::sort does not allocate as std::stable_sort does
+    bool PlacedBefore(const PlacedItem& a, const PlacedItem& b)
     {
-        for(auto tag : term.UnlocalizedTags())
-        {
-            if (tag.Descriptors().size())
-                text << CreateDescriptorsText(tag.Descriptors());
+        return a.Start < b.Start || (a.Start == b.Start && a.Order < b.Order);
+    }
 
-            if (tag.Count() != 1)
-                text << tag.Count();
-        }
+    PlacedItem TagItem(const ProFormaTag& tag, size_t order)
+    {
+        return PlacedItem{ tag.ZeroBasedStartIndex(), tag.ZeroBasedEndIndex(), &tag, nullptr, nullptr, false, order };
+    }
+
+    PlacedItem MemberItem(const ProFormaTagGroup* group, const ProFormaMembershipDescriptor& member, bool isFirst, size_t order)
+    {
+        return PlacedItem{ member.ZeroBasedStartIndex(), member.ZeroBasedEndIndex(), nullptr, group, &member, isFirst, order };
+    }
 
-        // Only write out a single question mark
-        text << '?';
+    // Heap order of the streams: smallest next start on top, the tags then the groups in order on ties
+    bool StreamAfter(const ItemStream& a, const ItemStream& b)
+    {
+        size_t startA = _streamItems[a.Next].Start;
+        size_t startB = _streamItems[b.Next].Start;
+        return startA > startB || (startA == startB && a.Index > b.Index);
     }
 
-    // Check N-terminal modifications
-    if (term.NTerminalDescriptors().size() > 0)
+    // Closes the stream started at begin, sorting it only when the term was built out of order
+    void AddStream(size_t begin)
     {
-        text << CreateDescriptorsText(term.NTerminalDescriptors());
+        size_t end = _streamItems.size();
+        if (begin == end)
+            return;
+
+        auto first = _streamItems.begin() + begin;
+        auto last = _streamItems.begin() + end;
+        if (!std::is_sorted(first, last, StartsBefore))
+            std::sort(first, last, PlacedBefore);
+
+        _streams.push_back(ItemStream{ begin, end, _streams.size() });
     }
 
+    // Orders the tags and the group members by start index. The tags and the members of each group are
+    // streams already sorted by the parser and ProFormaTermBuilder, they are merged k-way through a heap
+    // of stream cursors, so a term costs O(n log k) for k groups. Tags win ties so a shared bracket lists
+    // them first.
+    const std::vector<PlacedItem>& PlaceItems(const ProFormaTerm& term)
+    {
+        std::vector<PlacedItem>& items = _placedItems;
+        std::vector<PlacedItem>& streamItems = _streamItems;
+        std::vector<ItemStream>& streams = _streams;
+        items.clear();
+        streamItems.clear();
+        streams.clear();
+
+        for (auto& tag : term.Tags())
+            streamItems.push_back(TagItem(tag, streamItems.size()));
+        AddStream(0);
+
+        for (auto& item : term.TagGroups())
+        {
+            const ProFormaTagGroup* group = item.second;
+            size_t begin = streamItems.size();
+            for (auto& member : group->Members())
+                streamItems.push_back(MemberItem(group, member, &member == &group->Members().front(), streamItems.size()));
+            AddStream(begin);
+        }
+
+        // A single stream is already in place
+        if (streams.size() == 1)
+            return streamItems;
 
-    std::vector<std::tuple<void*, size_t, size_t, bool, double>> tagsAndGroups;
+        std::make_heap(streams.begin(), streams.end(), StreamAfter);
+        while (!streams.empty())
+        {
+            std::pop_heap(streams.begin(), streams.end(), StreamAfter);
+            ItemStream& stream = streams.back();
+            items.push_back(streamItems[stream.Next++]);
 
-    if (term.Tags().size()) {
-        for (auto tag : term.Tags()) {
-            tagsAndGroups.push_back(std::make_tuple(&tag, tag.ZeroBasedStartIndex(), tag.ZeroBasedEndIndex(), true, 0.0));
+            if (stream.Next == stream.End)
+                streams.pop_back();
+            else
+                std::push_heap(streams.begin(), streams.end(), StreamAfter);
         }
+
+        return items;
     }
 
-    if (term.TagGroups().size()) {
-        for (auto item : term.TagGroups()) {
-            ProFormaTagGroup* tagGroup = item.second;
-            for (auto member : tagGroup->Members()) {
-                auto it = std::find(tagGroup->Members().begin(), tagGroup->Members().end(), member);
-                bool isFirst = (it == tagGroup->Members().begin());
-                tagsAndGroups.push_back(std::make_tuple(&tagGroup, member.ZeroBasedStartIndex(), member.ZeroBasedEndIndex(), isFirst, member.Weight()));
+    template <typename Sink>
+    void WriteDescriptor(Sink& sink, const IProFormaDescriptor& descriptor)
+    {
+        switch (descriptor.Key())
+        {
+        case ProFormaKey::Formula:  AppendText(sink, "Formula:"); break;
+        case ProFormaKey::Glycan:   AppendText(sink, "Glycan:"); break;
+        case ProFormaKey::Info:     AppendText(sink, "Info:"); break;
+        case ProFormaKey::Name:
+        case ProFormaKey::Mass:
+            switch (descriptor.EvidenceType())
+            {
+            case ProFormaEvidenceType::None:        break; // We assume the name is enough
+            case ProFormaEvidenceType::Observed:    AppendText(sink, "Obs:"); break;
+            case ProFormaEvidenceType::Unimod:      AppendText(sink, "U:"); break;
+            case ProFormaEvidenceType::Resid:       AppendText(sink, "R:"); break;
+            case ProFormaEvidenceType::PsiMod:      AppendText(sink, "M:"); break;
+            case ProFormaEvidenceType::XlMod:       AppendText(sink, "X:"); break;
+            case ProFormaEvidenceType::Gno:         AppendText(sink, "G:"); break;
+            case ProFormaEvidenceType::Brno:        AppendText(sink, "B:"); break;
+            default:
+                throw new std::runtime_error("Can't handle " + std::to_string(static_cast<int>(descriptor.Key())) + " with evidence type: " + std::to_string(static_cast<int>(descriptor.EvidenceType())));
             }
+            break;
+        case ProFormaKey::Identifier:
+            // The parser keeps the prefix of every identifier but RESID ones
+            if (descriptor.EvidenceType() == ProFormaEvidenceType::Resid)
+                AppendText(sink, "RESID:");
+            break;
+        default: // use descriptor value only
+            break;
         }
+
+        sink.Append(descriptor.Value());
     }
 
-    // Check indexed modifications
-    if (tagsAndGroups.size())
+    template <typename Sink>
+    void WriteDescriptors(Sink& sink, const std::list<ProFormaDescriptor>& descriptors)
     {
-        // Sort by start index
-        std::sort(tagsAndGroups.begin(), tagsAndGroups.end(), &ProFormaWriter::sortBySec);
-       
-        size_t currentIndex = 0;
-        for(const std::tuple<void*, size_t, size_t, bool, double>& item : tagsAndGroups)
+        bool first = true;
+        for (auto& descriptor : descriptors)
         {
-            void* obj;
-            size_t startIndex, endIndex;
-            bool displayValue;
-            double weight;
+            if (!first)
+                sink.Append('|');
+            WriteDescriptor(sink, descriptor);
+            first = false;
+        }
+    }
+
+    template <typename Sink>
+    void WriteItem(Sink& sink, const PlacedItem& item)
+    {
+        if (item.Tag)
+        {
+            WriteDescriptors(sink, item.Tag->Descriptors());
+            return;
+        }
+
+        if (item.DisplayValue && item.Group->Value().length())
+            WriteDescriptor(sink, *item.Group);
+
+        sink.Append('#');
+        sink.Append(item.Group->Name());
+
+        if (item.Member->Weight() > 0.0)
+        {
+            // Same digits as the stream default (6 significant), without the locale lookups of printf
+            char weight[40];
+            weight[0] = '(';
+            char* end = std::to_chars(weight + 1, weight + sizeof(weight) - 1, item.Member->Weight(), std::chars_format::general, 6).ptr;
+            *end++ = ')';
+            sink.Append(weight, static_cast<size_t>(end - weight));
+        }
+    }
 
-            std::tie(obj, startIndex, endIndex, displayValue, weight) = item;
-            if (startIndex == endIndex)
+    template <typename Sink>
+    void WriteTerm(Sink& sink, const ProFormaTerm& term, const std::vector<PlacedItem>& items)
+    {
+        // Global modifications
+        for (auto& globalMod : term.GlobalModifications())
+        {
+            sink.Append('<');
+            if (globalMod.TargetAminoAcids().size())
             {
-                // Write sequence up to tag
-                text << term.Sequence().substr(currentIndex, startIndex - currentIndex + 1);
-                currentIndex = startIndex + 1;
+                sink.Append('[');
+                WriteDescriptors(sink, globalMod.Descriptors());
+                sink.Append(']');
+                sink.Append('@');
+
+                bool first = true;
+                for (char targetAminoAcid : globalMod.TargetAminoAcids())
+                {
+                    if (!first)
+                        sink.Append(',');
+                    sink.Append(targetAminoAcid);
+                    first = false;
+                }
             }
-            else // Handle ambiguity range
-            {
-                // Write sequence up to range
-                text << term.Sequence().substr(currentIndex, startIndex - currentIndex);
+            else
+                WriteDescriptors(sink, globalMod.Descriptors());
+            sink.Append('>');
+        }
 
-                // Write sequence in range
-                text << term.Sequence().substr(startIndex, endIndex - startIndex + 1);
-                currentIndex = endIndex + 1;
+        // Labile modifications
+        if (term.LabileDescriptors().size())
+        {
+            sink.Append('{');
+            WriteDescriptors(sink, term.LabileDescriptors());
+            sink.Append('}');
+        }
+
+        // Unlocalized modifications, only write out a single question mark
+        if (term.UnlocalizedTags().size())
+        {
+            for (auto& tag : term.UnlocalizedTags())
+            {
+                sink.Append('[');
+                WriteDescriptors(sink, tag.Descriptors());
+                sink.Append(']');
+
+                if (tag.Count() != 1)
+                {
+                    char count[16];
+                    count[0] = '^';
+                    char* end = std::to_chars(count + 1, count + sizeof(count), tag.Count()).ptr;
+                    sink.Append(count, static_cast<size_t>(end - count));
+                }
             }
+            sink.Append('?');
+        }
+
+        // N-terminal modifications
+        if (term.NTerminalDescriptors().size())
+        {
+            sink.Append('[');
+            WriteDescriptors(sink, term.NTerminalDescriptors());
+            sink.Append(']');
+            sink.Append('-');
+        }
+
+        // Indexed modifications, sequence runs are copied straight from the term
+        const std::string& sequence = term.Sequence();
+        size_t currentIndex = 0;
 
-            if (typeid(obj) == typeid(ProFormaTag))
+        for (size_t i = 0; i < items.size(); )
+        {
+            const PlacedItem& item = items[i];
+
+            if (item.Start >= currentIndex)
             {
-                ProFormaTag* tag = static_cast<ProFormaTag*>(obj);
-                text << CreateDescriptorsText(tag->Descriptors());
+                if (item.Start == item.End)
+                {
+                    // Write sequence up to and including the tagged residue
+                    sink.Append(sequence, currentIndex, item.Start - currentIndex + 1);
+                }
+                else // Handle ambiguity range
+                {
+                    sink.Append(sequence, currentIndex, item.Start - currentIndex);
+                    sink.Append('(');
+                    sink.Append(sequence, item.Start, item.End - item.Start + 1);
+                    sink.Append(')');
+                }
+                currentIndex = item.End + 1;
             }
-            else if (typeid(obj) == typeid(ProFormaTagGroup))
+
+            // Items on the same residues share one tag
+            sink.Append('[');
+            WriteItem(sink, item);
+            for (i++; i < items.size() && items[i].Start == item.Start && items[i].End == item.End; i++)
             {
-                ProFormaTagGroup* tagGroup = static_cast<ProFormaTagGroup*>(obj);
-                if (displayValue)
-                    text << CreateDescriptorText(*tagGroup) << "#" << tagGroup->Name();
-                else
-                    text << "[#" << tagGroup->Name();
-
-                if (weight > 0.0)
-                    text << "(" << weight << ")]";
-                else
-                    text << ']';
+                sink.Append('|');
+                WriteItem(sink, items[i]);
             }
+            sink.Append(']');
         }
 
         // Write the rest of the sequence
-        text << term.Sequence().substr(currentIndex);
+        if (currentIndex < sequence.length())
+            sink.Append(sequence, currentIndex, sequence.length() - currentIndex);
+
+        // C-terminal modifications
+        if (term.CTerminalDescriptors().size())
+        {
+            sink.Append('-');
+            sink.Append('[');
+            WriteDescriptors(sink, term.CTerminalDescriptors());
+            sink.Append(']');
+        }
     }
-    else
+}
+
+/*****************************************************************************/
+// JSON OUTPUT
+/*****************************************************************************/
+
+namespace {
+    // Members of an object that are written, lists are left out only when empty in compact mode
+    template <typename List>
+    size_t ListMember(const List& list, bool compact)
     {
-        text << term.Sequence();
+        return list.empty() && compact ? 0 : 1;
     }
-    // Check C-terminal modifications
-    if (term.CTerminalDescriptors().size() > 0)
+
+    // Writes the key of a list member, an empty list is null or, in compact mode, left out.
+    // Returns true when the list itself has to follow.
+    template <typename Emitter, size_t N, typename List>
+    bool WriteListKey(Emitter& json, const char (&key)[N], const List& list, bool compact)
     {
-        text << CreateDescriptorsText(term.CTerminalDescriptors());
+        if (list.empty() && compact)
+            return false;
+
+        json.Key(key);
+        if (list.empty())
+        {
+            json.Null();
+            return false;
+        }
+
+        return true;
     }
 
-    return text.str();         
-}
+    // Global modification descriptors have always been written with their keys sorted (the DOM writer
+    // built them as nlohmann::json), the other descriptors in declaration order
+    template <typename Emitter, size_t N>
+    void WriteDescriptorsJson(Emitter& json, const char (&key)[N], const std::list<ProFormaDescriptor>& descriptors, bool compact, bool sortedKeys = false)
+    {
+        if (!WriteListKey(json, key, descriptors, compact))
+            return;
 
-std::string ProFormaWriter::TermToJson(ProFormaTerm& term)
-{
-    nlohmann::ordered_json json_term;
-
-    // Test examples here:  https://github.com/HUPO-PSI/ProForma
-
-    ProFormaLogger::GetLogger()->Log("TERM has %d unlocalized tags", term.UnlocalizedTags().size());
-
-    // Add sequence
-    json_term["Sequence"] = term.Sequence();
-
-    // Add global modifications:  i.e.  <13C>ATPEILTVNSIGQLK
-    // with targetAminoacids:  <[MOD:01090]@C>[Phospho]?EM[Oxidation]EVTSECSPEK 
-    json json_globalModifications = nullptr;
-    for (auto modification : term.GlobalModifications()) {
-        if (json_globalModifications == nullptr) json_globalModifications = json::array();
-        // append modification to the array
-        nlohmann::ordered_json json_modification;
-        nlohmann::ordered_json json_modification_descriptors = nullptr;
-        for (auto descriptor : modification.Descriptors()) {
-            if (json_modification_descriptors == nullptr) json_modification_descriptors = json::array();
-            nlohmann::ordered_json json_modification_descriptor;
-            json_modification_descriptor["Key"] = descriptor.Key();
-            json_modification_descriptor["EvidenceType"] = descriptor.EvidenceType();
-            json_modification_descriptor["Value"] = descriptor.Value();
-            json_modification_descriptors.push_back(json_modification_descriptor);
-        }
-        json_modification["Descriptors"] = json_modification_descriptors;
-        // Target aminoacids
-        json json_targetAminoAcids = nullptr;
-        for (auto aminoacid : modification.TargetAminoAcids()) {
-            if (json_targetAminoAcids == nullptr) json_targetAminoAcids = json::array();
-            json_targetAminoAcids.push_back(aminoacid);
+        json.BeginArray(descriptors.size());
+        for (auto& descriptor : descriptors)
+        {
+            json.BeginObject(3);
+            if (sortedKeys)
+            {
+                json.Key("EvidenceType");
+                json.Integer(static_cast<int>(descriptor.EvidenceType()));
+                json.Key("Key");
+                json.Integer(static_cast<int>(descriptor.Key()));
+            }
+            else
+            {
+                json.Key("Key");
+                json.Integer(static_cast<int>(descriptor.Key()));
+                json.Key("EvidenceType");
+                json.Integer(static_cast<int>(descriptor.EvidenceType()));
+            }
+            json.Key("Value");
+            json.String(descriptor.Value());
+            json.EndObject();
         }
-        json_modification["TargetAminoacids"] = json_targetAminoAcids;
-        json_globalModifications.push_back(json_modification);
+        json.EndArray();
     }
 
-    json_term["GlobalModifications"] = json_globalModifications;
-
-    // Add NTerminalDescriptors
-    nlohmann::ordered_json json_nterminal_descriptors = nullptr;
-    for (auto descriptor : term.NTerminalDescriptors()) {
-        if (json_nterminal_descriptors == nullptr) json_nterminal_descriptors = json::array();
-        nlohmann::ordered_json json_descriptor;
-        json_descriptor["Key"] = descriptor.Key();
-        json_descriptor["EvidenceType"] = descriptor.EvidenceType();
-        json_descriptor["Value"] = descriptor.Value();
-        json_nterminal_descriptors.push_back(json_descriptor);
-    }
-    json_term["NTerminalDescriptors"] = json_nterminal_descriptors;
-
-    // Add CTerminalDescriptors
-    nlohmann::ordered_json json_cterminal_descriptors = nullptr;
-    for (auto descriptor : term.CTerminalDescriptors()) {
-        if (json_cterminal_descriptors == nullptr) json_cterminal_descriptors = json::array();
-        nlohmann::ordered_json json_descriptor;
-        json_descriptor["Key"] = descriptor.Key();
-        json_descriptor["EvidenceType"] = descriptor.EvidenceType();
-        json_descriptor["Value"] = descriptor.Value();
-        json_cterminal_descriptors.push_back(json_descriptor);
-    }
-    json_term["CTerminalDescriptors"] = json_cterminal_descriptors;
-
-    // Add LabileDescriptors
-    nlohmann::ordered_json json_labile_descriptors = nullptr;
-    for (auto descriptor : term.LabileDescriptors()) {
-        if (json_labile_descriptors == nullptr) json_labile_descriptors = json::array();
-        nlohmann::ordered_json json_descriptor;
-        json_descriptor["Key"] = descriptor.Key();
-        json_descriptor["EvidenceType"] = descriptor.EvidenceType();
-        json_descriptor["Value"] = descriptor.Value();
-        json_labile_descriptors.push_back(json_descriptor);
-    }
-    json_term["LabileDescriptors"] = json_labile_descriptors;
-
-
-    // Add Tags
-    nlohmann::ordered_json json_tags = nullptr;
-
-    for (auto tag : term.Tags()) {
-        if (json_tags == nullptr) json_tags = json::array();
-        // append tag to the array
-        nlohmann::ordered_json json_tag;
-        json_tag["ZeroBasedStartIndex"] = tag.ZeroBasedStartIndex();
-        json_tag["ZeroBasedEndIndex"] = tag.ZeroBasedEndIndex();
-        nlohmann::ordered_json json_tag_descriptors = nullptr;
-        for (auto descriptor : tag.Descriptors()) {
-            if (json_tag_descriptors == nullptr) json_tag_descriptors = json::array();
-            nlohmann::ordered_json json_tag_descriptor;
-            json_tag_descriptor["Key"] = descriptor.Key();
-            json_tag_descriptor["EvidenceType"] = descriptor.EvidenceType();
-            json_tag_descriptor["Value"] = descriptor.Value();
-            json_tag_descriptors.push_back(json_tag_descriptor);
+    // The TermToJson layout, written through ProFormaJsonEmitter or one of the binary emitters
+    template <typename Emitter>
+    void WriteDocument(Emitter& json, const ProFormaTerm& term, bool compact)
+    {
+        // Test examples here:  https://github.com/HUPO-PSI/ProForma
+        json.BeginObject(1 + ListMember(term.GlobalModifications(), compact) + ListMember(term.NTerminalDescriptors(), compact)
+            + ListMember(term.CTerminalDescriptors(), compact) + ListMember(term.LabileDescriptors(), compact) + ListMember(term.Tags(), compact)
+            + ListMember(term.UnlocalizedTags(), compact) + ListMember(term.TagGroups(), compact));
+
+        // Add sequence
+        json.Key("Sequence");
+        json.String(term.Sequence());
+
+        // Add global modifications:  i.e.  <13C>ATPEILTVNSIGQLK
+        // with targetAminoacids:  <[MOD:01090]@C>[Phospho]?EM[Oxidation]EVTSECSPEK 
+        if (WriteListKey(json, "GlobalModifications", term.GlobalModifications(), compact))
+        {
+            json.BeginArray(term.GlobalModifications().size());
+            for (auto& modification : term.GlobalModifications())
+            {
+                json.BeginObject(ListMember(modification.Descriptors(), compact) + ListMember(modification.TargetAminoAcids(), compact));
+                WriteDescriptorsJson(json, "Descriptors", modification.Descriptors(), compact, true);
+
+                // Target aminoacids, written as character codes
+                if (WriteListKey(json, "TargetAminoacids", modification.TargetAminoAcids(), compact))
+                {
+                    json.BeginArray(modification.TargetAminoAcids().size());
+                    for (char aminoacid : modification.TargetAminoAcids())
+                        json.Integer(aminoacid);
+                    json.EndArray();
+                }
+                json.EndObject();
+            }
+            json.EndArray();
         }
-        json_tag["Descriptors"] = json_tag_descriptors;
-        json_tags.push_back(json_tag);
-    }
-    json_term["Tags"] = json_tags;
-
-    // Add unlocalized tags. i.e   <[MOD:01090]@C>[Phospho]?EM[Oxidation]EVTSECSPEK
-    /*
-    * "UnlocalizedTags":[{"Count":1,"Descriptors":[{"Key":1,"EvidenceType":0,"Value":"Phospho"}]}]
-    */
-    nlohmann::ordered_json json_unlocalized_tags = nullptr;
-    for (auto tag : term.UnlocalizedTags()) {
-        if (json_unlocalized_tags == nullptr) json_unlocalized_tags = json::array();
-        // append tag to the array
-        nlohmann::ordered_json json_tag;
-        json_tag["Count"] = tag.Count();
-        nlohmann::ordered_json json_tag_descriptors = nullptr;
-        for (auto descriptor : tag.Descriptors()) {
-            if (json_tag_descriptors == nullptr) json_tag_descriptors = json::array();
-            nlohmann::ordered_json json_tag_descriptor;
-            json_tag_descriptor["Key"] = descriptor.Key();
-            json_tag_descriptor["EvidenceType"] = descriptor.EvidenceType();
-            json_tag_descriptor["Value"] = descriptor.Value();
-            json_tag_descriptors.push_back(json_tag_descriptor);
+
+        WriteDescriptorsJson(json, "NTerminalDescriptors", term.NTerminalDescriptors(), compact);
+        WriteDescriptorsJson(json, "CTerminalDescriptors", term.CTerminalDescriptors(), compact);
+        WriteDescriptorsJson(json, "LabileDescriptors", term.LabileDescriptors(), compact);
+
+        // Add Tags
+        if (WriteListKey(json, "Tags", term.Tags(), compact))
+        {
+            json.BeginArray(term.Tags().size());
+            for (auto& tag : term.Tags())
+            {
+                json.BeginObject(2 + ListMember(tag.Descriptors(), compact));
+                json.Key("ZeroBasedStartIndex");
+                json.Unsigned(tag.ZeroBasedStartIndex());
+                json.Key("ZeroBasedEndIndex");
+                json.Unsigned(tag.ZeroBasedEndIndex());
+                WriteDescriptorsJson(json, "Descriptors", tag.Descriptors(), compact);
+                json.EndObject();
+            }
+            json.EndArray();
         }
-        json_tag["Descriptors"] = json_tag_descriptors;
-        json_unlocalized_tags.push_back(json_tag);
-    }
-    json_term["UnlocalizedTags"] = json_unlocalized_tags;
-
-    nlohmann::ordered_json json_tagGroups = nullptr;
-
-    // Add TagGroups
-    for (auto item : term.TagGroups()) {
-        if (json_tagGroups == nullptr) json_tagGroups = json::array();
-        // append group to the array
-        nlohmann::ordered_json json_group;
-        auto group = item.second;
-        if (group->IsChanging()) {
-            ProFormaTagGroupChangingValue* g = static_cast<ProFormaTagGroupChangingValue*>(group);
-            json_group["ValueFlux"] = g->ValueFlux();
-            json_group["KeyFlux"] = g->KeyFlux();
-            json_group["EvidenceFlux"] = g->EvidenceFlux();
+
+        // Add unlocalized tags. i.e   <[MOD:01090]@C>[Phospho]?EM[Oxidation]EVTSECSPEK
+        /*
+        * "UnlocalizedTags":[{"Count":1,"Descriptors":[{"Key":1,"EvidenceType":0,"Value":"Phospho"}]}]
+        */
+        if (WriteListKey(json, "UnlocalizedTags", term.UnlocalizedTags(), compact))
+        {
+            json.BeginArray(term.UnlocalizedTags().size());
+            for (auto& tag : term.UnlocalizedTags())
+            {
+                json.BeginObject(1 + ListMember(tag.Descriptors(), compact));
+                json.Key("Count");
+                json.Integer(tag.Count());
+                WriteDescriptorsJson(json, "Descriptors", tag.Descriptors(), compact);
+                json.EndObject();
+            }
+            json.EndArray();
+        }
+
+        // Add TagGroups
+        if (WriteListKey(json, "TagGroups", term.TagGroups(), compact))
+        {
+            json.BeginArray(term.TagGroups().size());
+            for (auto& item : term.TagGroups())
+            {
+                const ProFormaTagGroup* group = item.second;
+                json.BeginObject((group->IsChanging() ? 3 : 0) + 4 + ListMember(group->Members(), compact));
+                if (group->IsChanging())
+                {
+                    auto changing = static_cast<const ProFormaTagGroupChangingValue*>(group);
+                    json.Key("ValueFlux");
+                    json.String(changing->ValueFlux());
+                    json.Key("KeyFlux");
+                    json.Integer(static_cast<int>(changing->KeyFlux()));
+                    json.Key("EvidenceFlux");
+                    json.Integer(static_cast<int>(changing->EvidenceFlux()));
+                }
+                json.Key("Name");
+                json.String(group->Name());
+                json.Key("Key");
+                json.Integer(static_cast<int>(group->Key()));
+                json.Key("EvidenceType");
+                json.Integer(static_cast<int>(group->EvidenceType()));
+                json.Key("Value");
+                json.String(group->Value());
+
+                if (WriteListKey(json, "Members", group->Members(), compact))
+                {
+                    json.BeginArray(group->Members().size());
+                    for (auto& member : group->Members())
+                    {
+                        json.BeginObject(3);
+                        json.Key("ZeroBasedStartIndex");
+                        json.Unsigned(member.ZeroBasedStartIndex());
+                        json.Key("ZeroBasedEndIndex");
+                        json.Unsigned(member.ZeroBasedEndIndex());
+                        json.Key("Weight");
+                        json.Double(member.Weight());
+                        json.EndObject();
+                    }
+                    json.EndArray();
+                }
+                json.EndObject();
+            }
+            json.EndArray();
         }
-        json_group["Name"] = group->Name();
-        json_group["Key"] = group->Key();
-        json_group["EvidenceType"] = group->EvidenceType();
-        json_group["Value"] = group->Value();
-        nlohmann::ordered_json json_group_members = nullptr;
-        for (auto member : group->Members()) {
-            if (json_group_members == nullptr) json_group_members = json::array();
-            nlohmann::ordered_json json_member;
-            json_member["ZeroBasedStartIndex"] = member.ZeroBasedStartIndex();
-            json_member["ZeroBasedEndIndex"] = member.ZeroBasedEndIndex();
-            json_member["Weight"] = member.Weight();
-            json_group_members.push_back(json_member);
+
+        json.EndObject();
+    }
+
+    // Terms serialized by one worker before the chunk is handed over, and the size of the serial writes
+    const size_t JsonLinesChunk = 256;
+    const size_t JsonLinesFlush = 1 << 20;
+
+    // Chunks a worker may run ahead of the sink, per worker thread
+    const size_t JsonLinesWindow = 4;
+
+    // Times a writer entry point into ProFormaLatency, the clock is only read when recording is enabled,
+    // fires the write probes with the bytes appended to the output and attributes the allocations
+    template <typename Output>
+    class WriteScope {
+    public:
+        WriteScope(ProFormaOperation operation, const ProFormaTerm& term, const Output& out)
+            : _operation(operation), _term(term), _out(out), _start(out.size()), _enabled(ProFormaLatency::Enabled()),
+              _allocations(ProFormaAllocationCategory::WriterBuffer)
+        {
+            if constexpr (ProFormaAllocationStats::Enabled)
+                ProFormaAllocationStats::AddWrite();
+            PROFORMA_PROBE2(write__start, static_cast<int>(_operation), _term.Sequence().length());
+            if (_enabled)
+                _startTime = std::chrono::steady_clock::now();
         }
-        json_group["Members"] = json_group_members;
 
-        json_tagGroups.push_back(json_group);
+        ~WriteScope()
+        {
+            if (_enabled)
+                ProFormaLatency::Record(_operation, _term.Sequence().length(),
+                    static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _startTime).count()));
+            PROFORMA_PROBE3(write__done, static_cast<int>(_operation), _term.Sequence().length(), _out.size() - _start);
+        }
 
+    private:
+        ProFormaOperation _operation;
+        const ProFormaTerm& _term;
+        const Output& _out;
+        size_t _start;
+        bool _enabled;
+        std::chrono::steady_clock::time_point _startTime;
+        ProFormaAllocationScope _allocations;
+    };
+
+    void AppendJsonLines(std::string& out, const ProFormaTerm* terms, size_t count, ProFormaJsonFormat format)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            ProFormaWriter::AppendJsonTo(out, terms[i], format);
+            out.push_back('\n');
+        }
     }
-    json_term["TagGroups"] = json_tagGroups;
-    
-    return json_term.dump();
 }
 
 /*****************************************************************************/
-// PRIVATE
+// PUBLIC
 /*****************************************************************************/
+ 
+std::string ProFormaWriter::TermToString(const ProFormaTerm& term)
+{
+    std::string text;
+    AppendTo(text, term);
+    return text;
+}
 
-std::string ProFormaWriter::CreateDescriptorsText(const std::list<ProFormaDescriptor>& descriptors)
+void ProFormaWriter::AppendTo(std::string& out, const ProFormaTerm& term)
 {
-    std::stringstream text;
-    int i = 0;
+    WriteScope scope(ProFormaOperation::WriteString, term, out);
+    const std::vector<PlacedItem>& items = PlaceItems(term);
 
-    for (auto descriptor : descriptors)
-    {
-        IProFormaDescriptor* id = static_cast<IProFormaDescriptor*>(&descriptor);
-        text << CreateDescriptorText(*id);
-        if (i < descriptors.size() - 1)
-            text << '|';
-        i++;
-    }
+    LengthSink length;
+    WriteTerm(length, term, items);
+
+    // Keep the geometric growth of buffers collecting many terms
+    size_t required = out.length() + length.Length;
+    if (required > out.capacity())
+        out.reserve(std::max(required, 2 * out.capacity()));
+
+    StringSink text{ out };
+    WriteTerm(text, term, items);
+}
+
+std::string ProFormaWriter::TermToJson(const ProFormaTerm& term, ProFormaJsonFormat format)
+{
+    std::string text;
+    AppendJsonTo(text, term, format);
+    return text;
+}
+
+void ProFormaWriter::AppendJsonTo(std::string& out, const ProFormaTerm& term, ProFormaJsonFormat format)
+{
+    WriteScope scope(ProFormaOperation::WriteJson, term, out);
+    ProFormaJsonEmitter json(out);
+    WriteDocument(json, term, format == ProFormaJsonFormat::Compact);
+}
 
-    return text.str();
+std::vector<uint8_t> ProFormaWriter::TermToCbor(const ProFormaTerm& term, ProFormaJsonFormat format)
+{
+    std::vector<uint8_t> bytes;
+    AppendCborTo(bytes, term, format);
+    return bytes;
 }
 
-std::string ProFormaWriter::CreateDescriptorText(IProFormaDescriptor& descriptor)
+void ProFormaWriter::AppendCborTo(std::vector<uint8_t>& out, const ProFormaTerm& term, ProFormaJsonFormat format)
 {
-    std::string text = descriptor.Value();
+    WriteScope scope(ProFormaOperation::WriteCbor, term, out);
+    ProFormaCborEmitter cbor(out);
+    WriteDocument(cbor, term, format == ProFormaJsonFormat::Compact);
+}
 
-    switch (descriptor.Key())
+std::vector<uint8_t> ProFormaWriter::TermToMsgPack(const ProFormaTerm& term, ProFormaJsonFormat format)
+{
+    std::vector<uint8_t> bytes;
+    AppendMsgPackTo(bytes, term, format);
+    return bytes;
+}
+
+void ProFormaWriter::AppendMsgPackTo(std::vector<uint8_t>& out, const ProFormaTerm& term, ProFormaJsonFormat format)
+{
+    WriteScope scope(ProFormaOperation::WriteMsgPack, term, out);
+    ProFormaMsgPackEmitter msgpack(out);
+    WriteDocument(msgpack, term, format == ProFormaJsonFormat::Compact);
+}
+
+size_t ProFormaWriter::WriteJsonLines(const ProFormaTerm* terms, size_t count, std::ostream& sink, unsigned threads, ProFormaJsonFormat format)
+{
+    size_t chunkCount = (count + JsonLinesChunk - 1) / JsonLinesChunk;
+    size_t written = 0;
+
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    if (threads > chunkCount)
+        threads = static_cast<unsigned>(chunkCount);
+
+    if (threads <= 1)
     {
-    case ProFormaKey::Formula:
-        text = "Formula:" + descriptor.Value();
-        break;
-    case ProFormaKey::Glycan:
-        text = "Glycan:" + descriptor.Value();
-        break;
-    case ProFormaKey::Info:
-        text = "Info:" + descriptor.Value();
-        break;
-    case ProFormaKey::Name:
-    case ProFormaKey::Mass:
-        switch (descriptor.EvidenceType()) 
+        std::string buffer;
+        for (size_t i = 0; i < count; i += JsonLinesChunk)
         {
-        case ProFormaEvidenceType::None:        text = descriptor.Value(); break;// We assume the name is enough
-        case ProFormaEvidenceType::Observed:    text = "Obs:" + descriptor.Value(); break;
-        case ProFormaEvidenceType::Unimod:      text = "U:" + descriptor.Value(); break;
-        case ProFormaEvidenceType::Resid:       text = "R:" + descriptor.Value(); break;
-        case ProFormaEvidenceType::PsiMod:      text = "M:" + descriptor.Value(); break;
-        case ProFormaEvidenceType::XlMod:       text = "X:" + descriptor.Value(); break;
-        case ProFormaEvidenceType::Gno:         text = "G:" + descriptor.Value(); break;
-        default: 
-            throw new std::exception(std::string("Can't handle " + std::to_string(static_cast<int>(descriptor.Key())) + " with evidence type: " + std::to_string(static_cast<int>(descriptor.EvidenceType()))).c_str()); 
-            break;
+            AppendJsonLines(buffer, terms + i, std::min(JsonLinesChunk, count - i), format);
+            if (buffer.length() >= JsonLinesFlush || i + JsonLinesChunk >= count)
+            {
+                sink.write(buffer.data(), buffer.length());
+                written += buffer.length();
+                buffer.clear();
+            }
         }
-        break;
-    case ProFormaKey::Identifier:
-        text = "Formula:" + descriptor.Value();
-        break;
-    default: // use descriptor value initialized
-            break;
+        return written;
     }
 
-    return text;
+    // Chunk n goes to slot n % window, a worker only takes a chunk once the sink is done with its slot
+    size_t window = JsonLinesWindow * threads;
+    std::vector<std::string> slots(window);
+    std::vector<char> ready(window, 0);
+    size_t nextChunk = 0, writtenChunks = 0;
+    bool stop = false;
+    std::exception_ptr error;
+    std::mutex mutex;
+    std::condition_variable produced, consumed;
+
+    auto worker = [&]()
+    {
+        for (;;)
+        {
+            size_t chunk;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                consumed.wait(lock, [&]() { return stop || nextChunk >= chunkCount || nextChunk < writtenChunks + window; });
+                if (stop || nextChunk >= chunkCount)
+                    return;
+                chunk = nextChunk++;
+            }
+
+            std::string& text = slots[chunk % window];
+            text.clear();
+
+            try
+            {
+                size_t first = chunk * JsonLinesChunk;
+                AppendJsonLines(text, terms + first, std::min(JsonLinesChunk, count - first), format);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                error = std::current_exception();
+                stop = true;
+                produced.notify_all();
+                consumed.notify_all();
+                return;
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            ready[chunk % window] = 1;
+            produced.notify_all();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < threads; i++)
+        workers.emplace_back(worker);
+
+    try
+    {
+        for (size_t chunk = 0; chunk < chunkCount; chunk++)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                produced.wait(lock, [&]() { return stop || ready[chunk % window]; });
+                if (stop)
+                    break;
+            }
+
+            const std::string& text = slots[chunk % window];
+            sink.write(text.data(), text.length());
+            written += text.length();
+
+            std::lock_guard<std::mutex> lock(mutex);
+            ready[chunk % window] = 0;
+            writtenChunks++;
+            stop = stop || !sink;
+            consumed.notify_all();
+        }
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!error)
+            error = std::current_exception();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+        consumed.notify_all();
+    }
+
+    for (auto& thread : workers)
+        thread.join();
+
+    if (error)
+        std::rethrow_exception(error);
+
+    return written;
 }
 
-bool ProFormaWriter::sortBySec(const std::tuple<void*, size_t, size_t, bool, double>& a,    const std::tuple<void*, size_t, size_t, bool, double>& b)
+/*****************************************************************************/
+// PRIVATE
+/*****************************************************************************/
+
+std::string& ProFormaWriter::ThreadBuffer()
 {
-    return (std::get<1>(a) < std::get<1>(b));
+    static thread_local std::string buffer;
+    return buffer;
 }
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <ostream>
 #include <string>
 #include <list>
-#include <tuple>
+#include <vector>
 
 #include "PlatformHelper.h"
 
@@ -10,6 +13,17 @@
 
 
 namespace ProForma {
+    /** @enum ProFormaJsonFormat
+     *  @brief Layout of the JSON written by ProFormaWriter
+     */
+    enum class ProFormaJsonFormat {
+        /**< Every member is written, empty lists as null. */
+        Standard = 0,
+
+        /**< Members that would be null are left out. */
+        Compact = 1,
+    };
+
 	/**
 	 * \class ProFormaWriter
 	 *
@@ -26,16 +40,104 @@ namespace ProForma {
 		  * \param  term The input term.
 		  * \return string value
 		  */
-        static std::string TermToString(ProFormaTerm& term);
+        static std::string TermToString(const ProFormaTerm& term);
+
+        /** \brief  Appends the string representation of the ProFormaTerm object to a caller buffer.
+		  *         The exact length is computed first and reserved once, nothing else is allocated
+		  *         once the buffer and the per-thread scratch space have grown to the largest term.
+		  * \param  out The buffer to append to.
+		  * \param  term The input term.
+		  * \return void
+		  */
+        static void AppendTo(std::string& out, const ProFormaTerm& term);
+
+        /** \brief  Writes the string representation of the ProFormaTerm object through an output iterator
+		  * \param  out The output iterator, e.g. std::ostreambuf_iterator or std::back_inserter.
+		  * \param  term The input term.
+		  * \return the iterator past the last character written
+		  */
+        template <typename OutputIterator>
+        static OutputIterator WriteTo(OutputIterator out, const ProFormaTerm& term)
+        {
+            std::string& buffer = ThreadBuffer();
+            buffer.clear();
+            AppendTo(buffer, term);
+            return std::copy(buffer.begin(), buffer.end(), out);
+        }
 
         /** \brief  Returns the JSON representation of the ProFormaTerm object
 		  * \param  term The input term.
+		  * \param  format Standard writes every member, Compact leaves out the empty (null) ones.
 		  * \return string value
 		  */
-        static std::string TermToJson(ProFormaTerm& term);
+        static std::string TermToJson(const ProFormaTerm& term, ProFormaJsonFormat format = ProFormaJsonFormat::Standard);
+
+        /** \brief  Appends the JSON representation of the ProFormaTerm object to a caller buffer. The text is
+		  *         streamed directly, a reused buffer makes the whole export free of per-term allocations.
+		  * \param  out The buffer to append to.
+		  * \param  term The input term.
+		  * \param  format Standard writes every member, Compact leaves out the empty (null) ones.
+		  * \return void
+		  */
+        static void AppendJsonTo(std::string& out, const ProFormaTerm& term, ProFormaJsonFormat format = ProFormaJsonFormat::Standard);
+
+        /** \brief  Returns the CBOR encoding of the ProFormaTerm object, same members as TermToJson
+		  * \param  term The input term.
+		  * \param  format Standard writes every member, Compact leaves out the empty (null) ones.
+		  * \return the bytes
+		  */
+        static std::vector<uint8_t> TermToCbor(const ProFormaTerm& term, ProFormaJsonFormat format = ProFormaJsonFormat::Standard);
+
+        /** \brief  Appends the CBOR encoding of the ProFormaTerm object to a caller buffer. It is written
+		  *         straight from the term, the same bytes as nlohmann::json::to_cbor() of the JSON document.
+		  * \param  out The buffer to append to.
+		  * \param  term The input term.
+		  * \param  format Standard writes every member, Compact leaves out the empty (null) ones.
+		  * \return void
+		  */
+        static void AppendCborTo(std::vector<uint8_t>& out, const ProFormaTerm& term, ProFormaJsonFormat format = ProFormaJsonFormat::Standard);
+
+        /** \brief  Returns the MessagePack encoding of the ProFormaTerm object, same members as TermToJson
+		  * \param  term The input term.
+		  * \param  format Standard writes every member, Compact leaves out the empty (null) ones.
+		  * \return the bytes
+		  */
+        static std::vector<uint8_t> TermToMsgPack(const ProFormaTerm& term, ProFormaJsonFormat format = ProFormaJsonFormat::Standard);
+
+        /** \brief  Appends the MessagePack encoding of the ProFormaTerm object to a caller buffer. It is written
+		  *         straight from the term, the same bytes as nlohmann::json::to_msgpack() of the JSON document.
+		  * \param  out The buffer to append to.
+		  * \param  term The input term.
+		  * \param  format Standard writes every member, Compact leaves out the empty (null) ones.
+		  * \return void
+		  */
+        static void AppendMsgPackTo(std::vector<uint8_t>& out, const ProFormaTerm& term, ProFormaJsonFormat format = ProFormaJsonFormat::Standard);
+
+        /** \brief  Writes the terms as JSON Lines, one JSON object and a newline per term. Chunks of terms are
+		  *         serialized on worker threads into their own buffers and written to the sink in input
+		  *         order, one write per chunk. The output is the same for any number of threads.
+		  * \param  terms The first term.
+		  * \param  count The number of terms.
+		  * \param  sink The output stream.
+		  * \param  threads Number of worker threads, 0 uses one per hardware thread.
+		  * \param  format Standard writes every member, Compact leaves out the empty (null) ones.
+		  * \return the number of bytes written
+		  */
+        static size_t WriteJsonLines(const ProFormaTerm* terms, size_t count, std::ostream& sink, unsigned threads = 0, ProFormaJsonFormat format = ProFormaJsonFormat::Standard);
+
+        /** \brief  Writes the terms as JSON Lines, see the pointer overload
+		  * \param  terms The terms.
+		  * \param  sink The output stream.
+		  * \param  threads Number of worker threads, 0 uses one per hardware thread.
+		  * \param  format Standard writes every member, Compact leaves out the empty (null) ones.
+		  * \return the number of bytes written
+		  */
+        static size_t WriteJsonLines(const std::vector<ProFormaTerm>& terms, std::ostream& sink, unsigned threads = 0, ProFormaJsonFormat format = ProFormaJsonFormat::Standard)
+        {
+            return WriteJsonLines(terms.data(), terms.size(), sink, threads, format);
+        }
     private:
-		static std::string CreateDescriptorsText(const std::list<ProFormaDescriptor>& descriptors);
-		static std::string CreateDescriptorText(IProFormaDescriptor& descriptor);
-		static bool sortBySec(const std::tuple<void*, size_t, size_t, bool, double>& a, const std::tuple<void*, size_t, size_t, bool, double>& b);
+		/** \brief  Per-thread buffer behind WriteTo, reused from term to term */
+		static std::string& ThreadBuffer();
 	};
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <ostream>
+#include <utility>
 
 #include "IProFormaDescriptor.h"
 
@@ -19,7 +20,7 @@ namespace ProForma {
 		  * \return void
 		  */
         ProFormaDescriptor(std::string value)
-            : ProFormaDescriptor(ProFormaKey::Name, ProFormaEvidenceType::None, value) { }
+            : ProFormaDescriptor(ProFormaKey::Name, ProFormaEvidenceType::None, std::move(value)) { }
 
         /** \brief  Initializes a descriptor with key and value
           * \param  key Key to be assigned to the descriptor
@@ -27,7 +28,7 @@ namespace ProForma {
 		  * \return void
 		  */
         ProFormaDescriptor(ProFormaKey key, std::string value)
-            : ProFormaDescriptor(key, ProFormaEvidenceType::None, value) { }
+            : ProFormaDescriptor(key, ProFormaEvidenceType::None, std::move(value)) { }
 
         /** \brief  Initializes a descriptor with all parameters
           * \param  key Key to be assigned to the descriptor
@@ -36,20 +37,18 @@ namespace ProForma {
 		  * \return void
 		  */
         ProFormaDescriptor(ProFormaKey key, ProFormaEvidenceType evidenceType, std::string value)
+            : _key(key), _evidenceType(evidenceType), _value(std::move(value))
         {
-            this->_key = key;
-            this->_evidenceType = evidenceType;
-            this->_value = value;
         }
 
         /** \brief  Key getter */
-        ProFormaKey Key() { return _key; }
+        ProFormaKey Key() const { return _key; }
 
         /** \brief The type of the evidence getter */
-        ProFormaEvidenceType EvidenceType() { return _evidenceType; }
+        ProFormaEvidenceType EvidenceType() const { return _evidenceType; }
 
         /** \brief The value getter. */
-        std::string Value() { return _value; }
+        const std::string& Value() const { return _value; }
 
         /** \brief Returns the string representation for descriptor object */
         std::string ToString() const
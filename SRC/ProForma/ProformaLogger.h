@@ -1,17 +1,27 @@
 #pragma once
 
 
+#include <atomic>
+#include <condition_variable>
+#include <ctime>
+#include <cstdarg>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <iostream>
-#include <cstdarg>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
 
 #include "PlatformHelper.h"
 
 using namespace std;
 
 
-#define LOGGER CLogger::GetLogger()
+#define LOGGER ProForma::ProFormaLogger::GetLogger()
 
 namespace ProForma {
     /**
@@ -19,6 +29,13 @@ namespace ProForma {
      *
      * \brief  Singleton Logger Class.
      *
+     *         Log() does not format: it stores the format pointer, the time and the arguments in a fixed size
+     *         record of a ring owned by the calling thread, strings are copied into the record. A background
+     *         thread formats the records of every ring and writes them to the output, the date and time
+     *         prefix is rebuilt once per second. When the ring of a thread is full the record is dropped
+     *         and counted, the logging threads never wait. Format strings must be literals, or at least
+     *         outlive the logger.
+     *
      */
 
     class EXPORT ProFormaLogger {
@@ -28,48 +45,196 @@ namespace ProForma {
         */
         void Log(const std::string& sMessage);
 
-        /** \brief Variable Length Logger function
+        /** \brief Variable Length Logger function, printf conversions with at most MaxArguments arguments
         *   \param format string for the message to be logged.
+        *   \param args integers, floating point numbers, characters, strings and pointers.
         */
-        void Log(const char* format, ...);
+        template <typename... Args>
+        void Log(const char* format, const Args&... args)
+        {
+#ifndef RELEASE
+            static_assert(sizeof...(Args) <= MaxArguments, "Too many arguments for ProFormaLogger::Log");
+
+            Ring* ring = ThreadRing();
+            uint64_t head = ring->Head.load(std::memory_order_relaxed);
+            if (head - ring->Tail.load(std::memory_order_acquire) >= ring->Records.size())
+            {
+                ring->Dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            Record& record = ring->Records[head & (ring->Records.size() - 1)];
+            record.Format = format;
+            record.Time = time(nullptr);
+            record.Count = 0;
+            record.TextLength = 0;
+            (Store(record, args), ...);
+
+            ring->Head.store(head + 1, std::memory_order_release);
+#endif
+        }
 
         /** \brief  << overloaded function to Logs a message
         *   \param sMessage message to be logged.
         */
         ProFormaLogger& operator<<(const string& sMessage);
 
+        /** \brief Writes the following messages to a file instead of the standard output
+        *   \param fileName path of the log file, messages are appended.
+        *   \return false if the file could not be opened, the output is unchanged then.
+        */
+        bool Open(const std::string& fileName = _sFileName);
+
+        /** \brief Waits until every message logged before the call is written and flushed. */
+        void Flush();
+
+        /** \brief Number of records of the rings created afterwards, rounded up to a power of two.
+        *   \param records records per thread, each one takes RecordSize bytes.
+        */
+        void SetRingCapacity(size_t records);
+
+        /** \brief Messages dropped because the ring of their thread was full. */
+        uint64_t Dropped() const;
+
         /**\brief Funtion to create the instance of logger class.
         *  \return singleton object of Clogger class..
         */
         static ProFormaLogger* GetLogger();
+
+        /** \brief Most arguments a message can have. */
+        static const size_t MaxArguments = 8;
+
+        /** \brief Size of a record, strings longer than the space left in it are truncated. */
+        static const size_t RecordSize = 256;
+
+        /**
+        *   Stops the background thread once everything logged is written.
+        */
+        ~ProFormaLogger();
     private:
+        enum class ArgumentType : uint8_t { Signed, Unsigned, Floating, Pointer, Text };
+
+        struct Argument {
+            ArgumentType Type;
+            union {
+                long long Signed;
+                unsigned long long Unsigned;
+                double Floating;
+                const void* Pointer;
+                struct { uint16_t Offset, Length; } Text;
+            };
+        };
+
+        static const size_t HeaderSize = sizeof(const char*) + sizeof(time_t) + 2 * sizeof(uint16_t) + MaxArguments * sizeof(Argument);
+
+        struct Record {
+            const char* Format;
+            time_t Time;
+            Argument Arguments[MaxArguments];
+            uint16_t Count;
+            uint16_t TextLength;
+            char Text[RecordSize - HeaderSize];
+        };
+        static_assert(sizeof(Record) == RecordSize, "ProFormaLogger records are not packed");
+
+        // Single producer (the owning thread), single consumer (the background thread)
+        struct Ring {
+            explicit Ring(size_t capacity) : Records(capacity) {}
+
+            alignas(64) std::atomic<uint64_t> Head{ 0 };
+            alignas(64) std::atomic<uint64_t> Tail{ 0 };
+            std::atomic<uint64_t> Dropped{ 0 };
+            std::vector<Record> Records;
+
+            // Set when the owning thread ends, shared with its thread_local slot which may be destroyed after the logger
+            std::shared_ptr<std::atomic<bool>> Retired = std::make_shared<std::atomic<bool>>(false);
+        };
+
         /**
-        *    Default constructor for the Logger class.
+        *   Default constructor for the Logger class.
         */
         ProFormaLogger();
         /**
         *   copy constructor for the Logger class.
         */
-        ProFormaLogger(const ProFormaLogger&) {};             // copy constructor is private
+        ProFormaLogger(const ProFormaLogger&) = delete;
         /**
         *   assignment operator for the Logger class.
         */
-        ProFormaLogger& operator=(const ProFormaLogger&) { return *this; };  // assignment operator is private
+        ProFormaLogger& operator=(const ProFormaLogger&) = delete;
 
-        /* date & time helper */ 
-        static const std::string CurrentDateTime();
+        template <typename T>
+        static void Store(Record& record, const T& value)
+        {
+            Argument& argument = record.Arguments[record.Count++];
+            if constexpr (std::is_same_v<T, std::string>)
+                StoreText(record, argument, value.data(), value.length());
+            else if constexpr (std::is_convertible_v<const T&, const char*>)
+            {
+                const char* text = value;
+                StoreText(record, argument, text, text != nullptr ? strlen(text) : 0);
+            }
+            else if constexpr (std::is_floating_point_v<T>)
+            {
+                argument.Type = ArgumentType::Floating;
+                argument.Floating = static_cast<double>(value);
+            }
+            else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+            {
+                argument.Type = ArgumentType::Signed;
+                argument.Signed = static_cast<long long>(value);
+            }
+            else if constexpr (std::is_integral_v<T> || std::is_enum_v<T>)
+            {
+                argument.Type = ArgumentType::Unsigned;
+                argument.Unsigned = static_cast<unsigned long long>(value);
+            }
+            else
+            {
+                static_assert(std::is_pointer_v<T>, "Unsupported ProFormaLogger::Log argument");
+                argument.Type = ArgumentType::Pointer;
+                argument.Pointer = static_cast<const void*>(value);
+            }
+        }
+
+        static void StoreText(Record& record, Argument& argument, const char* text, size_t length);
+
+        Ring* ThreadRing();
+        Ring* CreateRing();
+        void Run();
+        size_t Drain(std::string& buffer);
+        void Format(std::string& buffer, const Record& record);
+        void Write(std::string& buffer, bool flush);
 
         /**
         *   Log file name.
         **/
         static const std::string _sFileName;
         /**
-        *   Singleton logger class object pointer.
-        **/
-        static ProFormaLogger* _pThis;
-        /**
         *   Log file stream object.
         **/
-        static ofstream _Logfile;
+        ofstream _Logfile;
+        std::ostream* _output;
+        std::mutex _outputMutex;
+
+        mutable std::mutex _ringsMutex;
+        std::vector<std::unique_ptr<Ring>> _rings;
+        size_t _ringCapacity;
+        std::atomic<uint64_t> _retiredDropped{ 0 };
+
+        // Background thread, woken by Flush() and the destructor, polls otherwise
+        std::mutex _mutex;
+        std::condition_variable _wake;
+        std::condition_variable _done;
+        uint64_t _flushRequests = 0;
+        uint64_t _flushesDone = 0;
+        bool _stop = false;
+        std::thread _thread;
+
+        // Written by the background thread only
+        std::vector<Ring*> _draining;
+        time_t _stampTime = -1;
+        char _stamp[32];
+        uint64_t _droppedReported = 0;
     };
 }
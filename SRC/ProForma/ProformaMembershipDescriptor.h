@@ -50,13 +50,13 @@ namespace ProForma {
         }
 
         /** \brief  Gets the zero-based start index in the sequence. */
-        size_t ZeroBasedStartIndex() { return _zeroBasedStartIndex; } 
+        size_t ZeroBasedStartIndex() const { return _zeroBasedStartIndex; } 
 
         /** \brief  Gets the zero-based end index in the sequence. */
-        size_t ZeroBasedEndIndex() { return _zeroBasedEndIndex; } 
+        size_t ZeroBasedEndIndex() const { return _zeroBasedEndIndex; } 
 
         /** \brief  The weight this member has on the group. */
-        double Weight() { return _weight; }
+        double Weight() const { return _weight; }
     private:
         size_t _zeroBasedStartIndex;
         size_t _zeroBasedEndIndex;
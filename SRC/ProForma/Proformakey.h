@@ -2,7 +2,7 @@
 
 namespace ProForma {
     /** @enum ProFormaKey
-     *  @brief Possible keys for a descriptor
+     *  @brief Possible keys for a descriptor. New keys go last, ProFormaKeyCount is derived from the last one
      */
     enum class ProFormaKey {
         /**<  No key provided. */
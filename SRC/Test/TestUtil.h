@@ -0,0 +1,77 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "ProFormaParser.h"
+#include "ProFormaTermBuilder.h"
+
+// Failed checks of the test program, main returns non zero when there are any
+inline int failures = 0;
+
+// Compares an output with the expected text, reports the outcome and counts the failures
+inline void check(const std::string& test, const std::string& expected, const std::string& output)
+{
+  if (output == expected)
+  {
+    std::cout << test << " PASSED" << std::endl;
+  }
+  else
+  {
+    std::cerr << test << " FAILED: Expected " << expected << " but got " << output << std::endl;
+    failures++;
+  }
+}
+
+// One string per feature of the grammar, the corpus of the format round trip tests
+inline const std::vector<std::string> CommonInputs = {
+  "PEPTIDE",
+  "EM[Oxidation]EVEES[Phospho]PEK",
+  "[Acetyl]-PEPTIDE-[Amidated]",
+  "<[Carbamidomethyl]@C,M>ATPEILTCNSIGCLK",
+  "{Glycan:Hex}EMEVNESPEK",
+  "[Phospho]?EM[Oxidation]EVTSECSPEK",
+  "EM[U:Oxidation]EVT[#g1(0.01)]S[#g1(0.09)]ES[Phospho#g1(0.90)]PEK",
+  "PRT(ESFRMS)[+19.0523]ISK",
+  "EM[MOD:00719]EVEES[UNIMOD:21]PEK",
+  "S[Phospho|#g1]EKT[#g1]",
+  "ELV[Formula:C12H20O2]IS[Info:test]K",
+};
+
+// The common inputs followed by the cases of one format
+inline std::vector<std::string> WithCommonInputs(std::initializer_list<std::string> cases)
+{
+  std::vector<std::string> inputs = CommonInputs;
+  inputs.insert(inputs.end(), cases);
+  return inputs;
+}
+
+// Term the parser cannot produce: tags and group members out of order, a group with a fixed value,
+// a descriptor holding a nul byte, an isotope and an unlocalized tag with a count
+inline ProForma::ProFormaTerm BuildEdgeCaseTerm()
+{
+  using namespace ProForma;
+
+  ProFormaTermBuilder builder;
+  builder.SetSequence("ACDEFGHIK");
+  builder.AddTag(6, { ProFormaDescriptor(ProFormaKey::Mass, "+79.966") });
+  builder.AddTag(1, { ProFormaDescriptor(ProFormaKey::Info, std::string("binary\0value", 12)) });
+  builder.AddTagGroup("fixed", ProFormaKey::Name, ProFormaEvidenceType::Unimod, "Phospho");
+  builder.AddGroupMember("fixed", ProFormaMembershipDescriptor(5, 8, 1.0 / 3.0));
+  builder.AddGroupMember("fixed", ProFormaMembershipDescriptor(0, 0, 0.5));
+  builder.AddGlobalModification({ ProFormaDescriptor("13C") }, {});
+  builder.AddUnlocalizedTag(3, { ProFormaDescriptor(ProFormaKey::Mass, "-17.0265") });
+  return std::move(builder).Build();
+}
+
+// The inputs parsed, then the edge case term
+inline std::vector<ProForma::ProFormaTerm> ParseWithEdgeCase(const std::vector<std::string>& inputs)
+{
+  ProForma::ProFormaQuietParser parser;
+  std::vector<ProForma::ProFormaTerm> terms;
+  for (auto& input : inputs)
+    terms.push_back(parser.ParseString(input));
+  terms.push_back(BuildEdgeCaseTerm());
+  return terms;
+}
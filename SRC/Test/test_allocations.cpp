@@ -0,0 +1,176 @@
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "ProFormaAllocationStats.h"
+#include "ProFormaParseException.h"
+#include "ProFormaParser.h"
+#include "ProFormaWriter.h"
+#include "TestUtil.h"
+
+using namespace ProForma;
+
+#if !PROFORMA_ALLOCATION_TRACKING
+static std::atomic<uint64_t> _heapAllocations(0);
+
+// The library counts nothing in the default build, the test counts every heap allocation of the process
+// instead, as perf_gate does, so the bounds below are checked in both builds
+void* operator new(size_t size)
+{
+  _heapAllocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+#endif
+
+static void checkAtMost(const std::string& test, uint64_t bound, uint64_t output)
+{
+  check(test, "at most " + std::to_string(bound), output <= bound ? "at most " + std::to_string(bound) : std::to_string(output));
+}
+
+// Allocations of a call, by category when the library counts them. Total holds the parser categories, or
+// WriterBuffer for the writer, with the tracking and every allocation of the process without it
+struct Counted {
+  ProFormaAllocationSnapshot Stats;
+  uint64_t Total;
+};
+
+template <typename Call>
+static Counted count(bool writer, Call call)
+{
+  ProFormaAllocationStats::Reset();
+#if !PROFORMA_ALLOCATION_TRACKING
+  uint64_t before = _heapAllocations.load(std::memory_order_relaxed);
+#endif
+  call();
+
+  Counted counted{ ProFormaAllocationStats::Snapshot(), 0 };
+#if PROFORMA_ALLOCATION_TRACKING
+  counted.Total = writer ? counted.Stats[ProFormaAllocationCategory::WriterBuffer] : counted.Stats.ParserAllocations();
+#else
+  (void)writer;
+  counted.Total = _heapAllocations.load(std::memory_order_relaxed) - before;
+#endif
+  return counted;
+}
+
+// Allocations of one parse of the string, the bounds below are the counts at the time of writing
+static Counted parseOnce(const std::string& proFormaString)
+{
+  ProFormaQuietParser parser;
+  return count(false, [&]() { parser.ParseString(proFormaString); });
+}
+
+void test_allocationsPlain()
+{
+  Counted counted = parseOnce("PEPTIDE");
+  checkAtMost("test_allocationsPlain(total)", 1, counted.Total);
+  if (ProFormaAllocationStats::Enabled)
+  {
+    check("test_allocationsPlain(terms)", "1", std::to_string(counted.Stats.Terms));
+    check("test_allocationsPlain(tags)", "0", std::to_string(counted.Stats[ProFormaAllocationCategory::Tag]));
+  }
+
+  // Past the small string buffer the sequence grows geometrically
+  counted = parseOnce(std::string(200, 'A'));
+  checkAtMost("test_allocationsPlain(sequence total)", 7, counted.Total);
+  if (ProFormaAllocationStats::Enabled)
+    checkAtMost("test_allocationsPlain(sequence)", 6, counted.Stats[ProFormaAllocationCategory::Sequence]);
+}
+
+void test_allocationsTagged()
+{
+  Counted counted = parseOnce("EM[Oxidation]EVEES[UNIMOD:21]PEK");
+
+  checkAtMost("test_allocationsTagged(total)", 8, counted.Total);
+  if (ProFormaAllocationStats::Enabled)
+  {
+    checkAtMost("test_allocationsTagged(tag)", 5, counted.Stats[ProFormaAllocationCategory::Tag]);
+    checkAtMost("test_allocationsTagged(descriptor)", 3, counted.Stats[ProFormaAllocationCategory::Descriptor]);
+    check("test_allocationsTagged(group)", "0", std::to_string(counted.Stats[ProFormaAllocationCategory::Group]));
+  }
+}
+
+void test_allocationsGrouped()
+{
+  Counted counted = parseOnce("[Acetyl]-EM[Oxidation]EVT[#g1(0.01)]S[#g1(0.09)]ES[Phospho#g1(0.90)]PEK-[Amidated]");
+
+  checkAtMost("test_allocationsGrouped(total)", 25, counted.Total);
+  if (ProFormaAllocationStats::Enabled)
+    checkAtMost("test_allocationsGrouped(group)", 6, counted.Stats[ProFormaAllocationCategory::Group]);
+}
+
+void test_allocationsWriter()
+{
+  ProFormaTerm term = ProFormaQuietParser().ParseString("EM[Oxidation]EVEES[UNIMOD:21]PEK");
+
+  std::string json, text;
+  Counted counted = count(true, [&]()
+  {
+    ProFormaWriter::AppendJsonTo(json, term);
+    text = ProFormaWriter::TermToString(term);
+  });
+
+  checkAtMost("test_allocationsWriter(buffer)", 10, counted.Total);
+  if (ProFormaAllocationStats::Enabled)
+  {
+    check("test_allocationsWriter(writes)", "2", std::to_string(counted.Stats.Writes));
+    check("test_allocationsWriter(parser)", "0", std::to_string(counted.Stats.ParserAllocations()));
+  }
+}
+
+void test_allocationsReport()
+{
+  ProFormaQuietParser parser;
+  ProFormaAllocationStats::Reset();
+
+  // Allocations outside the parser and the writer are not counted
+  std::string outside(100, 'A');
+  check("test_allocationsReport(outside)", "0", std::to_string(ProFormaAllocationStats::Snapshot().ParserAllocations()));
+
+  // Every thread is counted
+  std::thread([&parser] { parser.ParseString("PEPT[Phospho]IDE"); }).join();
+  parser.ParseString("PEPT[Phospho]IDE");
+
+  ProFormaAllocationSnapshot stats = ProFormaAllocationStats::Snapshot();
+  check("test_allocationsReport(terms)", "2", std::to_string(stats.Terms));
+  check("test_allocationsReport(descriptors)", "2", std::to_string(stats[ProFormaAllocationCategory::Descriptor]));
+
+  std::ostringstream report;
+  ProFormaAllocationStats::Report(report, stats);
+  std::cout << report.str();
+  check("test_allocationsReport(descriptor line)", "1", std::to_string(report.str().find("descriptor") != std::string::npos));
+}
+
+int main()
+{
+  try
+  {
+    // The first parse of a thread allocates its counter blocks
+    ProFormaQuietParser().ParseString("A");
+
+    test_allocationsPlain();
+    test_allocationsTagged();
+    test_allocationsGrouped();
+    test_allocationsWriter();
+    if (ProFormaAllocationStats::Enabled)
+      test_allocationsReport();
+    else
+      check("test_allocationsDisabled", "0", std::to_string(ProFormaAllocationStats::Snapshot().ParserAllocations()));
+  }
+  catch (ProFormaParseException* e)
+  {
+    std::cerr << "FAILED with parsing exception: " << e->what() << std::endl;
+    failures++;
+  }
+
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,140 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ProFormaBinaryReader.h"
+#include "ProFormaBinaryWriter.h"
+#include "ProFormaParseException.h"
+#include "ProFormaParser.h"
+#include "ProFormaWriter.h"
+#include "TestUtil.h"
+
+using namespace ProForma;
+
+void test_binaryRoundTrip()
+{
+  std::vector<ProFormaTerm> terms = ParseWithEdgeCase(CommonInputs);
+
+  std::stringstream stream;
+  ProFormaBinaryWriter writer(stream);
+  for (auto& term : terms)
+    writer.Write(term);
+
+  ProFormaBinaryReader reader(stream);
+  ProFormaTerm term("");
+  size_t index = 0;
+
+  while (reader.Read(term))
+  {
+    std::string name = index < CommonInputs.size() ? CommonInputs[index] : "built";
+    check("test_binaryRoundTrip(" + name + ")", ProFormaWriter::TermToJson(terms[index]), ProFormaWriter::TermToJson(term));
+    index++;
+  }
+
+  check("test_binaryRoundTrip(count)", std::to_string(terms.size()), std::to_string(index));
+}
+
+void test_binaryStringTable()
+{
+  ProFormaQuietParser parser;
+  std::stringstream once, twice;
+
+  ProFormaBinaryWriter first(once);
+  first.Write(parser.ParseString("EM[Oxidation]EVEES[Phospho]PEK"));
+
+  ProFormaBinaryWriter second(twice);
+  second.Write(parser.ParseString("EM[Oxidation]EVEES[Phospho]PEK"));
+  size_t firstRecord = twice.str().length();
+  second.Write(parser.ParseString("EM[Oxidation]EVEES[Phospho]PEK"));
+
+  // The second record refers to the strings of the first one instead of repeating them
+  size_t firstLength = once.str().length() - 6;
+  size_t secondLength = twice.str().length() - firstRecord;
+  check("test_binaryStringTable", "true", secondLength + std::string("OxidationPhospho").length() < firstLength ? "true" : "false");
+}
+
+static std::string ReadError(const std::string& bytes)
+{
+  try
+  {
+    std::istringstream stream(bytes);
+    ProFormaBinaryReader reader(stream);
+    ProFormaTerm term("");
+    while (reader.Read(term))
+      ;
+    return "no error";
+  }
+  catch (ProFormaParseException* e)
+  {
+    std::string message = e->what();
+    delete e;
+    return message;
+  }
+}
+
+void test_binaryInvalid()
+{
+  std::stringstream stream;
+  ProFormaBinaryWriter writer(stream);
+  writer.Write(ProFormaQuietParser().ParseString("EM[Oxidation]EVEES[Phospho]PEK"));
+  std::string bytes = stream.str();
+
+  check("test_binaryInvalid(magic)", "Not a ProForma binary stream.", ReadError("JSON" + bytes.substr(4)));
+
+  std::string newer = bytes;
+  newer[4] = 2;
+  check("test_binaryInvalid(version)", "Unsupported ProForma binary format version 2, this reader supports up to 1.", ReadError(newer));
+
+  check("test_binaryInvalid(truncated)", "Binary stream is truncated.", ReadError(bytes.substr(0, bytes.length() - 1)));
+  check("test_binaryInvalid(empty stream)", "no error", ReadError(bytes.substr(0, 6)));
+}
+
+// One record: string table "Oxidation", "g1", sequence PEP, then the tags and groups given
+static std::string CorruptRecord(const std::string& header, const std::string& tags, const std::string& groups)
+{
+  std::string record = std::string("\x02\x09", 2) + "Oxidation" + std::string("\x02", 1) + "g1" + std::string("\x03", 1) + "PEP";
+  record += std::string(4, '\0');          // global, N-terminal, C-terminal and labile modifications
+  record += tags;
+  record += std::string(1, '\0');          // unlocalized tags
+  record += groups;
+
+  return header + static_cast<char>(record.length()) + record;
+}
+
+void test_binaryCorrupt()
+{
+  std::stringstream stream;
+  ProFormaBinaryWriter writer(stream);
+  std::string header = stream.str().substr(0, 6);
+
+  // A length prefix of 2^62 bytes followed by a few, fails without allocating the announced length
+  check("test_binaryCorrupt(length)", "Binary stream is truncated.", ReadError(header + std::string("\x80\x80\x80\x80\x80\x80\x80\x80\x40", 9) + "PEPTIDE"));
+
+  // A well formed record first, then the tag and member positions are broken one by one
+  check("test_binaryCorrupt(valid)", "no error", ReadError(CorruptRecord(header, std::string("\x01\x02\x02\x01\x01\x00", 6), std::string("\x00", 1))));
+  check("test_binaryCorrupt(tag past sequence)", "Binary record has a tag at 3-3, outside the 3 residues of the sequence.",
+    ReadError(CorruptRecord(header, std::string("\x01\x03\x03\x01\x01\x00", 6), std::string("\x00", 1))));
+  check("test_binaryCorrupt(tag reversed)", "Binary record has a tag at 2-1, outside the 3 residues of the sequence.",
+    ReadError(CorruptRecord(header, std::string("\x01\x02\x01\x01\x01\x00", 6), std::string("\x00", 1))));
+  check("test_binaryCorrupt(member past sequence)", "Binary record has a tag group member at 0-200, outside the 3 residues of the sequence.",
+    ReadError(CorruptRecord(header, std::string("\x00", 1), std::string("\x01\x01\x01\x00\x00\x01\x00\xC8\x01", 9))));
+}
+
+int main()
+{
+  try
+  {
+    test_binaryRoundTrip();
+    test_binaryStringTable();
+    test_binaryInvalid();
+    test_binaryCorrupt();
+  }
+  catch (ProFormaParseException* e)
+  {
+    std::cerr << "FAILED with parsing exception: " << e->what() << std::endl;
+    failures++;
+  }
+
+  return failures == 0 ? 0 : 1;
+}
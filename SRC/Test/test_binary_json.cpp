@@ -0,0 +1,123 @@
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "nlohmann/json.hpp"
+
+#include "ProFormaParseException.h"
+#include "ProFormaParser.h"
+#include "ProFormaTagGroupChangingValue.h"
+#include "ProFormaTermBuilder.h"
+#include "ProFormaWriter.h"
+#include "TestUtil.h"
+
+using namespace ProForma;
+
+static std::string Hex(const std::vector<uint8_t>& bytes)
+{
+  static const char hex[] = "0123456789abcdef";
+  std::string out;
+
+  for (uint8_t b : bytes)
+  {
+    out += hex[b >> 4];
+    out += hex[b & 0xF];
+  }
+
+  return out;
+}
+
+// An unlocalized count and an observed mass add integer and float encodings
+static const std::vector<std::string> Inputs = WithCommonInputs({
+  "[Phospho]^2?EM[Oxidation]EVTSECSPEK",
+  "EMEVTSES[Phospho|Obs:+79.966]PEK",
+});
+
+// Strings of every length class, integers of every width and doubles that do and do not fit a float
+static ProFormaTerm BuildTerm()
+{
+  ProFormaTermBuilder builder;
+  builder.SetSequence(std::string(300, 'A'));
+  builder.AddTag(1, { ProFormaDescriptor(ProFormaKey::Info, "quote\" tab\t nul utf8 \xc3\xa9") });
+  builder.AddTag(2, { ProFormaDescriptor(ProFormaKey::Info, std::string(31, 'x')), ProFormaDescriptor(ProFormaKey::Info, std::string(32, 'y')) });
+  builder.AddTag(255, 256, { ProFormaDescriptor(ProFormaKey::Info, std::string(255, 'z')), ProFormaDescriptor(ProFormaKey::Info, std::string(70000, 'w')) });
+  builder.SetLabileDescriptors({ ProFormaDescriptor("") });
+
+  auto group = static_cast<ProFormaTagGroupChangingValue*>(builder.AddTagGroup(new ProFormaTagGroupChangingValue("g2", ProFormaKey::Mass, ProFormaEvidenceType::Observed, {})));
+  double weights[] = { 0.0, 0.5, 1e-5, 0.25, 123456789012345678.0, 1e20, 0.1 + 0.2, 2.5e-300, 12.0, -3.0 };
+  size_t i = 0;
+  for (double weight : weights)
+  {
+    builder.AddGroupMember("g2", ProFormaMembershipDescriptor(i, i + 100, weight));
+    i++;
+  }
+  group->SetValueFlux("+1.5");
+
+  builder.AddGlobalModification({ ProFormaDescriptor("13C") }, {});
+  builder.AddUnlocalizedTag(-70000, { ProFormaDescriptor(ProFormaKey::Mass, "-17.0265") });
+  builder.AddUnlocalizedTag(24, { ProFormaDescriptor(ProFormaKey::Mass, "+1") });
+
+  return std::move(builder).Build();
+}
+
+// Reference encodings go through the JSON text and nlohmann's DOM
+static void checkTerm(const std::string& name, const ProFormaTerm& term)
+{
+  for (auto format : { ProFormaJsonFormat::Standard, ProFormaJsonFormat::Compact })
+  {
+    std::string suffix = name + (format == ProFormaJsonFormat::Compact ? ", compact)" : ")");
+    auto dom = nlohmann::ordered_json::parse(ProFormaWriter::TermToJson(term, format));
+
+    check("test_cborMatchesDom(" + suffix, Hex(nlohmann::ordered_json::to_cbor(dom)), Hex(ProFormaWriter::TermToCbor(term, format)));
+    check("test_msgpackMatchesDom(" + suffix, Hex(nlohmann::ordered_json::to_msgpack(dom)), Hex(ProFormaWriter::TermToMsgPack(term, format)));
+  }
+}
+
+void test_binaryJsonMatchesDom()
+{
+  ProFormaQuietParser parser;
+
+  for (auto& input : Inputs)
+    checkTerm(input, parser.ParseString(input));
+  checkTerm("built", BuildTerm());
+}
+
+void test_binaryJsonAppendReusesBuffer()
+{
+  ProFormaQuietParser parser;
+  ProFormaTerm first = parser.ParseString(Inputs[1]);
+  ProFormaTerm second = parser.ParseString(Inputs[6]);
+
+  std::vector<uint8_t> buffer = { 0x82 };
+  ProFormaWriter::AppendCborTo(buffer, first);
+  ProFormaWriter::AppendCborTo(buffer, second);
+
+  auto array = nlohmann::ordered_json::from_cbor(buffer);
+  check("test_binaryJsonAppendReusesBuffer(cbor)",
+    "[" + ProFormaWriter::TermToJson(first) + "," + ProFormaWriter::TermToJson(second) + "]", array.dump());
+
+  buffer = { 0x92 };
+  ProFormaWriter::AppendMsgPackTo(buffer, first, ProFormaJsonFormat::Compact);
+  ProFormaWriter::AppendMsgPackTo(buffer, second, ProFormaJsonFormat::Compact);
+
+  array = nlohmann::ordered_json::from_msgpack(buffer);
+  check("test_binaryJsonAppendReusesBuffer(msgpack)",
+    "[" + ProFormaWriter::TermToJson(first, ProFormaJsonFormat::Compact) + "," + ProFormaWriter::TermToJson(second, ProFormaJsonFormat::Compact) + "]", array.dump());
+}
+
+int main()
+{
+  try
+  {
+    test_binaryJsonMatchesDom();
+    test_binaryJsonAppendReusesBuffer();
+  }
+  catch (ProFormaParseException* e)
+  {
+    std::cerr << "FAILED with parsing exception: " << e->what() << std::endl;
+    failures++;
+  }
+
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,164 @@
+#include <iostream>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "ProFormaCanonicalizer.h"
+#include "ProFormaParseException.h"
+#include "ProFormaParser.h"
+#include "ProFormaTermBuilder.h"
+#include "ProFormaWriter.h"
+#include "TestUtil.h"
+
+using namespace ProForma;
+
+static std::string Bool(bool value) { return value ? "true" : "false"; }
+
+// Pairs of spellings of the same proteoform
+static const std::vector<std::pair<std::string, std::string>> Same = {
+  { "EM[Oxidation]EVEES[Phospho]PEK", "EM[Oxidation]EVEES[Phospho]PEK" },
+  { "EVEES[Phospho|+79.966]PEK", "EVEES[+79.9660|Phospho]PEK" },
+  { "EVEES[Phospho|Phospho]PEK", "EVEES[Phospho]PEK" },
+  { "EM[mod:00719]EVEESPEK", "EM[MOD:00719]EVEESPEK" },
+  { "PRT(ESFRMS)[+19.0523]ISK", "PRT(ESFRMS)[+19.05230]ISK" },
+  { "EM[U:Oxidation]EVT[#g1(0.01)]S[#g1(0.09)]ES[Phospho#g1(0.90)]PEK", "EM[U:Oxidation]EVT[#site(0.01)]S[#site(0.09)]ES[Phospho#site(0.90)]PEK" },
+  { "<[Carbamidomethyl]@C,M>ATPEILTCNSIGCLK", "<[Carbamidomethyl]@M,C>ATPEILTCNSIGCLK" },
+  { "[Acetyl]-PEPTIDE-[Amidated]", "[Acetyl]-PEPTIDE-[Amidated]" },
+};
+
+// Pairs that must stay apart
+static const std::vector<std::pair<std::string, std::string>> Different = {
+  { "EM[Oxidation]EVEES[Phospho]PEK", "EMEVEES[Phospho]PEK" },
+  { "EM[Oxidation]EVEES[Phospho]PEK", "EM[Oxidation]EVEEST[Phospho]PEK" },
+  { "EVEES[Phospho]PEK", "EVEES[U:Phospho]PEK" },
+  { "EVEES[+79.966]PEK", "EVEES[+79.967]PEK" },
+  { "[Acetyl]-PEPTIDE", "PEPTIDE-[Acetyl]" },
+};
+
+void test_canonicalEquivalent()
+{
+  ProFormaQuietParser parser;
+  const ProFormaCanonicalizer& canonicalizer = ProFormaCanonicalizer::Default();
+
+  for (auto& item : Same)
+  {
+    ProFormaTerm left = parser.ParseString(item.first);
+    ProFormaTerm right = parser.ParseString(item.second);
+
+    check("test_canonicalEquivalent(" + item.first + ")", "true", Bool(left == right));
+    check("test_canonicalEquivalent(hash " + item.first + ")", "true", Bool(canonicalizer.Hash(left) == canonicalizer.Hash(right)));
+  }
+
+  for (auto& item : Different)
+  {
+    ProFormaTerm left = parser.ParseString(item.first);
+    ProFormaTerm right = parser.ParseString(item.second);
+
+    check("test_canonicalDifferent(" + item.second + ")", "true", Bool(left != right));
+    check("test_canonicalDifferent(hash " + item.second + ")", "true", Bool(canonicalizer.Hash(left) != canonicalizer.Hash(right)));
+  }
+}
+
+void test_canonicalUnlocalizedMerged()
+{
+  ProFormaTermBuilder once, twice;
+  once.SetSequence("PEPTIDE").AddUnlocalizedTag(2, { ProFormaDescriptor("Phospho") });
+  twice.SetSequence("PEPTIDE").AddUnlocalizedTag(1, { ProFormaDescriptor("Phospho") }).AddUnlocalizedTag(1, { ProFormaDescriptor("Phospho") });
+
+  ProFormaTerm left = std::move(once).Build();
+  ProFormaTerm right = std::move(twice).Build();
+  check("test_canonicalUnlocalizedMerged", "true", Bool(left == right));
+  check("test_canonicalUnlocalizedMerged(canonical)", ProFormaWriter::TermToJson(left), ProFormaWriter::TermToJson(ProFormaCanonicalizer::Default().Canonicalize(right)));
+}
+
+// Groups without members have no position to order them by, the map keeps them in name order
+void test_canonicalMemberlessGroups()
+{
+  ProFormaTermBuilder first, swapped;
+  first.SetSequence("PEPTIDE")
+    .AddTagGroup("a", ProFormaKey::Name, ProFormaEvidenceType::None, "Phospho")
+    .AddTagGroup("b", ProFormaKey::Name, ProFormaEvidenceType::None, "Oxidation");
+  swapped.SetSequence("PEPTIDE")
+    .AddTagGroup("a", ProFormaKey::Name, ProFormaEvidenceType::None, "Oxidation")
+    .AddTagGroup("b", ProFormaKey::Name, ProFormaEvidenceType::None, "Phospho");
+
+  ProFormaTerm left = std::move(first).Build();
+  ProFormaTerm right = std::move(swapped).Build();
+  const ProFormaCanonicalizer& canonicalizer = ProFormaCanonicalizer::Default();
+  check("test_canonicalMemberlessGroups", "true", Bool(left == right));
+  check("test_canonicalMemberlessGroups(hash)", "true", Bool(canonicalizer.Hash(left) == canonicalizer.Hash(right)));
+  check("test_canonicalMemberlessGroups(canonical)", ProFormaWriter::TermToJson(canonicalizer.Canonicalize(left)), ProFormaWriter::TermToJson(canonicalizer.Canonicalize(right)));
+  check("test_canonicalMemberlessGroups(g1)", "Oxidation", canonicalizer.Canonicalize(left).TagGroups().at("g1")->Value());
+}
+
+void test_canonicalSynonyms()
+{
+  ProFormaQuietParser parser;
+  ProFormaCanonicalizer canonicalizer;
+  canonicalizer.AddSynonym(ProFormaDescriptor(ProFormaKey::Name, ProFormaEvidenceType::Unimod, "Phospho"),
+    ProFormaDescriptor(ProFormaKey::Identifier, ProFormaEvidenceType::Unimod, "UNIMOD:21"));
+
+  ProFormaTerm name = parser.ParseString("EVEES[U:Phospho]PEK");
+  ProFormaTerm identifier = parser.ParseString("EVEES[unimod:21]PEK");
+
+  check("test_canonicalSynonyms(default)", "false", Bool(ProFormaCanonicalizer::Default().Equivalent(name, identifier)));
+  check("test_canonicalSynonyms", "true", Bool(canonicalizer.Equivalent(name, identifier)));
+  check("test_canonicalSynonyms(hash)", "true", Bool(canonicalizer.Hash(name) == canonicalizer.Hash(identifier)));
+  check("test_canonicalSynonyms(canonical)", "EVEES[UNIMOD:21]PEK", ProFormaWriter::TermToString(canonicalizer.Canonicalize(name)));
+}
+
+void test_canonicalForm()
+{
+  ProFormaQuietParser parser;
+  const ProFormaCanonicalizer& canonicalizer = ProFormaCanonicalizer::Default();
+
+  ProFormaTerm term = parser.ParseString("<[Carbamidomethyl]@M,C>EM[Oxidation]EVT[#site(0.01)]S[+79.9660|Phospho#site(0.09)]ES[#site(0.90)]PCK");
+  ProFormaTerm canonical = canonicalizer.Canonicalize(term);
+
+  // The group value is written on the first member
+
+  check("test_canonicalForm", "<[Carbamidomethyl]@C,M>EM[Oxidation]EVT[Phospho#g1(0.01)]S[+79.966|#g1(0.09)]ES[#g1(0.9)]PCK", ProFormaWriter::TermToString(canonical));
+  check("test_canonicalForm(idempotent)", ProFormaWriter::TermToString(canonical), ProFormaWriter::TermToString(canonicalizer.Canonicalize(canonical)));
+  check("test_canonicalForm(hash)", "true", Bool(canonicalizer.Hash(term) == canonicalizer.Hash(canonical)));
+
+  for (auto& item : Same)
+  {
+    ProFormaTerm input = parser.ParseString(item.first);
+    check("test_canonicalForm(hash " + item.first + ")", "true", Bool(canonicalizer.Hash(input) == canonicalizer.Hash(canonicalizer.Canonicalize(input))));
+  }
+}
+
+void test_canonicalUnorderedSet()
+{
+  ProFormaQuietParser parser;
+  std::unordered_set<ProFormaTerm> terms;
+
+  for (auto& item : Same)
+  {
+    terms.insert(parser.ParseString(item.first));
+    terms.insert(parser.ParseString(item.second));
+  }
+
+  check("test_canonicalUnorderedSet", std::to_string(Same.size()), std::to_string(terms.size()));
+}
+
+int main()
+{
+  try
+  {
+    test_canonicalEquivalent();
+    test_canonicalUnlocalizedMerged();
+    test_canonicalMemberlessGroups();
+    test_canonicalSynonyms();
+    test_canonicalForm();
+    test_canonicalUnorderedSet();
+  }
+  catch (ProFormaParseException* e)
+  {
+    std::cerr << "FAILED with parsing exception: " << e->what() << std::endl;
+    failures++;
+  }
+
+  return failures == 0 ? 0 : 1;
+}
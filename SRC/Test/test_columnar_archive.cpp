@@ -0,0 +1,198 @@
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ProFormaColumnarReader.h"
+#include "ProFormaColumnarWriter.h"
+#include "ProFormaParseException.h"
+#include "ProFormaParser.h"
+#include "ProFormaWriter.h"
+#include "TestUtil.h"
+
+using namespace ProForma;
+
+// Rows repeating earlier ones share their dictionary entries
+static const std::vector<std::string> Inputs = WithCommonInputs({
+  "PEPTIDE",
+  "EM[Oxidation]EVEES[Phospho]PEK",
+});
+
+static std::vector<ProFormaTerm> Terms()
+{
+  return ParseWithEdgeCase(Inputs);
+}
+
+void test_columnarRoundTrip()
+{
+  std::vector<ProFormaTerm> terms = Terms();
+
+  std::stringstream stream;
+  ProFormaColumnarWriter writer(stream, 4);
+  writer.Write(terms);
+  writer.Close();
+
+  ProFormaColumnarReader reader(stream);
+  check("test_columnarRoundTrip(rows)", std::to_string(terms.size()), std::to_string(reader.RowCount()));
+  check("test_columnarRoundTrip(row groups)", "4", std::to_string(reader.RowGroups().size()));
+
+  std::vector<ProFormaTerm> decoded;
+  for (size_t i = 0; i < reader.RowGroups().size(); i++)
+    reader.ReadRowGroup(i, decoded);
+
+  for (size_t i = 0; i < terms.size() && i < decoded.size(); i++)
+  {
+    std::string name = i < Inputs.size() ? Inputs[i] : "built";
+    check("test_columnarRoundTrip(" + name + ")", ProFormaWriter::TermToJson(terms[i]), ProFormaWriter::TermToJson(decoded[i]));
+  }
+}
+
+void test_columnarMassStatistics()
+{
+  std::vector<ProFormaTerm> terms = Terms();
+
+  std::stringstream stream;
+  ProFormaColumnarWriter writer(stream, 4);
+  writer.Write(terms);
+  writer.Close();
+
+  ProFormaColumnarReader reader(stream);
+
+  bool inRange = true;
+  for (auto& rowGroup : reader.RowGroups())
+    for (uint64_t row = rowGroup.FirstRow; row < rowGroup.FirstRow + rowGroup.Rows; row++)
+    {
+      double mass = Columnar::TermMass(terms[static_cast<size_t>(row)]);
+      inRange = inRange && mass >= rowGroup.MinMass && mass <= rowGroup.MaxMass;
+    }
+  check("test_columnarMassStatistics(ranges)", "true", inRange ? "true" : "false");
+
+  // PEPTIDE is 799.36, rows 0 and 11 hold it
+  char mass[32];
+  snprintf(mass, sizeof(mass), "%.2f", Columnar::TermMass(terms[0]));
+  check("test_columnarMassStatistics(PEPTIDE)", "799.36", mass);
+
+  std::string selected;
+  for (size_t index : reader.RowGroupsInMassRange(700.0, 900.0))
+    selected += std::to_string(index);
+  check("test_columnarMassStatistics(select)", "02", selected);
+}
+
+void test_columnarTagQuery()
+{
+  std::stringstream stream;
+  ProFormaColumnarWriter writer(stream, 4);
+  writer.Write(Terms());
+  writer.Close();
+
+  ProFormaColumnarReader reader(stream);
+
+  // All sites carrying Phospho, the group value of row 6 is not a tag. Reading the symbols, the sequences the tags
+  // are checked against and the tag columns only
+  std::string sites;
+  uint64_t expectedBytes = 0;
+  for (size_t i = 0; i < reader.RowGroups().size(); i++)
+  {
+    reader.ReadTags(i, [&sites](uint64_t row, const ProFormaTag& tag)
+    {
+      for (auto& descriptor : tag.Descriptors())
+        if (descriptor.Value() == "Phospho")
+          sites += std::to_string(row) + ":" + std::to_string(tag.ZeroBasedStartIndex()) + " ";
+    });
+
+    auto& rowGroup = reader.RowGroups()[i];
+    expectedBytes += rowGroup.Lengths[static_cast<size_t>(Columnar::Column::Symbols)]
+      + rowGroup.Lengths[static_cast<size_t>(Columnar::Column::Sequences)]
+      + rowGroup.Lengths[static_cast<size_t>(Columnar::Column::TagPositions)]
+      + rowGroup.Lengths[static_cast<size_t>(Columnar::Column::TagSymbols)];
+  }
+
+  check("test_columnarTagQuery(sites)", "1:6 9:0 12:6 ", sites);
+  check("test_columnarTagQuery(bytes read)", std::to_string(expectedBytes), std::to_string(reader.BytesRead()));
+
+  std::string sequences;
+  reader.ReadSequences(3, [&sequences](uint64_t row, const std::string& sequence) { sequences += std::to_string(row) + ":" + sequence + " "; });
+  check("test_columnarTagQuery(sequences)", "12:EMEVEESPEK 13:ACDEFGHIK ", sequences);
+}
+
+static std::string ReadError(const std::string& bytes)
+{
+  try
+  {
+    std::istringstream stream(bytes);
+    ProFormaColumnarReader reader(stream);
+    std::vector<ProFormaTerm> terms;
+    for (size_t i = 0; i < reader.RowGroups().size(); i++)
+      reader.ReadRowGroup(i, terms);
+    return "no error";
+  }
+  catch (ProFormaParseException* e)
+  {
+    std::string message = e->what();
+    delete e;
+    return message;
+  }
+}
+
+void test_columnarInvalid()
+{
+  std::stringstream stream;
+  {
+    ProFormaColumnarWriter writer(stream);
+    writer.Write(ProFormaQuietParser().ParseString("EM[Oxidation]EVEES[Phospho]PEK"));
+  }
+  std::string bytes = stream.str();
+
+  check("test_columnarInvalid(closed by destructor)", "no error", ReadError(bytes));
+  check("test_columnarInvalid(magic)", "Not a ProForma columnar archive.", ReadError("PFMB" + bytes.substr(4)));
+
+  std::string newer = bytes;
+  newer[4] = 2;
+  check("test_columnarInvalid(version)", "Unsupported ProForma columnar format version 2, this reader supports up to 1.", ReadError(newer));
+
+  check("test_columnarInvalid(not closed)", "Columnar archive is truncated.", ReadError(bytes.substr(0, bytes.length() - 1)));
+
+  std::string corrupted = bytes;
+  corrupted[6] = 5;
+  check("test_columnarInvalid(symbols)", "Binary record is truncated.", ReadError(corrupted));
+
+  // The first tag start delta (zigzag 2, residue 1) rewritten to 100, residue 50 of a 10 residue sequence
+  std::istringstream original(bytes);
+  size_t positions = static_cast<size_t>(ProFormaColumnarReader(original).RowGroups()[0].Offsets[static_cast<size_t>(Columnar::Column::TagPositions)]);
+  std::string outside = bytes;
+  outside[positions + 1] = 100;
+  const std::string message = "Columnar archive row 0 has a tag at 50-50, outside the 10 residues of its sequence.";
+  check("test_columnarInvalid(tag position)", message, ReadError(outside));
+
+  std::string tagsError = "no error";
+  try
+  {
+    std::istringstream stream(outside);
+    ProFormaColumnarReader(stream).ReadTags(0, [](uint64_t, const ProFormaTag&) {});
+  }
+  catch (ProFormaParseException* e)
+  {
+    tagsError = e->what();
+    delete e;
+  }
+  check("test_columnarInvalid(tag position, tags only)", message, tagsError);
+}
+
+int main()
+{
+  try
+  {
+    test_columnarRoundTrip();
+    test_columnarMassStatistics();
+    test_columnarTagQuery();
+    test_columnarInvalid();
+  }
+  catch (ProFormaParseException* e)
+  {
+    std::cerr << "FAILED with parsing exception: " << e->what() << std::endl;
+    failures++;
+  }
+
+  return failures == 0 ? 0 : 1;
+}
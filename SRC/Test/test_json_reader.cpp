@@ -0,0 +1,124 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ProFormaJsonReader.h"
+#include "ProFormaParseException.h"
+#include "ProFormaParser.h"
+#include "ProFormaWriter.h"
+#include "TestUtil.h"
+
+using namespace ProForma;
+
+// A quoted descriptor value exercises the string escapes
+static const std::vector<std::string> Inputs = WithCommonInputs({
+  "ELV[Formula:C12H20O2]IS[Info:test \"quoted\"]K",
+});
+
+void test_readWhatWasWritten()
+{
+  ProFormaQuietParser parser;
+
+  for (auto& input : Inputs)
+  {
+    std::string json = ProFormaWriter::TermToJson(parser.ParseString(input));
+    check("test_readWhatWasWritten(" + input + ")", json, ProFormaWriter::TermToJson(ProFormaJsonReader::ReadTerm(json)));
+  }
+
+  std::string built = ProFormaWriter::TermToJson(BuildEdgeCaseTerm());
+  check("test_readWhatWasWritten(built)", built, ProFormaWriter::TermToJson(ProFormaJsonReader::ReadTerm(built)));
+}
+
+void test_readCompact()
+{
+  ProFormaQuietParser parser;
+
+  for (auto& input : Inputs)
+  {
+    auto term = parser.ParseString(input);
+    std::string compact = ProFormaWriter::TermToJson(term, ProFormaJsonFormat::Compact);
+    check("test_readCompact(" + input + ")", ProFormaWriter::TermToJson(term), ProFormaWriter::TermToJson(ProFormaJsonReader::ReadTerm(compact)));
+  }
+}
+
+void test_readJsonLines()
+{
+  ProFormaQuietParser parser;
+  std::string lines;
+  std::string expected;
+
+  for (auto& input : Inputs)
+  {
+    ProFormaWriter::AppendJsonTo(lines, parser.ParseString(input));
+    lines += "\r\n\n";
+    expected += ProFormaWriter::TermToJson(parser.ParseString(input)) + "\n";
+  }
+
+  std::string fromText;
+  size_t count = ProFormaJsonReader::ReadJsonLines(lines, [&fromText](ProFormaTerm&& term) { fromText += ProFormaWriter::TermToJson(term) + "\n"; });
+  check("test_readJsonLines(text)", expected, fromText);
+  check("test_readJsonLines(count)", std::to_string(Inputs.size()), std::to_string(count));
+
+  std::istringstream stream(lines);
+  std::string fromStream;
+  ProFormaJsonReader::ReadJsonLines(stream, [&fromStream](ProFormaTerm&& term) { fromStream += ProFormaWriter::TermToJson(term) + "\n"; });
+  check("test_readJsonLines(stream)", expected, fromStream);
+}
+
+void test_readInvalid()
+{
+  const std::vector<std::string> invalid = {
+    "{\"Sequence\":\"PEPTIDE\"",
+    "{\"Sequence\":\"PEPTIDE\",\"Unknown\":null}",
+    "{\"Sequence\":\"PEPTIDE\",\"Tags\":[{\"ZeroBasedStartIndex\":-1,\"ZeroBasedEndIndex\":1,\"Descriptors\":null}]}",
+    "{\"Sequence\":\"PEPTIDE\",\"Tags\":[{\"ZeroBasedStartIndex\":1,\"ZeroBasedEndIndex\":1,\"Descriptors\":[{\"Key\":9,\"EvidenceType\":0,\"Value\":\"x\"}]}]}",
+    "{\"Sequence\":true}",
+    "[]",
+  };
+
+  for (auto& json : invalid)
+  {
+    try
+    {
+      ProFormaJsonReader::ReadTerm(json);
+      std::cerr << "test_readInvalid FAILED: No exception thrown for " << json << std::endl;
+      failures++;
+    }
+    catch (ProFormaParseException* e)
+    {
+      std::cout << "test_readInvalid PASSED: " << e->what() << std::endl;
+      delete e;
+    }
+  }
+
+  try
+  {
+    ProFormaJsonReader::ReadJsonLines("{\"Sequence\":\"PEPTIDE\"}\n\n{\"Sequence\":}\n", [](ProFormaTerm&&) {});
+    std::cerr << "test_readInvalid FAILED: No exception thrown for JSON Lines" << std::endl;
+    failures++;
+  }
+  catch (ProFormaParseException* e)
+  {
+    check("test_readInvalid(line number)", "Line 3:", std::string(e->what()).substr(0, 7));
+    delete e;
+  }
+}
+
+int main()
+{
+  try
+  {
+    test_readWhatWasWritten();
+    test_readCompact();
+    test_readJsonLines();
+    test_readInvalid();
+  }
+  catch (ProFormaParseException* e)
+  {
+    std::cerr << "FAILED with parsing exception: " << e->what() << std::endl;
+    failures++;
+  }
+
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,227 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ProFormaJsonEmitter.h"
+#include "ProFormaParseException.h"
+#include "ProFormaParser.h"
+#include "ProFormaTagGroupChangingValue.h"
+#include "ProFormaTermBuilder.h"
+#include "ProFormaWriter.h"
+#include "TestUtil.h"
+
+using namespace ProForma;
+
+// Output of the DOM based writer this one replaced, global modifications with sorted keys since it built them as nlohmann::json.
+// The last weight of the built term is 1e+23: its shortest digits, Grisu2 in nlohmann::json wrote 9.999999999999999e+22.
+static const std::vector<std::pair<std::string, std::string>> Expected = {
+        { "PEPTIDE",
+          "{\"Sequence\":\"PEPTIDE\",\"GlobalModifications\":null,\"NTerminalDescriptors\":null,\"CTerminalDescriptors\":null,\"LabileDescriptors\":null,\"Tags\":null,\"UnlocalizedTags\":null,\"TagGroups\":null}" },
+        { "EM[Oxidation]EVEES[Phospho]PEK",
+          "{\"Sequence\":\"EMEVEESPEK\",\"GlobalModifications\":null,\"NTerminalDescriptors\":null,\"CTerminalDescriptors\":null,\"LabileDescriptors\":null,\"Tags\":[{\"ZeroBasedStartIndex\":1,\"ZeroBasedEndIndex\":1,\"Descriptors\":[{\"Key\":1,\"EvidenceType\":0,\"Value\":\"Oxidation\"}]},{\"ZeroBasedStartIndex\":6,\"ZeroBasedEndIndex\":6,\"Descriptors\":[{\"Key\":1,\"EvidenceType\":0,\"Value\":\"Phospho\"}]}],\"UnlocalizedTags\":null,\"TagGroups\":null}" },
+        { "[Acetyl]-PEPTIDE-[Amidated]",
+          "{\"Sequence\":\"PEPTIDE\",\"GlobalModifications\":null,\"NTerminalDescriptors\":[{\"Key\":1,\"EvidenceType\":0,\"Value\":\"Acetyl\"}],\"CTerminalDescriptors\":[{\"Key\":1,\"EvidenceType\":0,\"Value\":\"Amidated\"}],\"LabileDescriptors\":null,\"Tags\":null,\"UnlocalizedTags\":null,\"TagGroups\":null}" },
+        { "<[Carbamidomethyl]@C,M>ATPEILTCNSIGCLK",
+          "{\"Sequence\":\"ATPEILTCNSIGCLK\",\"GlobalModifications\":[{\"Descriptors\":[{\"EvidenceType\":0,\"Key\":1,\"Value\":\"Carbamidomethyl\"}],\"TargetAminoacids\":[67,77]}],\"NTerminalDescriptors\":null,\"CTerminalDescriptors\":null,\"LabileDescriptors\":null,\"Tags\":null,\"UnlocalizedTags\":null,\"TagGroups\":null}" },
+        { "{Glycan:Hex}EMEVNESPEK",
+          "{\"Sequence\":\"EMEVNESPEK\",\"GlobalModifications\":null,\"NTerminalDescriptors\":null,\"CTerminalDescriptors\":null,\"LabileDescriptors\":[{\"Key\":5,\"EvidenceType\":0,\"Value\":\"Hex\"}],\"Tags\":null,\"UnlocalizedTags\":null,\"TagGroups\":null}" },
+        { "[Phospho]?EM[Oxidation]EVTSECSPEK",
+          "{\"Sequence\":\"EMEVTSECSPEK\",\"GlobalModifications\":null,\"NTerminalDescriptors\":null,\"CTerminalDescriptors\":null,\"LabileDescriptors\":null,\"Tags\":[{\"ZeroBasedStartIndex\":1,\"ZeroBasedEndIndex\":1,\"Descriptors\":[{\"Key\":1,\"EvidenceType\":0,\"Value\":\"Oxidation\"}]}],\"UnlocalizedTags\":[{\"Count\":1,\"Descriptors\":[{\"Key\":1,\"EvidenceType\":0,\"Value\":\"Phospho\"}]}],\"TagGroups\":null}" },
+        { "EM[U:Oxidation]EVT[#g1(0.01)]S[#g1(0.09)]ES[Phospho#g1(0.90)]PEK",
+          "{\"Sequence\":\"EMEVTSESPEK\",\"GlobalModifications\":null,\"NTerminalDescriptors\":null,\"CTerminalDescriptors\":null,\"LabileDescriptors\":null,\"Tags\":[{\"ZeroBasedStartIndex\":1,\"ZeroBasedEndIndex\":1,\"Descriptors\":[{\"Key\":1,\"EvidenceType\":2,\"Value\":\"Oxidation\"}]}],\"UnlocalizedTags\":null,\"TagGroups\":[{\"ValueFlux\":\"Phospho\",\"KeyFlux\":1,\"EvidenceFlux\":0,\"Name\":\"g1\",\"Key\":1,\"EvidenceType\":0,\"Value\":\"Phospho\",\"Members\":[{\"ZeroBasedStartIndex\":4,\"ZeroBasedEndIndex\":4,\"Weight\":0.01},{\"ZeroBasedStartIndex\":5,\"ZeroBasedEndIndex\":5,\"Weight\":0.09},{\"ZeroBasedStartIndex\":7,\"ZeroBasedEndIndex\":7,\"Weight\":0.9}]}]}" },
+        { "PRT(ESFRMS)[+19.0523]ISK",
+          "{\"Sequence\":\"PRTESFRMSISK\",\"GlobalModifications\":null,\"NTerminalDescriptors\":null,\"CTerminalDescriptors\":null,\"LabileDescriptors\":null,\"Tags\":[{\"ZeroBasedStartIndex\":3,\"ZeroBasedEndIndex\":8,\"Descriptors\":[{\"Key\":3,\"EvidenceType\":0,\"Value\":\"+19.0523\"}]}],\"UnlocalizedTags\":null,\"TagGroups\":null}" },
+        { "EM[MOD:00719]EVEES[UNIMOD:21]PEK",
+          "{\"Sequence\":\"EMEVEESPEK\",\"GlobalModifications\":null,\"NTerminalDescriptors\":null,\"CTerminalDescriptors\":null,\"LabileDescriptors\":null,\"Tags\":[{\"ZeroBasedStartIndex\":1,\"ZeroBasedEndIndex\":1,\"Descriptors\":[{\"Key\":2,\"EvidenceType\":5,\"Value\":\"MOD:00719\"}]},{\"ZeroBasedStartIndex\":6,\"ZeroBasedEndIndex\":6,\"Descriptors\":[{\"Key\":2,\"EvidenceType\":2,\"Value\":\"UNIMOD:21\"}]}],\"UnlocalizedTags\":null,\"TagGroups\":null}" },
+        { "EM[RESID:AA0037]K",
+          "{\"Sequence\":\"EMK\",\"GlobalModifications\":null,\"NTerminalDescriptors\":null,\"CTerminalDescriptors\":null,\"LabileDescriptors\":null,\"Tags\":[{\"ZeroBasedStartIndex\":1,\"ZeroBasedEndIndex\":1,\"Descriptors\":[{\"Key\":2,\"EvidenceType\":4,\"Value\":\"AA0037\"}]}],\"UnlocalizedTags\":null,\"TagGroups\":null}" },
+        { "S[Phospho|#g1]EKT[#g1]",
+          "{\"Sequence\":\"SEKT\",\"GlobalModifications\":null,\"NTerminalDescriptors\":null,\"CTerminalDescriptors\":null,\"LabileDescriptors\":null,\"Tags\":[{\"ZeroBasedStartIndex\":0,\"ZeroBasedEndIndex\":0,\"Descriptors\":[{\"Key\":1,\"EvidenceType\":0,\"Value\":\"Phospho\"}]}],\"UnlocalizedTags\":null,\"TagGroups\":[{\"ValueFlux\":\"\",\"KeyFlux\":0,\"EvidenceFlux\":0,\"Name\":\"g1\",\"Key\":0,\"EvidenceType\":0,\"Value\":\"\",\"Members\":[{\"ZeroBasedStartIndex\":0,\"ZeroBasedEndIndex\":0,\"Weight\":0.0},{\"ZeroBasedStartIndex\":3,\"ZeroBasedEndIndex\":3,\"Weight\":0.0}]}]}" },
+        { "EMEVTSES[Phospho|Obs:+79.966]PEK",
+          "{\"Sequence\":\"EMEVTSESPEK\",\"GlobalModifications\":null,\"NTerminalDescriptors\":null,\"CTerminalDescriptors\":null,\"LabileDescriptors\":null,\"Tags\":[{\"ZeroBasedStartIndex\":7,\"ZeroBasedEndIndex\":7,\"Descriptors\":[{\"Key\":1,\"EvidenceType\":0,\"Value\":\"Phospho\"},{\"Key\":3,\"EvidenceType\":1,\"Value\":\"+79.966\"}]}],\"UnlocalizedTags\":null,\"TagGroups\":null}" },
+        { "ELV[Formula:C12H20O2]IS[Info:test]K",
+          "{\"Sequence\":\"ELVISK\",\"GlobalModifications\":null,\"NTerminalDescriptors\":null,\"CTerminalDescriptors\":null,\"LabileDescriptors\":null,\"Tags\":[{\"ZeroBasedStartIndex\":2,\"ZeroBasedEndIndex\":2,\"Descriptors\":[{\"Key\":4,\"EvidenceType\":0,\"Value\":\"C12H20O2\"}]},{\"ZeroBasedStartIndex\":4,\"ZeroBasedEndIndex\":4,\"Descriptors\":[{\"Key\":6,\"EvidenceType\":0,\"Value\":\"test\"}]}],\"UnlocalizedTags\":null,\"TagGroups\":null}" },
+        { "built",
+          "{\"Sequence\":\"ACDEFGHIK\",\"GlobalModifications\":[{\"Descriptors\":[{\"EvidenceType\":0,\"Key\":1,\"Value\":\"13C\"}],\"TargetAminoacids\":null}],\"NTerminalDescriptors\":null,\"CTerminalDescriptors\":null,\"LabileDescriptors\":[{\"Key\":1,\"EvidenceType\":0,\"Value\":\"\"}],\"Tags\":[{\"ZeroBasedStartIndex\":1,\"ZeroBasedEndIndex\":1,\"Descriptors\":[{\"Key\":6,\"EvidenceType\":0,\"Value\":\"quote\\\" backslash\\\\ slash/ tab\\t nl\\n cr\\r bs\\b ff\\f nul\"}]},{\"ZeroBasedStartIndex\":2,\"ZeroBasedEndIndex\":2,\"Descriptors\":[{\"Key\":6,\"EvidenceType\":0,\"Value\":\"ctl\\u0001\\u001f del\x7f"" utf8 \xc3""\xa9""\xe2""\x82""\xac"" end\"}]},{\"ZeroBasedStartIndex\":3,\"ZeroBasedEndIndex\":5,\"Descriptors\":[{\"Key\":1,\"EvidenceType\":8,\"Value\":\"averyveryverylongname_thatspans\\\"multiple_words\\\\\"}]}],\"UnlocalizedTags\":[{\"Count\":3,\"Descriptors\":[{\"Key\":3,\"EvidenceType\":0,\"Value\":\"-17.0265\"}]}],\"TagGroups\":[{\"Name\":\"fixed\",\"Key\":1,\"EvidenceType\":2,\"Value\":\"Phospho\",\"Members\":[{\"ZeroBasedStartIndex\":0,\"ZeroBasedEndIndex\":8,\"Weight\":1.0}]},{\"ValueFlux\":\"+1.5\",\"KeyFlux\":3,\"EvidenceFlux\":1,\"Name\":\"g2\",\"Key\":3,\"EvidenceType\":1,\"Value\":\"+1.5\",\"Members\":[{\"ZeroBasedStartIndex\":0,\"ZeroBasedEndIndex\":0,\"Weight\":0.0},{\"ZeroBasedStartIndex\":1,\"ZeroBasedEndIndex\":1,\"Weight\":0.5},{\"ZeroBasedStartIndex\":2,\"ZeroBasedEndIndex\":2,\"Weight\":1e-05},{\"ZeroBasedStartIndex\":3,\"ZeroBasedEndIndex\":3,\"Weight\":0.0001},{\"ZeroBasedStartIndex\":4,\"ZeroBasedEndIndex\":4,\"Weight\":0.001234},{\"ZeroBasedStartIndex\":5,\"ZeroBasedEndIndex\":5,\"Weight\":1.2345678901234568e+17},{\"ZeroBasedStartIndex\":6,\"ZeroBasedEndIndex\":6,\"Weight\":1e+15},{\"ZeroBasedStartIndex\":7,\"ZeroBasedEndIndex\":7,\"Weight\":1e+16},{\"ZeroBasedStartIndex\":8,\"ZeroBasedEndIndex\":8,\"Weight\":1e+20},{\"ZeroBasedStartIndex\":0,\"ZeroBasedEndIndex\":0,\"Weight\":0.30000000000000004},{\"ZeroBasedStartIndex\":1,\"ZeroBasedEndIndex\":1,\"Weight\":0.3333333333333333},{\"ZeroBasedStartIndex\":2,\"ZeroBasedEndIndex\":2,\"Weight\":2.5e-300},{\"ZeroBasedStartIndex\":3,\"ZeroBasedEndIndex\":3,\"Weight\":12.0},{\"ZeroBasedStartIndex\":4,\"ZeroBasedEndIndex\":4,\"Weight\":0.0001},{\"ZeroBasedStartIndex\":5,\"ZeroBasedEndIndex\":5,\"Weight\":1e+23}]}]}" }
+};
+
+// Term built without the parser, covering escapes and every number layout
+static ProFormaTerm BuildTerm()
+{
+  ProFormaTermBuilder builder;
+  builder.SetSequence("ACDEFGHIK");
+  builder.AddTag(1, { ProFormaDescriptor(ProFormaKey::Info, "quote\" backslash\\ slash/ tab\t nl\n cr\r bs\b ff\f nul") });
+  builder.AddTag(2, { ProFormaDescriptor(ProFormaKey::Info, std::string("ctl\x01\x1f del\x7f utf8 \xc3\xa9\xe2\x82\xac end")) });
+  builder.AddTag(3, 5, { ProFormaDescriptor(ProFormaKey::Name, ProFormaEvidenceType::Brno, "averyveryverylongname_thatspans\"multiple_words\\") });
+  builder.SetLabileDescriptors({ ProFormaDescriptor("") });
+
+  auto group = static_cast<ProFormaTagGroupChangingValue*>(builder.AddTagGroup(new ProFormaTagGroupChangingValue("g2", ProFormaKey::Mass, ProFormaEvidenceType::Observed, {})));
+  double weights[] = { 0.0, 0.5, 1e-5, 0.0001, 0.001234, 123456789012345678.0, 1e15, 1e16, 1e20, 0.1 + 0.2, 1.0 / 3.0, 2.5e-300, 12.0, 1e-4, 9.999999999999999e22 };
+  size_t i = 0;
+  for (double weight : weights)
+  {
+    builder.AddGroupMember("g2", ProFormaMembershipDescriptor(i % 9, i % 9, weight));
+    i++;
+  }
+  group->SetValueFlux("+1.5");
+
+  builder.AddTagGroup("fixed", ProFormaKey::Name, ProFormaEvidenceType::Unimod, "Phospho");
+  builder.AddGroupMember("fixed", ProFormaMembershipDescriptor(0, 8, 1.0));
+  builder.AddGlobalModification({ ProFormaDescriptor("13C") }, {});
+  builder.AddUnlocalizedTag(3, { ProFormaDescriptor(ProFormaKey::Mass, "-17.0265") });
+
+  return std::move(builder).Build();
+}
+
+void test_jsonMatchesDomOutput()
+{
+  ProFormaQuietParser parser;
+
+  for (auto& item : Expected)
+  {
+    if (item.first == "built")
+      check("test_jsonMatchesDomOutput(built)", item.second, ProFormaWriter::TermToJson(BuildTerm()));
+    else
+      check("test_jsonMatchesDomOutput(" + item.first + ")", item.second, ProFormaWriter::TermToJson(parser.ParseString(item.first)));
+  }
+}
+
+void test_jsonAppendReusesBuffer()
+{
+  ProFormaQuietParser parser;
+  std::string buffer = "[";
+
+  ProFormaWriter::AppendJsonTo(buffer, parser.ParseString(Expected[0].first));
+  buffer += ',';
+  ProFormaWriter::AppendJsonTo(buffer, parser.ParseString(Expected[1].first));
+  buffer += ']';
+
+  check("test_jsonAppendReusesBuffer", "[" + Expected[0].second + "," + Expected[1].second + "]", buffer);
+}
+
+void test_jsonCompact()
+{
+  ProFormaQuietParser parser;
+
+  check("test_jsonCompact(plain)", "{\"Sequence\":\"PEPTIDE\"}",
+    ProFormaWriter::TermToJson(parser.ParseString("PEPTIDE"), ProFormaJsonFormat::Compact));
+  check("test_jsonCompact(tags)",
+    "{\"Sequence\":\"EMEVEESPEK\",\"NTerminalDescriptors\":[{\"Key\":1,\"EvidenceType\":0,\"Value\":\"Acetyl\"}],"
+    "\"Tags\":[{\"ZeroBasedStartIndex\":1,\"ZeroBasedEndIndex\":1,\"Descriptors\":[{\"Key\":1,\"EvidenceType\":0,\"Value\":\"Oxidation\"}]}]}",
+    ProFormaWriter::TermToJson(parser.ParseString("[Acetyl]-EM[Oxidation]EVEESPEK"), ProFormaJsonFormat::Compact));
+}
+
+void test_jsonLinesParallel()
+{
+  ProFormaQuietParser parser;
+  std::vector<ProFormaTerm> terms;
+  std::string expected;
+
+  // Not a multiple of the chunk size, so the last chunk is short
+  for (size_t i = 0; i < 1000; i++)
+  {
+    const std::string& input = Expected[i % Expected.size()].first;
+    terms.push_back(input == "built" ? BuildTerm() : parser.ParseString(input));
+    expected += ProFormaWriter::TermToJson(terms.back(), ProFormaJsonFormat::Compact) + "\n";
+  }
+
+  for (unsigned threads : { 1u, 2u, 3u, 8u, 0u })
+  {
+    std::ostringstream sink;
+    size_t written = ProFormaWriter::WriteJsonLines(terms, sink, threads, ProFormaJsonFormat::Compact);
+    check("test_jsonLinesParallel(threads " + std::to_string(threads) + ")", expected, sink.str());
+    check("test_jsonLinesParallel(bytes " + std::to_string(threads) + ")", std::to_string(expected.length()), std::to_string(written));
+  }
+
+  std::ostringstream empty;
+  check("test_jsonLinesParallel(empty)", "0", std::to_string(ProFormaWriter::WriteJsonLines(terms.data(), 0, empty, 4)));
+}
+
+// Reference escaping, one byte at a time
+static std::string EscapeBytewise(const std::string& text)
+{
+  static const char hex[] = "0123456789abcdef";
+  std::string out;
+
+  for (unsigned char c : text)
+  {
+    switch (c)
+    {
+    case '"': out += "\\\""; break;
+    case '\\': out += "\\\\"; break;
+    case '\b': out += "\\b"; break;
+    case '\f': out += "\\f"; break;
+    case '\n': out += "\\n"; break;
+    case '\r': out += "\\r"; break;
+    case '\t': out += "\\t"; break;
+    default:
+      if (c < 0x20)
+      {
+        out += "\\u00";
+        out += hex[c >> 4];
+        out += hex[c & 0xF];
+      }
+      else
+        out += static_cast<char>(c);
+    }
+  }
+
+  return out;
+}
+
+void test_jsonEscapeEveryPosition()
+{
+  // Every special byte at every offset of strings crossing several 8 byte blocks
+  const std::string specials = std::string("\"\\\b\f\n\r\t\x01\x1f", 9) + std::string(1, '\0');
+  const std::string neutral = std::string("A \x20\x7f\x80\xff", 6);
+  std::string failure;
+
+  for (size_t length = 0; length <= 33 && failure.empty(); length++)
+  {
+    for (size_t position = 0; position < length && failure.empty(); position++)
+    {
+      for (char special : specials + neutral)
+      {
+        std::string text(length, 'x');
+        text[position] = special;
+
+        std::string escaped;
+        ProFormaJsonEmitter::AppendEscaped(escaped, text.data(), text.length());
+        if (escaped != EscapeBytewise(text))
+        {
+          failure = EscapeBytewise(text) + " but got " + escaped;
+          break;
+        }
+      }
+    }
+  }
+
+  if (failure.empty())
+    std::cout << "test_jsonEscapeEveryPosition PASSED" << std::endl;
+  else
+  {
+    std::cerr << "test_jsonEscapeEveryPosition FAILED: Expected " << failure << std::endl;
+    failures++;
+  }
+}
+
+int main()
+{
+  try
+  {
+    test_jsonMatchesDomOutput();
+    test_jsonAppendReusesBuffer();
+    test_jsonCompact();
+    test_jsonLinesParallel();
+    test_jsonEscapeEveryPosition();
+  }
+  catch (ProFormaParseException* e)
+  {
+    std::cerr << "FAILED with parsing exception: " << e->what() << std::endl;
+    failures++;
+  }
+
+  return failures == 0 ? 0 : 1;
+}
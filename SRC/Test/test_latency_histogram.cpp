@@ -0,0 +1,163 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ProFormaLatencyHistogram.h"
+#include "ProFormaParseException.h"
+#include "ProFormaParser.h"
+#include "ProFormaWriter.h"
+#include "TestUtil.h"
+
+using namespace ProForma;
+
+// Within 1/32 of the expected value, the precision of the histogram
+static void checkClose(const std::string& test, uint64_t expected, uint64_t output)
+{
+  uint64_t difference = output > expected ? output - expected : expected - output;
+  check(test, std::to_string(expected) + " (3%)", difference * 32 <= expected ? std::to_string(expected) + " (3%)" : std::to_string(output));
+}
+
+void test_histogramBuckets()
+{
+  std::string failure;
+  size_t previous = 0;
+
+  // Every value lies in its bucket, buckets grow with the values and are narrower than 1/32 of them
+  for (uint64_t value = 0; value < (uint64_t(1) << 40) && failure.empty(); value = value < 200 ? value + 1 : value + value / 7 + 3)
+  {
+    size_t index = ProFormaLatencyHistogram::BucketIndex(value);
+    uint64_t lower = ProFormaLatencyHistogram::BucketLowerBound(index);
+    uint64_t upper = ProFormaLatencyHistogram::BucketUpperBound(index);
+
+    if (index < previous || index >= ProFormaLatencyHistogram::BucketCount)
+      failure = "index of " + std::to_string(value);
+    else if (value < lower || value > upper)
+      failure = "bounds of " + std::to_string(value);
+    else if (value < (uint64_t(1) << ProFormaLatencyHistogram::MaxBits) && (upper - lower) * 32 > value)
+      failure = "width at " + std::to_string(value);
+
+    previous = index;
+  }
+
+  check("test_histogramBuckets", "", failure);
+  check("test_histogramBuckets(last)", std::to_string(ProFormaLatencyHistogram::BucketCount - 1),
+    std::to_string(ProFormaLatencyHistogram::BucketIndex(UINT64_MAX)));
+}
+
+void test_histogramQuantiles()
+{
+  ProFormaLatencyHistogram histogram, low, high;
+  check("test_histogramQuantiles(empty)", "0", std::to_string(histogram.ValueAtQuantile(0.5)));
+
+  for (uint64_t value = 1; value <= 100000; value++)
+  {
+    histogram.Record(value);
+    (value <= 50000 ? low : high).Record(value);
+  }
+
+  checkClose("test_histogramQuantiles(p50)", 50000, histogram.ValueAtQuantile(0.5));
+  checkClose("test_histogramQuantiles(p99)", 99000, histogram.ValueAtQuantile(0.99));
+  check("test_histogramQuantiles(max)", "100000", std::to_string(histogram.ValueAtQuantile(1.0)));
+  check("test_histogramQuantiles(min)", "1", std::to_string(histogram.ValueAtQuantile(0.0)));
+  check("test_histogramQuantiles(mean)", "50000.5", std::to_string(histogram.Mean()).substr(0, 7));
+
+  // A few giant values in the tail
+  ProFormaLatencyHistogram tail;
+  for (int i = 0; i < 990; i++)
+    tail.Record(1000);
+  for (int i = 0; i < 10; i++)
+    tail.Record(5000000);
+  checkClose("test_histogramQuantiles(tail p50)", 1000, tail.ValueAtQuantile(0.5));
+  checkClose("test_histogramQuantiles(tail p99.5)", 5000000, tail.ValueAtQuantile(0.995));
+
+  low.Merge(high);
+  bool same = low.Count == histogram.Count && low.Sum == histogram.Sum && low.Min == histogram.Min && low.Max == histogram.Max;
+  for (size_t i = 0; i < ProFormaLatencyHistogram::BucketCount; i++)
+    same = same && low.Buckets[i] == histogram.Buckets[i];
+  check("test_histogramQuantiles(merge)", "1", std::to_string(same));
+
+  low.Reset();
+  check("test_histogramQuantiles(reset)", "0", std::to_string(low.Count + low.Max));
+}
+
+void test_latencyRecording()
+{
+  ProFormaQuietParser parser;
+  ProFormaLatency::Reset();
+
+  // Nothing is timed until enabled
+  parser.ParseString("PEPTIDE");
+  check("test_latencyRecording(disabled)", "0", std::to_string(ProFormaLatency::Snapshot(ProFormaOperation::Parse).Count));
+
+  ProFormaLatency::SetEnabled(true);
+  std::string longInput(3000, 'A');
+  for (int i = 0; i < 100; i++)
+    parser.ParseString("EM[Oxidation]EVK");
+  ProFormaTerm longTerm = parser.ParseString(longInput);
+  try
+  {
+    parser.ParseString("EM[Oxidation");
+  }
+  catch (ProFormaParseException*)
+  {
+  }
+
+  ProFormaWriter::TermToJson(longTerm);
+  ProFormaWriter::TermToString(longTerm);
+  ProFormaWriter::TermToCbor(longTerm);
+  ProFormaLatency::SetEnabled(false);
+
+  check("test_latencyRecording(parse short)", "101", std::to_string(ProFormaLatency::Snapshot(ProFormaOperation::Parse, ProFormaLengthClass::UpTo16).Count));
+  check("test_latencyRecording(parse long)", "1", std::to_string(ProFormaLatency::Snapshot(ProFormaOperation::Parse, ProFormaLengthClass::UpTo4096).Count));
+  check("test_latencyRecording(parse all)", "102", std::to_string(ProFormaLatency::Snapshot(ProFormaOperation::Parse).Count));
+  check("test_latencyRecording(json)", "1", std::to_string(ProFormaLatency::Snapshot(ProFormaOperation::WriteJson, ProFormaLengthClass::UpTo4096).Count));
+  check("test_latencyRecording(string)", "1", std::to_string(ProFormaLatency::Snapshot(ProFormaOperation::WriteString).Count));
+  check("test_latencyRecording(cbor)", "1", std::to_string(ProFormaLatency::Snapshot(ProFormaOperation::WriteCbor).Count));
+  check("test_latencyRecording(msgpack)", "0", std::to_string(ProFormaLatency::Snapshot(ProFormaOperation::WriteMsgPack).Count));
+
+  ProFormaLatencyHistogram parse = ProFormaLatency::Snapshot(ProFormaOperation::Parse);
+  check("test_latencyRecording(bounds)", "1", std::to_string(parse.Min > 0 && parse.Min <= parse.ValueAtQuantile(0.5) && parse.ValueAtQuantile(0.5) <= parse.Max));
+
+  ProFormaLatency::Reset();
+  check("test_latencyRecording(reset)", "0", std::to_string(ProFormaLatency::Snapshot(ProFormaOperation::Parse).Count));
+}
+
+void test_latencyThreads()
+{
+  ProFormaLatency::Reset();
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++)
+    threads.emplace_back([t] {
+      for (uint64_t i = 1; i <= 10000; i++)
+        ProFormaLatency::Record(ProFormaOperation::WriteJson, 10, i + t);
+    });
+  for (auto& thread : threads)
+    thread.join();
+
+  ProFormaLatencyHistogram histogram = ProFormaLatency::Snapshot(ProFormaOperation::WriteJson);
+  check("test_latencyThreads(count)", "40000", std::to_string(histogram.Count));
+  check("test_latencyThreads(min)", "1", std::to_string(histogram.Min));
+  check("test_latencyThreads(max)", "10003", std::to_string(histogram.Max));
+  ProFormaLatency::Reset();
+}
+
+int main()
+{
+  try
+  {
+    test_histogramBuckets();
+    test_histogramQuantiles();
+    test_latencyRecording();
+    test_latencyThreads();
+  }
+  catch (ProFormaParseException* e)
+  {
+    std::cerr << "FAILED with parsing exception: " << e->what() << std::endl;
+    failures++;
+  }
+
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,155 @@
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ProFormaLogger.h"
+#include "ProFormaParseException.h"
+#include "TestUtil.h"
+
+using namespace ProForma;
+
+static const std::string LogFile = "test_logger.log";
+
+// Messages written since the file was opened, without the date and time prefix
+static std::vector<std::string> ReadMessages()
+{
+  std::ifstream file(LogFile);
+  std::vector<std::string> messages;
+  std::string line;
+
+  while (std::getline(file, line))
+  {
+    size_t tab = line.find(":\t");
+    messages.push_back(tab == std::string::npos ? "<no prefix> " + line : line.substr(tab + 2));
+  }
+
+  return messages;
+}
+
+void test_loggerFormatsArguments()
+{
+  ProFormaLogger* logger = ProFormaLogger::GetLogger();
+  std::remove(LogFile.c_str());
+  logger->Open(LogFile);
+
+  {
+    // The string is gone when the background thread formats the message
+    std::string temporary = "Phospho";
+    logger->Log("tag %s at %d of %zu, char [%c], mass %.3f, %u%%", temporary.c_str(), -3, static_cast<size_t>(12), 'S', 79.96633, 7u);
+    temporary.assign(64, 'x');
+  }
+  logger->Log("long %s", std::string(1000, 'L'));
+  logger->Log("missing %d and %s");
+  logger->Log("mismatch %s", 42);
+  logger->Log(std::string("message"));
+  *logger << "streamed";
+  logger->Flush();
+
+  std::vector<std::string> messages = ReadMessages();
+  check("test_loggerFormatsArguments(count)", "6", std::to_string(messages.size()));
+  if (messages.size() != 6)
+    return;
+
+  check("test_loggerFormatsArguments(types)", "tag Phospho at -3 of 12, char [S], mass 79.966, 7%", messages[0]);
+  check("test_loggerFormatsArguments(truncated)", "1",
+    std::to_string(messages[1].length() > 64 && messages[1].length() < ProFormaLogger::RecordSize && messages[1].find_first_not_of('L', 5) == std::string::npos));
+  check("test_loggerFormatsArguments(missing)", "missing %d and %s", messages[2]);
+  check("test_loggerFormatsArguments(mismatch)", "mismatch 42", messages[3]);
+  check("test_loggerFormatsArguments(string)", "message", messages[4]);
+  check("test_loggerFormatsArguments(stream)", "streamed", messages[5]);
+}
+
+void test_loggerThreads()
+{
+  ProFormaLogger* logger = ProFormaLogger::GetLogger();
+  std::remove(LogFile.c_str());
+  logger->Open(LogFile);
+
+  // Rings large enough for every message, so none is dropped
+  logger->SetRingCapacity(4096);
+  uint64_t dropped = logger->Dropped();
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++)
+    threads.emplace_back([logger, t] {
+      for (int i = 0; i < 2000; i++)
+        logger->Log("thread %d message %d", t, i);
+    });
+  for (auto& thread : threads)
+    thread.join();
+  logger->Flush();
+
+  // Messages of one thread keep their order
+  std::vector<std::string> messages = ReadMessages();
+  std::vector<int> next(4, 0);
+  bool ordered = true;
+  for (auto& message : messages)
+  {
+    int t = -1, i = -1;
+    if (sscanf(message.c_str(), "thread %d message %d", &t, &i) != 2 || t < 0 || t > 3 || next[t] != i)
+      ordered = false;
+    else
+      next[t]++;
+  }
+
+  check("test_loggerThreads(count)", "8000", std::to_string(messages.size()));
+  check("test_loggerThreads(ordered)", "1", std::to_string(ordered));
+  check("test_loggerThreads(dropped)", "0", std::to_string(logger->Dropped() - dropped));
+}
+
+void test_loggerDropsOnOverflow()
+{
+  ProFormaLogger* logger = ProFormaLogger::GetLogger();
+  std::remove(LogFile.c_str());
+  logger->Open(LogFile);
+
+  logger->SetRingCapacity(16);
+  uint64_t dropped = logger->Dropped();
+
+  // New thread, so a new ring of 16 records, filled faster than it is drained
+  std::thread producer([logger] {
+    for (int i = 0; i < 100000; i++)
+      logger->Log("burst %d", i);
+  });
+  producer.join();
+  logger->Flush();
+
+  uint64_t lost = logger->Dropped() - dropped;
+  size_t written = 0;
+  std::string report;
+  for (auto& message : ReadMessages())
+  {
+    if (message.compare(0, 6, "burst ") == 0)
+      written++;
+    else
+      report = message;
+  }
+
+  check("test_loggerDropsOnOverflow(accounted)", "100000", std::to_string(written + lost));
+  check("test_loggerDropsOnOverflow(dropped)", "1", std::to_string(lost > 0));
+  check("test_loggerDropsOnOverflow(report)", "1", std::to_string(report.find("messages dropped") != std::string::npos));
+
+  logger->SetRingCapacity(1024);
+}
+
+int main()
+{
+  try
+  {
+    test_loggerFormatsArguments();
+    test_loggerThreads();
+    test_loggerDropsOnOverflow();
+  }
+  catch (ProFormaParseException* e)
+  {
+    std::cerr << "FAILED with parsing exception: " << e->what() << std::endl;
+    failures++;
+  }
+
+  std::remove(LogFile.c_str());
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,89 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ProFormaMemoryUsage.h"
+#include "ProFormaParseException.h"
+#include "ProFormaParser.h"
+#include "TestUtil.h"
+
+using namespace ProForma;
+
+void test_memoryPlain()
+{
+  ProFormaQuietParser parser;
+
+  // A short sequence stays in the string object
+  ProFormaMemoryUsage usage = parser.ParseString("PEPTIDE").ApproximateMemoryUsage();
+  check("test_memoryPlain(term)", std::to_string(sizeof(ProFormaTerm)), std::to_string(usage.Term));
+  check("test_memoryPlain(heap)", "0", std::to_string(usage.Heap()));
+  check("test_memoryPlain(terms)", "1", std::to_string(usage.Terms));
+
+  ProFormaMemoryUsage longUsage = parser.ParseString(std::string(1000, 'A')).ApproximateMemoryUsage();
+  check("test_memoryPlain(sequence)", "1", std::to_string(longUsage.Sequence >= 1001 && longUsage.Sequence < 2100));
+  check("test_memoryPlain(only sequence)", std::to_string(longUsage.Sequence), std::to_string(longUsage.Heap()));
+}
+
+void test_memoryComponents()
+{
+  ProFormaQuietParser parser;
+
+  ProFormaMemoryUsage one = parser.ParseString("EM[Oxidation]EVK").ApproximateMemoryUsage();
+  ProFormaMemoryUsage two = parser.ParseString("EM[Oxidation]EVS[Phospho]K").ApproximateMemoryUsage();
+  check("test_memoryComponents(tags)", "1", std::to_string(one.Tags > 0 && two.Tags == 2 * one.Tags));
+  check("test_memoryComponents(descriptors)", "1", std::to_string(two.Descriptors >= one.Descriptors + sizeof(ProFormaDescriptor)));
+  check("test_memoryComponents(no groups)", "0", std::to_string(two.TagGroups + two.GlobalModifications));
+
+  // A value past the small string buffer adds its heap block
+  std::string name(100, 'x');
+  ProFormaMemoryUsage longName = parser.ParseString("EM[" + name + "]EVK").ApproximateMemoryUsage();
+  check("test_memoryComponents(value)", std::to_string(one.Descriptors + ProFormaMemoryUsage::HeapBlock(101)), std::to_string(longName.Descriptors));
+
+  ProFormaMemoryUsage grouped = parser.ParseString("EM[Oxidation#g1(0.5)]EVEM[#g1(0.5)]K").ApproximateMemoryUsage();
+  check("test_memoryComponents(groups)", "1", std::to_string(grouped.TagGroups > sizeof(ProFormaTagGroup)));
+
+  ProFormaMemoryUsage global = parser.ParseString("<[Carbamidomethyl]@C>PEPCK").ApproximateMemoryUsage();
+  check("test_memoryComponents(global)", "1", std::to_string(global.GlobalModifications > 0 && global.Descriptors > 0 && global.Tags == 0));
+
+  check("test_memoryComponents(total)", std::to_string(global.Term + global.Sequence + global.Tags + global.Descriptors + global.TagGroups + global.GlobalModifications),
+    std::to_string(global.Total()));
+}
+
+void test_memoryCorpus()
+{
+  ProFormaQuietParser parser;
+  std::vector<ProFormaTerm> terms;
+  for (const char* input : { "PEPTIDE", "EM[Oxidation]EVK", "EM[Oxidation#g1(0.5)]EVEM[#g1(0.5)]K" })
+    terms.push_back(parser.ParseString(input));
+
+  ProFormaMemoryUsage corpus = ProFormaMemoryUsage::Of(terms.data(), terms.size());
+  ProFormaMemoryUsage sum;
+  for (auto& term : terms)
+    sum.Add(term);
+
+  check("test_memoryCorpus(terms)", "3", std::to_string(corpus.Terms));
+  check("test_memoryCorpus(total)", std::to_string(sum.Total()), std::to_string(corpus.Total()));
+  check("test_memoryCorpus(term)", std::to_string(3 * sizeof(ProFormaTerm)), std::to_string(corpus.Term));
+
+  std::ostringstream report;
+  corpus.Report(report);
+  check("test_memoryCorpus(report)", "1", std::to_string(report.str().find("descriptors") != std::string::npos && report.str().find("100.0%") != std::string::npos));
+}
+
+int main()
+{
+  try
+  {
+    test_memoryPlain();
+    test_memoryComponents();
+    test_memoryCorpus();
+  }
+  catch (ProFormaParseException* e)
+  {
+    std::cerr << "FAILED with parsing exception: " << e->what() << std::endl;
+    failures++;
+  }
+
+  return failures == 0 ? 0 : 1;
+}
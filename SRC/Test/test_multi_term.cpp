@@ -0,0 +1,101 @@
+#include <iostream>
+#include <string>
+
+#include "ProFormaMultiTerm.h"
+#include "ProFormaParseException.h"
+#include "ProFormaParser.h"
+#include "TestUtil.h"
+
+using namespace ProForma;
+
+static std::string describeSites(const ProFormaCrosslink& crosslink)
+{
+  std::string text;
+  for (auto& site : crosslink.Sites)
+    text += std::to_string(site.ChainIndex) + ":" + std::to_string(site.ZeroBasedStartIndex) + " ";
+  return text;
+}
+
+static std::string parseOutcome(const std::string& proFormaString)
+{
+  try
+  {
+    ProFormaQuietParser parser;
+    return std::to_string(parser.ParseMultiString(proFormaString).ChainCount()) + " chains";
+  }
+  catch (ProFormaParseException* e)
+  {
+    delete e;
+    return "rejected";
+  }
+}
+
+void test_multiTermCrosslink()
+{
+  ProFormaQuietParser parser;
+  ProFormaMultiTerm multiTerm = parser.ParseMultiString("EMEVTK[XLMOD:02001#XL1]SESPEK//EMEVTK[#XL1]SESPEK");
+
+  check("test_multiTermCrosslink(chains)", "2", std::to_string(multiTerm.ChainCount()));
+  check("test_multiTermCrosslink(separator)", "1", std::to_string(static_cast<int>(multiTerm.Separator(1))));
+  check("test_multiTermCrosslink(first chain view)", "EMEVTKSESPEK", std::string(multiTerm.ChainSequence(0)));
+  check("test_multiTermCrosslink(chain view)", "EMEVTKSESPEK", std::string(multiTerm.ChainSequence(1)));
+  check("test_multiTermCrosslink(count)", "1", std::to_string(multiTerm.Crosslinks().size()));
+
+  // The crosslinker is named on the first chain only, both sites are merged into one crosslink
+  const ProFormaCrosslink& crosslink = multiTerm.Crosslinks()[0];
+  check("test_multiTermCrosslink(name)", "XL1", crosslink.Name);
+  check("test_multiTermCrosslink(value)", "XLMOD:02001", crosslink.Value);
+  check("test_multiTermCrosslink(sites)", "0:5 1:5 ", describeSites(crosslink));
+  check("test_multiTermCrosslink(chain crosslinks)", "1", std::to_string(multiTerm.ChainCrosslinks(1).size()));
+}
+
+void test_multiTermBranch()
+{
+  ProFormaQuietParser parser;
+  ProFormaMultiTerm multiTerm = parser.ParseMultiString("ETFGD[MOD:00093#BRANCH]LEVPSAK//GR[#BRANCH]");
+
+  check("test_multiTermBranch(chains)", "2", std::to_string(multiTerm.ChainCount()));
+  check("test_multiTermBranch(name)", "BRANCH", multiTerm.Crosslinks()[0].Name);
+  check("test_multiTermBranch(sites)", "0:4 1:1 ", describeSites(multiTerm.Crosslinks()[0]));
+}
+
+void test_multiTermChimeric()
+{
+  ProFormaQuietParser parser;
+  ProFormaMultiTerm multiTerm = parser.ParseMultiString("EMEVEESPEK+ELVIS[Phospho]K+PEPTIDE");
+
+  check("test_multiTermChimeric(chains)", "3", std::to_string(multiTerm.ChainCount()));
+  check("test_multiTermChimeric(separator)", "2", std::to_string(static_cast<int>(multiTerm.Separator(2))));
+  check("test_multiTermChimeric(chain view)", "ELVISK", std::string(multiTerm.ChainSequence(1)));
+  check("test_multiTermChimeric(tags)", "1", std::to_string(multiTerm.Chain(1).Tags().size()));
+  check("test_multiTermChimeric(no crosslinks)", "0", std::to_string(multiTerm.Crosslinks().size()));
+}
+
+void test_multiTermEmptyChains()
+{
+  check("test_multiTermEmptyChains(leading +)", "rejected", parseOutcome("+PEPTIDE"));
+  check("test_multiTermEmptyChains(leading //)", "rejected", parseOutcome("//PEPTIDE"));
+  check("test_multiTermEmptyChains(trailing //)", "rejected", parseOutcome("PEP//"));
+  check("test_multiTermEmptyChains(trailing +)", "rejected", parseOutcome("PEP+"));
+  check("test_multiTermEmptyChains(inner)", "rejected", parseOutcome("PEP++TIDE"));
+  check("test_multiTermEmptyChains(mixed)", "rejected", parseOutcome("PEP//+TIDE"));
+  check("test_multiTermEmptyChains(valid)", "2 chains", parseOutcome("PEP+TIDE"));
+}
+
+int main()
+{
+  try
+  {
+    test_multiTermCrosslink();
+    test_multiTermBranch();
+    test_multiTermChimeric();
+    test_multiTermEmptyChains();
+  }
+  catch (ProFormaParseException* e)
+  {
+    std::cerr << "FAILED with parsing exception: " << e->what() << std::endl;
+    failures++;
+  }
+
+  return failures == 0 ? 0 : 1;
+}
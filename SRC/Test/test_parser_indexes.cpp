@@ -0,0 +1,66 @@
+#include <iostream>
+#include <string>
+
+#include "ProFormaParseException.h"
+#include "ProFormaParser.h"
+#include "ProFormaTagGroup.h"
+#include "TestUtil.h"
+
+using namespace ProForma;
+
+// "start-end" of every tag
+static std::string tagIndexes(const ProFormaTerm& term)
+{
+  std::string indexes;
+  for (const ProFormaTag& tag : term.Tags())
+    indexes += std::to_string(tag.ZeroBasedStartIndex()) + "-" + std::to_string(tag.ZeroBasedEndIndex()) + " ";
+  return indexes;
+}
+
+// "start-end" of every member of a group
+static std::string memberIndexes(const ProFormaTerm& term, const std::string& group)
+{
+  std::string indexes;
+  auto found = term.TagGroups().find(group);
+  if (found != term.TagGroups().end())
+    for (const ProFormaMembershipDescriptor& member : found->second->Members())
+      indexes += std::to_string(member.ZeroBasedStartIndex()) + "-" + std::to_string(member.ZeroBasedEndIndex()) + " ";
+  return indexes;
+}
+
+// Residue 255 used to be the parser's "no index" value: a range starting there lost its start and a group
+// member there was dropped as if defined before the sequence
+void test_rangePastResidue255()
+{
+  ProFormaQuietParser parser;
+
+  ProFormaTerm atLimit = parser.ParseString(std::string(255, 'A') + "(EMK)[Oxidation]" + std::string(10, 'A'));
+  check("test_rangePastResidue255(at 255)", "255-257 ", tagIndexes(atLimit));
+
+  ProFormaTerm past = parser.ParseString(std::string(300, 'A') + "(EMK)[Oxidation]S[Phospho]");
+  check("test_rangePastResidue255(past 255)", "300-302 303-303 ", tagIndexes(past));
+}
+
+void test_tagGroupPastResidue255()
+{
+  ProFormaQuietParser parser;
+
+  ProFormaTerm term = parser.ParseString(std::string(255, 'A') + "S[Phospho#g1]" + std::string(44, 'A') + "(TK)[#g1]");
+  check("test_tagGroupPastResidue255", "255-255 300-301 ", memberIndexes(term, "g1"));
+}
+
+int main()
+{
+  try
+  {
+    test_rangePastResidue255();
+    test_tagGroupPastResidue255();
+  }
+  catch (ProFormaParseException* e)
+  {
+    std::cerr << "FAILED with parsing exception: " << e->what() << std::endl;
+    failures++;
+  }
+
+  return failures == 0 ? 0 : 1;
+}
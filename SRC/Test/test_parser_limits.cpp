@@ -0,0 +1,111 @@
+#include <iostream>
+#include <string>
+
+#include "ProFormaParseException.h"
+#include "ProFormaParser.h"
+#include "ProFormaParserLimits.h"
+#include "TestUtil.h"
+
+using namespace ProForma;
+
+// Error code of the parse, "ok" when it succeeds
+static std::string parseOutcome(const ProFormaParserLimits& limits, const std::string& proFormaString)
+{
+  try
+  {
+    ProFormaQuietParser parser(limits);
+    parser.ParseString(proFormaString);
+    return "ok";
+  }
+  catch (ProFormaParseException* e)
+  {
+    std::string code = std::to_string(static_cast<int>(e->Code()));
+    delete e;
+    return code;
+  }
+}
+
+static std::string code(ProFormaParseErrorCode code)
+{
+  return std::to_string(static_cast<int>(code));
+}
+
+void test_limitInputTooLong()
+{
+  ProFormaParserLimits limits;
+  limits.MaxInputLength = 7;
+
+  check("test_limitInputTooLong(at limit)", "ok", parseOutcome(limits, "PEPTIDE"));
+  check("test_limitInputTooLong", code(ProFormaParseErrorCode::InputTooLong), parseOutcome(limits, "PEPTIDES"));
+}
+
+void test_limitTooManyResidues()
+{
+  ProFormaParserLimits limits;
+  limits.MaxResidues = 7;
+
+  check("test_limitTooManyResidues(at limit)", "ok", parseOutcome(limits, "PEM[Oxidation]TIDE"));
+  check("test_limitTooManyResidues", code(ProFormaParseErrorCode::TooManyResidues), parseOutcome(limits, "PEM[Oxidation]TIDES"));
+}
+
+void test_limitTooManyTags()
+{
+  ProFormaParserLimits limits;
+  limits.MaxTags = 2;
+
+  check("test_limitTooManyTags(at limit)", "ok", parseOutcome(limits, "[Acetyl]-PEM[Oxidation]TIDE"));
+  check("test_limitTooManyTags", code(ProFormaParseErrorCode::TooManyTags), parseOutcome(limits, "[Acetyl]-PEM[Oxidation]TIDE-[Amidated]"));
+}
+
+void test_limitTooManyDescriptors()
+{
+  ProFormaParserLimits limits;
+  limits.MaxDescriptorsPerTag = 2;
+
+  check("test_limitTooManyDescriptors(at limit)", "ok", parseOutcome(limits, "PEM[Oxidation|Info:a]TIDE"));
+  check("test_limitTooManyDescriptors", code(ProFormaParseErrorCode::TooManyDescriptors), parseOutcome(limits, "PEM[Oxidation|Info:a|Info:b]TIDE"));
+  check("test_limitTooManyDescriptors(global)", code(ProFormaParseErrorCode::TooManyDescriptors), parseOutcome(limits, "<[Oxidation|Info:a|Info:b]@M>PEMTIDE"));
+
+  // Checked while the tag is read, an unclosed tag fails on the limit instead of the missing bracket
+  check("test_limitTooManyDescriptors(unclosed)", code(ProFormaParseErrorCode::TooManyDescriptors), parseOutcome(limits, "PEM[a|b|c|d|e|f"));
+}
+
+void test_limitNestingTooDeep()
+{
+  ProFormaParserLimits limits;
+  limits.MaxNestingDepth = 1;
+
+  check("test_limitNestingTooDeep(at limit)", "ok", parseOutcome(limits, "PEM[Oxidation]TIDE"));
+  check("test_limitNestingTooDeep", code(ProFormaParseErrorCode::NestingTooDeep), parseOutcome(limits, "PEM[Formula:[13C]H2]TIDE"));
+}
+
+void test_limitAllocationLimitExceeded()
+{
+  ProFormaParserLimits limits;
+  limits.MaxAllocatedBytes = 64;
+
+  check("test_limitAllocationLimitExceeded(residues)", code(ProFormaParseErrorCode::AllocationLimitExceeded), parseOutcome(limits, std::string(65, 'A')));
+
+  // Counted while the tag is read, an unclosed tag cannot grow past the limit
+  check("test_limitAllocationLimitExceeded(tag)", code(ProFormaParseErrorCode::AllocationLimitExceeded), parseOutcome(limits, "PEM[" + std::string(100, 'x')));
+}
+
+int main()
+{
+  try
+  {
+    test_limitInputTooLong();
+    test_limitTooManyResidues();
+    test_limitTooManyTags();
+    test_limitTooManyDescriptors();
+    test_limitNestingTooDeep();
+    test_limitAllocationLimitExceeded();
+  }
+  catch (ProFormaParseException* e)
+  {
+    std::cerr << "FAILED with parsing exception: " << e->what() << std::endl;
+    failures++;
+  }
+
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,64 @@
+#include <iostream>
+#include <string>
+
+#include "ProFormaParseException.h"
+#include "ProFormaParser.h"
+#include "TestUtil.h"
+
+using namespace ProForma;
+
+template <typename Parser>
+static std::string parseOutcome(const std::string& proFormaString)
+{
+  try
+  {
+    Parser parser;
+    return parser.ParseString(proFormaString).Sequence();
+  }
+  catch (ProFormaParseException* e)
+  {
+    delete e;
+    return "rejected";
+  }
+}
+
+void test_peptidePolicyRejectsFeatures()
+{
+  // Disabled features are errors, not silently dropped
+  check("test_peptidePolicyRejectsFeatures(global)", "rejected", parseOutcome<ProFormaPeptideParser>("<[Carbamidomethyl]@C>PEPCK"));
+  check("test_peptidePolicyRejectsFeatures(labile)", "rejected", parseOutcome<ProFormaPeptideParser>("{Glycan:Hex}PEPTIDE"));
+  check("test_peptidePolicyRejectsFeatures(range)", "rejected", parseOutcome<ProFormaPeptideParser>("(PEP)[Oxidation]TIDE"));
+  check("test_peptidePolicyRejectsFeatures(group)", "rejected", parseOutcome<ProFormaPeptideParser>("EM[Oxidation#g1]EVK"));
+  check("test_peptidePolicyRejectsFeatures(unlocalized)", "rejected", parseOutcome<ProFormaPeptideParser>("[Phospho]?PEPTIDE"));
+
+  // Localized and terminal modifications are kept
+  check("test_peptidePolicyRejectsFeatures(localized)", "PEMTIDE", parseOutcome<ProFormaPeptideParser>("[Acetyl]-PEM[Oxidation]TIDE-[Amidated]"));
+}
+
+void test_lenientPolicyAcceptsLowerCase()
+{
+  check("test_lenientPolicyAcceptsLowerCase(lower)", "PEPTIDE", parseOutcome<ProFormaLenientParser>("peptide"));
+  check("test_lenientPolicyAcceptsLowerCase(blanks)", "PEPTIDE", parseOutcome<ProFormaLenientParser>(" pep\ttide "));
+  check("test_lenientPolicyAcceptsLowerCase(tags)", "PEMTIDE", parseOutcome<ProFormaLenientParser>("pem[Oxidation] tide"));
+
+  // Only letters are residues, and strict parsers keep rejecting lower case
+  check("test_lenientPolicyAcceptsLowerCase(digit)", "rejected", parseOutcome<ProFormaLenientParser>("pep7ide"));
+  check("test_lenientPolicyAcceptsLowerCase(high bit)", "rejected", parseOutcome<ProFormaLenientParser>("pep\xE9tide"));
+  check("test_lenientPolicyAcceptsLowerCase(strict)", "rejected", parseOutcome<ProFormaQuietParser>("peptide"));
+}
+
+int main()
+{
+  try
+  {
+    test_peptidePolicyRejectsFeatures();
+    test_lenientPolicyAcceptsLowerCase();
+  }
+  catch (ProFormaParseException* e)
+  {
+    std::cerr << "FAILED with parsing exception: " << e->what() << std::endl;
+    failures++;
+  }
+
+  return failures == 0 ? 0 : 1;
+}
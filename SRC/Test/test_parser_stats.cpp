@@ -0,0 +1,127 @@
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ProFormaParseException.h"
+#include "ProFormaParser.h"
+#include "ProFormaParserStats.h"
+#include "TestUtil.h"
+
+using namespace ProForma;
+
+static void checkCounter(const std::string& test, uint64_t expected, const ProFormaParserStatsSnapshot& stats, ProFormaParserCounter counter)
+{
+  check(test, std::to_string(expected), std::to_string(stats[counter]));
+}
+
+void test_statsCountConstructs()
+{
+  ProFormaQuietParser parser;
+  ProFormaParserStats::Reset();
+
+  const std::string grouped = "[Acetyl]-EM[Oxidation]EVT[#g1(0.01)]S[#g1(0.09)]ES[Phospho#g1(0.90)]PEK-[Amidated]";
+  const std::string other = "<[Carbamidomethyl]@C>[Phospho]?{Glycan:Hex}PRT(ESFRMS)[+19.0523|Info:test]ISK";
+  parser.ParseString(grouped);
+  parser.ParseString(other);
+
+  ProFormaParserStatsSnapshot stats = ProFormaParserStats::Snapshot();
+  checkCounter("test_statsCountConstructs(parses)", 2, stats, ProFormaParserCounter::Parses);
+  checkCounter("test_statsCountConstructs(failures)", 0, stats, ProFormaParserCounter::Failures);
+  checkCounter("test_statsCountConstructs(bytes)", grouped.length() + other.length(), stats, ProFormaParserCounter::InputBytes);
+  checkCounter("test_statsCountConstructs(residues)", 11 + 12, stats, ProFormaParserCounter::Residues);
+  checkCounter("test_statsCountConstructs(tags)", 6 + 4, stats, ProFormaParserCounter::Tags);
+  checkCounter("test_statsCountConstructs(localized)", 1 + 1, stats, ProFormaParserCounter::LocalizedTags);
+  checkCounter("test_statsCountConstructs(terminal)", 2, stats, ProFormaParserCounter::TerminalModifications);
+  checkCounter("test_statsCountConstructs(groups)", 1, stats, ProFormaParserCounter::TagGroups);
+  checkCounter("test_statsCountConstructs(members)", 3, stats, ProFormaParserCounter::GroupMembers);
+  checkCounter("test_statsCountConstructs(unlocalized)", 1, stats, ProFormaParserCounter::UnlocalizedTags);
+  checkCounter("test_statsCountConstructs(global)", 1, stats, ProFormaParserCounter::GlobalModifications);
+  checkCounter("test_statsCountConstructs(labile)", 1, stats, ProFormaParserCounter::LabileModifications);
+  checkCounter("test_statsCountConstructs(ranges)", 1, stats, ProFormaParserCounter::Ranges);
+  checkCounter("test_statsCountConstructs(descriptors)", 6 + 5, stats, ProFormaParserCounter::Descriptors);
+
+  // Naked group references have no key
+  check("test_statsCountConstructs(names)", "6", std::to_string(stats.DescriptorsByKey[static_cast<size_t>(ProFormaKey::Name)]));
+  check("test_statsCountConstructs(none)", "2", std::to_string(stats.DescriptorsByKey[static_cast<size_t>(ProFormaKey::None)]));
+  check("test_statsCountConstructs(glycan)", "1", std::to_string(stats.DescriptorsByKey[static_cast<size_t>(ProFormaKey::Glycan)]));
+  check("test_statsCountConstructs(time)", "1", std::to_string(stats[ProFormaParserCounter::ParseNanoseconds] > 0));
+}
+
+void test_statsCountErrors()
+{
+  ProFormaParserLimits limits;
+  limits.MaxTags = 1;
+  ProFormaQuietParser parser(limits);
+  ProFormaParserStats::Reset();
+
+  for (const char* input : { "EM[Oxidation]S[Phospho]K", "EM[Oxidation", "PEPTIDE" })
+  {
+    try
+    {
+      parser.ParseString(input);
+    }
+    catch (ProFormaParseException*)
+    {
+    }
+  }
+
+  ProFormaParserStatsSnapshot stats = ProFormaParserStats::Snapshot();
+  checkCounter("test_statsCountErrors(parses)", 1, stats, ProFormaParserCounter::Parses);
+  checkCounter("test_statsCountErrors(failures)", 2, stats, ProFormaParserCounter::Failures);
+  check("test_statsCountErrors(tags)", "1", std::to_string(stats.Errors[static_cast<size_t>(ProFormaParseErrorCode::TooManyTags)]));
+  check("test_statsCountErrors(syntax)", "1", std::to_string(stats.Errors[static_cast<size_t>(ProFormaParseErrorCode::Syntax)]));
+}
+
+void test_statsMergeThreads()
+{
+  ProFormaParserStats::Reset();
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++)
+    threads.emplace_back([] {
+      ProFormaQuietParser parser;
+      for (int i = 0; i < 1000; i++)
+        parser.ParseString("PEPT[Phospho]IDE");
+    });
+  for (auto& thread : threads)
+    thread.join();
+
+  // Counters of finished threads are kept
+  ProFormaParserStatsSnapshot stats = ProFormaParserStats::Snapshot();
+  checkCounter("test_statsMergeThreads(parses)", 4000, stats, ProFormaParserCounter::Parses);
+  checkCounter("test_statsMergeThreads(residues)", 28000, stats, ProFormaParserCounter::Residues);
+  checkCounter("test_statsMergeThreads(tags)", 4000, stats, ProFormaParserCounter::LocalizedTags);
+
+  ProFormaParserStatsSnapshot twice = stats;
+  twice.Merge(stats);
+  checkCounter("test_statsMergeThreads(merge)", 8000, twice, ProFormaParserCounter::Parses);
+
+  ProFormaParserStats::Reset();
+  checkCounter("test_statsMergeThreads(reset)", 0, ProFormaParserStats::Snapshot(), ProFormaParserCounter::Parses);
+}
+
+int main()
+{
+  if (!ProFormaDefaultPolicy::CollectStats)
+  {
+    // Built with PROFORMA_PARSER_STATS=0, the parsers do not count anything
+    ProFormaQuietParser().ParseString("PEPTIDE");
+    checkCounter("test_statsDisabled", 0, ProFormaParserStats::Snapshot(), ProFormaParserCounter::Parses);
+    return failures == 0 ? 0 : 1;
+  }
+
+  try
+  {
+    test_statsCountConstructs();
+    test_statsCountErrors();
+    test_statsMergeThreads();
+  }
+  catch (ProFormaParseException* e)
+  {
+    std::cerr << "FAILED with parsing exception: " << e->what() << std::endl;
+    failures++;
+  }
+
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,106 @@
+#include <iostream>
+#include <string>
+
+#include "ProFormaLiteral.h"
+#include "ProFormaParseException.h"
+#include "ProFormaParser.h"
+#include "ProFormaWriter.h"
+#include "TestUtil.h"
+
+using namespace ProForma;
+
+// Parsed by the compiler, a syntax error in these literals breaks the build
+constexpr auto fixedMods = "<[Carbamidomethyl]@C,M>"_proforma;
+constexpr auto peptide = "[Acetyl]-PEM[Oxidation]T[Phospho|Info:test]IDE-[Amidated]"_proforma;
+
+static_assert(fixedMods.Sequence().empty(), "A global modification has no residues");
+static_assert(fixedMods.GlobalModificationCount() == 1, "One global modification");
+static_assert(fixedMods.GlobalModification(0).Targets == "C,M", "Targets are kept as written");
+static_assert(peptide.Sequence().length() == 7, "Residue count");
+static_assert(peptide.TagCount() == 2, "Tag count");
+static_assert(peptide.Tag(0).ZeroBasedIndex == 2, "Oxidation is on M");
+static_assert(peptide.Tag(1).ZeroBasedIndex == 3, "Second tag is on T");
+static_assert(peptide.Tag(1).DescriptorCount == 2, "Descriptors separated by |");
+static_assert(peptide.Descriptor(peptide.Tag(1).FirstDescriptor + 1).Key == ProFormaKey::Info, "Info prefix is classified");
+static_assert(peptide.NTerminal().DescriptorCount == 1 && peptide.CTerminal().DescriptorCount == 1, "Terminal modifications");
+
+static std::string describe(const std::list<ProFormaDescriptor>& descriptors)
+{
+  std::string text;
+  for (auto& descriptor : descriptors)
+    text += std::to_string(static_cast<int>(descriptor.Key())) + "/" + std::to_string(static_cast<int>(descriptor.EvidenceType())) + "/" + descriptor.Value() + ";";
+  return text;
+}
+
+// Everything a literal can hold, compared field by field
+static std::string describe(const ProFormaTerm& term)
+{
+  std::string text = term.Sequence() + " N:" + describe(term.NTerminalDescriptors()) + " C:" + describe(term.CTerminalDescriptors());
+
+  for (auto& tag : term.Tags())
+    text += " @" + std::to_string(tag.ZeroBasedStartIndex()) + ":" + describe(tag.Descriptors());
+
+  for (auto& global : term.GlobalModifications())
+  {
+    text += " <" + describe(global.Descriptors()) + "@";
+    for (char target : global.TargetAminoAcids())
+      text += target;
+    text += ">";
+  }
+
+  return text;
+}
+
+template <typename Literal>
+static void checkLiteral(const std::string& test, const Literal& literal, const std::string& proFormaString)
+{
+  ProFormaQuietParser parser;
+  ProFormaTerm parsed = parser.ParseString(proFormaString);
+  ProFormaTerm converted = literal.ToTerm();
+
+  check(test, describe(parsed), describe(converted));
+  check(test + "(string)", ProFormaWriter::TermToString(parsed), ProFormaWriter::TermToString(converted));
+}
+
+void test_literalMatchesParser()
+{
+  checkLiteral("test_literalMatchesParser(global)", fixedMods, "<[Carbamidomethyl]@C,M>");
+  checkLiteral("test_literalMatchesParser(peptide)", peptide, "[Acetyl]-PEM[Oxidation]T[Phospho|Info:test]IDE-[Amidated]");
+  checkLiteral("test_literalMatchesParser(prefixes)", "PEM[U:Oxidation]S[UNIMOD:21]K[Formula:C2H2O]C[+57.021]Y[MOD:00046]"_proforma,
+    "PEM[U:Oxidation]S[UNIMOD:21]K[Formula:C2H2O]C[+57.021]Y[MOD:00046]");
+  checkLiteral("test_literalMatchesParser(mass global)", "<[+15.995]@M>PEMTIDE"_proforma, "<[+15.995]@M>PEMTIDE");
+}
+
+void test_literalRejectsAtRuntime()
+{
+  // Not declared constexpr, so the errors surface as exceptions instead of compilation errors
+  std::string outcome;
+  try
+  {
+    auto term = ProFormaLiteralTerm::Parse("EM[Oxidation#g1]EVK");
+    outcome = std::string(term.Sequence());
+  }
+  catch (ProFormaParseException* e)
+  {
+    outcome = e->what();
+    delete e;
+  }
+
+  check("test_literalRejectsAtRuntime", "Tag groups are not supported in ProForma literals.", outcome);
+}
+
+int main()
+{
+  try
+  {
+    test_literalMatchesParser();
+    test_literalRejectsAtRuntime();
+  }
+  catch (ProFormaParseException* e)
+  {
+    std::cerr << "FAILED with parsing exception: " << e->what() << std::endl;
+    failures++;
+  }
+
+  return failures == 0 ? 0 : 1;
+}
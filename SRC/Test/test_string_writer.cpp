@@ -0,0 +1,75 @@
+#include <iostream>
+#include <string>
+
+#include "ProFormaParseException.h"
+#include "ProFormaParser.h"
+#include "ProFormaTermBuilder.h"
+#include "ProFormaWriter.h"
+#include "TestUtil.h"
+
+using namespace ProForma;
+
+// The string is written back as it was read, and reading the output again gives the same string
+static void checkRoundTrip(const std::string& test, const std::string& proFormaString)
+{
+  ProFormaQuietParser parser;
+  std::string written = ProFormaWriter::TermToString(parser.ParseString(proFormaString));
+
+  check(test, proFormaString, written);
+  check(test + "(twice)", written, ProFormaWriter::TermToString(parser.ParseString(written)));
+}
+
+void test_roundTripGroups()
+{
+  checkRoundTrip("test_roundTripGroups(ambiguity)", "EM[Oxidation]EVT[Phospho#g1(0.01)]S[#g1(0.09)]ES[#g1(0.9)]PEK");
+  checkRoundTrip("test_roundTripGroups(two groups)", "EM[Oxidation#g2]EVT[Phospho#g1]S[#g1]ES[#g2]PEK");
+  checkRoundTrip("test_roundTripGroups(tag and member)", "EM[Oxidation]EVT[Phospho|#g1]S[#g1]PEK");
+  checkRoundTrip("test_roundTripGroups(crosslink)", "EMEVTK[XLMOD:02001#XL1]SESPEK[#XL1]");
+  checkRoundTrip("test_roundTripGroups(interleaved)", "EMEVT[Phospho#g1]S[Phospho#g2]ES[#g1]PEK[#g2]");
+  checkRoundTrip("test_roundTripGroups(interleaved with tags)", "EM[Oxidation]EVT[Phospho#g1]S[Phospho#g2]E[Deamidated]S[#g1]PEK[#g2]");
+}
+
+void test_roundTripRanges()
+{
+  checkRoundTrip("test_roundTripRanges(range)", "PRT(ESFRMS)[+19.0523]ISK");
+  checkRoundTrip("test_roundTripRanges(group range)", "PRT(ESFRMS)[+19.0523#g1]ISK(EE)[#g1]");
+}
+
+void test_roundTripUnlocalized()
+{
+  checkRoundTrip("test_roundTripUnlocalized(single)", "[Phospho]?EM[Oxidation]EVTSESPEK");
+  checkRoundTrip("test_roundTripUnlocalized(terminal)", "[Phospho]?[Acetyl]-EMEVTSESPEK-[Amidated]");
+  checkRoundTrip("test_roundTripUnlocalized(global and labile)", "<[Carbamidomethyl]@C>{Glycan:Hex}[Phospho]?EMCVTSESPEK");
+}
+
+void test_writeOutOfOrder()
+{
+  // Built by hand in reverse order, the writer sorts the tags and members
+  ProFormaTermBuilder builder;
+  builder.SetSequence("EMEVTSESPEK");
+  builder.AddTag(8, std::list<ProFormaDescriptor>{ ProFormaDescriptor("Phospho") });
+  builder.AddTag(1, std::list<ProFormaDescriptor>{ ProFormaDescriptor("Oxidation") });
+  builder.AddTagGroup("g1", ProFormaKey::Name, ProFormaEvidenceType::None, "Phospho");
+  builder.AddGroupMember("g1", ProFormaMembershipDescriptor(5));
+  builder.AddGroupMember("g1", ProFormaMembershipDescriptor(4));
+
+  check("test_writeOutOfOrder", "EM[Oxidation]EVT[#g1]S[Phospho#g1]ESP[Phospho]EK", ProFormaWriter::TermToString(std::move(builder).Build()));
+}
+
+int main()
+{
+  try
+  {
+    test_roundTripGroups();
+    test_roundTripRanges();
+    test_roundTripUnlocalized();
+    test_writeOutOfOrder();
+  }
+  catch (ProFormaParseException* e)
+  {
+    std::cerr << "FAILED with parsing exception: " << e->what() << std::endl;
+    failures++;
+  }
+
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,158 @@
+// GCC pairs the malloc inlined from the replacement operator new below with the operator delete calls and
+// reports them as mismatched, although both replacements go through malloc and free
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+
+#include "ProFormaParseException.h"
+#include "ProFormaTagGroupChangingValue.h"
+#include "ProFormaTermBuilder.h"
+#include "TestUtil.h"
+
+using namespace ProForma;
+
+static std::atomic<long> _allocations(0);
+static std::atomic<long> _liveAllocations(0);
+
+// Count every heap allocation of the test, and those not freed yet
+void* operator new(size_t size)
+{
+  _allocations.fetch_add(1, std::memory_order_relaxed);
+  _liveAllocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+  if (p)
+    _liveAllocations.fetch_sub(1, std::memory_order_relaxed);
+  std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+  if (p)
+    _liveAllocations.fetch_sub(1, std::memory_order_relaxed);
+  std::free(p);
+}
+
+static std::list<ProFormaDescriptor> makeDescriptors(size_t count, size_t valueLength)
+{
+  std::list<ProFormaDescriptor> descriptors;
+  for (size_t i = 0; i < count; i++)
+    descriptors.push_back(ProFormaDescriptor(ProFormaKey::Name, std::string(valueLength, 'x')));
+  return descriptors;
+}
+
+template <typename Action>
+static long countAllocations(Action action)
+{
+  long before = _allocations.load(std::memory_order_relaxed);
+  action();
+  return _allocations.load(std::memory_order_relaxed) - before;
+}
+
+// Nothing is copied: what a builder call allocates does not depend on the size of what it is given
+void test_builderAllocatesOnce()
+{
+  ProFormaTermBuilder builder;
+  builder.SetSequence(std::string(300, 'A'));
+
+  std::list<ProFormaDescriptor> small = makeDescriptors(1, 1);
+  std::list<ProFormaDescriptor> large = makeDescriptors(50, 100);
+  long addSmall = countAllocations([&]() { builder.AddTag(0, std::move(small)); });
+  long addLarge = countAllocations([&]() { builder.AddTag(1, std::move(large)); });
+  check("test_builderAllocatesOnce(AddTag)", std::to_string(addSmall), std::to_string(addLarge));
+
+  ProFormaDescriptor shortValue(ProFormaKey::Name, "x");
+  ProFormaDescriptor longValue(ProFormaKey::Name, std::string(1000, 'x'));
+  long descriptorShort = countAllocations([&]() { builder.AddDescriptor(std::move(shortValue)); });
+  long descriptorLong = countAllocations([&]() { builder.AddDescriptor(std::move(longValue)); });
+  check("test_builderAllocatesOnce(AddDescriptor)", std::to_string(descriptorShort), std::to_string(descriptorLong));
+
+  // Build only moves the containers, so a term of 100 tags costs what a term of 1 tag does
+  ProFormaTermBuilder one;
+  one.SetSequence("A").AddTag(0, makeDescriptors(1, 1));
+
+  ProFormaTermBuilder hundred;
+  hundred.SetSequence(std::string(300, 'A'));
+  for (size_t i = 0; i < 100; i++)
+    hundred.AddTag(i, makeDescriptors(3, 50));
+
+  long buildOne = countAllocations([&]() { ProFormaTerm term = std::move(one).Build(); });
+  long buildHundred = countAllocations([&]() { ProFormaTerm term = std::move(hundred).Build(); });
+  check("test_builderAllocatesOnce(Build)", std::to_string(buildOne), std::to_string(buildHundred));
+}
+
+void test_builderAddDescriptorWithoutTag()
+{
+  std::string outcome = "accepted";
+  try
+  {
+    ProFormaTermBuilder builder;
+    builder.SetSequence("PEPTIDE").AddDescriptor(ProFormaDescriptor("Oxidation"));
+  }
+  catch (ProFormaParseException* e)
+  {
+    outcome = "rejected";
+    delete e;
+  }
+
+  check("test_builderAddDescriptorWithoutTag", "rejected", outcome);
+}
+
+void test_builderFreesGroups()
+{
+  long live = _liveAllocations.load(std::memory_order_relaxed);
+  {
+    // Abandoned half way, as after a parse error
+    ProFormaTermBuilder builder;
+    builder.SetSequence("EMEVTKSESPEK");
+    builder.AddTagGroup("g1", ProFormaKey::Name, ProFormaEvidenceType::None, "Oxidation");
+    builder.AddTagGroup(new ProFormaTagGroupChangingValue(std::string(100, 'g'), ProFormaKey::Name, ProFormaEvidenceType::None, std::list<ProFormaMembershipDescriptor>()));
+    builder.AddGroupMember("g1", ProFormaMembershipDescriptor(1, 1, 0.5));
+  }
+  check("test_builderFreesGroups(abandoned)", std::to_string(live), std::to_string(_liveAllocations.load(std::memory_order_relaxed)));
+
+  std::string outcome = "accepted";
+  {
+    ProFormaTermBuilder builder;
+    builder.AddTagGroup("g1", ProFormaKey::Name, ProFormaEvidenceType::None, "Oxidation");
+    try
+    {
+      builder.AddTagGroup("g1", ProFormaKey::Name, ProFormaEvidenceType::None, "Phospho");
+    }
+    catch (ProFormaParseException* e)
+    {
+      outcome = "rejected";
+      delete e;
+    }
+  }
+  check("test_builderFreesGroups(duplicate)", "rejected", outcome);
+  check("test_builderFreesGroups(duplicate freed)", std::to_string(live), std::to_string(_liveAllocations.load(std::memory_order_relaxed)));
+}
+
+int main()
+{
+  try
+  {
+    test_builderAllocatesOnce();
+    test_builderAddDescriptorWithoutTag();
+    test_builderFreesGroups();
+  }
+  catch (ProFormaParseException* e)
+  {
+    std::cerr << "FAILED with parsing exception: " << e->what() << std::endl;
+    failures++;
+  }
+
+  return failures == 0 ? 0 : 1;
+}